@@ -38,6 +38,7 @@
 
 #include "app/credentials_dialog.h"
 
+#include "proxy/discovery_cache.h"
 #include "proxy/server_config.h"
 #include "proxy/settings_manager.h"
 
@@ -351,6 +352,7 @@ int main(int argc, char* argv[]) {
   int res = app.exec();
   settings_manager->SetMainWindowSettings(main_window.saveGeometry());
   settings_manager->Save();
+  fastonosql::proxy::DiscoveryCache::GetInstance().Flush();
   settings_manager->FreeInstance();
   return res;
 }
@@ -0,0 +1,339 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/db/redis/cluster_dashboard_dialog.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <QColor>
+#include <QDialogButtonBox>
+#include <QFont>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QThread>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include <common/qt/convert2string.h>
+
+#include "proxy/cluster/icluster.h"
+#include "proxy/db/redis/server.h"
+
+#include "gui/db/redis/cluster_stats_monitor.h"
+
+#include "translations/global.h"
+
+namespace {
+const QString trInterval = QObject::tr("Interval, sec:");
+const QString trConnections = QObject::tr("Parallel connections:");
+const QString trStart = QObject::tr("Start");
+const QString trNode = QObject::tr("Node");
+const QString trRole = QObject::tr("Role");
+const QString trOpsPerSec = QObject::tr("Ops/sec");
+const QString trHitRatio = QObject::tr("Hit ratio");
+const QString trEvictionsPerSec = QObject::tr("Evictions/sec");
+const QString trMemory = QObject::tr("Memory, MB");
+const QString trMemoryUsage = QObject::tr("Memory, %");
+const QString trClients = QObject::tr("Clients");
+const QString trReplicationLag = QObject::tr("Replication lag, bytes");
+const QString trTotal = QObject::tr("Total");
+const QString trMaster = QObject::tr("master");
+const QString trReplica = QObject::tr("replica");
+const QString trOk = QObject::tr("OK");
+const QString trStatusTemplate_2S = QObject::tr("Nodes: %1, unavailable: %2");
+const QString trSkippedTemplate_1S = QObject::tr("Not sampled: %1");
+
+enum Column {
+  kNodeColumn = 0,
+  kRoleColumn,
+  kOpsColumn,
+  kHitRatioColumn,
+  kEvictionsColumn,
+  kMemoryColumn,
+  kMemoryUsageColumn,
+  kClientsColumn,
+  kLagColumn,
+  kStateColumn,
+  kColumnsCount
+};
+
+const double kBytesInMb = 1024.0 * 1024.0;
+
+QString ratioText(double ratio) {
+  return ratio < 0 ? QString() : QString::number(ratio * 100, 'f', 1) + "%";
+}
+
+double memoryUsage(const fastonosql::proxy::redis_compatible::NodeStats& stats) {
+  return stats.maxmemory ? static_cast<double>(stats.used_memory) * 100 / static_cast<double>(stats.maxmemory) : -1;
+}
+
+// green for coldest node, red for hottest one
+QColor heatColor(double value, double max) {
+  const double heat = max > 0 ? std::min(std::max(value / max, 0.0), 1.0) : 0;
+  return QColor::fromHsvF((1 - heat) / 3, 0.35, 1.0);
+}
+}  // namespace
+
+namespace fastonosql {
+namespace gui {
+namespace redis {
+
+ClusterDashboardDialog::ClusterDashboardDialog(const QString& title,
+                                               const QIcon& icon,
+                                               proxy::IClusterSPtr cluster,
+                                               QWidget* parent)
+    : base_class(title, parent),
+      interval_spin_(nullptr),
+      connections_spin_(nullptr),
+      start_button_(nullptr),
+      stop_button_(nullptr),
+      nodes_table_(nullptr),
+      status_label_(nullptr),
+      skipped_nodes_(),
+      cluster_(cluster),
+      monitor_() {
+  CHECK(cluster_);
+  setWindowIcon(icon);
+
+  const proxy::redis_compatible::InfoSamplerOptions defaults;
+  interval_spin_ = new QSpinBox;
+  interval_spin_->setRange(1, max_interval_sec);
+  interval_spin_->setValue(static_cast<int>(defaults.interval_msec / 1000));
+  connections_spin_ = new QSpinBox;
+  connections_spin_->setRange(1, max_connections);
+  connections_spin_->setValue(static_cast<int>(defaults.max_connections));
+
+  QFormLayout* options_layout = new QFormLayout;
+  options_layout->addRow(trInterval, interval_spin_);
+  options_layout->addRow(trConnections, connections_spin_);
+
+  start_button_ = new QPushButton;
+  VERIFY(connect(start_button_, &QPushButton::clicked, this, &ClusterDashboardDialog::startClicked));
+  stop_button_ = new QPushButton;
+  VERIFY(connect(stop_button_, &QPushButton::clicked, this, &ClusterDashboardDialog::stopClicked));
+  QHBoxLayout* buttons_layout = new QHBoxLayout;
+  buttons_layout->addWidget(start_button_);
+  buttons_layout->addWidget(stop_button_);
+  buttons_layout->addStretch(1);
+
+  nodes_table_ = new QTreeWidget;
+  nodes_table_->setRootIsDecorated(false);
+  nodes_table_->setColumnCount(kColumnsCount);
+
+  status_label_ = new QLabel;
+  status_label_->setWordWrap(true);
+
+  QDialogButtonBox* button_box = new QDialogButtonBox(QDialogButtonBox::Close);
+  button_box->setOrientation(Qt::Horizontal);
+  VERIFY(connect(button_box, &QDialogButtonBox::rejected, this, &ClusterDashboardDialog::reject));
+
+  QVBoxLayout* main_layout = new QVBoxLayout;
+  main_layout->addLayout(options_layout);
+  main_layout->addLayout(buttons_layout);
+  main_layout->addWidget(nodes_table_, 1);
+  main_layout->addWidget(status_label_);
+  main_layout->addWidget(button_box);
+  setLayout(main_layout);
+  setMinimumSize(QSize(min_width, min_height));
+
+  setRunning(false);
+}
+
+void ClusterDashboardDialog::reject() {
+  if (monitor_) {
+    monitor_->stop();
+  }
+  base_class::reject();
+}
+
+void ClusterDashboardDialog::startClicked() {
+  std::vector<proxy::redis_compatible::InfoSamplerNode> nodes;
+  skipped_nodes_.clear();
+  for (auto node : cluster_->GetNodes()) {
+    QString qname;
+    common::ConvertFromString(node->GetName(), &qname);
+    proxy::redis::Server* server = dynamic_cast<proxy::redis::Server*>(node.get());  // +
+    if (!server) {
+      skipped_nodes_ << qname;
+      continue;
+    }
+
+    proxy::redis_compatible::InfoSamplerNode sampler_node;
+    sampler_node.name = node->GetName();
+    common::Error err = server->GetDirectConnectionInfo(&sampler_node.host, &sampler_node.ssh_info,
+                                                         &sampler_node.password);
+    if (err) {
+      skipped_nodes_ << qname;
+      continue;
+    }
+    nodes.push_back(sampler_node);
+  }
+
+  nodes_table_->clear();
+  if (nodes.empty()) {
+    setStatus(QString());
+    return;
+  }
+
+  for (const auto& node : nodes) {
+    QString qname;
+    common::ConvertFromString(node.name, &qname);
+    QTreeWidgetItem* item = new QTreeWidgetItem(nodes_table_);
+    item->setText(kNodeColumn, qname);
+  }
+  QTreeWidgetItem* totals = new QTreeWidgetItem(nodes_table_);
+  totals->setText(kNodeColumn, trTotal);
+  QFont font = totals->font(kNodeColumn);
+  font.setBold(true);
+  for (int i = 0; i < kColumnsCount; ++i) {
+    totals->setFont(i, font);
+  }
+  setStatus(QString());
+
+  proxy::redis_compatible::InfoSamplerOptions options;
+  options.interval_msec = interval_spin_->value() * 1000;
+  options.max_connections = connections_spin_->value();
+
+  QThread* th = new QThread;
+  ClusterStatsMonitor* monitor = new ClusterStatsMonitor(nodes, options);
+  monitor->moveToThread(th);
+  VERIFY(connect(th, &QThread::started, monitor, &ClusterStatsMonitor::routine));
+  VERIFY(connect(monitor, &ClusterStatsMonitor::statsUpdated, this, &ClusterDashboardDialog::statsUpdated));
+  VERIFY(connect(monitor, &ClusterStatsMonitor::monitorFinished, this, &ClusterDashboardDialog::monitorFinished));
+  VERIFY(connect(monitor, &ClusterStatsMonitor::monitorFinished, th, &QThread::quit));
+  VERIFY(connect(th, &QThread::finished, monitor, &ClusterStatsMonitor::deleteLater));
+  VERIFY(connect(th, &QThread::finished, th, &QThread::deleteLater));
+  monitor_ = monitor;
+  setRunning(true);
+  th->start();
+}
+
+void ClusterDashboardDialog::stopClicked() {
+  if (monitor_) {
+    monitor_->stop();
+  }
+  stop_button_->setEnabled(false);
+}
+
+void ClusterDashboardDialog::statsUpdated(proxy::redis_compatible::ClusterStats stats) {
+  const int nodes_count = static_cast<int>(stats.nodes.size());
+  if (nodes_table_->topLevelItemCount() != nodes_count + 1) {
+    return;  // table was rebuilt for another session
+  }
+
+  double max_ops = 0;
+  double max_evictions = 0;
+  double max_memory = 0;
+  double max_clients = 0;
+  double max_lag = 0;
+  size_t unavailable = 0;
+  for (const auto& node : stats.nodes) {
+    if (!node.error.empty()) {
+      unavailable++;
+      continue;
+    }
+    max_ops = std::max(max_ops, node.ops_per_sec);
+    max_evictions = std::max(max_evictions, node.evictions_per_sec);
+    max_memory = std::max(max_memory, static_cast<double>(node.used_memory));
+    max_clients = std::max(max_clients, static_cast<double>(node.connected_clients));
+    max_lag = std::max(max_lag, static_cast<double>(node.repl_lag_bytes));
+  }
+
+  const auto fill_row = [](QTreeWidgetItem* item, const proxy::redis_compatible::NodeStats& node) {
+    item->setText(kOpsColumn, QString::number(node.ops_per_sec, 'f', 1));
+    item->setText(kHitRatioColumn, ratioText(node.hit_ratio));
+    item->setText(kEvictionsColumn, QString::number(node.evictions_per_sec, 'f', 1));
+    item->setText(kMemoryColumn, QString::number(node.used_memory / kBytesInMb, 'f', 1));
+    const double usage = memoryUsage(node);
+    item->setText(kMemoryUsageColumn, usage < 0 ? QString() : QString::number(usage, 'f', 1));
+    item->setText(kClientsColumn, QString::number(node.connected_clients));
+    item->setText(kLagColumn, node.repl_lag_bytes < 0 ? QString() : QString::number(node.repl_lag_bytes));
+  };
+
+  for (int i = 0; i < nodes_count; ++i) {
+    const auto& node = stats.nodes[i];
+    QTreeWidgetItem* item = nodes_table_->topLevelItem(i);
+    if (!node.error.empty()) {
+      QString qerror;
+      common::ConvertFromString(node.error, &qerror);
+      item->setText(kStateColumn, qerror);
+      for (int column = kRoleColumn; column < kStateColumn; ++column) {
+        item->setText(column, QString());
+        item->setBackground(column, QBrush());
+      }
+      continue;
+    }
+
+    item->setText(kRoleColumn, node.is_master ? trMaster : trReplica);
+    item->setText(kStateColumn, trOk);
+    fill_row(item, node);
+    item->setBackground(kOpsColumn, heatColor(node.ops_per_sec, max_ops));
+    // misses are the hot side of hit ratio
+    item->setBackground(kHitRatioColumn, heatColor(node.hit_ratio < 0 ? 0 : 1 - node.hit_ratio, 1));
+    item->setBackground(kEvictionsColumn, heatColor(node.evictions_per_sec, max_evictions));
+    item->setBackground(kMemoryColumn, heatColor(static_cast<double>(node.used_memory), max_memory));
+    item->setBackground(kMemoryUsageColumn, heatColor(memoryUsage(node), 100));
+    item->setBackground(kClientsColumn, heatColor(static_cast<double>(node.connected_clients), max_clients));
+    item->setBackground(kLagColumn, heatColor(static_cast<double>(node.repl_lag_bytes), max_lag));
+  }
+
+  fill_row(nodes_table_->topLevelItem(nodes_count), stats.totals);
+
+  setStatus(trStatusTemplate_2S.arg(nodes_count).arg(unavailable));
+}
+
+void ClusterDashboardDialog::monitorFinished() {
+  monitor_ = nullptr;
+  setRunning(false);
+}
+
+void ClusterDashboardDialog::setRunning(bool running) {
+  interval_spin_->setEnabled(!running);
+  connections_spin_->setEnabled(!running);
+  start_button_->setEnabled(!running);
+  stop_button_->setEnabled(running);
+}
+
+void ClusterDashboardDialog::setStatus(const QString& status) {
+  if (skipped_nodes_.isEmpty()) {
+    status_label_->setText(status);
+    return;
+  }
+
+  const QString skipped = trSkippedTemplate_1S.arg(skipped_nodes_.join(", "));
+  status_label_->setText(status.isEmpty() ? skipped : status + "\n" + skipped);
+}
+
+void ClusterDashboardDialog::retranslateUi() {
+  start_button_->setText(trStart);
+  stop_button_->setText(translations::trStop);
+
+  QStringList columns;
+  columns << trNode << trRole << trOpsPerSec << trHitRatio << trEvictionsPerSec << trMemory << trMemoryUsage
+          << trClients << trReplicationLag << translations::trState;
+  nodes_table_->setHeaderLabels(columns);
+  base_class::retranslateUi();
+}
+
+}  // namespace redis
+}  // namespace gui
+}  // namespace fastonosql
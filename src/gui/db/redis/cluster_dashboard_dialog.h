@@ -0,0 +1,87 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QPointer>
+#include <QStringList>
+
+#include "gui/dialogs/base_dialog.h"
+
+#include "proxy/db/redis_compatible/info_sampler.h"
+#include "proxy/proxy_fwd.h"
+
+class QLabel;
+class QPushButton;
+class QSpinBox;
+class QTreeWidget;
+
+namespace fastonosql {
+namespace gui {
+namespace redis {
+
+class ClusterStatsMonitor;
+
+// Live INFO based metrics of all cluster nodes, cells are tinted by their load relative to other nodes.
+// Nodes are polled on dedicated connections, interactive connections of servers stay free.
+class ClusterDashboardDialog : public BaseDialog {
+  Q_OBJECT
+
+ public:
+  typedef BaseDialog base_class;
+  template <typename T, typename... Args>
+  friend T* createDialog(Args&&... args);
+
+  enum { min_width = 800, min_height = 400, max_interval_sec = 60, max_connections = 64 };
+
+ public Q_SLOTS:
+  void reject() override;
+
+ private Q_SLOTS:
+  void startClicked();
+  void stopClicked();
+  void statsUpdated(proxy::redis_compatible::ClusterStats stats);
+  void monitorFinished();
+
+ protected:
+  ClusterDashboardDialog(const QString& title,
+                         const QIcon& icon,
+                         proxy::IClusterSPtr cluster,
+                         QWidget* parent = Q_NULLPTR);
+
+  void retranslateUi() override;
+
+ private:
+  void setRunning(bool running);
+  void setStatus(const QString& status);
+
+  QSpinBox* interval_spin_;
+  QSpinBox* connections_spin_;
+  QPushButton* start_button_;
+  QPushButton* stop_button_;
+  QTreeWidget* nodes_table_;
+  QLabel* status_label_;
+  QStringList skipped_nodes_;  // without direct TCP access
+
+  const proxy::IClusterSPtr cluster_;
+  QPointer<ClusterStatsMonitor> monitor_;
+};
+
+}  // namespace redis
+}  // namespace gui
+}  // namespace fastonosql
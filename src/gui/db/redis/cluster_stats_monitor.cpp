@@ -0,0 +1,47 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/db/redis/cluster_stats_monitor.h"
+
+namespace fastonosql {
+namespace gui {
+namespace redis {
+
+ClusterStatsMonitor::ClusterStatsMonitor(const std::vector<proxy::redis_compatible::InfoSamplerNode>& nodes,
+                                         const proxy::redis_compatible::InfoSamplerOptions& options,
+                                         QObject* parent)
+    : QObject(parent), sampler_(nodes, options) {
+  qRegisterMetaType<proxy::redis_compatible::ClusterStats>("proxy::redis_compatible::ClusterStats");
+}
+
+void ClusterStatsMonitor::stop() {
+  sampler_.Stop();
+}
+
+void ClusterStatsMonitor::routine() {
+  const auto callback = [this](const proxy::redis_compatible::ClusterStats& stats) {
+    emit statsUpdated(stats);
+    return true;
+  };
+  sampler_.Run(callback);
+  emit monitorFinished();
+}
+
+}  // namespace redis
+}  // namespace gui
+}  // namespace fastonosql
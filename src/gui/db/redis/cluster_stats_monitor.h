@@ -0,0 +1,54 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include <QObject>
+
+#include "proxy/db/redis_compatible/info_sampler.h"
+
+namespace fastonosql {
+namespace gui {
+namespace redis {
+
+class ClusterStatsMonitor : public QObject {
+  Q_OBJECT
+
+ public:
+  ClusterStatsMonitor(const std::vector<proxy::redis_compatible::InfoSamplerNode>& nodes,
+                      const proxy::redis_compatible::InfoSamplerOptions& options,
+                      QObject* parent = Q_NULLPTR);
+
+  void stop();  // thread safe
+
+ Q_SIGNALS:
+  void statsUpdated(proxy::redis_compatible::ClusterStats stats);
+  void monitorFinished();
+
+ public Q_SLOTS:
+  void routine();
+
+ private:
+  proxy::redis_compatible::InfoSampler sampler_;
+};
+
+}  // namespace redis
+}  // namespace gui
+}  // namespace fastonosql
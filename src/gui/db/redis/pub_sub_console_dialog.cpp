@@ -0,0 +1,333 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "gui/db/redis/pub_sub_console_dialog.h"
+
+#include <string>
+
+#include <QCheckBox>
+#include <QDateTime>
+#include <QDialogButtonBox>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPlainTextEdit>
+#include <QPushButton>
+#include <QSplitter>
+#include <QThread>
+#include <QTimer>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include <common/qt/convert2string.h>
+#include <common/qt/logger.h>
+
+#include "proxy/db/redis/server.h"
+
+#include "gui/db/redis/pub_sub_receiver.h"
+
+#include "translations/global.h"
+
+namespace {
+const QString trChannelsLabel = QObject::tr("Channels:");
+const QString trPatterns = QObject::tr("Patterns");
+const QString trSubscribe = QObject::tr("Subscribe");
+const QString trChannel = QObject::tr("Channel");
+const QString trMessages = QObject::tr("Messages");
+const QString trMessagesPerSec = QObject::tr("Msg/s");
+const QString trBytesPerSec = QObject::tr("Bytes/s");
+const QString trTotalBytes = QObject::tr("Total bytes");
+const QString trConnecting = QObject::tr("Connecting...");
+const QString trStatusTemplate_2S = QObject::tr("Received: %1, dropped: %2");
+const QString trErrorTemplate_1S = QObject::tr("Subscriber error: %1");
+const QString trMessageTemplate_3S = QObject::tr("[%1] %2: %3");
+const QString trPatternMessageTemplate_4S = QObject::tr("[%1] %2 (%3): %4");
+const QString trTruncatedTemplate_1S = QObject::tr("... (%1 bytes)");
+
+std::vector<std::string> SplitNames(const QString& text) {
+  std::vector<std::string> result;
+  const QStringList names = text.split(' ', QString::SkipEmptyParts);
+  for (const QString& name : names) {
+    result.push_back(common::ConvertToString(name));
+  }
+  return result;
+}
+}  // namespace
+
+namespace fastonosql {
+namespace gui {
+namespace redis {
+
+PubSubConsoleDialog::PubSubConsoleDialog(const QString& title,
+                                         const QIcon& icon,
+                                         proxy::IServerSPtr server,
+                                         const QString& channels,
+                                         QWidget* parent)
+    : base_class(title, parent),
+      channels_edit_(nullptr),
+      patterns_check_(nullptr),
+      subscribe_button_(nullptr),
+      stop_button_(nullptr),
+      status_label_(nullptr),
+      stats_table_(nullptr),
+      messages_view_(nullptr),
+      render_timer_(nullptr),
+      stats_timer_(nullptr),
+      server_(server),
+      subscriber_(),
+      receiving_(false),
+      batch_(),
+      received_(0),
+      last_stats_(),
+      last_stats_msec_(0) {
+  CHECK(server_);
+  setWindowIcon(icon);
+
+  channels_edit_ = new QLineEdit(channels);
+  patterns_check_ = new QCheckBox;
+  subscribe_button_ = new QPushButton;
+  VERIFY(connect(subscribe_button_, &QPushButton::clicked, this, &PubSubConsoleDialog::subscribeClicked));
+  stop_button_ = new QPushButton;
+  VERIFY(connect(stop_button_, &QPushButton::clicked, this, &PubSubConsoleDialog::stopClicked));
+
+  QHBoxLayout* channels_layout = new QHBoxLayout;
+  channels_layout->addWidget(new QLabel(trChannelsLabel));
+  channels_layout->addWidget(channels_edit_);
+  channels_layout->addWidget(patterns_check_);
+  channels_layout->addWidget(subscribe_button_);
+  channels_layout->addWidget(stop_button_);
+
+  stats_table_ = new QTreeWidget;
+  stats_table_->setRootIsDecorated(false);
+  messages_view_ = new QPlainTextEdit;
+  messages_view_->setReadOnly(true);
+  messages_view_->setMaximumBlockCount(max_shown_messages);
+
+  QSplitter* splitter = new QSplitter(Qt::Vertical);
+  splitter->addWidget(stats_table_);
+  splitter->addWidget(messages_view_);
+
+  status_label_ = new QLabel;
+
+  QDialogButtonBox* button_box = new QDialogButtonBox(QDialogButtonBox::Close);
+  button_box->setOrientation(Qt::Horizontal);
+  VERIFY(connect(button_box, &QDialogButtonBox::rejected, this, &PubSubConsoleDialog::reject));
+
+  QVBoxLayout* main_layout = new QVBoxLayout;
+  main_layout->addLayout(channels_layout);
+  main_layout->addWidget(splitter);
+  main_layout->addWidget(status_label_);
+  main_layout->addWidget(button_box);
+  setLayout(main_layout);
+  setMinimumSize(QSize(min_width, min_height));
+
+  render_timer_ = new QTimer(this);
+  render_timer_->setInterval(render_interval_msec);
+  VERIFY(connect(render_timer_, &QTimer::timeout, this, &PubSubConsoleDialog::renderMessages));
+  stats_timer_ = new QTimer(this);
+  stats_timer_->setInterval(stats_interval_msec);
+  VERIFY(connect(stats_timer_, &QTimer::timeout, this, &PubSubConsoleDialog::updateStats));
+
+  batch_.reserve(proxy::redis_compatible::Subscriber::default_buffer_capacity);
+  updateButtons();
+}
+
+void PubSubConsoleDialog::reject() {
+  if (subscriber_) {
+    common::Error err = subscriber_->Stop();
+    UNUSED(err);
+  }
+  base_class::reject();
+}
+
+void PubSubConsoleDialog::subscribeClicked() {
+  const std::vector<std::string> names = SplitNames(channels_edit_->text());
+  if (names.empty()) {
+    return;
+  }
+
+  const bool is_patterns = patterns_check_->isChecked();
+  if (!subscriber_) {
+    startReceive(is_patterns ? std::vector<std::string>() : names, is_patterns ? names : std::vector<std::string>());
+    return;
+  }
+
+  // subscriptions of running receiver are extended on the same connection
+  common::Error err = is_patterns ? subscriber_->PSubscribe(names) : subscriber_->Subscribe(names);
+  if (err) {
+    showError(err);
+  }
+}
+
+void PubSubConsoleDialog::stopClicked() {
+  if (!subscriber_) {
+    return;
+  }
+
+  common::Error err = subscriber_->Stop();
+  if (err) {
+    showError(err);
+  }
+  stop_button_->setEnabled(false);
+}
+
+void PubSubConsoleDialog::startReceive(const std::vector<std::string>& channels,
+                                       const std::vector<std::string>& patterns) {
+  proxy::redis::Server* server = dynamic_cast<proxy::redis::Server*>(server_.get());  // +
+  if (!server) {
+    DNOTREACHED();
+    return;
+  }
+
+  common::net::HostAndPort host;
+  core::SSHInfo ssh_info;
+  std::string password;
+  common::Error err = server->GetDirectConnectionInfo(&host, &ssh_info, &password);
+  if (err) {
+    showError(err);
+    return;
+  }
+
+  subscriber_ = std::make_shared<proxy::redis_compatible::Subscriber>(host, ssh_info, password);
+  received_ = 0;
+  last_stats_.clear();
+  last_stats_msec_ = common::time::current_utc_mstime();
+  status_label_->setText(trConnecting);
+
+  QThread* th = new QThread;
+  PubSubReceiver* receiver = new PubSubReceiver(subscriber_, channels, patterns);
+  receiver->moveToThread(th);
+  VERIFY(connect(th, &QThread::started, receiver, &PubSubReceiver::routine));
+  VERIFY(connect(receiver, &PubSubReceiver::receiveStarted, this, &PubSubConsoleDialog::receiveStarted));
+  VERIFY(connect(receiver, &PubSubReceiver::receiveFinished, this, &PubSubConsoleDialog::receiveFinished));
+  VERIFY(connect(receiver, &PubSubReceiver::receiveFinished, th, &QThread::quit));
+  VERIFY(connect(th, &QThread::finished, receiver, &PubSubReceiver::deleteLater));
+  VERIFY(connect(th, &QThread::finished, th, &QThread::deleteLater));
+  th->start();
+  updateButtons();
+}
+
+void PubSubConsoleDialog::receiveStarted() {
+  receiving_ = true;
+  render_timer_->start();
+  stats_timer_->start();
+  updateButtons();
+}
+
+void PubSubConsoleDialog::receiveFinished(common::Error err) {
+  if (receiving_) {
+    renderMessages();
+    updateStats();
+  }
+
+  render_timer_->stop();
+  stats_timer_->stop();
+  receiving_ = false;
+  subscriber_.reset();
+  if (err) {
+    showError(err);
+  }
+  updateButtons();
+}
+
+void PubSubConsoleDialog::renderMessages() {
+  batch_.clear();
+  const size_t count = subscriber_->PopMessages(proxy::redis_compatible::Subscriber::default_buffer_capacity, &batch_);
+  received_ += count;
+  status_label_->setText(trStatusTemplate_2S.arg(received_).arg(subscriber_->GetDroppedCount()));
+  if (!count) {
+    return;
+  }
+
+  // under heavy load only the newest part of batch is shown, totals are still counted
+  QStringList lines;
+  const size_t first = count > max_rendered_per_batch ? count - max_rendered_per_batch : 0;
+  for (size_t i = first; i < count; ++i) {
+    const proxy::redis_compatible::PubSubMessage& message = batch_[i];
+    const QString time = QDateTime::fromMSecsSinceEpoch(message.received_msec).toString("hh:mm:ss.zzz");
+    QString channel, payload;
+    common::ConvertFromString(message.channel, &channel);
+    common::ConvertFromString(message.payload, &payload);
+    if (message.payload_size > message.payload.size()) {
+      payload += trTruncatedTemplate_1S.arg(message.payload_size);
+    }
+
+    if (message.pattern.empty()) {
+      lines << trMessageTemplate_3S.arg(time, channel, payload);
+    } else {
+      QString pattern;
+      common::ConvertFromString(message.pattern, &pattern);
+      lines << trPatternMessageTemplate_4S.arg(time, channel, pattern, payload);
+    }
+  }
+  messages_view_->appendPlainText(lines.join('\n'));
+}
+
+void PubSubConsoleDialog::updateStats() {
+  const proxy::redis_compatible::pub_sub_stats_t stats = subscriber_->GetStats();
+  const common::time64_t now = common::time::current_utc_mstime();
+  const double elapsed = now > last_stats_msec_ ? static_cast<double>(now - last_stats_msec_) / 1000 : 1;
+
+  stats_table_->clear();
+  for (const auto& channel_stats : stats) {
+    const proxy::redis_compatible::PubSubChannelStats& current = channel_stats.second;
+    proxy::redis_compatible::PubSubChannelStats previous;
+    const auto it = last_stats_.find(channel_stats.first);
+    if (it != last_stats_.end()) {
+      previous = it->second;
+    }
+
+    QString channel;
+    common::ConvertFromString(channel_stats.first, &channel);
+    QStringList row;
+    row << channel << QString::number(current.messages)
+        << QString::number(static_cast<double>(current.messages - previous.messages) / elapsed, 'f', 1)
+        << QString::number(static_cast<double>(current.bytes - previous.bytes) / elapsed, 'f', 1)
+        << QString::number(current.bytes);
+    stats_table_->addTopLevelItem(new QTreeWidgetItem(row));
+  }
+
+  last_stats_ = stats;
+  last_stats_msec_ = now;
+}
+
+void PubSubConsoleDialog::updateButtons() {
+  subscribe_button_->setEnabled(!subscriber_ || receiving_);
+  stop_button_->setEnabled(receiving_);
+}
+
+void PubSubConsoleDialog::showError(common::Error err) {
+  QString qerror;
+  common::ConvertFromString(err->GetDescription(), &qerror);
+  status_label_->setText(trErrorTemplate_1S.arg(qerror));
+  LOG_ERROR(err, common::logging::LOG_LEVEL_ERR, true);
+}
+
+void PubSubConsoleDialog::retranslateUi() {
+  patterns_check_->setText(trPatterns);
+  subscribe_button_->setText(trSubscribe);
+  stop_button_->setText(translations::trStop);
+
+  QStringList columns;
+  columns << trChannel << trMessages << trMessagesPerSec << trBytesPerSec << trTotalBytes;
+  stats_table_->setHeaderLabels(columns);
+  base_class::retranslateUi();
+}
+
+}  // namespace redis
+}  // namespace gui
+}  // namespace fastonosql
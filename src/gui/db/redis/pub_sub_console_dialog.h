@@ -0,0 +1,105 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "gui/dialogs/base_dialog.h"
+
+#include "proxy/db/redis_compatible/subscriber.h"
+#include "proxy/proxy_fwd.h"
+
+class QCheckBox;
+class QLabel;
+class QLineEdit;
+class QPlainTextEdit;
+class QPushButton;
+class QTimer;
+class QTreeWidget;
+
+namespace fastonosql {
+namespace gui {
+namespace redis {
+
+// Subscriber view on its own connection, messages are captured by receive thread
+// into bounded ring buffer and rendered in batches by timer.
+class PubSubConsoleDialog : public BaseDialog {
+  Q_OBJECT
+
+ public:
+  typedef BaseDialog base_class;
+  template <typename T, typename... Args>
+  friend T* createDialog(Args&&... args);
+
+  enum {
+    min_width = 800,
+    min_height = 600,
+    render_interval_msec = 100,
+    stats_interval_msec = 1000,
+    max_rendered_per_batch = 200,
+    max_shown_messages = 5000
+  };
+
+ public Q_SLOTS:
+  void reject() override;
+
+ private Q_SLOTS:
+  void subscribeClicked();
+  void stopClicked();
+  void receiveStarted();
+  void receiveFinished(common::Error err);
+  void renderMessages();
+  void updateStats();
+
+ protected:
+  PubSubConsoleDialog(const QString& title,
+                      const QIcon& icon,
+                      proxy::IServerSPtr server,
+                      const QString& channels,
+                      QWidget* parent = Q_NULLPTR);
+
+  void retranslateUi() override;
+
+ private:
+  void startReceive(const std::vector<std::string>& channels, const std::vector<std::string>& patterns);
+  void updateButtons();
+  void showError(common::Error err);
+
+  QLineEdit* channels_edit_;
+  QCheckBox* patterns_check_;
+  QPushButton* subscribe_button_;
+  QPushButton* stop_button_;
+  QLabel* status_label_;
+  QTreeWidget* stats_table_;
+  QPlainTextEdit* messages_view_;
+  QTimer* render_timer_;
+  QTimer* stats_timer_;
+
+  const proxy::IServerSPtr server_;
+  proxy::redis_compatible::SubscriberSPtr subscriber_;
+  bool receiving_;
+  std::vector<proxy::redis_compatible::PubSubMessage> batch_;
+  uint64_t received_;
+  proxy::redis_compatible::pub_sub_stats_t last_stats_;
+  common::time64_t last_stats_msec_;
+};
+
+}  // namespace redis
+}  // namespace gui
+}  // namespace fastonosql
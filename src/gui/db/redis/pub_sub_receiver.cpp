@@ -0,0 +1,65 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "gui/db/redis/pub_sub_receiver.h"
+
+namespace fastonosql {
+namespace gui {
+namespace redis {
+
+PubSubReceiver::PubSubReceiver(proxy::redis_compatible::SubscriberSPtr subscriber,
+                               const std::vector<std::string>& channels,
+                               const std::vector<std::string>& patterns,
+                               QObject* parent)
+    : QObject(parent), subscriber_(subscriber), channels_(channels), patterns_(patterns) {
+  qRegisterMetaType<common::Error>("common::Error");
+}
+
+void PubSubReceiver::routine() {
+  common::Error err = subscribe();
+  if (subscriber_->IsStopped()) {
+    emit receiveFinished(common::Error());  // dialog closed while connecting, unsubscribe may have missed socket
+    return;
+  }
+
+  if (err) {
+    emit receiveFinished(err);
+    return;
+  }
+
+  emit receiveStarted();
+  err = subscriber_->Run();
+  emit receiveFinished(err);
+}
+
+common::Error PubSubReceiver::subscribe() {
+  common::Error err = subscriber_->Connect();
+  if (err) {
+    return err;
+  }
+
+  err = subscriber_->Subscribe(channels_);
+  if (err) {
+    return err;
+  }
+
+  return subscriber_->PSubscribe(patterns_);
+}
+
+}  // namespace redis
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,57 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <QObject>
+
+#include "proxy/db/redis_compatible/subscriber.h"
+
+namespace fastonosql {
+namespace gui {
+namespace redis {
+
+class PubSubReceiver : public QObject {
+  Q_OBJECT
+
+ public:
+  PubSubReceiver(proxy::redis_compatible::SubscriberSPtr subscriber,
+                 const std::vector<std::string>& channels,
+                 const std::vector<std::string>& patterns,
+                 QObject* parent = Q_NULLPTR);
+
+ Q_SIGNALS:
+  void receiveStarted();
+  void receiveFinished(common::Error err);
+
+ public Q_SLOTS:
+  void routine();
+
+ private:
+  common::Error subscribe();
+
+  const proxy::redis_compatible::SubscriberSPtr subscriber_;
+  const std::vector<std::string> channels_;
+  const std::vector<std::string> patterns_;
+};
+
+}  // namespace redis
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,50 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "gui/db/redis/rdb_analyzer.h"
+
+namespace fastonosql {
+namespace gui {
+namespace redis {
+
+RdbAnalyzer::RdbAnalyzer(const std::string& path,
+                         const std::string& ns_separator,
+                         size_t largest_keys_count,
+                         QObject* parent)
+    : QObject(parent), path_(path), ns_separator_(ns_separator), largest_keys_count_(largest_keys_count), stop_(0) {
+  qRegisterMetaType<common::Error>("common::Error");
+  qRegisterMetaType<proxy::redis_compatible::RdbReport>("proxy::redis_compatible::RdbReport");
+}
+
+void RdbAnalyzer::stop() {
+  stop_.storeRelease(1);
+}
+
+void RdbAnalyzer::routine() {
+  const auto progress = [this](int percent) {
+    emit progressChanged(percent);
+    return stop_.loadAcquire() == 0;
+  };
+  proxy::redis_compatible::RdbReport report;
+  common::Error err =
+      proxy::redis_compatible::AnalyzeRdbFile(path_, ns_separator_, largest_keys_count_, progress, &report);
+  emit analyzeFinished(err, report);
+}
+
+}  // namespace redis
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,58 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <string>
+
+#include <QAtomicInt>
+#include <QObject>
+
+#include "proxy/db/redis_compatible/rdb_analyzer.h"
+
+namespace fastonosql {
+namespace gui {
+namespace redis {
+
+class RdbAnalyzer : public QObject {
+  Q_OBJECT
+
+ public:
+  RdbAnalyzer(const std::string& path,
+              const std::string& ns_separator,
+              size_t largest_keys_count,
+              QObject* parent = Q_NULLPTR);
+
+  void stop();
+
+ Q_SIGNALS:
+  void progressChanged(int percent);
+  void analyzeFinished(common::Error err, proxy::redis_compatible::RdbReport report);
+
+ public Q_SLOTS:
+  void routine();
+
+ private:
+  const std::string path_;
+  const std::string ns_separator_;
+  const size_t largest_keys_count_;
+  QAtomicInt stop_;
+};
+
+}  // namespace redis
+}  // namespace gui
+}  // namespace fastonosql
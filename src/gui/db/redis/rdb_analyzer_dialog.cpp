@@ -0,0 +1,228 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "gui/db/redis/rdb_analyzer_dialog.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <QDialogButtonBox>
+#include <QLabel>
+#include <QProgressBar>
+#include <QTabWidget>
+#include <QThread>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include <common/macros.h>
+#include <common/qt/convert2string.h>
+
+#include "gui/db/redis/rdb_analyzer.h"
+
+#include "translations/global.h"
+
+namespace {
+const QString trNamespaces = QObject::tr("Namespaces");
+const QString trTypes = QObject::tr("Types");
+const QString trTTL = QObject::tr("TTL");
+const QString trLargestKeys = QObject::tr("Largest keys");
+const QString trKeys = QObject::tr("Keys");
+const QString trSize = QObject::tr("Size, bytes");
+const QString trShare = QObject::tr("Share, %");
+const QString trNoNamespace = QObject::tr("(no namespace)");
+const QString trNoExpire = QObject::tr("no expire");
+const QString trAnalyzing = QObject::tr("Analyzing...");
+const QString trReportTemplate_4S = QObject::tr("RDB version %1, file size %2 bytes, %3 keys, %4 bytes in keys");
+const QString trAnalyzeFailedTemplate_1S = QObject::tr("Analyze failed: %1");
+}  // namespace
+
+namespace fastonosql {
+namespace gui {
+namespace redis {
+
+RdbAnalyzerDialog::RdbAnalyzerDialog(const QString& title,
+                                     const QIcon& icon,
+                                     const std::string& path,
+                                     const std::string& ns_separator,
+                                     QWidget* parent)
+    : base_class(title, parent),
+      status_label_(nullptr),
+      progress_bar_(nullptr),
+      tabs_(nullptr),
+      namespaces_table_(nullptr),
+      types_table_(nullptr),
+      ttls_table_(nullptr),
+      largest_keys_table_(nullptr),
+      analyzer_() {
+  setWindowIcon(icon);
+
+  status_label_ = new QLabel(trAnalyzing);
+  progress_bar_ = new QProgressBar;
+  progress_bar_->setRange(0, 100);
+
+  namespaces_table_ = createTable();
+  types_table_ = createTable();
+  ttls_table_ = createTable();
+  largest_keys_table_ = new QTreeWidget;
+  largest_keys_table_->setRootIsDecorated(false);
+
+  tabs_ = new QTabWidget;
+  tabs_->addTab(namespaces_table_, trNamespaces);
+  tabs_->addTab(types_table_, trTypes);
+  tabs_->addTab(ttls_table_, trTTL);
+  tabs_->addTab(largest_keys_table_, trLargestKeys);
+
+  QDialogButtonBox* button_box = new QDialogButtonBox(QDialogButtonBox::Close);
+  button_box->setOrientation(Qt::Horizontal);
+  VERIFY(connect(button_box, &QDialogButtonBox::rejected, this, &RdbAnalyzerDialog::reject));
+
+  QVBoxLayout* main_layout = new QVBoxLayout;
+  main_layout->addWidget(status_label_);
+  main_layout->addWidget(progress_bar_);
+  main_layout->addWidget(tabs_);
+  main_layout->addWidget(button_box);
+  setLayout(main_layout);
+  setMinimumSize(QSize(min_width, min_height));
+
+  startAnalyze(path, ns_separator);
+}
+
+void RdbAnalyzerDialog::reject() {
+  if (analyzer_) {
+    analyzer_->stop();
+  }
+  base_class::reject();
+}
+
+void RdbAnalyzerDialog::startAnalyze(const std::string& path, const std::string& ns_separator) {
+  QThread* th = new QThread;
+  RdbAnalyzer* analyzer = new RdbAnalyzer(path, ns_separator, largest_keys_count);
+  analyzer->moveToThread(th);
+  VERIFY(connect(th, &QThread::started, analyzer, &RdbAnalyzer::routine));
+  VERIFY(connect(analyzer, &RdbAnalyzer::progressChanged, this, &RdbAnalyzerDialog::analyzeProgressed));
+  VERIFY(connect(analyzer, &RdbAnalyzer::analyzeFinished, this, &RdbAnalyzerDialog::analyzeFinished));
+  VERIFY(connect(analyzer, &RdbAnalyzer::analyzeFinished, th, &QThread::quit));
+  VERIFY(connect(th, &QThread::finished, analyzer, &RdbAnalyzer::deleteLater));
+  VERIFY(connect(th, &QThread::finished, th, &QThread::deleteLater));
+  analyzer_ = analyzer;
+  th->start();
+}
+
+void RdbAnalyzerDialog::analyzeProgressed(int percent) {
+  progress_bar_->setValue(percent);
+}
+
+void RdbAnalyzerDialog::analyzeFinished(common::Error err, proxy::redis_compatible::RdbReport report) {
+  progress_bar_->setValue(100);
+  if (err) {
+    QString qerror;
+    common::ConvertFromString(err->GetDescription(), &qerror);
+    status_label_->setText(trAnalyzeFailedTemplate_1S.arg(qerror));
+    return;
+  }
+
+  status_label_->setText(trReportTemplate_4S.arg(report.version)
+                             .arg(report.file_size)
+                             .arg(report.total.keys)
+                             .arg(report.total.bytes));
+
+  std::map<std::string, proxy::redis_compatible::RdbKeysStats> namespaces = report.namespaces;
+  const auto no_ns = namespaces.find(std::string());
+  if (no_ns != namespaces.end()) {
+    namespaces[common::ConvertToString(trNoNamespace)] = no_ns->second;
+    namespaces.erase(no_ns);
+  }
+  fillStats(namespaces_table_, namespaces);
+  fillStats(types_table_, report.types);
+
+  ttls_table_->clear();
+  for (size_t i = 0; i < report.ttls.size(); ++i) {
+    const auto& stats = report.ttls[i];
+    QStringList row;
+    row << proxy::redis_compatible::GetRdbTTLBucketName(static_cast<proxy::redis_compatible::RdbTTLBucket>(i))
+        << QString::number(stats.keys) << QString::number(stats.bytes);
+    ttls_table_->addTopLevelItem(new QTreeWidgetItem(row));
+  }
+
+  largest_keys_table_->clear();
+  for (const auto& key : report.largest_keys) {
+    QString qkey;
+    common::ConvertFromString(key.key, &qkey);
+    QStringList row;
+    row << qkey << QString::fromStdString(key.type) << QString::number(key.bytes)
+        << (key.ttl < 0 ? trNoExpire : QString::number(key.ttl));
+    largest_keys_table_->addTopLevelItem(new QTreeWidgetItem(row));
+  }
+}
+
+QTreeWidget* RdbAnalyzerDialog::createTable() {
+  QTreeWidget* table = new QTreeWidget;
+  table->setRootIsDecorated(false);
+  return table;
+}
+
+void RdbAnalyzerDialog::fillStats(QTreeWidget* table,
+                                  const std::map<std::string, proxy::redis_compatible::RdbKeysStats>& stats) {
+  std::vector<std::pair<std::string, proxy::redis_compatible::RdbKeysStats>> sorted(stats.begin(), stats.end());
+  std::sort(sorted.begin(), sorted.end(),
+            [](const std::pair<std::string, proxy::redis_compatible::RdbKeysStats>& lhs,
+               const std::pair<std::string, proxy::redis_compatible::RdbKeysStats>& rhs) {
+              return lhs.second.bytes > rhs.second.bytes;
+            });
+
+  uint64_t total = 0;
+  for (const auto& item : sorted) {
+    total += item.second.bytes;
+  }
+
+  table->clear();
+  for (const auto& item : sorted) {
+    QString qname;
+    common::ConvertFromString(item.first, &qname);
+    const double share = total ? static_cast<double>(item.second.bytes) * 100 / static_cast<double>(total) : 0;
+    QStringList row;
+    row << qname << QString::number(item.second.keys) << QString::number(item.second.bytes)
+        << QString::number(share, 'f', 2);
+    table->addTopLevelItem(new QTreeWidgetItem(row));
+  }
+}
+
+void RdbAnalyzerDialog::retranslateUi() {
+  QStringList stats_columns;
+  stats_columns << translations::trName << trKeys << trSize << trShare;
+  namespaces_table_->setHeaderLabels(stats_columns);
+  types_table_->setHeaderLabels(stats_columns);
+
+  QStringList ttl_columns;
+  ttl_columns << trTTL << trKeys << trSize;
+  ttls_table_->setHeaderLabels(ttl_columns);
+
+  QStringList key_columns;
+  key_columns << translations::trKey << translations::trType << trSize << trTTL;
+  largest_keys_table_->setHeaderLabels(key_columns);
+
+  tabs_->setTabText(0, trNamespaces);
+  tabs_->setTabText(1, trTypes);
+  tabs_->setTabText(2, trTTL);
+  tabs_->setTabText(3, trLargestKeys);
+  base_class::retranslateUi();
+}
+
+}  // namespace redis
+}  // namespace gui
+}  // namespace fastonosql
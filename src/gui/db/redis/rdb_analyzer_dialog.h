@@ -0,0 +1,85 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <map>
+#include <string>
+
+#include <QPointer>
+
+#include <common/error.h>
+
+#include "gui/dialogs/base_dialog.h"
+#include "proxy/db/redis_compatible/rdb_analyzer.h"
+
+class QLabel;
+class QProgressBar;
+class QTabWidget;
+class QTreeWidget;
+
+namespace fastonosql {
+namespace gui {
+namespace redis {
+
+class RdbAnalyzer;
+
+class RdbAnalyzerDialog : public BaseDialog {
+  Q_OBJECT
+
+ public:
+  typedef BaseDialog base_class;
+  template <typename T, typename... Args>
+  friend T* createDialog(Args&&... args);
+
+  enum { min_width = 640, min_height = 480, largest_keys_count = 100 };
+
+ public Q_SLOTS:
+  void reject() override;
+
+ private Q_SLOTS:
+  void analyzeProgressed(int percent);
+  void analyzeFinished(common::Error err, proxy::redis_compatible::RdbReport report);
+
+ protected:
+  RdbAnalyzerDialog(const QString& title,
+                    const QIcon& icon,
+                    const std::string& path,
+                    const std::string& ns_separator,
+                    QWidget* parent = Q_NULLPTR);
+
+  void retranslateUi() override;
+
+ private:
+  static QTreeWidget* createTable();
+  static void fillStats(QTreeWidget* table, const std::map<std::string, proxy::redis_compatible::RdbKeysStats>& stats);
+
+  void startAnalyze(const std::string& path, const std::string& ns_separator);
+
+  QLabel* status_label_;
+  QProgressBar* progress_bar_;
+  QTabWidget* tabs_;
+  QTreeWidget* namespaces_table_;
+  QTreeWidget* types_table_;
+  QTreeWidget* ttls_table_;
+  QTreeWidget* largest_keys_table_;
+  QPointer<RdbAnalyzer> analyzer_;
+};
+
+}  // namespace redis
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,274 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "gui/db/redis/workload_analyzer_dialog.h"
+
+#include <string>
+
+#include <QDialogButtonBox>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTabWidget>
+#include <QThread>
+#include <QTimer>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include <common/qt/convert2string.h>
+#include <common/qt/logger.h>
+
+#include "proxy/db/redis/server.h"
+
+#include "gui/db/redis/workload_monitor.h"
+
+#include "translations/global.h"
+
+namespace {
+const QString trDuration = QObject::tr("Duration, sec:");
+const QString trMaxSamples = QObject::tr("Max samples:");
+const QString trTopSize = QObject::tr("Top size:");
+const QString trWindow = QObject::tr("Window, sec:");
+const QString trStart = QObject::tr("Start");
+const QString trCommands = QObject::tr("Commands");
+const QString trKeys = QObject::tr("Keys");
+const QString trClients = QObject::tr("Clients");
+const QString trCount = QObject::tr("Count");
+const QString trRate = QObject::tr("Per second");
+const QString trConnecting = QObject::tr("Connecting...");
+const QString trStatusTemplate_3S = QObject::tr("Samples: %1, unparsed lines: %2, elapsed: %3 sec");
+const QString trMonitorErrorTemplate_1S = QObject::tr("Monitor error: %1");
+
+const int kMaxDurationSec = 3600;
+const int kMaxSamples = 100000000;
+}  // namespace
+
+namespace fastonosql {
+namespace gui {
+namespace redis {
+
+WorkloadAnalyzerDialog::WorkloadAnalyzerDialog(const QString& title,
+                                               const QIcon& icon,
+                                               proxy::IServerSPtr server,
+                                               QWidget* parent)
+    : base_class(title, parent),
+      duration_spin_(nullptr),
+      samples_spin_(nullptr),
+      top_spin_(nullptr),
+      window_spin_(nullptr),
+      start_button_(nullptr),
+      stop_button_(nullptr),
+      status_label_(nullptr),
+      tabs_(nullptr),
+      commands_table_(nullptr),
+      keys_table_(nullptr),
+      clients_table_(nullptr),
+      duration_timer_(nullptr),
+      server_(server),
+      monitor_() {
+  CHECK(server_);
+  setWindowIcon(icon);
+
+  const proxy::redis_compatible::MonitorOptions defaults;
+  duration_spin_ = new QSpinBox;
+  duration_spin_->setRange(1, kMaxDurationSec);
+  duration_spin_->setValue(defaults.duration_sec);
+  samples_spin_ = new QSpinBox;
+  samples_spin_->setRange(1000, kMaxSamples);
+  samples_spin_->setValue(static_cast<int>(defaults.max_samples));
+  top_spin_ = new QSpinBox;
+  top_spin_->setRange(1, 1000);
+  top_spin_->setValue(static_cast<int>(defaults.top_k));
+  window_spin_ = new QSpinBox;
+  window_spin_->setRange(proxy::redis_compatible::MonitorAnalyzer::window_buckets, kMaxDurationSec);
+  window_spin_->setValue(defaults.window_sec);
+
+  QFormLayout* options_layout = new QFormLayout;
+  options_layout->addRow(trDuration, duration_spin_);
+  options_layout->addRow(trMaxSamples, samples_spin_);
+  options_layout->addRow(trTopSize, top_spin_);
+  options_layout->addRow(trWindow, window_spin_);
+
+  start_button_ = new QPushButton;
+  VERIFY(connect(start_button_, &QPushButton::clicked, this, &WorkloadAnalyzerDialog::startClicked));
+  stop_button_ = new QPushButton;
+  VERIFY(connect(stop_button_, &QPushButton::clicked, this, &WorkloadAnalyzerDialog::stopClicked));
+  QHBoxLayout* buttons_layout = new QHBoxLayout;
+  buttons_layout->addWidget(start_button_);
+  buttons_layout->addWidget(stop_button_);
+  buttons_layout->addStretch(1);
+
+  commands_table_ = createTable();
+  keys_table_ = createTable();
+  clients_table_ = createTable();
+  tabs_ = new QTabWidget;
+  tabs_->addTab(commands_table_, trCommands);
+  tabs_->addTab(keys_table_, trKeys);
+  tabs_->addTab(clients_table_, trClients);
+
+  status_label_ = new QLabel;
+
+  QDialogButtonBox* button_box = new QDialogButtonBox(QDialogButtonBox::Close);
+  button_box->setOrientation(Qt::Horizontal);
+  VERIFY(connect(button_box, &QDialogButtonBox::rejected, this, &WorkloadAnalyzerDialog::reject));
+
+  QVBoxLayout* main_layout = new QVBoxLayout;
+  main_layout->addLayout(options_layout);
+  main_layout->addLayout(buttons_layout);
+  main_layout->addWidget(tabs_);
+  main_layout->addWidget(status_label_);
+  main_layout->addWidget(button_box);
+  setLayout(main_layout);
+  setMinimumSize(QSize(min_width, min_height));
+
+  // MONITOR on idle server sends nothing, so duration limit is also enforced from here
+  duration_timer_ = new QTimer(this);
+  duration_timer_->setSingleShot(true);
+  VERIFY(connect(duration_timer_, &QTimer::timeout, this, &WorkloadAnalyzerDialog::stopClicked));
+
+  setRunning(false);
+}
+
+void WorkloadAnalyzerDialog::reject() {
+  if (monitor_) {
+    monitor_->stop();
+  }
+  base_class::reject();
+}
+
+void WorkloadAnalyzerDialog::startClicked() {
+  proxy::redis::Server* server = dynamic_cast<proxy::redis::Server*>(server_.get());  // +
+  if (!server) {
+    DNOTREACHED();
+    return;
+  }
+
+  common::net::HostAndPort host;
+  core::SSHInfo ssh_info;
+  std::string password;
+  common::Error err = server->GetDirectConnectionInfo(&host, &ssh_info, &password);
+  if (err) {
+    QString qerror;
+    common::ConvertFromString(err->GetDescription(), &qerror);
+    status_label_->setText(trMonitorErrorTemplate_1S.arg(qerror));
+    return;
+  }
+
+  proxy::redis_compatible::MonitorOptions options;
+  options.duration_sec = duration_spin_->value();
+  options.max_samples = samples_spin_->value();
+  options.top_k = top_spin_->value();
+  options.window_sec = window_spin_->value();
+
+  QThread* th = new QThread;
+  WorkloadMonitor* monitor = new WorkloadMonitor(host, ssh_info, password, options);
+  monitor->moveToThread(th);
+  VERIFY(connect(th, &QThread::started, monitor, &WorkloadMonitor::routine));
+  VERIFY(connect(monitor, &WorkloadMonitor::reportUpdated, this, &WorkloadAnalyzerDialog::reportUpdated));
+  VERIFY(connect(monitor, &WorkloadMonitor::monitorFinished, this, &WorkloadAnalyzerDialog::monitorFinished));
+  VERIFY(connect(monitor, &WorkloadMonitor::monitorFinished, th, &QThread::quit));
+  VERIFY(connect(th, &QThread::finished, monitor, &WorkloadMonitor::deleteLater));
+  VERIFY(connect(th, &QThread::finished, th, &QThread::deleteLater));
+  monitor_ = monitor;
+  status_label_->setText(trConnecting);
+  setRunning(true);
+  duration_timer_->start(options.duration_sec * 1000);
+  th->start();
+}
+
+void WorkloadAnalyzerDialog::stopClicked() {
+  if (monitor_) {
+    monitor_->stop();
+  }
+  stop_button_->setEnabled(false);
+}
+
+void WorkloadAnalyzerDialog::reportUpdated(proxy::redis_compatible::MonitorReport report) {
+  showReport(report);
+}
+
+void WorkloadAnalyzerDialog::monitorFinished(common::Error err, proxy::redis_compatible::MonitorReport report) {
+  duration_timer_->stop();
+  monitor_ = nullptr;
+  setRunning(false);
+  if (err) {
+    QString qerror;
+    common::ConvertFromString(err->GetDescription(), &qerror);
+    status_label_->setText(trMonitorErrorTemplate_1S.arg(qerror));
+    LOG_ERROR(err, common::logging::LOG_LEVEL_ERR, true);
+    return;
+  }
+
+  showReport(report);
+}
+
+void WorkloadAnalyzerDialog::showReport(const proxy::redis_compatible::MonitorReport& report) {
+  fillTable(commands_table_, report.commands);
+  fillTable(keys_table_, report.keys);
+  fillTable(clients_table_, report.clients);
+  status_label_->setText(
+      trStatusTemplate_3S.arg(report.samples).arg(report.parse_errors).arg(report.elapsed_msec / 1000));
+}
+
+void WorkloadAnalyzerDialog::setRunning(bool running) {
+  duration_spin_->setEnabled(!running);
+  samples_spin_->setEnabled(!running);
+  top_spin_->setEnabled(!running);
+  window_spin_->setEnabled(!running);
+  start_button_->setEnabled(!running);
+  stop_button_->setEnabled(running);
+}
+
+QTreeWidget* WorkloadAnalyzerDialog::createTable() {
+  QTreeWidget* table = new QTreeWidget;
+  table->setRootIsDecorated(false);
+  return table;
+}
+
+void WorkloadAnalyzerDialog::fillTable(QTreeWidget* table,
+                                       const std::vector<proxy::redis_compatible::MonitorHit>& hits) {
+  table->clear();
+  for (const auto& hit : hits) {
+    QString qname;
+    common::ConvertFromString(hit.name, &qname);
+    QStringList row;
+    row << qname << QString::number(hit.count) << QString::number(hit.rate, 'f', 1);
+    table->addTopLevelItem(new QTreeWidgetItem(row));
+  }
+}
+
+void WorkloadAnalyzerDialog::retranslateUi() {
+  start_button_->setText(trStart);
+  stop_button_->setText(translations::trStop);
+
+  QStringList columns;
+  columns << translations::trName << trCount << trRate;
+  commands_table_->setHeaderLabels(columns);
+  keys_table_->setHeaderLabels(columns);
+  clients_table_->setHeaderLabels(columns);
+
+  tabs_->setTabText(0, trCommands);
+  tabs_->setTabText(1, trKeys);
+  tabs_->setTabText(2, trClients);
+  base_class::retranslateUi();
+}
+
+}  // namespace redis
+}  // namespace gui
+}  // namespace fastonosql
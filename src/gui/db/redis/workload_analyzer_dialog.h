@@ -0,0 +1,96 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <vector>
+
+#include <QPointer>
+
+#include "gui/dialogs/base_dialog.h"
+
+#include "proxy/db/redis_compatible/monitor_analyzer.h"
+#include "proxy/proxy_fwd.h"
+
+class QLabel;
+class QPushButton;
+class QSpinBox;
+class QTabWidget;
+class QTimer;
+class QTreeWidget;
+
+namespace fastonosql {
+namespace gui {
+namespace redis {
+
+class WorkloadMonitor;
+
+// Hot commands, keys and clients from MONITOR stream of dedicated connection.
+// MONITOR slows server down, so session is always bounded by duration and samples count.
+class WorkloadAnalyzerDialog : public BaseDialog {
+  Q_OBJECT
+
+ public:
+  typedef BaseDialog base_class;
+  template <typename T, typename... Args>
+  friend T* createDialog(Args&&... args);
+
+  enum { min_width = 640, min_height = 480 };
+
+ public Q_SLOTS:
+  void reject() override;
+
+ private Q_SLOTS:
+  void startClicked();
+  void stopClicked();
+  void reportUpdated(proxy::redis_compatible::MonitorReport report);
+  void monitorFinished(common::Error err, proxy::redis_compatible::MonitorReport report);
+
+ protected:
+  WorkloadAnalyzerDialog(const QString& title,
+                         const QIcon& icon,
+                         proxy::IServerSPtr server,
+                         QWidget* parent = Q_NULLPTR);
+
+  void retranslateUi() override;
+
+ private:
+  static QTreeWidget* createTable();
+  static void fillTable(QTreeWidget* table, const std::vector<proxy::redis_compatible::MonitorHit>& hits);
+  void showReport(const proxy::redis_compatible::MonitorReport& report);
+  void setRunning(bool running);
+
+  QSpinBox* duration_spin_;
+  QSpinBox* samples_spin_;
+  QSpinBox* top_spin_;
+  QSpinBox* window_spin_;
+  QPushButton* start_button_;
+  QPushButton* stop_button_;
+  QLabel* status_label_;
+  QTabWidget* tabs_;
+  QTreeWidget* commands_table_;
+  QTreeWidget* keys_table_;
+  QTreeWidget* clients_table_;
+  QTimer* duration_timer_;
+
+  const proxy::IServerSPtr server_;
+  QPointer<WorkloadMonitor> monitor_;
+};
+
+}  // namespace redis
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,56 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "gui/db/redis/workload_monitor.h"
+
+namespace fastonosql {
+namespace gui {
+namespace redis {
+
+WorkloadMonitor::WorkloadMonitor(const common::net::HostAndPort& host,
+                                 const core::SSHInfo& ssh_info,
+                                 const std::string& password,
+                                 const proxy::redis_compatible::MonitorOptions& options,
+                                 QObject* parent)
+    : QObject(parent), analyzer_(host, ssh_info, password, options) {
+  qRegisterMetaType<common::Error>("common::Error");
+  qRegisterMetaType<proxy::redis_compatible::MonitorReport>("proxy::redis_compatible::MonitorReport");
+}
+
+void WorkloadMonitor::stop() {
+  analyzer_.Stop();
+}
+
+void WorkloadMonitor::routine() {
+  proxy::redis_compatible::MonitorReport report;
+  common::Error err = analyzer_.Connect();
+  if (err) {
+    emit monitorFinished(err, report);
+    return;
+  }
+
+  const auto callback = [this](const proxy::redis_compatible::MonitorReport& current) {
+    emit reportUpdated(current);
+    return true;
+  };
+  err = analyzer_.Run(callback, &report);
+  emit monitorFinished(err, report);
+}
+
+}  // namespace redis
+}  // namespace gui
+}  // namespace fastonosql
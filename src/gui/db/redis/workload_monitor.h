@@ -0,0 +1,55 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <string>
+
+#include <QObject>
+
+#include "proxy/db/redis_compatible/monitor_analyzer.h"
+
+namespace fastonosql {
+namespace gui {
+namespace redis {
+
+class WorkloadMonitor : public QObject {
+  Q_OBJECT
+
+ public:
+  WorkloadMonitor(const common::net::HostAndPort& host,
+                  const core::SSHInfo& ssh_info,
+                  const std::string& password,
+                  const proxy::redis_compatible::MonitorOptions& options,
+                  QObject* parent = Q_NULLPTR);
+
+  void stop();  // thread safe
+
+ Q_SIGNALS:
+  void reportUpdated(proxy::redis_compatible::MonitorReport report);
+  void monitorFinished(common::Error err, proxy::redis_compatible::MonitorReport report);
+
+ public Q_SLOTS:
+  void routine();
+
+ private:
+  proxy::redis_compatible::MonitorAnalyzer analyzer_;
+};
+
+}  // namespace redis
+}  // namespace gui
+}  // namespace fastonosql
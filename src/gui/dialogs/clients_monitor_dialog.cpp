@@ -19,13 +19,16 @@
 #include "gui/dialogs/clients_monitor_dialog.h"
 
 #include <QAction>
+#include <QCheckBox>
 #include <QDialogButtonBox>
 #include <QHBoxLayout>
 #include <QLineEdit>
 #include <QMenu>
 #include <QPushButton>
 #include <QSortFilterProxyModel>
+#include <QSpinBox>
 #include <QSplitter>
+#include <QTimer>
 
 #include <common/convert2string.h>
 #include <common/string_util.h>
@@ -43,6 +46,11 @@
 #define CLIENT_KILL_COMMAND CLIENT_COMMAND SPACE_STR KILL_ARG
 #define ID_ARG "ID"
 
+namespace {
+const QString trAutoRefresh = QObject::tr("Auto refresh every");
+const QString trSecondsSuffix = QObject::tr(" sec");
+}  // namespace
+
 namespace fastonosql {
 namespace gui {
 
@@ -51,6 +59,10 @@ ClientsMonitorDialog::ClientsMonitorDialog(const QString& title,
                                            proxy::IServerSPtr server,
                                            QWidget* parent)
     : base_class(title, parent),
+      auto_refresh_check_(nullptr),
+      refresh_interval_spin_(nullptr),
+      refresh_timer_(nullptr),
+      loading_(false),
       update_button_(nullptr),
       clients_table_(nullptr),
       clients_model_(nullptr),
@@ -71,10 +83,22 @@ ClientsMonitorDialog::ClientsMonitorDialog(const QString& title,
   proxy_model_->setSourceModel(clients_model_);
   proxy_model_->setDynamicSortFilter(true);
 
+  refresh_timer_ = new QTimer(this);
+  VERIFY(connect(refresh_timer_, &QTimer::timeout, this, &ClientsMonitorDialog::refreshTimeout));
+
   QHBoxLayout* search_layout = new QHBoxLayout;
+  auto_refresh_check_ = new QCheckBox;
+  VERIFY(connect(auto_refresh_check_, &QCheckBox::stateChanged, this, &ClientsMonitorDialog::autoRefreshChange));
+  refresh_interval_spin_ = new QSpinBox;
+  refresh_interval_spin_->setRange(min_refresh_interval_sec, max_refresh_interval_sec);
+  refresh_interval_spin_->setValue(default_refresh_interval_sec);
+  VERIFY(connect(refresh_interval_spin_, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this,
+                 &ClientsMonitorDialog::refreshIntervalChange));
   update_button_ = new QPushButton;
   VERIFY(connect(update_button_, &QPushButton::clicked, this, &ClientsMonitorDialog::updateClicked));
   search_layout->addWidget(new QSplitter(Qt::Horizontal));
+  search_layout->addWidget(auto_refresh_check_);
+  search_layout->addWidget(refresh_interval_spin_);
   search_layout->addWidget(update_button_);
 
   clients_table_ = new FastoTableView;
@@ -112,18 +136,18 @@ ClientsMonitorDialog::ClientsMonitorDialog(const QString& title,
 void ClientsMonitorDialog::startLoadServerClients(const proxy::events_info::LoadServerClientsRequest& req) {
   UNUSED(req);
 
-  clients_model_->clear();
+  loading_ = true;
 }
 
 void ClientsMonitorDialog::finishLoadServerClients(const proxy::events_info::LoadServerClientsResponse& res) {
+  loading_ = false;
   common::Error err = res.errorInfo();
   if (err) {
     return;
   }
 
-  for (auto client : res.clients) {
-    clients_model_->insertItem(new ClientTableItem(client));
-  }
+  // rows are diffed in place, so selection and scroll position survive refresh
+  clients_model_->updateClients(res.clients);
 }
 
 void ClientsMonitorDialog::startExecuteCommand(const proxy::events_info::ExecuteInfoRequest& req) {
@@ -208,6 +232,29 @@ void ClientsMonitorDialog::updateClicked() {
   server_->LoadClients(req);
 }
 
+void ClientsMonitorDialog::autoRefreshChange(int state) {
+  if (state != Qt::Checked) {
+    refresh_timer_->stop();
+    return;
+  }
+
+  refresh_timer_->start(refresh_interval_spin_->value() * 1000);
+}
+
+void ClientsMonitorDialog::refreshIntervalChange(int value) {
+  if (refresh_timer_->isActive()) {
+    refresh_timer_->start(value * 1000);
+  }
+}
+
+void ClientsMonitorDialog::refreshTimeout() {
+  if (loading_ || !server_->IsConnected()) {
+    return;
+  }
+
+  updateClicked();
+}
+
 void ClientsMonitorDialog::killClient() {
   QModelIndex sel = selectedIndex();
   if (!sel.isValid()) {
@@ -229,6 +276,8 @@ void ClientsMonitorDialog::killClient() {
 }
 
 void ClientsMonitorDialog::retranslateUi() {
+  auto_refresh_check_->setText(trAutoRefresh);
+  refresh_interval_spin_->setSuffix(trSecondsSuffix);
   update_button_->setText(translations::trRefresh);
 }
 
@@ -22,9 +22,12 @@
 
 #include "proxy/proxy_fwd.h"
 
+class QCheckBox;
 class QLabel;
 class QLineEdit;
 class QSortFilterProxyModel;
+class QSpinBox;
+class QTimer;
 
 namespace fastonosql {
 namespace proxy {
@@ -46,7 +49,13 @@ class ClientsMonitorDialog : public BaseDialog {
   typedef BaseDialog base_class;
   template <typename T, typename... Args>
   friend T* createDialog(Args&&... args);
-  enum { min_width = 800, min_height = 600 };
+  enum {
+    min_width = 800,
+    min_height = 600,
+    min_refresh_interval_sec = 1,
+    max_refresh_interval_sec = 60,
+    default_refresh_interval_sec = 2
+  };
 
  private Q_SLOTS:
   void startLoadServerClients(const proxy::events_info::LoadServerClientsRequest& req);
@@ -59,6 +68,10 @@ class ClientsMonitorDialog : public BaseDialog {
   void updateClicked();
   void killClient();
 
+  void autoRefreshChange(int state);
+  void refreshIntervalChange(int value);
+  void refreshTimeout();
+
  protected:
   explicit ClientsMonitorDialog(const QString& title,
                                 const QIcon& icon,
@@ -72,6 +85,10 @@ class ClientsMonitorDialog : public BaseDialog {
   QModelIndex selectedIndex() const;
 
  private:
+  QCheckBox* auto_refresh_check_;
+  QSpinBox* refresh_interval_spin_;
+  QTimer* refresh_timer_;
+  bool loading_;  // skip timer ticks while previous CLIENT LIST is in flight
   QPushButton* update_button_;
   FastoTableView* clients_table_;
   ClientsTableModel* clients_model_;
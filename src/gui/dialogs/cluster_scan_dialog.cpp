@@ -0,0 +1,304 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/dialogs/cluster_scan_dialog.h"
+
+#include <QDialogButtonBox>
+#include <QGridLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QSplitter>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include <common/macros.h>
+#include <common/qt/convert2string.h>
+
+#include <fastonosql/core/macros.h>
+#include <fastonosql/core/value.h>
+
+#include "translations/global.h"
+
+namespace {
+const QString trPattern = QObject::tr("Pattern");
+const QString trPageSize = QObject::tr("Keys per page");
+const QString trKeysPerNode = QObject::tr("Keys per node limit (0 - unlimited)");
+const QString trStart = QObject::tr("Start");
+const QString trInvalidPattern = QObject::tr("Invalid pattern!");
+const QString trNode = QObject::tr("Node");
+const QString trScanned = QObject::tr("Scanned");
+const QString trMerged = QObject::tr("Merged");
+const QString trTotal = QObject::tr("Total");
+const QString trPages = QObject::tr("Pages");
+const QString trTimeMsec = QObject::tr("Time, msec");
+const QString trTTL = QObject::tr("TTL");
+const QString trScanning = QObject::tr("Scanning");
+const QString trDone = QObject::tr("Done");
+const QString trStatusTemplate_3S = QObject::tr("Keys: %1, nodes done: %2 of %3");
+const QString trScanFailedTemplate_1S = QObject::tr("Scan failed: %1");
+const char* kDefaultPattern = ALL_KEYS_PATTERNS;
+
+enum NodeColumn { kNodeName = 0, kNodeScanned, kNodeMerged, kNodeTotal, kNodePages, kNodeTime, kNodeState };
+}  // namespace
+
+namespace fastonosql {
+namespace gui {
+
+ClusterScanDialog::ClusterScanDialog(const QString& title,
+                                     const QIcon& icon,
+                                     proxy::IClusterSPtr cluster,
+                                     QWidget* parent)
+    : base_class(title, parent),
+      cluster_(cluster),
+      scan_(nullptr),
+      progress_(),
+      keys_count_(0),
+      pattern_label_(nullptr),
+      pattern_edit_(nullptr),
+      page_label_(nullptr),
+      page_spin_(nullptr),
+      limit_label_(nullptr),
+      limit_spin_(nullptr),
+      nodes_table_(nullptr),
+      keys_table_(nullptr),
+      status_label_(nullptr),
+      start_stop_button_(nullptr) {
+  CHECK(cluster_);
+  setWindowIcon(icon);
+
+  pattern_edit_ = new QLineEdit;
+  pattern_edit_->setText(kDefaultPattern);
+
+  page_spin_ = new QSpinBox;
+  page_spin_->setRange(min_page_size, max_page_size);
+  page_spin_->setValue(defaults_page_size);
+
+  limit_spin_ = new QSpinBox;
+  limit_spin_->setRange(0, max_keys_per_node);
+  limit_spin_->setValue(0);
+
+  pattern_label_ = new QLabel;
+  page_label_ = new QLabel;
+  limit_label_ = new QLabel;
+
+  QGridLayout* settings_layout = new QGridLayout;
+  settings_layout->addWidget(pattern_label_, 0, 0);
+  settings_layout->addWidget(pattern_edit_, 0, 1);
+  settings_layout->addWidget(page_label_, 1, 0);
+  settings_layout->addWidget(page_spin_, 1, 1);
+  settings_layout->addWidget(limit_label_, 2, 0);
+  settings_layout->addWidget(limit_spin_, 2, 1);
+
+  nodes_table_ = new QTreeWidget;
+  nodes_table_->setRootIsDecorated(false);
+
+  keys_table_ = new QTreeWidget;
+  keys_table_->setRootIsDecorated(false);
+  keys_table_->setUniformRowHeights(true);  // can hold millions of rows
+  keys_table_->setSortingEnabled(false);
+
+  QSplitter* splitter = new QSplitter(Qt::Vertical);
+  splitter->addWidget(nodes_table_);
+  splitter->addWidget(keys_table_);
+  splitter->setStretchFactor(1, 1);
+
+  status_label_ = new QLabel;
+  status_label_->setWordWrap(true);
+
+  QDialogButtonBox* button_box = new QDialogButtonBox(QDialogButtonBox::Close);
+  button_box->setOrientation(Qt::Horizontal);
+  start_stop_button_ = button_box->addButton(trStart, QDialogButtonBox::ActionRole);
+  VERIFY(connect(start_stop_button_, &QPushButton::clicked, this, &ClusterScanDialog::startStop));
+  VERIFY(connect(button_box, &QDialogButtonBox::rejected, this, &ClusterScanDialog::reject));
+
+  QVBoxLayout* main_layout = new QVBoxLayout;
+  main_layout->addLayout(settings_layout);
+  main_layout->addWidget(splitter, 1);
+  main_layout->addWidget(status_label_);
+  main_layout->addWidget(button_box);
+  setLayout(main_layout);
+  setMinimumSize(QSize(min_width, min_height));
+}
+
+ClusterScanDialog::~ClusterScanDialog() {
+  closeScan();
+}
+
+void ClusterScanDialog::reject() {
+  closeScan();
+  base_class::reject();
+}
+
+void ClusterScanDialog::startStop() {
+  if (scan_) {
+    scan_->Stop();
+    return;
+  }
+
+  const QString pattern = pattern_edit_->text();
+  if (pattern.isEmpty()) {
+    QMessageBox::warning(this, translations::trError, trInvalidPattern);
+    pattern_edit_->setFocus();
+    return;
+  }
+
+  proxy::ClusterScanOptions options;
+  options.pattern = common::ConvertToString(pattern);
+  options.page_size = page_spin_->value();
+  options.keys_per_node_limit = limit_spin_->value();
+
+  nodes_table_->clear();
+  keys_table_->clear();
+  progress_.clear();
+  keys_count_ = 0;
+
+  scan_ = new proxy::ClusterScan(cluster_, options, this);
+  VERIFY(connect(scan_, &proxy::ClusterScan::NodeProgressed, this, &ClusterScanDialog::nodeProgressed,
+                 Qt::DirectConnection));
+  VERIFY(connect(scan_, &proxy::ClusterScan::KeysMerged, this, &ClusterScanDialog::keysMerged,
+                 Qt::DirectConnection));
+  VERIFY(connect(scan_, &proxy::ClusterScan::Finished, this, &ClusterScanDialog::scanFinished,
+                 Qt::DirectConnection));
+
+  syncControls();
+  scan_->Start();
+  if (!scan_->IsRunning()) {  // failed on start, status already shows the error
+    return;
+  }
+
+  progress_ = scan_->GetProgress();
+  for (const auto& progress : progress_) {
+    QString qname;
+    common::ConvertFromString(progress.name, &qname);
+    QStringList row;
+    row << qname << QString::number(0) << QString::number(0) << QString() << QString::number(0)
+        << QString::number(0) << trScanning;
+    nodes_table_->addTopLevelItem(new QTreeWidgetItem(row));
+  }
+  updateStatus();
+}
+
+void ClusterScanDialog::nodeProgressed(size_t index, const proxy::ClusterScanNodeProgress& progress) {
+  if (index >= progress_.size()) {
+    return;
+  }
+
+  progress_[index] = progress;
+  QTreeWidgetItem* item = nodes_table_->topLevelItem(static_cast<int>(index));
+  if (!item) {  // progress before rows are created
+    return;
+  }
+
+  item->setText(kNodeScanned, QString::number(progress.scanned_keys));
+  item->setText(kNodeMerged, QString::number(progress.merged_keys));
+  item->setText(kNodeTotal, QString::number(progress.db_keys_count));
+  item->setText(kNodePages, QString::number(progress.pages));
+  item->setText(kNodeTime, QString::number(progress.elapsed_msec));
+  if (progress.err) {
+    QString qerror;
+    common::ConvertFromString(progress.err->GetDescription(), &qerror);
+    item->setText(kNodeState, qerror);
+  } else {
+    item->setText(kNodeState, progress.done ? trDone : trScanning);
+  }
+  updateStatus();
+}
+
+void ClusterScanDialog::keysMerged(const proxy::ClusterScan::keys_t& keys) {
+  QList<QTreeWidgetItem*> items;
+  items.reserve(static_cast<int>(keys.size()));
+  for (const auto& merged : keys) {
+    const core::NKey key = merged.key.GetKey();
+    QString qkey;
+    common::ConvertFromBytes(key.GetKey().GetHumanReadable(), &qkey);
+    QString qnode;
+    if (merged.node < progress_.size()) {
+      common::ConvertFromString(progress_[merged.node].name, &qnode);
+    }
+    QStringList row;
+    row << qkey << core::GetTypeName(merged.key.GetType()) << QString::number(key.GetTTL()) << qnode;
+    items.append(new QTreeWidgetItem(row));
+  }
+  keys_table_->addTopLevelItems(items);
+  keys_count_ += keys.size();
+  updateStatus();
+}
+
+void ClusterScanDialog::scanFinished(common::Error err) {
+  updateStatus();
+  if (err && err->GetErrorCode() != common::COMMON_EINTR) {
+    QString qerror;
+    common::ConvertFromString(err->GetDescription(), &qerror);
+    status_label_->setText(status_label_->text() + "\n" + trScanFailedTemplate_1S.arg(qerror));
+  }
+
+  // scan emits from its own slots, release it after return
+  QMetaObject::invokeMethod(this, "closeScan", Qt::QueuedConnection);
+}
+
+void ClusterScanDialog::closeScan() {
+  if (!scan_) {
+    return;
+  }
+
+  VERIFY(disconnect(scan_, Q_NULLPTR, this, Q_NULLPTR));
+  scan_->Stop();
+  scan_->deleteLater();
+  scan_ = nullptr;
+  syncControls();
+}
+
+void ClusterScanDialog::updateStatus() {
+  size_t done = 0;
+  for (const auto& progress : progress_) {
+    if (progress.done) {
+      done++;
+    }
+  }
+  status_label_->setText(trStatusTemplate_3S.arg(keys_count_).arg(done).arg(progress_.size()));
+}
+
+void ClusterScanDialog::syncControls() {
+  const bool running = scan_ != nullptr;
+  start_stop_button_->setText(running ? translations::trStop : trStart);
+  pattern_edit_->setEnabled(!running);
+  page_spin_->setEnabled(!running);
+  limit_spin_->setEnabled(!running);
+}
+
+void ClusterScanDialog::retranslateUi() {
+  pattern_label_->setText(trPattern + ":");
+  page_label_->setText(trPageSize + ":");
+  limit_label_->setText(trKeysPerNode + ":");
+
+  QStringList node_columns;
+  node_columns << trNode << trScanned << trMerged << trTotal << trPages << trTimeMsec << translations::trState;
+  nodes_table_->setHeaderLabels(node_columns);
+
+  QStringList key_columns;
+  key_columns << translations::trKey << translations::trType << trTTL << trNode;
+  keys_table_->setHeaderLabels(key_columns);
+  syncControls();
+  base_class::retranslateUi();
+}
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,92 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <common/error.h>
+
+#include "gui/dialogs/base_dialog.h"
+#include "proxy/cluster/cluster_scan.h"
+
+class QLabel;
+class QLineEdit;
+class QPushButton;
+class QSpinBox;
+class QTreeWidget;
+
+namespace fastonosql {
+namespace gui {
+
+// Keys of all cluster masters in one list, with scan progress of every node.
+class ClusterScanDialog : public BaseDialog {
+  Q_OBJECT
+
+ public:
+  typedef BaseDialog base_class;
+  template <typename T, typename... Args>
+  friend T* createDialog(Args&&... args);
+
+  enum {
+    min_width = 640,
+    min_height = 480,
+    min_page_size = 10,
+    max_page_size = 100000,
+    defaults_page_size = 1000,
+    max_keys_per_node = 100000000
+  };
+
+  ~ClusterScanDialog() override;
+
+ public Q_SLOTS:
+  void reject() override;
+
+ private Q_SLOTS:
+  void startStop();
+  void nodeProgressed(size_t index, const fastonosql::proxy::ClusterScanNodeProgress& progress);
+  void keysMerged(const fastonosql::proxy::ClusterScan::keys_t& keys);
+  void scanFinished(common::Error err);
+  void closeScan();
+
+ protected:
+  ClusterScanDialog(const QString& title, const QIcon& icon, proxy::IClusterSPtr cluster, QWidget* parent = Q_NULLPTR);
+
+  void retranslateUi() override;
+
+ private:
+  void updateStatus();
+  void syncControls();
+
+  const proxy::IClusterSPtr cluster_;
+  proxy::ClusterScan* scan_;
+  proxy::ClusterScan::progress_t progress_;
+  size_t keys_count_;
+
+  QLabel* pattern_label_;
+  QLineEdit* pattern_edit_;
+  QLabel* page_label_;
+  QSpinBox* page_spin_;
+  QLabel* limit_label_;
+  QSpinBox* limit_spin_;
+  QTreeWidget* nodes_table_;
+  QTreeWidget* keys_table_;
+  QLabel* status_label_;
+  QPushButton* start_stop_button_;
+};
+
+}  // namespace gui
+}  // namespace fastonosql
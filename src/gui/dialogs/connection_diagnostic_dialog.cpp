@@ -15,12 +15,17 @@
     You should have received a copy of the GNU General Public License
     along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
 */
-
 #include "gui/dialogs/connection_diagnostic_dialog.h"
 
+#include <algorithm>
+
 #include <QDialogButtonBox>
+#include <QFontDatabase>
+#include <QGridLayout>
 #include <QIcon>
 #include <QLabel>
+#include <QPushButton>
+#include <QSpinBox>
 #include <QThread>
 #include <QVBoxLayout>
 
@@ -34,7 +39,59 @@
 
 namespace {
 const QSize kStateIconSize = QSize(64, 64);
+const int kHistogramBarWidth = 30;
+const int kMaxPingCount = 100000;
+const int kMaxPayloadSize = fastonosql::proxy::DiagnosticsOptions::max_batch_size;
+
+const QString trPings = QObject::tr("Pings");
+const QString trPayloadBytes = QObject::tr("Payload, bytes");
+const QString trRunDiagnostics = QObject::tr("Run diagnostics");
+const QString trRunningDiagnostics = QObject::tr("Running diagnostics");
+const QString trSshSession = QObject::tr("SSH session");
+const QString trReused = QObject::tr("reused");
+const QString trSshChannel = QObject::tr("SSH channel");
+const QString trTcpConnect = QObject::tr("TCP connect");
+const QString trTlsHandshake = QObject::tr("TLS handshake");
+const QString trAuth = QObject::tr("AUTH");
+const QString trSkipped = QObject::tr("skipped");
+const QString trPingLatencyTemplate_6S = QObject::tr("PING x%1: min %2, avg %3, p50 %4, p99 %5, max %6");
+const QString trThroughputTemplate_4S = QObject::tr("SET/GET (pipeline %1, %2 bytes): %3 ops/sec, %4 MB/sec");
+const QString trThroughputSkippedTemplate_1S = QObject::tr("SET/GET: skipped, %1");
+
+QString formatUsec(fastonosql::proxy::ConnectionDiagnostics::usec_t usec) {
+  return QString::number(usec / 1000.0, 'f', 2) + " ms";
+}
+
+QString formatPhase(const QString& name, fastonosql::proxy::ConnectionDiagnostics::usec_t usec) {
+  const QString value =
+      usec == fastonosql::proxy::ConnectionDiagnostics::phase_skipped ? trSkipped : formatUsec(usec);
+  return QString("%1: %2").arg(name, -16).arg(value);
+}
+
+// text bars so the report stays copyable
+QString formatHistogram(const fastonosql::proxy::LatencyHistogram& histogram) {
+  size_t first = histogram.GetBucketsCount();
+  size_t last = 0;
+  size_t peak = 0;
+  for (size_t i = 0; i < histogram.GetBucketsCount(); ++i) {
+    const size_t count = histogram.GetBucketCount(i);
+    if (count) {
+      first = std::min(first, i);
+      last = i;
+      peak = std::max(peak, count);
+    }
+  }
+
+  QStringList lines;
+  for (size_t i = first; i <= last && peak; ++i) {
+    const size_t count = histogram.GetBucketCount(i);
+    const int width = static_cast<int>(count * kHistogramBarWidth / peak);
+    const QString bound = "<= " + formatUsec(histogram.GetBucketUpperBound(i));
+    lines << QString("%1 |%2 %3").arg(bound, -12).arg(QString(width, '#'), -kHistogramBarWidth).arg(count);
+  }
+  return lines.join('\n');
 }
+}  // namespace
 
 namespace fastonosql {
 namespace gui {
@@ -43,10 +100,17 @@ ConnectionDiagnosticDialog::ConnectionDiagnosticDialog(const QString& title,
                                                        proxy::IConnectionSettingsBaseSPtr connection,
                                                        QWidget* parent)
     : base_class(title, parent),
+      connection_(connection),
       glass_widget_(nullptr),
       execute_time_label_(nullptr),
       status_label_(nullptr),
-      icon_label_(nullptr) {
+      icon_label_(nullptr),
+      pings_label_(nullptr),
+      pings_spin_(nullptr),
+      payload_label_(nullptr),
+      payload_spin_(nullptr),
+      diagnose_button_(nullptr),
+      diagnostics_label_(nullptr) {
   setWindowIcon(GuiFactory::GetInstance().icon(connection->GetType()));
 
   execute_time_label_ = new QLabel;
@@ -57,6 +121,31 @@ ConnectionDiagnosticDialog::ConnectionDiagnosticDialog(const QString& title,
   icon_label_ = new QLabel;
   setIcon(GuiFactory::GetInstance().failIcon());
 
+  const proxy::DiagnosticsOptions defaults;
+  pings_label_ = new QLabel;
+  pings_spin_ = new QSpinBox;
+  pings_spin_->setRange(1, kMaxPingCount);
+  pings_spin_->setValue(static_cast<int>(defaults.ping_count));
+  payload_label_ = new QLabel;
+  payload_spin_ = new QSpinBox;
+  payload_spin_->setRange(1, kMaxPayloadSize);
+  payload_spin_->setValue(static_cast<int>(defaults.payload_size));
+  diagnose_button_ = new QPushButton;
+  diagnose_button_->setEnabled(false);
+  VERIFY(connect(diagnose_button_, &QPushButton::clicked, this, &ConnectionDiagnosticDialog::startDiagnostics));
+
+  diagnostics_label_ = new QLabel;
+  diagnostics_label_->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+  diagnostics_label_->setTextInteractionFlags(Qt::TextSelectableByMouse);
+  diagnostics_label_->setVisible(false);
+
+  QGridLayout* diagnostics_layout = new QGridLayout;
+  diagnostics_layout->addWidget(pings_label_, 0, 0);
+  diagnostics_layout->addWidget(pings_spin_, 0, 1);
+  diagnostics_layout->addWidget(payload_label_, 1, 0);
+  diagnostics_layout->addWidget(payload_spin_, 1, 1);
+  diagnostics_layout->addWidget(diagnose_button_, 2, 0, 1, 2);
+
   QDialogButtonBox* button_box = new QDialogButtonBox(QDialogButtonBox::Ok);
   button_box->setOrientation(Qt::Horizontal);
   VERIFY(connect(button_box, &QDialogButtonBox::accepted, this, &ConnectionDiagnosticDialog::accept));
@@ -65,6 +154,8 @@ ConnectionDiagnosticDialog::ConnectionDiagnosticDialog(const QString& title,
   main_layout->addWidget(execute_time_label_);
   main_layout->addWidget(status_label_);
   main_layout->addWidget(icon_label_, 1, Qt::AlignCenter);
+  main_layout->addLayout(diagnostics_layout);
+  main_layout->addWidget(diagnostics_label_);
   main_layout->addWidget(button_box);
   main_layout->setSizeConstraint(QLayout::SetFixedSize);
   setLayout(main_layout);
@@ -90,6 +181,82 @@ void ConnectionDiagnosticDialog::connectionResultReady(common::Error err, qint64
 
   setIcon(GuiFactory::GetInstance().successIcon());
   status_label_->setText(translations::trConnectionStatusTemplate_1S.arg(translations::trSuccess));
+  diagnose_button_->setEnabled(true);
+}
+
+void ConnectionDiagnosticDialog::startDiagnostics() {
+  proxy::DiagnosticsOptions options;
+  options.ping_count = pings_spin_->value();
+  options.payload_size = payload_spin_->value();
+
+  diagnose_button_->setEnabled(false);
+  glass_widget_->start();
+
+  QThread* th = new QThread;
+  TestConnection* cheker = new TestConnection(connection_);
+  cheker->setDiagnosticsOptions(options);
+  cheker->moveToThread(th);
+  VERIFY(connect(th, &QThread::started, cheker, &TestConnection::routine));
+  VERIFY(connect(cheker, &TestConnection::diagnosticsResult, this,
+                 &ConnectionDiagnosticDialog::diagnosticsResultReady));
+  VERIFY(connect(cheker, &TestConnection::connectionResult, th, &QThread::quit));
+  VERIFY(connect(th, &QThread::finished, this, &ConnectionDiagnosticDialog::diagnosticsFinished));
+  VERIFY(connect(th, &QThread::finished, cheker, &TestConnection::deleteLater));
+  VERIFY(connect(th, &QThread::finished, th, &QThread::deleteLater));
+  th->start();
+}
+
+void ConnectionDiagnosticDialog::diagnosticsResultReady(common::Error err, proxy::ConnectionDiagnostics diagnostics) {
+  QStringList lines;
+  if (diagnostics.ssh_usec != proxy::ConnectionDiagnostics::phase_skipped && diagnostics.ssh_session_reused) {
+    lines << formatPhase(trSshSession, diagnostics.ssh_usec) + " (" + trReused + ")";
+  } else {
+    lines << formatPhase(trSshSession, diagnostics.ssh_usec);
+  }
+  lines << formatPhase(trTcpConnect, diagnostics.tcp_usec);
+  lines << formatPhase(trSshChannel, diagnostics.ssh_channel_usec);
+  lines << formatPhase(trTlsHandshake, diagnostics.tls_usec);
+  lines << formatPhase(trAuth, diagnostics.auth_usec);
+
+  const proxy::LatencyHistogram& ping = diagnostics.ping;
+  if (ping.GetCount()) {
+    lines << QString();
+    lines << trPingLatencyTemplate_6S.arg(ping.GetCount())
+                 .arg(formatUsec(ping.GetMin()))
+                 .arg(formatUsec(ping.GetAverage()))
+                 .arg(formatUsec(ping.GetPercentile(50)))
+                 .arg(formatUsec(ping.GetPercentile(99)))
+                 .arg(formatUsec(ping.GetMax()));
+    lines << formatHistogram(ping);
+  }
+
+  if (diagnostics.throughput_ops) {
+    lines << QString();
+    lines << trThroughputTemplate_4S.arg(diagnostics.pipeline_depth)
+                 .arg(diagnostics.payload_size)
+                 .arg(QString::number(diagnostics.GetOpsPerSecond(), 'f', 0))
+                 .arg(QString::number(diagnostics.GetBytesPerSecond() / (1024 * 1024), 'f', 2));
+  } else if (!diagnostics.throughput_skipped.empty()) {
+    QString qreason;
+    common::ConvertFromString(diagnostics.throughput_skipped, &qreason);
+    lines << QString();
+    lines << trThroughputSkippedTemplate_1S.arg(qreason);
+  }
+
+  if (err) {
+    QString qerror;
+    common::ConvertFromString(err->GetDescription(), &qerror);
+    lines << QString();
+    lines << translations::trConnectionStatusTemplate_1S.arg(qerror);
+  }
+
+  diagnostics_label_->setText(lines.join('\n'));
+  diagnostics_label_->setVisible(true);
+}
+
+void ConnectionDiagnosticDialog::diagnosticsFinished() {
+  glass_widget_->stop();
+  diagnose_button_->setEnabled(true);
 }
 
 void ConnectionDiagnosticDialog::showEvent(QShowEvent* e) {
@@ -97,6 +264,13 @@ void ConnectionDiagnosticDialog::showEvent(QShowEvent* e) {
   glass_widget_->start();
 }
 
+void ConnectionDiagnosticDialog::retranslateUi() {
+  pings_label_->setText(trPings + ":");
+  payload_label_->setText(trPayloadBytes + ":");
+  diagnose_button_->setText(trRunDiagnostics);
+  base_class::retranslateUi();
+}
+
 void ConnectionDiagnosticDialog::setIcon(const QIcon& icon) {
   QPixmap pm = icon.pixmap(kStateIconSize);
   icon_label_->setPixmap(pm);
@@ -20,9 +20,12 @@
 
 #include "gui/dialogs/base_dialog.h"
 
+#include "proxy/connection_diagnostics.h"
 #include "proxy/connection_settings/iconnection_settings.h"
 
 class QLabel;
+class QPushButton;
+class QSpinBox;
 
 namespace common {
 namespace qt {
@@ -45,6 +48,9 @@ class ConnectionDiagnosticDialog : public BaseDialog {
 
  private Q_SLOTS:
   void connectionResultReady(common::Error err, qint64 exec_mstime);
+  void startDiagnostics();
+  void diagnosticsResultReady(common::Error err, proxy::ConnectionDiagnostics diagnostics);
+  void diagnosticsFinished();
 
  protected:
   ConnectionDiagnosticDialog(const QString& title,
@@ -52,15 +58,24 @@ class ConnectionDiagnosticDialog : public BaseDialog {
                              QWidget* parent = Q_NULLPTR);
 
   void showEvent(QShowEvent* e) override;
+  void retranslateUi() override;
 
  private:
   void setIcon(const QIcon& icon);
   void startTestConnection(proxy::IConnectionSettingsBaseSPtr connection);
 
+  const proxy::IConnectionSettingsBaseSPtr connection_;
   common::qt::gui::GlassWidget* glass_widget_;
   QLabel* execute_time_label_;
   QLabel* status_label_;
   QLabel* icon_label_;
+
+  QLabel* pings_label_;
+  QSpinBox* pings_spin_;
+  QLabel* payload_label_;
+  QSpinBox* payload_spin_;
+  QPushButton* diagnose_button_;
+  QLabel* diagnostics_label_;
 };
 
 }  // namespace gui
@@ -18,6 +18,7 @@
 
 #include "gui/dialogs/dbkey_dialog.h"
 
+#include <string>
 #include <vector>
 
 #include <QComboBox>
@@ -30,6 +31,8 @@
 
 #include <fastonosql/core/value.h>
 
+#include "proxy/server/iserver.h"
+
 #include "gui/shortcuts.h"
 #include "gui/widgets/key_edit_widget.h"
 
@@ -41,6 +44,8 @@ const QSize kPrefListSize = QSize(600, 300);
 const QSize kPrefHashSize = QSize(600, 300);
 const QSize kPrefStreamSize = QSize(600, 300);
 const QSize kPrefJsonSize = QSize(640, 300);
+const QString trValueNotCompleteTemplate_1S =
+    QObject::tr("Value is loaded partially, scroll to the end of %1 before saving.");
 }  // namespace
 
 namespace fastonosql {
@@ -51,8 +56,9 @@ DbKeyDialog::DbKeyDialog(const QString& title,
                          std::vector<common::Value::Type> types,
                          const core::NDbKValue& key,
                          bool is_edit,
+                         proxy::IServerSPtr server,
                          QWidget* parent)
-    : base_class(title, parent), editor_(nullptr), key_(key) {
+    : base_class(title, parent), editor_(nullptr), key_(key), changes_(), has_changes_(false) {
   setWindowIcon(icon);
 
   editor_ = createWidget<KeyEditWidget>();
@@ -69,6 +75,13 @@ DbKeyDialog::DbKeyDialog(const QString& title,
   setMinimumSize(kMinSize);
 
   VERIFY(connect(editor_, &KeyEditWidget::typeChanged, this, &DbKeyDialog::changeType));
+  if (is_edit) {
+    editor_->setPageSource(server);
+  }
+  if (server) {
+    const auto db = server->GetCurrentDatabaseInfo();
+    editor_->setViewCacheScope(server->GetPath(), db ? db->GetName() : std::string());
+  }
   editor_->initialize(types, key_);
   editor_->setEnableKeyEdit(!is_edit);
 }
@@ -77,7 +90,35 @@ core::NDbKValue DbKeyDialog::key() const {
   return key_;
 }
 
+bool DbKeyDialog::valueChanges(proxy::KeyChangeSet* changes) const {
+  if (!changes || !has_changes_) {
+    return false;
+  }
+
+  *changes = changes_;
+  return true;
+}
+
 void DbKeyDialog::accept() {
+  // edited collections loaded from server are saved by their changes only
+  has_changes_ = editor_->valueChanges(&changes_);
+  if (has_changes_) {
+    if (!editor_->validateChanges(changes_)) {
+      has_changes_ = false;
+      QMessageBox::warning(this, translations::trInvalidInput, translations::trInvalidInput + "!");
+      return;
+    }
+
+    base_class::accept();
+    return;
+  }
+
+  if (!editor_->isValueComplete()) {
+    QMessageBox::warning(this, translations::trInvalidInput,
+                         trValueNotCompleteTemplate_1S.arg(core::GetTypeName(key_.GetType())));
+    return;
+  }
+
   if (!validateAndApply()) {
     QMessageBox::warning(this, translations::trInvalidInput, translations::trInvalidInput + "!");
     return;
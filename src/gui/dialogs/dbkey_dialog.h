@@ -22,6 +22,9 @@
 
 #include <fastonosql/core/db_key.h>
 
+#include "proxy/key_change_set.h"
+#include "proxy/proxy_fwd.h"
+
 #include "gui/dialogs/base_dialog.h"
 
 namespace fastonosql {
@@ -38,6 +41,7 @@ class DbKeyDialog : public BaseDialog {
   friend T* createDialog(Args&&... args);
 
   core::NDbKValue key() const;
+  bool valueChanges(proxy::KeyChangeSet* changes) const;  // false if whole key should be written
 
  public Q_SLOTS:
   void accept() override;
@@ -51,6 +55,7 @@ class DbKeyDialog : public BaseDialog {
               std::vector<common::Value::Type> types,
               const core::NDbKValue& key,
               bool is_edit,
+              proxy::IServerSPtr server,
               QWidget* parent = Q_NULLPTR);
 
   void keyPressEvent(QKeyEvent* event) override;
@@ -60,6 +65,8 @@ class DbKeyDialog : public BaseDialog {
 
   KeyEditWidget* editor_;
   core::NDbKValue key_;
+  proxy::KeyChangeSet changes_;
+  bool has_changes_;
 };
 
 }  // namespace gui
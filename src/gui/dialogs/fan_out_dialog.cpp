@@ -0,0 +1,327 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/dialogs/fan_out_dialog.h"
+
+#include <QComboBox>
+#include <QDialogButtonBox>
+#include <QGridLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include <common/macros.h>
+#include <common/qt/convert2string.h>
+
+#include <fastonosql/core/value.h>
+
+#include "proxy/server/iserver_remote.h"
+
+#include "translations/global.h"
+
+namespace {
+const QString trCommand = QObject::tr("Command");
+const QString trNodes = QObject::tr("Nodes");
+const QString trAllNodes = QObject::tr("All");
+const QString trMasterNodes = QObject::tr("Masters");
+const QString trReplicaNodes = QObject::tr("Replicas");
+const QString trConcurrency = QObject::tr("Requests at once (0 - all nodes)");
+const QString trExecute = QObject::tr("Execute");
+const QString trNode = QObject::tr("Node");
+const QString trRole = QObject::tr("Role");
+const QString trLatencyMsec = QObject::tr("Latency, msec");
+const QString trMaster = QObject::tr("master");
+const QString trReplica = QObject::tr("replica");
+const QString trOk = QObject::tr("OK");
+const QString trWaiting = QObject::tr("Waiting");
+const QString trInvalidCommand = QObject::tr("Invalid command!");
+const QString trNoNodesChecked = QObject::tr("Check at least one node.");
+const QString trStatusTemplate_3S = QObject::tr("Nodes done: %1 of %2, failed: %3");
+}  // namespace
+
+namespace fastonosql {
+namespace gui {
+
+namespace {
+enum Column { kNodeColumn = 0, kRoleColumn, kLatencyColumn, kStateColumn };
+
+core::ServerType nodeRole(proxy::IServerSPtr node, bool* known) {
+  proxy::IServerRemote* rserver = dynamic_cast<proxy::IServerRemote*>(node.get());  // +
+  *known = rserver != nullptr;
+  return rserver ? rserver->GetRole() : core::MASTER;
+}
+
+// one row per line, bulk replies like INFO stay readable
+void addReplyRows(QTreeWidgetItem* parent, core::FastoObject* reply) {
+  const auto childs = reply->GetChildrens();
+  if (!childs.empty()) {
+    for (const auto& child : childs) {
+      addReplyRows(parent, child.get());
+    }
+    return;
+  }
+
+  auto value = reply->GetValue();
+  if (!value) {
+    return;
+  }
+
+  QString text;
+  common::ConvertFromBytes(core::ConvertValue(value.get(), reply->GetDelimiter()), &text);
+  const QStringList lines = text.split('\n', QString::SkipEmptyParts);
+  for (QString line : lines) {
+    if (line.endsWith('\r')) {
+      line.chop(1);
+    }
+    QTreeWidgetItem* item = new QTreeWidgetItem(parent);
+    item->setText(kNodeColumn, line);
+  }
+}
+}  // namespace
+
+FanOutDialog::FanOutDialog(const QString& title,
+                           const QIcon& icon,
+                           const proxy::FanOutExecution::nodes_t& nodes,
+                           QWidget* parent)
+    : base_class(title, parent),
+      nodes_(nodes),
+      execution_(nullptr),
+      running_items_(),
+      command_label_(nullptr),
+      command_edit_(nullptr),
+      filter_label_(nullptr),
+      filter_combo_(nullptr),
+      concurrency_label_(nullptr),
+      concurrency_spin_(nullptr),
+      results_tree_(nullptr),
+      status_label_(nullptr),
+      execute_stop_button_(nullptr) {
+  setWindowIcon(icon);
+
+  command_edit_ = new QLineEdit;
+  VERIFY(connect(command_edit_, &QLineEdit::returnPressed, this, &FanOutDialog::executeStop));
+
+  filter_combo_ = new QComboBox;
+  filter_combo_->addItem(trAllNodes, kAllNodes);
+  filter_combo_->addItem(trMasterNodes, kMasterNodes);
+  filter_combo_->addItem(trReplicaNodes, kReplicaNodes);
+  typedef void (QComboBox::*ind)(int);
+  VERIFY(connect(filter_combo_, static_cast<ind>(&QComboBox::currentIndexChanged), this, &FanOutDialog::filterChange));
+
+  concurrency_spin_ = new QSpinBox;
+  concurrency_spin_->setRange(0, max_concurrency);
+  concurrency_spin_->setValue(defaults_concurrency);
+
+  command_label_ = new QLabel;
+  filter_label_ = new QLabel;
+  concurrency_label_ = new QLabel;
+
+  QGridLayout* settings_layout = new QGridLayout;
+  settings_layout->addWidget(command_label_, 0, 0);
+  settings_layout->addWidget(command_edit_, 0, 1);
+  settings_layout->addWidget(filter_label_, 1, 0);
+  settings_layout->addWidget(filter_combo_, 1, 1);
+  settings_layout->addWidget(concurrency_label_, 2, 0);
+  settings_layout->addWidget(concurrency_spin_, 2, 1);
+
+  results_tree_ = new QTreeWidget;
+  for (auto node : nodes_) {
+    QString qname;
+    common::ConvertFromString(node->GetName(), &qname);
+    bool known = false;
+    const core::ServerType role = nodeRole(node, &known);
+    QTreeWidgetItem* item = new QTreeWidgetItem(results_tree_);
+    item->setText(kNodeColumn, qname);
+    if (known) {
+      item->setText(kRoleColumn, role == core::MASTER ? trMaster : trReplica);
+    }
+    item->setCheckState(kNodeColumn, Qt::Checked);
+  }
+
+  status_label_ = new QLabel;
+  status_label_->setWordWrap(true);
+
+  QDialogButtonBox* button_box = new QDialogButtonBox(QDialogButtonBox::Close);
+  button_box->setOrientation(Qt::Horizontal);
+  execute_stop_button_ = button_box->addButton(trExecute, QDialogButtonBox::ActionRole);
+  VERIFY(connect(execute_stop_button_, &QPushButton::clicked, this, &FanOutDialog::executeStop));
+  VERIFY(connect(button_box, &QDialogButtonBox::rejected, this, &FanOutDialog::reject));
+
+  QVBoxLayout* main_layout = new QVBoxLayout;
+  main_layout->addLayout(settings_layout);
+  main_layout->addWidget(results_tree_, 1);
+  main_layout->addWidget(status_label_);
+  main_layout->addWidget(button_box);
+  setLayout(main_layout);
+  setMinimumSize(QSize(min_width, min_height));
+}
+
+FanOutDialog::~FanOutDialog() {
+  closeExecution();
+}
+
+void FanOutDialog::reject() {
+  closeExecution();
+  base_class::reject();
+}
+
+void FanOutDialog::executeStop() {
+  if (execution_) {
+    execution_->Stop();
+    return;
+  }
+
+  const QString command = command_edit_->text().trimmed();
+  if (command.isEmpty()) {
+    QMessageBox::warning(this, translations::trError, trInvalidCommand);
+    command_edit_->setFocus();
+    return;
+  }
+
+  proxy::FanOutExecution::nodes_t checked;
+  running_items_.clear();
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    QTreeWidgetItem* item = results_tree_->topLevelItem(static_cast<int>(i));
+    qDeleteAll(item->takeChildren());
+    item->setText(kLatencyColumn, QString());
+    item->setText(kStateColumn, QString());
+    if (item->checkState(kNodeColumn) == Qt::Checked) {
+      checked.push_back(nodes_[i]);
+      running_items_.push_back(item);
+      item->setText(kStateColumn, trWaiting);
+    }
+  }
+
+  if (checked.empty()) {
+    QMessageBox::warning(this, translations::trError, trNoNodesChecked);
+    return;
+  }
+
+  proxy::FanOutOptions options;
+  options.concurrency = concurrency_spin_->value();
+  const proxy::events_info::ExecuteInfoRequest req(this, common::ConvertToCharBytes(command), 0, 0, false, true,
+                                                   core::C_USER);
+  execution_ = new proxy::FanOutExecution(checked, req, options, this);
+  VERIFY(connect(execution_, &proxy::FanOutExecution::NodeFinished, this, &FanOutDialog::nodeFinished,
+                 Qt::DirectConnection));
+  VERIFY(connect(execution_, &proxy::FanOutExecution::Finished, this, &FanOutDialog::executionFinished,
+                 Qt::DirectConnection));
+  status_label_->setText(trStatusTemplate_3S.arg(0).arg(checked.size()).arg(0));
+  syncControls();
+  execution_->Start();
+}
+
+void FanOutDialog::filterChange(int index) {
+  const QVariant data = filter_combo_->itemData(index);
+  const int filter = data.toInt();
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    bool known = false;
+    const core::ServerType role = nodeRole(nodes_[i], &known);
+    bool checked = true;
+    if (filter == kMasterNodes) {
+      checked = known && role == core::MASTER;
+    } else if (filter == kReplicaNodes) {
+      checked = known && role != core::MASTER;
+    }
+    results_tree_->topLevelItem(static_cast<int>(i))->setCheckState(kNodeColumn, checked ? Qt::Checked : Qt::Unchecked);
+  }
+}
+
+void FanOutDialog::nodeFinished(size_t index, const proxy::FanOutNodeResult& result) {
+  if (index >= running_items_.size()) {
+    return;
+  }
+
+  QTreeWidgetItem* item = running_items_[index];
+  item->setText(kLatencyColumn, QString::number(result.latency_msec));
+  if (result.err) {
+    QString qerror;
+    common::ConvertFromString(result.err->GetDescription(), &qerror);
+    item->setText(kStateColumn, qerror);
+  } else {
+    item->setText(kStateColumn, trOk);
+  }
+
+  for (core::FastoObjectCommandIPtr command : result.commands) {
+    QString qcommand;
+    common::ConvertFromBytes(command->GetInputCommand(), &qcommand);
+    QTreeWidgetItem* command_item = new QTreeWidgetItem(item);
+    command_item->setText(kNodeColumn, qcommand);
+    addReplyRows(command_item, command.get());
+  }
+  item->setExpanded(true);
+
+  if (execution_) {
+    size_t done = 0;
+    size_t failed = 0;
+    for (const auto& node_result : execution_->GetResults()) {
+      if (node_result.done) {
+        done++;
+      }
+      if (node_result.err) {
+        failed++;
+      }
+    }
+    status_label_->setText(trStatusTemplate_3S.arg(done).arg(running_items_.size()).arg(failed));
+  }
+}
+
+void FanOutDialog::executionFinished(const proxy::FanOutExecution::results_t& results) {
+  UNUSED(results);
+  // execution emits from its own slots, release it after return
+  QMetaObject::invokeMethod(this, "closeExecution", Qt::QueuedConnection);
+}
+
+void FanOutDialog::closeExecution() {
+  if (!execution_) {
+    return;
+  }
+
+  VERIFY(disconnect(execution_, Q_NULLPTR, this, Q_NULLPTR));
+  execution_->Stop();
+  execution_->deleteLater();
+  execution_ = nullptr;
+  syncControls();
+}
+
+void FanOutDialog::syncControls() {
+  const bool running = execution_ != nullptr;
+  execute_stop_button_->setText(running ? translations::trStop : trExecute);
+  command_edit_->setEnabled(!running);
+  filter_combo_->setEnabled(!running);
+  concurrency_spin_->setEnabled(!running);
+}
+
+void FanOutDialog::retranslateUi() {
+  command_label_->setText(trCommand + ":");
+  filter_label_->setText(trNodes + ":");
+  concurrency_label_->setText(trConcurrency + ":");
+
+  QStringList columns;
+  columns << trNode << trRole << trLatencyMsec << translations::trState;
+  results_tree_->setHeaderLabels(columns);
+  syncControls();
+  base_class::retranslateUi();
+}
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,88 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "gui/dialogs/base_dialog.h"
+#include "proxy/fan_out_execution.h"
+
+class QComboBox;
+class QLabel;
+class QLineEdit;
+class QPushButton;
+class QSpinBox;
+class QTreeWidget;
+class QTreeWidgetItem;
+
+namespace fastonosql {
+namespace gui {
+
+// Same command on checked nodes of cluster or sentinel, replies are grouped by node.
+class FanOutDialog : public BaseDialog {
+  Q_OBJECT
+
+ public:
+  typedef BaseDialog base_class;
+  template <typename T, typename... Args>
+  friend T* createDialog(Args&&... args);
+
+  enum { min_width = 640, min_height = 480, max_concurrency = 1024, defaults_concurrency = 16 };
+  enum NodesFilter { kAllNodes = 0, kMasterNodes, kReplicaNodes };
+
+  ~FanOutDialog() override;
+
+ public Q_SLOTS:
+  void reject() override;
+
+ private Q_SLOTS:
+  void executeStop();
+  void filterChange(int index);
+  void nodeFinished(size_t index, const fastonosql::proxy::FanOutNodeResult& result);
+  void executionFinished(const fastonosql::proxy::FanOutExecution::results_t& results);
+  void closeExecution();
+
+ protected:
+  FanOutDialog(const QString& title,
+               const QIcon& icon,
+               const proxy::FanOutExecution::nodes_t& nodes,
+               QWidget* parent = Q_NULLPTR);
+
+  void retranslateUi() override;
+
+ private:
+  void syncControls();
+
+  const proxy::FanOutExecution::nodes_t nodes_;
+  proxy::FanOutExecution* execution_;
+  std::vector<QTreeWidgetItem*> running_items_;  // rows of nodes in execution order
+
+  QLabel* command_label_;
+  QLineEdit* command_edit_;
+  QLabel* filter_label_;
+  QComboBox* filter_combo_;
+  QLabel* concurrency_label_;
+  QSpinBox* concurrency_spin_;
+  QTreeWidget* results_tree_;
+  QLabel* status_label_;
+  QPushButton* execute_stop_button_;
+};
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,272 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "gui/dialogs/migration_dialog.h"
+
+#include <QComboBox>
+#include <QDialogButtonBox>
+#include <QGridLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QVBoxLayout>
+
+#include <common/macros.h>
+#include <common/qt/convert2string.h>
+
+#include <fastonosql/core/macros.h>
+
+#include "proxy/servers_manager.h"
+
+#include "translations/global.h"
+
+namespace {
+const QString trSource = QObject::tr("Source");
+const QString trTarget = QObject::tr("Target");
+const QString trPattern = QObject::tr("Pattern");
+const QString trBatchSize = QObject::tr("Keys per batch");
+const QString trQueueCapacity = QObject::tr("Queue capacity");
+const QString trKeysPerSecond = QObject::tr("Write limit, keys/sec (0 - unlimited)");
+const QString trStart = QObject::tr("Start");
+const QString trInvalidPattern = QObject::tr("Invalid pattern!");
+const QString trSameConnections = QObject::tr("Source and target should be different connections.");
+const QString trStatsTemplate_6S =
+    QObject::tr("Read: %1 keys (%2 keys/sec), written: %3 keys (%4 keys/sec), queued: %5, skipped: %6");
+const QString trMigrationDone = QObject::tr("Migration finished.");
+const QString trMigrationFailedTemplate_1S = QObject::tr("Migration failed: %1");
+const char* kDefaultPattern = ALL_KEYS_PATTERNS;
+}  // namespace
+
+namespace fastonosql {
+namespace gui {
+
+MigrationDialog::MigrationDialog(const QString& title, const QIcon& icon, QWidget* parent)
+    : base_class(title, parent),
+      connections_(proxy::SettingsManager::GetInstance()->GetConnections()),
+      migration_(),
+      source_label_(nullptr),
+      source_combo_(nullptr),
+      target_label_(nullptr),
+      target_combo_(nullptr),
+      pattern_label_(nullptr),
+      pattern_edit_(nullptr),
+      batch_label_(nullptr),
+      batch_spin_(nullptr),
+      queue_label_(nullptr),
+      queue_spin_(nullptr),
+      rate_label_(nullptr),
+      rate_spin_(nullptr),
+      status_label_(nullptr),
+      start_stop_button_(nullptr) {
+  setWindowIcon(icon);
+
+  source_combo_ = new QComboBox;
+  target_combo_ = new QComboBox;
+  for (size_t i = 0; i < connections_.size(); ++i) {
+    QString qname;
+    if (common::ConvertFromString(connections_[i]->GetPath().ToString(), &qname)) {
+      source_combo_->addItem(qname, static_cast<int>(i));
+      target_combo_->addItem(qname, static_cast<int>(i));
+    }
+  }
+
+  pattern_edit_ = new QLineEdit;
+  pattern_edit_->setText(kDefaultPattern);
+
+  batch_spin_ = new QSpinBox;
+  batch_spin_->setRange(min_batch_size, max_batch_size);
+  batch_spin_->setValue(defaults_batch_size);
+
+  queue_spin_ = new QSpinBox;
+  queue_spin_->setRange(min_batch_size, max_queue_capacity);
+  queue_spin_->setValue(defaults_queue_capacity);
+
+  rate_spin_ = new QSpinBox;
+  rate_spin_->setRange(0, max_keys_per_second);
+  rate_spin_->setValue(0);
+
+  source_label_ = new QLabel;
+  target_label_ = new QLabel;
+  pattern_label_ = new QLabel;
+  batch_label_ = new QLabel;
+  queue_label_ = new QLabel;
+  rate_label_ = new QLabel;
+
+  QGridLayout* settings_layout = new QGridLayout;
+  settings_layout->addWidget(source_label_, 0, 0);
+  settings_layout->addWidget(source_combo_, 0, 1);
+  settings_layout->addWidget(target_label_, 1, 0);
+  settings_layout->addWidget(target_combo_, 1, 1);
+  settings_layout->addWidget(pattern_label_, 2, 0);
+  settings_layout->addWidget(pattern_edit_, 2, 1);
+  settings_layout->addWidget(batch_label_, 3, 0);
+  settings_layout->addWidget(batch_spin_, 3, 1);
+  settings_layout->addWidget(queue_label_, 4, 0);
+  settings_layout->addWidget(queue_spin_, 4, 1);
+  settings_layout->addWidget(rate_label_, 5, 0);
+  settings_layout->addWidget(rate_spin_, 5, 1);
+
+  status_label_ = new QLabel;
+  status_label_->setWordWrap(true);
+
+  QDialogButtonBox* button_box = new QDialogButtonBox(QDialogButtonBox::Close);
+  button_box->setOrientation(Qt::Horizontal);
+  start_stop_button_ = button_box->addButton(trStart, QDialogButtonBox::ActionRole);
+  VERIFY(connect(start_stop_button_, &QPushButton::clicked, this, &MigrationDialog::startStop));
+  VERIFY(connect(button_box, &QDialogButtonBox::rejected, this, &MigrationDialog::reject));
+
+  QVBoxLayout* main_layout = new QVBoxLayout;
+  main_layout->addLayout(settings_layout);
+  main_layout->addWidget(status_label_);
+  main_layout->addWidget(button_box);
+  main_layout->setSizeConstraint(QLayout::SetFixedSize);
+  setLayout(main_layout);
+}
+
+MigrationDialog::~MigrationDialog() {
+  closeMigration();
+}
+
+void MigrationDialog::reject() {
+  closeMigration();
+  base_class::reject();
+}
+
+void MigrationDialog::startStop() {
+  if (migration_) {
+    migration_->Stop();
+    return;
+  }
+
+  const QString pattern = pattern_edit_->text();
+  if (pattern.isEmpty()) {
+    QMessageBox::warning(this, translations::trError, trInvalidPattern);
+    pattern_edit_->setFocus();
+    return;
+  }
+
+  proxy::IConnectionSettingsBaseSPtr source = selectedConnection(source_combo_);
+  proxy::IConnectionSettingsBaseSPtr target = selectedConnection(target_combo_);
+  if (!source || !target) {
+    return;
+  }
+
+  if (source == target) {
+    QMessageBox::warning(this, translations::trError, trSameConnections);
+    return;
+  }
+
+  proxy::MigrationOptions options;
+  options.pattern = common::ConvertToString(pattern);
+  options.batch_size = batch_spin_->value();
+  options.queue_capacity = queue_spin_->value();
+  options.keys_per_second = rate_spin_->value();
+
+  migration_ = proxy::ServersManager::GetInstance().CreateMigration(source, target, options);
+  if (!migration_) {
+    return;
+  }
+
+  VERIFY(connect(migration_.get(), &proxy::MigrationJob::Progressed, this, &MigrationDialog::migrationProgressed,
+                 Qt::DirectConnection));
+  VERIFY(connect(migration_.get(), &proxy::MigrationJob::Finished, this, &MigrationDialog::migrationFinished,
+                 Qt::DirectConnection));
+  updateStats(proxy::MigrationStats());
+  syncControls();
+  migration_->Start();
+}
+
+void MigrationDialog::migrationProgressed(const proxy::MigrationStats& stats) {
+  updateStats(stats);
+}
+
+void MigrationDialog::migrationFinished(common::Error err, const proxy::MigrationStats& stats) {
+  updateStats(stats);
+  QString status = status_label_->text() + "\n";
+  if (err) {
+    QString qerror;
+    common::ConvertFromString(err->GetDescription(), &qerror);
+    status += trMigrationFailedTemplate_1S.arg(qerror);
+  } else {
+    status += trMigrationDone;
+  }
+  status_label_->setText(status);
+
+  // job emits from its own slots, release it after return
+  QMetaObject::invokeMethod(this, "closeMigration", Qt::QueuedConnection);
+}
+
+void MigrationDialog::closeMigration() {
+  if (!migration_) {
+    return;
+  }
+
+  VERIFY(disconnect(migration_.get(), Q_NULLPTR, this, Q_NULLPTR));
+  proxy::ServersManager::GetInstance().CloseMigration(migration_);
+  migration_.reset();
+  syncControls();
+}
+
+void MigrationDialog::updateStats(const proxy::MigrationStats& stats) {
+  status_label_->setText(trStatsTemplate_6S.arg(stats.read_keys)
+                             .arg(stats.GetReadRate(), 0, 'f', 1)
+                             .arg(stats.written_keys)
+                             .arg(stats.GetWriteRate(), 0, 'f', 1)
+                             .arg(stats.queued_keys)
+                             .arg(stats.skipped_keys));
+}
+
+void MigrationDialog::syncControls() {
+  const bool running = migration_ != nullptr;
+  start_stop_button_->setText(running ? translations::trStop : trStart);
+  source_combo_->setEnabled(!running);
+  target_combo_->setEnabled(!running);
+  pattern_edit_->setEnabled(!running);
+  batch_spin_->setEnabled(!running);
+  queue_spin_->setEnabled(!running);
+  rate_spin_->setEnabled(!running);
+}
+
+proxy::IConnectionSettingsBaseSPtr MigrationDialog::selectedConnection(QComboBox* box) const {
+  const QVariant data = box->currentData();
+  if (!data.isValid()) {
+    return proxy::IConnectionSettingsBaseSPtr();
+  }
+
+  const size_t index = data.toInt();
+  if (index >= connections_.size()) {
+    return proxy::IConnectionSettingsBaseSPtr();
+  }
+
+  return connections_[index];
+}
+
+void MigrationDialog::retranslateUi() {
+  source_label_->setText(trSource + ":");
+  target_label_->setText(trTarget + ":");
+  pattern_label_->setText(trPattern + ":");
+  batch_label_->setText(trBatchSize + ":");
+  queue_label_->setText(trQueueCapacity + ":");
+  rate_label_->setText(trKeysPerSecond + ":");
+  syncControls();
+  base_class::retranslateUi();
+}
+
+}  // namespace gui
+}  // namespace fastonosql
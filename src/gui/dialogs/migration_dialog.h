@@ -0,0 +1,93 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <common/error.h>
+
+#include "gui/dialogs/base_dialog.h"
+#include "proxy/migration_job.h"
+#include "proxy/settings_manager.h"
+
+class QComboBox;
+class QLabel;
+class QLineEdit;
+class QPushButton;
+class QSpinBox;
+
+namespace fastonosql {
+namespace gui {
+
+class MigrationDialog : public BaseDialog {
+  Q_OBJECT
+
+ public:
+  typedef BaseDialog base_class;
+  template <typename T, typename... Args>
+  friend T* createDialog(Args&&... args);
+
+  enum {
+    min_batch_size = 1,
+    max_batch_size = 100000,
+    defaults_batch_size = 1000,
+    max_queue_capacity = 10000000,
+    defaults_queue_capacity = 10000,
+    max_keys_per_second = 10000000
+  };
+
+  ~MigrationDialog() override;
+
+ public Q_SLOTS:
+  void reject() override;
+
+ private Q_SLOTS:
+  void startStop();
+  void migrationProgressed(const fastonosql::proxy::MigrationStats& stats);
+  void migrationFinished(common::Error err, const fastonosql::proxy::MigrationStats& stats);
+  void closeMigration();
+
+ protected:
+  explicit MigrationDialog(const QString& title, const QIcon& icon, QWidget* parent = Q_NULLPTR);
+
+  void retranslateUi() override;
+
+ private:
+  proxy::IConnectionSettingsBaseSPtr selectedConnection(QComboBox* box) const;
+  void updateStats(const proxy::MigrationStats& stats);
+  void syncControls();
+
+  proxy::SettingsManager::connection_settings_t connections_;
+  proxy::MigrationJobSPtr migration_;
+
+  QLabel* source_label_;
+  QComboBox* source_combo_;
+  QLabel* target_label_;
+  QComboBox* target_combo_;
+  QLabel* pattern_label_;
+  QLineEdit* pattern_edit_;
+  QLabel* batch_label_;
+  QSpinBox* batch_spin_;
+  QLabel* queue_label_;
+  QSpinBox* queue_spin_;
+  QLabel* rate_label_;
+  QSpinBox* rate_spin_;
+  QLabel* status_label_;
+  QPushButton* start_stop_button_;
+};
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -48,6 +48,7 @@ const QString trAutoCheckUpd = QObject::tr("Automatically check for updates");
 const QString trShowAutoCompletion = QObject::tr("Show autocompletion");
 const QString trAutoOpenConsole = QObject::tr("Automatically open console");
 const QString trAutoConnectDb = QObject::tr("Automatically connect to DB");
+const QString trAutoConnectSaved = QObject::tr("Connect saved connections on startup");
 const QString trShowWelcomePage = QObject::tr("Show welcome page");
 const QString trLanguage = QObject::tr("Language");
 const QString trUiStyle = QObject::tr("UI style");
@@ -100,6 +101,7 @@ PreferencesDialog::PreferencesDialog(QWidget* parent)
       log_dir_path_(nullptr),
       auto_open_console_(nullptr),
       auto_connect_db_(nullptr),
+      auto_connect_saved_(nullptr),
       show_welcome_page_(nullptr),
       external_box_(nullptr),
       python_path_widget_(nullptr),
@@ -146,6 +148,7 @@ void PreferencesDialog::accept() {
   proxy::SettingsManager::GetInstance()->SetLoggingDirectory(log_dir_path_->text());
   proxy::SettingsManager::GetInstance()->SetAutoOpenConsole(auto_open_console_->isChecked());
   proxy::SettingsManager::GetInstance()->SetAutoConnectDB(auto_connect_db_->isChecked());
+  proxy::SettingsManager::GetInstance()->SetAutoConnectSavedConnections(auto_connect_saved_->isChecked());
   proxy::SettingsManager::GetInstance()->SetShowWelcomePage(show_welcome_page_->isChecked());
   proxy::SettingsManager::GetInstance()->SetPythonPath(python_path_widget_->path());
 
@@ -167,6 +170,7 @@ void PreferencesDialog::syncWithSettings() {
   log_dir_path_->setText(proxy::SettingsManager::GetInstance()->GetLoggingDirectory());
   auto_open_console_->setChecked(proxy::SettingsManager::GetInstance()->AutoOpenConsole());
   auto_connect_db_->setChecked(proxy::SettingsManager::GetInstance()->GetAutoConnectDB());
+  auto_connect_saved_->setChecked(proxy::SettingsManager::GetInstance()->GetAutoConnectSavedConnections());
   show_welcome_page_->setChecked(proxy::SettingsManager::GetInstance()->GetShowWelcomePage());
   QString python_path = proxy::SettingsManager::GetInstance()->GetPythonPath();
   python_path_widget_->setPath(python_path);
@@ -259,41 +263,44 @@ QWidget* PreferencesDialog::createMainTab() {
   auto_connect_db_ = new QCheckBox;
   general_layout->addWidget(auto_connect_db_, 2, 1);
 
+  auto_connect_saved_ = new QCheckBox;
+  general_layout->addWidget(auto_connect_saved_, 3, 0);
+
   styles_label_ = new QLabel;
   styles_combo_box_ = new QComboBox;
   styles_combo_box_->addItems(common::qt::gui::supportedStyles());
-  general_layout->addWidget(styles_label_, 3, 0);
-  general_layout->addWidget(styles_combo_box_, 3, 1);
+  general_layout->addWidget(styles_label_, 4, 0);
+  general_layout->addWidget(styles_combo_box_, 4, 1);
 
   font_label_ = new QLabel;
   font_combo_box_ = new QFontComboBox;
   font_combo_box_->setEditable(false);
   font_size_spin_box_ = new QSpinBox;
-  general_layout->addWidget(font_label_, 4, 0);
+  general_layout->addWidget(font_label_, 5, 0);
   // fontLayout->addWidget(new QSplitter(Qt::Horizontal));
   QHBoxLayout* l = new QHBoxLayout;
   l->addWidget(font_combo_box_);
   l->addWidget(font_size_spin_box_);
-  general_layout->addLayout(l, 4, 1);
+  general_layout->addLayout(l, 5, 1);
 
   languages_label_ = new QLabel;
-  general_layout->addWidget(languages_label_, 5, 0);
+  general_layout->addWidget(languages_label_, 6, 0);
   languages_combo_box_ = new QComboBox;
   languages_combo_box_->addItems(common::qt::translations::supportedLanguages());
-  general_layout->addWidget(languages_combo_box_, 5, 1);
+  general_layout->addWidget(languages_combo_box_, 6, 1);
 
   default_view_label_ = new QLabel;
   default_view_combo_box_ = new QComboBox;
   for (uint32_t i = 0; i < proxy::g_supported_views_text.size(); ++i) {
     default_view_combo_box_->addItem(proxy::g_supported_views_text[i], i);
   }
-  general_layout->addWidget(default_view_label_, 6, 0);
-  general_layout->addWidget(default_view_combo_box_, 6, 1);
+  general_layout->addWidget(default_view_label_, 7, 0);
+  general_layout->addWidget(default_view_combo_box_, 7, 1);
 
   log_dir_path_ = new QLineEdit;
   log_dir_label_ = new QLabel;
-  general_layout->addWidget(log_dir_label_, 7, 0);
-  general_layout->addWidget(log_dir_path_, 7, 1);
+  general_layout->addWidget(log_dir_label_, 8, 0);
+  general_layout->addWidget(log_dir_path_, 8, 1);
   general_box_->setLayout(general_layout);
 
   // main layout
@@ -339,6 +346,7 @@ void PreferencesDialog::retranslateUi() {
   auto_comletion_->setText(trShowAutoCompletion);
   auto_open_console_->setText(trAutoOpenConsole);
   auto_connect_db_->setText(trAutoConnectDb);
+  auto_connect_saved_->setText(trAutoConnectSaved);
   show_welcome_page_->setText(trShowWelcomePage);
   languages_label_->setText(trLanguage + ":");
   styles_label_->setText(trUiStyle + ":");
@@ -36,12 +36,18 @@
 #include "gui/models/items/channel_table_item.h"
 #include "gui/views/fasto_table_view.h"
 
+#if defined(BUILD_WITH_REDIS)
+#include "gui/db/redis/pub_sub_console_dialog.h"
+#endif
+
 #include "translations/global.h"
 
 namespace {
 const QString trPublishToChannel_1S = QObject::tr("Publish to channel %1");
 const QString trEnterWhatYoWantToSend = QObject::tr("Enter what you want to send:");
 const QString trSubscribeInNewConsole = QObject::tr("Subscribe in new console");
+const QString trSubscribeInSubscriberConsole = QObject::tr("Subscribe in subscriber console");
+const QString trSubscriberConsoleTemplate_1S = QObject::tr("Subscriber console of %1");
 }  // namespace
 
 namespace fastonosql {
@@ -145,6 +151,13 @@ void PubSubDialog::showContextMenu(const QPoint& point) {
 
   menu->addAction(publish_action);
   menu->addAction(subscribe_action);
+#if defined(BUILD_WITH_REDIS)
+  if (server_->GetType() == core::REDIS) {
+    QAction* subscriber_console_action = new QAction(trSubscribeInSubscriberConsole, this);
+    VERIFY(connect(subscriber_console_action, &QAction::triggered, this, &PubSubDialog::subscribeInSubscriberConsole));
+    menu->addAction(subscriber_console_action);
+  }
+#endif
   menu->exec(menu_point);
   delete menu;
 }
@@ -209,6 +222,27 @@ void PubSubDialog::subscribeInNewConsole() {
   }
 }
 
+#if defined(BUILD_WITH_REDIS)
+void PubSubDialog::subscribeInSubscriberConsole() {
+  const QModelIndex selected = selectedIndex();
+  if (!selected.isValid()) {
+    return;
+  }
+
+  ChannelTableItem* node = common::qt::item<common::qt::gui::TableItem*, ChannelTableItem*>(selected);
+  if (!node) {
+    DNOTREACHED();
+    return;
+  }
+
+  QString qname;
+  common::ConvertFromBytes(node->channel().GetName().GetHumanReadable(), &qname);
+  auto diag = createDialog<redis::PubSubConsoleDialog>(trSubscriberConsoleTemplate_1S.arg(qname), windowIcon(),
+                                                       server_, qname, this);  // +
+  diag->exec();
+}
+#endif
+
 QModelIndex PubSubDialog::selectedIndex() const {
   const QModelIndexList indexses = channels_table_->selectionModel()->selectedRows();
 
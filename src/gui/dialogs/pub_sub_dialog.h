@@ -58,6 +58,9 @@ class PubSubDialog : public BaseDialog {
   void showContextMenu(const QPoint& point);
   void publish();
   void subscribeInNewConsole();
+#if defined(BUILD_WITH_REDIS)
+  void subscribeInSubscriberConsole();
+#endif
 
  protected:
   explicit PubSubDialog(const QString& title,
@@ -23,6 +23,7 @@
 #include <QApplication>
 #include <QClipboard>
 #include <QFileDialog>
+#include <QFileInfo>
 #include <QHeaderView>
 #include <QInputDialog>
 #include <QKeyEvent>
@@ -32,15 +33,22 @@
 #include <common/convert2string.h>
 
 #include <common/qt/convert2string.h>
+#include <common/qt/logger.h>
 #include <common/qt/utils_qt.h>
 
 #include <common/qt/gui/regexp_input_dialog.h>
 
+#include <fastonosql/core/macros.h>
+
 #include "proxy/cluster/icluster.h"
 #include "proxy/sentinel/isentinel.h"
 #include "proxy/server/iserver_remote.h"
 
 #include "gui/dialogs/clients_monitor_dialog.h"
+#if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
+#include "gui/dialogs/cluster_scan_dialog.h"
+#include "gui/dialogs/fan_out_dialog.h"
+#endif
 #include "gui/dialogs/dbkey_dialog.h"
 #include "gui/dialogs/history_server_dialog.h"
 #include "gui/dialogs/info_server_dialog.h"
@@ -49,10 +57,23 @@
 #include "gui/dialogs/pub_sub_dialog.h"
 #include "gui/dialogs/view_keys_dialog.h"
 
+#if defined(BUILD_WITH_REDIS)
+#include "proxy/db/redis/server.h"
+
+#include "gui/db/redis/pub_sub_console_dialog.h"
+#include "gui/db/redis/rdb_analyzer_dialog.h"
+#include "gui/db/redis/workload_analyzer_dialog.h"
+#if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
+#include "gui/db/redis/cluster_dashboard_dialog.h"
+#endif
+#endif
+
 #include "gui/gui_factory.h"
 #include "gui/models/explorer_tree_model.h"
 #include "gui/models/explorer_tree_sort_filter_proxy_model.h"
 #include "gui/models/items/explorer_tree_item.h"
+#include "gui/output_view_detector.h"
+#include "gui/utils.h"
 
 #include "translations/global.h"
 
@@ -81,6 +102,34 @@ const QString trCreateDatabase_1S = QObject::tr("Create database on %1 server");
 const QString trPropertiesTemplate_1S = QObject::tr("%1 properties");
 const QString trHistoryTemplate_1S = QObject::tr("%1 history");
 const QString trCopyToClipboard = QObject::tr("Copy to clipboard");
+const QString trDumpKeys = QObject::tr("Dump keys...");
+const QString trRestoreKeys = QObject::tr("Restore keys...");
+const QString trDumpKeysTemplate_1S = QObject::tr("Dump keys of %1 server");
+const QString trRestoreKeysTemplate_1S = QObject::tr("Restore keys to %1 server");
+const QString trScanClusterKeys = QObject::tr("Scan keys...");
+const QString trScanClusterKeysTemplate_1S = QObject::tr("Scan keys of %1 cluster");
+const QString trExecuteOnNodes = QObject::tr("Execute on nodes...");
+const QString trExecuteOnNodesTemplate_1S = QObject::tr("Execute on nodes of %1");
+const QString trClusterDashboard = QObject::tr("Dashboard...");
+const QString trClusterDashboardTemplate_1S = QObject::tr("%1 dashboard");
+const QString trKeysPattern = QObject::tr("Keys pattern:");
+const QString trContinueDumpTemplate_1S =
+    QObject::tr("Continue unfinished dump in %1? Otherwise it will be started from the beginning.");
+const QString trFilterForDump = QObject::tr("Dump files (*.fndump)");
+const QString trAnalyzeRdb = QObject::tr("Analyze RDB file...");
+const QString trSubscriberConsole = QObject::tr("Subscriber console...");
+const QString trSubscriberConsoleTemplate_1S = QObject::tr("Subscriber console of %1 server");
+const QString trWorkloadAnalyzer = QObject::tr("Workload analyzer...");
+const QString trWorkloadAnalyzerTemplate_1S = QObject::tr("Workload of %1 server");
+const QString trLiveKeyUpdates = QObject::tr("Live key updates");
+const QString trAnalyzeRdbTemplate_1S = QObject::tr("Memory report of %1");
+const QString trBackupDb = QObject::tr("Backup...");
+const QString trIncrementalBackupDb = QObject::tr("Incremental backup...");
+const QString trOpenBackup = QObject::tr("Open backup...");
+const QString trBackupTemplate_1S = QObject::tr("Backup %1 into new directory");
+const QString trIncrementalBackupTemplate_1S = QObject::tr("Add incremental backup of %1 into directory");
+const QString trOpenBackupTemplate_1S = QObject::tr("Open backup in %1 session");
+const size_t kDumpWorkersCount = 4;
 }  // namespace
 
 namespace fastonosql {
@@ -270,6 +319,26 @@ void ExplorerTreeView::showContextMenu(const QPoint& point) {
       clients_monitor_action->setEnabled(is_connected);
       menu.addAction(clients_monitor_action);
 
+#if defined(BUILD_WITH_REDIS)
+      QAction* subscriber_console_action = new QAction(trSubscriberConsole, this);
+      VERIFY(connect(subscriber_console_action, &QAction::triggered, this, &ExplorerTreeView::viewSubscriberConsole));
+      subscriber_console_action->setEnabled(is_connected);
+      menu.addAction(subscriber_console_action);
+
+      QAction* workload_analyzer_action = new QAction(trWorkloadAnalyzer, this);
+      VERIFY(connect(workload_analyzer_action, &QAction::triggered, this, &ExplorerTreeView::viewWorkloadAnalyzer));
+      workload_analyzer_action->setEnabled(is_connected);
+      menu.addAction(workload_analyzer_action);
+
+      proxy::redis::Server* redis_server = dynamic_cast<proxy::redis::Server*>(server.get());  // +
+      QAction* live_keys_action = new QAction(trLiveKeyUpdates, this);
+      live_keys_action->setCheckable(true);
+      live_keys_action->setChecked(redis_server && redis_server->IsKeyspaceNotificationsActive());
+      VERIFY(connect(live_keys_action, &QAction::toggled, this, &ExplorerTreeView::toggleLiveKeyUpdates));
+      live_keys_action->setEnabled(is_connected && redis_server);
+      menu.addAction(live_keys_action);
+#endif
+
       bool is_local = true;
       bool is_can_remote = server->IsCanRemote();
       if (is_can_remote) {
@@ -286,10 +355,51 @@ void ExplorerTreeView::showContextMenu(const QPoint& point) {
       QAction* import_action = new QAction(translations::trRestore, this);
       VERIFY(connect(import_action, &QAction::triggered, this, &ExplorerTreeView::importServer));
 
-      export_action->setEnabled(!is_connected && is_local);
+      // redis and keydb stream the snapshot over the replication protocol, others copy local files
+      const core::ConnectionType server_type = server->GetType();
+      const bool is_streaming_backup = server_type == core::REDIS || server_type == core::KEYDB;
+      export_action->setEnabled(is_connected && (is_streaming_backup || is_local));
       menu.addAction(export_action);
       import_action->setEnabled(is_connected && is_local);
       menu.addAction(import_action);
+
+      QAction* dump_keys_action = new QAction(trDumpKeys, this);
+      VERIFY(connect(dump_keys_action, &QAction::triggered, this, &ExplorerTreeView::dumpKeys));
+
+      QAction* restore_keys_action = new QAction(trRestoreKeys, this);
+      VERIFY(connect(restore_keys_action, &QAction::triggered, this, &ExplorerTreeView::restoreKeys));
+
+      dump_keys_action->setEnabled(is_connected);
+      menu.addAction(dump_keys_action);
+      restore_keys_action->setEnabled(is_connected);
+      menu.addAction(restore_keys_action);
+
+#if defined(BUILD_WITH_REDIS)
+      QAction* analyze_rdb_action = new QAction(trAnalyzeRdb, this);
+      VERIFY(connect(analyze_rdb_action, &QAction::triggered, this, &ExplorerTreeView::analyzeRdbFile));
+      menu.addAction(analyze_rdb_action);
+#endif
+    }
+
+    const core::ConnectionType type = server->GetType();
+    if (type == core::ROCKSDB || type == core::LEVELDB) {
+      QAction* backup_action = new QAction(trBackupDb, this);
+      VERIFY(connect(backup_action, &QAction::triggered, this, &ExplorerTreeView::backupLocalServer));
+      backup_action->setEnabled(is_connected);
+      menu.addAction(backup_action);
+
+      if (type == core::ROCKSDB) {
+        QAction* incremental_backup_action = new QAction(trIncrementalBackupDb, this);
+        VERIFY(connect(incremental_backup_action, &QAction::triggered, this,
+                       &ExplorerTreeView::incrementalBackupLocalServer));
+        incremental_backup_action->setEnabled(is_connected);
+        menu.addAction(incremental_backup_action);
+      }
+
+      QAction* open_backup_action = new QAction(trOpenBackup, this);
+      VERIFY(connect(open_backup_action, &QAction::triggered, this, &ExplorerTreeView::openLocalBackup));
+      open_backup_action->setEnabled(is_connected);
+      menu.addAction(open_backup_action);
     }
 
     QAction* history_server_action = new QAction(translations::trHistory, this);
@@ -455,6 +565,20 @@ void ExplorerTreeView::showContextMenu(const QPoint& point) {
     VERIFY(connect(close_cluster_action, &QAction::triggered, this, &ExplorerTreeView::closeClusterConnection));
     menu.addAction(close_cluster_action);
 
+    QAction* scan_keys_action = new QAction(trScanClusterKeys, this);
+    VERIFY(connect(scan_keys_action, &QAction::triggered, this, &ExplorerTreeView::scanClusterKeys));
+    menu.addAction(scan_keys_action);
+
+    QAction* execute_on_nodes_action = new QAction(trExecuteOnNodes, this);
+    VERIFY(connect(execute_on_nodes_action, &QAction::triggered, this, &ExplorerTreeView::executeOnNodes));
+    menu.addAction(execute_on_nodes_action);
+
+#if defined(BUILD_WITH_REDIS)
+    QAction* dashboard_action = new QAction(trClusterDashboard, this);
+    VERIFY(connect(dashboard_action, &QAction::triggered, this, &ExplorerTreeView::viewClusterDashboard));
+    menu.addAction(dashboard_action);
+#endif
+
     QAction* copy_to_clipboard_action = new QAction(trCopyToClipboard, this);
     VERIFY(connect(copy_to_clipboard_action, &QAction::triggered, this, &ExplorerTreeView::copyToClipboard));
     menu.addAction(copy_to_clipboard_action);
@@ -465,6 +589,10 @@ void ExplorerTreeView::showContextMenu(const QPoint& point) {
     VERIFY(connect(close_sentinel_action, &QAction::triggered, this, &ExplorerTreeView::closeSentinelConnection));
     menu.addAction(close_sentinel_action);
 
+    QAction* execute_on_nodes_action = new QAction(trExecuteOnNodes, this);
+    VERIFY(connect(execute_on_nodes_action, &QAction::triggered, this, &ExplorerTreeView::executeOnNodes));
+    menu.addAction(execute_on_nodes_action);
+
     QAction* copy_to_clipboard_action = new QAction(trCopyToClipboard, this);
     VERIFY(connect(copy_to_clipboard_action, &QAction::triggered, this, &ExplorerTreeView::copyToClipboard));
     menu.addAction(copy_to_clipboard_action);
@@ -686,6 +814,83 @@ void ExplorerTreeView::closeClusterConnection() {
   }
 }
 
+void ExplorerTreeView::scanClusterKeys() {
+  QModelIndexList selected = selectedEqualTypeIndexes();
+  for (QModelIndex ind : selected) {
+    ExplorerClusterItem* cnode = common::qt::item<common::qt::gui::TreeItem*, ExplorerClusterItem*>(ind);
+    if (!cnode) {
+      DNOTREACHED();
+      continue;
+    }
+
+    proxy::IClusterSPtr cluster = cnode->cluster();
+    if (!cluster) {
+      continue;
+    }
+
+    auto diag = createDialog<ClusterScanDialog>(trScanClusterKeysTemplate_1S.arg(cnode->name()),
+                                                GuiFactory::GetInstance().clusterIcon(), cluster, this);  // +
+    diag->exec();
+  }
+}
+
+#if defined(BUILD_WITH_REDIS)
+void ExplorerTreeView::viewClusterDashboard() {
+  QModelIndexList selected = selectedEqualTypeIndexes();
+  for (QModelIndex ind : selected) {
+    ExplorerClusterItem* cnode = common::qt::item<common::qt::gui::TreeItem*, ExplorerClusterItem*>(ind);
+    if (!cnode) {
+      DNOTREACHED();
+      continue;
+    }
+
+    proxy::IClusterSPtr cluster = cnode->cluster();
+    if (!cluster) {
+      continue;
+    }
+
+    auto diag = createDialog<redis::ClusterDashboardDialog>(trClusterDashboardTemplate_1S.arg(cnode->name()),
+                                                            GuiFactory::GetInstance().clusterIcon(), cluster,
+                                                            this);  // +
+    diag->exec();
+  }
+}
+#endif
+
+void ExplorerTreeView::executeOnNodes() {
+  QModelIndexList selected = selectedEqualTypeIndexes();
+  for (QModelIndex ind : selected) {
+    IExplorerTreeItem* node = common::qt::item<common::qt::gui::TreeItem*, IExplorerTreeItem*>(ind);
+    if (!node) {
+      DNOTREACHED();
+      continue;
+    }
+
+    proxy::FanOutExecution::nodes_t nodes;
+    QIcon icon;
+    if (node->type() == IExplorerTreeItem::eCluster) {
+      proxy::IClusterSPtr cluster = static_cast<ExplorerClusterItem*>(node)->cluster();
+      if (cluster) {
+        nodes = cluster->GetNodes();
+      }
+      icon = GuiFactory::GetInstance().clusterIcon();
+    } else if (node->type() == IExplorerTreeItem::eSentinel) {
+      proxy::ISentinelSPtr sentinel = static_cast<ExplorerSentinelItem*>(node)->sentinel();
+      if (sentinel) {
+        nodes = sentinel->GetNodes();
+      }
+      icon = GuiFactory::GetInstance().sentinelIcon();
+    }
+
+    if (nodes.empty()) {
+      continue;
+    }
+
+    auto diag = createDialog<FanOutDialog>(trExecuteOnNodesTemplate_1S.arg(node->name()), icon, nodes, this);  // +
+    diag->exec();
+  }
+}
+
 void ExplorerTreeView::closeSentinelConnection() {
   QModelIndexList selected = selectedEqualTypeIndexes();
   for (QModelIndex ind : selected) {
@@ -720,6 +925,68 @@ void ExplorerTreeView::viewPubSub() {
   }
 }
 
+#if defined(BUILD_WITH_REDIS)
+void ExplorerTreeView::viewSubscriberConsole() {
+  QModelIndexList selected = selectedEqualTypeIndexes();
+  for (QModelIndex ind : selected) {
+    ExplorerServerItem* node = common::qt::item<common::qt::gui::TreeItem*, ExplorerServerItem*>(ind);
+    if (!node) {
+      DNOTREACHED();
+      continue;
+    }
+
+    proxy::IServerSPtr server = node->server();
+    auto diag = createDialog<redis::PubSubConsoleDialog>(trSubscriberConsoleTemplate_1S.arg(node->name()),
+                                                         GuiFactory::GetInstance().icon(server->GetType()), server,
+                                                         QString(), this);  // +
+    diag->exec();
+  }
+}
+
+void ExplorerTreeView::viewWorkloadAnalyzer() {
+  QModelIndexList selected = selectedEqualTypeIndexes();
+  for (QModelIndex ind : selected) {
+    ExplorerServerItem* node = common::qt::item<common::qt::gui::TreeItem*, ExplorerServerItem*>(ind);
+    if (!node) {
+      DNOTREACHED();
+      continue;
+    }
+
+    proxy::IServerSPtr server = node->server();
+    auto diag = createDialog<redis::WorkloadAnalyzerDialog>(trWorkloadAnalyzerTemplate_1S.arg(node->name()),
+                                                            GuiFactory::GetInstance().icon(server->GetType()), server,
+                                                            this);  // +
+    diag->exec();
+  }
+}
+
+void ExplorerTreeView::toggleLiveKeyUpdates(bool checked) {
+  QModelIndexList selected = selectedEqualTypeIndexes();
+  for (QModelIndex ind : selected) {
+    ExplorerServerItem* node = common::qt::item<common::qt::gui::TreeItem*, ExplorerServerItem*>(ind);
+    if (!node) {
+      DNOTREACHED();
+      continue;
+    }
+
+    proxy::redis::Server* server = dynamic_cast<proxy::redis::Server*>(node->server().get());  // +
+    if (!server) {
+      continue;
+    }
+
+    if (!checked) {
+      server->StopKeyspaceNotifications();
+      continue;
+    }
+
+    common::Error err = server->StartKeyspaceNotifications();
+    if (err) {
+      LOG_ERROR(err, common::logging::LOG_LEVEL_ERR, true);
+    }
+  }
+}
+#endif
+
 void ExplorerTreeView::viewClientsMonitor() {
   QModelIndexList selected = selectedEqualTypeIndexes();
   for (QModelIndex ind : selected) {
@@ -752,10 +1019,10 @@ void ExplorerTreeView::importServer() {
     }
 
     QString filepath =
-        QFileDialog::getOpenFileName(this, translations::trBackup, QString(), translations::trfilterForRdb);
+        QFileDialog::getOpenFileName(this, translations::trRestore, QString(), translations::trfilterForRdb);
     if (!filepath.isEmpty()) {
-      proxy::events_info::BackupInfoRequest req(this, common::ConvertToString(filepath));
-      server->BackupToPath(req);
+      proxy::events_info::RestoreInfoRequest req(this, common::ConvertToString(filepath));
+      server->RestoreFromPath(req);
     }
   }
 }
@@ -776,14 +1043,191 @@ void ExplorerTreeView::exportServer() {
     }
 
     QString filepath =
-        QFileDialog::getOpenFileName(this, translations::trRestore, QString(), translations::trfilterForRdb);
+        QFileDialog::getSaveFileName(this, translations::trBackup, QString(), translations::trfilterForRdb);
     if (!filepath.isEmpty()) {
-      proxy::events_info::RestoreInfoRequest req(this, common::ConvertToString(filepath));
-      server->RestoreFromPath(req);
+      proxy::events_info::BackupInfoRequest req(this, common::ConvertToString(filepath));
+      server->BackupToPath(req);
     }
   }
 }
 
+void ExplorerTreeView::dumpKeys() {
+  QModelIndexList selected = selectedEqualTypeIndexes();
+  for (QModelIndex ind : selected) {
+    ExplorerServerItem* node = common::qt::item<common::qt::gui::TreeItem*, ExplorerServerItem*>(ind);
+    if (!node) {
+      DNOTREACHED();
+      continue;
+    }
+
+    proxy::IServerSPtr server = node->server();
+    if (!server) {
+      DNOTREACHED();
+      break;
+    }
+
+    const QString title = trDumpKeysTemplate_1S.arg(node->name());
+    bool ok;
+    const QString pattern =
+        QInputDialog::getText(this, title, trKeysPattern, QLineEdit::Normal, ALL_KEYS_PATTERNS, &ok);
+    if (!ok || pattern.isEmpty()) {
+      continue;
+    }
+
+    const QString filepath = showSaveFileDialog(this, title, QString(), trFilterForDump);
+    if (filepath.isEmpty()) {
+      continue;
+    }
+
+    bool resume = false;
+    if (QFileInfo::exists(filepath)) {
+      const int answer = QMessageBox::question(this, title, trContinueDumpTemplate_1S.arg(filepath), QMessageBox::Yes,
+                                               QMessageBox::No, QMessageBox::NoButton);
+      resume = answer == QMessageBox::Yes;
+    }
+
+    proxy::events_info::DumpKeysRequest req(this, common::ConvertToString(filepath), common::ConvertToString(pattern),
+                                            kDumpWorkersCount, resume);
+    server->DumpKeys(req);
+  }
+}
+
+void ExplorerTreeView::restoreKeys() {
+  QModelIndexList selected = selectedEqualTypeIndexes();
+  for (QModelIndex ind : selected) {
+    ExplorerServerItem* node = common::qt::item<common::qt::gui::TreeItem*, ExplorerServerItem*>(ind);
+    if (!node) {
+      DNOTREACHED();
+      continue;
+    }
+
+    proxy::IServerSPtr server = node->server();
+    if (!server) {
+      DNOTREACHED();
+      break;
+    }
+
+    const QString filepath =
+        QFileDialog::getOpenFileName(this, trRestoreKeysTemplate_1S.arg(node->name()), QString(), trFilterForDump);
+    if (filepath.isEmpty()) {
+      continue;
+    }
+
+    // interrupted restore continues after its last completed chunk, RESTORE ... REPLACE keeps repeats harmless
+    proxy::events_info::RestoreKeysRequest req(this, common::ConvertToString(filepath), kDumpWorkersCount, true);
+    server->RestoreKeys(req);
+  }
+}
+
+#if defined(BUILD_WITH_REDIS)
+void ExplorerTreeView::analyzeRdbFile() {
+  QModelIndexList selected = selectedEqualTypeIndexes();
+  for (QModelIndex ind : selected) {
+    ExplorerServerItem* node = common::qt::item<common::qt::gui::TreeItem*, ExplorerServerItem*>(ind);
+    if (!node) {
+      DNOTREACHED();
+      continue;
+    }
+
+    proxy::IServerSPtr server = node->server();
+    if (!server) {
+      DNOTREACHED();
+      break;
+    }
+
+    const QString filepath = QFileDialog::getOpenFileName(this, trAnalyzeRdb, QString(), translations::trfilterForRdb);
+    if (filepath.isEmpty()) {
+      continue;
+    }
+
+    // file is parsed offline, server only provides namespace separator
+    auto diag = createDialog<redis::RdbAnalyzerDialog>(trAnalyzeRdbTemplate_1S.arg(QFileInfo(filepath).fileName()),
+                                                       GuiFactory::GetInstance().icon(server->GetType()),
+                                                       common::ConvertToString(filepath), server->GetNsSeparator(),
+                                                       this);  // +
+    diag->exec();
+  }
+}
+#endif
+
+void ExplorerTreeView::backupLocalServer() {
+  QModelIndexList selected = selectedEqualTypeIndexes();
+  for (QModelIndex ind : selected) {
+    ExplorerServerItem* node = common::qt::item<common::qt::gui::TreeItem*, ExplorerServerItem*>(ind);
+    if (!node) {
+      DNOTREACHED();
+      continue;
+    }
+
+    proxy::IServerSPtr server = node->server();
+    if (!server) {
+      DNOTREACHED();
+      break;
+    }
+
+    // rocksdb checkpoint or leveldb snapshot copy, both create the directory themselves
+    const QString dirpath = showSaveFileDialog(this, trBackupTemplate_1S.arg(node->name()), QString(), QString());
+    if (dirpath.isEmpty()) {
+      continue;
+    }
+
+    proxy::events_info::BackupInfoRequest req(this, common::ConvertToString(dirpath));
+    server->BackupToPath(req);
+  }
+}
+
+void ExplorerTreeView::incrementalBackupLocalServer() {
+  QModelIndexList selected = selectedEqualTypeIndexes();
+  for (QModelIndex ind : selected) {
+    ExplorerServerItem* node = common::qt::item<common::qt::gui::TreeItem*, ExplorerServerItem*>(ind);
+    if (!node) {
+      DNOTREACHED();
+      continue;
+    }
+
+    proxy::IServerSPtr server = node->server();
+    if (!server) {
+      DNOTREACHED();
+      break;
+    }
+
+    const QString dirpath =
+        QFileDialog::getExistingDirectory(this, trIncrementalBackupTemplate_1S.arg(node->name()), QString());
+    if (dirpath.isEmpty()) {
+      continue;
+    }
+
+    proxy::events_info::BackupInfoRequest req(this, common::ConvertToString(dirpath), true);
+    server->BackupToPath(req);
+  }
+}
+
+void ExplorerTreeView::openLocalBackup() {
+  QModelIndexList selected = selectedEqualTypeIndexes();
+  for (QModelIndex ind : selected) {
+    ExplorerServerItem* node = common::qt::item<common::qt::gui::TreeItem*, ExplorerServerItem*>(ind);
+    if (!node) {
+      DNOTREACHED();
+      continue;
+    }
+
+    proxy::IServerSPtr server = node->server();
+    if (!server) {
+      DNOTREACHED();
+      break;
+    }
+
+    const QString dirpath =
+        QFileDialog::getExistingDirectory(this, trOpenBackupTemplate_1S.arg(node->name()), QString());
+    if (dirpath.isEmpty()) {
+      continue;
+    }
+
+    proxy::events_info::RestoreInfoRequest req(this, common::ConvertToString(dirpath));
+    server->RestoreFromPath(req);
+  }
+}
+
 void ExplorerTreeView::loadContentDb() {
   QModelIndexList selected = selectedEqualTypeIndexes();
   for (QModelIndex ind : selected) {
@@ -886,7 +1330,7 @@ void ExplorerTreeView::addKeyToBranch() {
     const auto inf = server->GetCurrentServerInfo();
     auto loadDb =
         createDialog<DbKeyDialog>(trCreateKeyForDbTemplate_1S.arg(node_db->name()), GuiFactory::GetInstance().keyIcon(),
-                                  server->GetSupportedValueTypes(inf->GetVersion()), nkey, false, this);  // +
+                                  server->GetSupportedValueTypes(inf->GetVersion()), nkey, false, server, this);  // +
     int result = loadDb->exec();
     if (result == QDialog::Accepted) {
       core::NDbKValue key = loadDb->key();
@@ -944,7 +1388,7 @@ void ExplorerTreeView::createKey() {
     const auto inf = server->GetCurrentServerInfo();
     auto loadDb =
         createDialog<DbKeyDialog>(trCreateKeyForDbTemplate_1S.arg(node->name()), GuiFactory::GetInstance().keyIcon(),
-                                  server->GetSupportedValueTypes(inf->GetVersion()), dbv, false, this);  // +
+                                  server->GetSupportedValueTypes(inf->GetVersion()), dbv, false, server, this);  // +
     int result = loadDb->exec();
     if (result == QDialog::Accepted) {
       core::NDbKValue key = loadDb->key();
@@ -966,9 +1410,18 @@ void ExplorerTreeView::editKey() {
     const auto inf = server->GetCurrentServerInfo();
     auto loadDb =
         createDialog<DbKeyDialog>(trEditKey_1S.arg(node->name()), GuiFactory::GetInstance().keyIcon(),
-                                  server->GetSupportedValueTypes(inf->GetVersion()), node->dbv(), true, this);  // +
+                                  server->GetSupportedValueTypes(inf->GetVersion()), node->dbv(), true, server,
+                                  this);  // +
     int result = loadDb->exec();
     if (result == QDialog::Accepted) {
+      proxy::KeyChangeSet changes;
+      if (loadDb->valueChanges(&changes)) {
+        if (!changes.IsEmpty()) {
+          node->changeValue(changes);
+        }
+        continue;
+      }
+
       core::NDbKValue key = loadDb->key();
       node->editValue(key.GetValue());
     }
@@ -1129,6 +1582,48 @@ void ExplorerTreeView::removeTTL() {
   }
 }
 
+void ExplorerTreeView::startConnect(const proxy::events_info::ConnectInfoRequest& req) {
+  UNUSED(req);
+
+  proxy::IServer* serv = qobject_cast<proxy::IServer*>(sender());
+  CHECK(serv);
+  source_model_->setServerConnectionState(serv, ExplorerServerItem::eConnecting);
+}
+
+void ExplorerTreeView::finishConnect(const proxy::events_info::ConnectInfoResponse& res) {
+  proxy::IServer* serv = qobject_cast<proxy::IServer*>(sender());
+  CHECK(serv);
+
+  common::Error err = res.errorInfo();
+  if (err) {
+    QString qerror;
+    common::ConvertFromString(err->GetDescription(), &qerror);
+    source_model_->setServerConnectionState(serv, ExplorerServerItem::eFailed, qerror);
+    return;
+  }
+
+  source_model_->setServerConnectionState(serv, ExplorerServerItem::eConnected);
+}
+
+void ExplorerTreeView::finishDisconnect(const proxy::events_info::DisConnectInfoResponse& res) {
+  UNUSED(res);
+
+  proxy::IServer* serv = qobject_cast<proxy::IServer*>(sender());
+  CHECK(serv);
+  source_model_->setServerConnectionState(serv, ExplorerServerItem::eIdle);
+}
+
+void ExplorerTreeView::changeHealth(const proxy::ConnectionHealthInfo& info) {
+  proxy::IServer* serv = qobject_cast<proxy::IServer*>(sender());
+  CHECK(serv);
+
+  if (info.state == proxy::ConnectionHealthInfo::RECONNECTING) {
+    source_model_->setServerConnectionState(serv, ExplorerServerItem::eConnecting);
+  } else if (info.state == proxy::ConnectionHealthInfo::HEALTHY) {
+    source_model_->setServerConnectionState(serv, ExplorerServerItem::eConnected);
+  }
+}
+
 void ExplorerTreeView::startLoadDatabases(const proxy::events_info::LoadDatabasesInfoRequest& req) {
   UNUSED(req);
 }
@@ -1199,6 +1694,7 @@ void ExplorerTreeView::flushDB(core::IDataBaseInfoSPtr db) {
   proxy::IServer* serv = qobject_cast<proxy::IServer*>(sender());
   CHECK(serv);
 
+  OutputViewCache::GetInstance().removeDatabase(serv->GetPath(), db ? db->GetName() : std::string());
   source_model_->removeAllKeys(serv, db);
 }
 
@@ -1214,6 +1710,7 @@ void ExplorerTreeView::removeKey(core::IDataBaseInfoSPtr db, core::NKey key) {
   proxy::IServer* serv = qobject_cast<proxy::IServer*>(sender());
   CHECK(serv);
 
+  forgetKeyView(serv, db, key);
   source_model_->removeKey(serv, db, key);
 }
 
@@ -1223,6 +1720,8 @@ void ExplorerTreeView::addKey(core::IDataBaseInfoSPtr db, core::NDbKValue key) {
     return;
   }
 
+  // value was written, its format may differ from the detected one
+  forgetKeyView(serv, db, key.GetKey());
   const std::string ns = serv->GetNsSeparator();
   const proxy::NsDisplayStrategy ns_strategy = serv->GetNsDisplayStrategy();
   source_model_->addKey(serv, db, key, ns, ns_strategy);
@@ -1236,11 +1735,19 @@ void ExplorerTreeView::renameKey(core::IDataBaseInfoSPtr db, core::NKey key, cor
 
   core::NKey new_key = key;
   new_key.SetKey(new_name);
+  forgetKeyView(serv, db, key);
+  forgetKeyView(serv, db, new_key);
   const std::string ns = serv->GetNsSeparator();
   const proxy::NsDisplayStrategy ns_strategy = serv->GetNsDisplayStrategy();
   source_model_->renameKey(serv, db, key, new_key, ns, ns_strategy);
 }
 
+void ExplorerTreeView::forgetKeyView(proxy::IServer* server, core::IDataBaseInfoSPtr db, const core::NKey& key) {
+  const std::string db_name = db ? db->GetName() : std::string();
+  const auto view_key = OutputViewCache::makeKey(server->GetPath(), db_name, key.GetKey().GetForCommandLine());
+  OutputViewCache::GetInstance().remove(view_key);
+}
+
 void ExplorerTreeView::loadKey(core::IDataBaseInfoSPtr db, core::NDbKValue key) {
   proxy::IServer* serv = qobject_cast<proxy::IServer*>(sender());
   CHECK(serv);
@@ -1282,6 +1789,12 @@ void ExplorerTreeView::syncWithServer(proxy::IServer* server) {
     return;
   }
 
+  VERIFY(connect(server, &proxy::IServer::ConnectStarted, this, &ExplorerTreeView::startConnect));
+  VERIFY(connect(server, &proxy::IServer::ConnectFinished, this, &ExplorerTreeView::finishConnect));
+  VERIFY(connect(server, &proxy::IServer::DisconnectFinished, this, &ExplorerTreeView::finishDisconnect));
+  if (proxy::IServerRemote* rserver = qobject_cast<proxy::IServerRemote*>(server)) {
+    VERIFY(connect(rserver, &proxy::IServerRemote::HealthChanged, this, &ExplorerTreeView::changeHealth));
+  }
   VERIFY(connect(server, &proxy::IServer::LoadDatabasesStarted, this, &ExplorerTreeView::startLoadDatabases));
   VERIFY(connect(server, &proxy::IServer::LoadDatabasesFinished, this, &ExplorerTreeView::finishLoadDatabases));
   VERIFY(
@@ -1308,6 +1821,12 @@ void ExplorerTreeView::unsyncWithServer(proxy::IServer* server) {
     return;
   }
 
+  VERIFY(disconnect(server, &proxy::IServer::ConnectStarted, this, &ExplorerTreeView::startConnect));
+  VERIFY(disconnect(server, &proxy::IServer::ConnectFinished, this, &ExplorerTreeView::finishConnect));
+  VERIFY(disconnect(server, &proxy::IServer::DisconnectFinished, this, &ExplorerTreeView::finishDisconnect));
+  if (proxy::IServerRemote* rserver = qobject_cast<proxy::IServerRemote*>(server)) {
+    VERIFY(disconnect(rserver, &proxy::IServerRemote::HealthChanged, this, &ExplorerTreeView::changeHealth));
+  }
   VERIFY(disconnect(server, &proxy::IServer::LoadDatabasesStarted, this, &ExplorerTreeView::startLoadDatabases));
   VERIFY(disconnect(server, &proxy::IServer::LoadDatabasesFinished, this, &ExplorerTreeView::finishLoadDatabases));
   VERIFY(disconnect(server, &proxy::IServer::LoadDataBaseContentStarted, this,
@@ -20,6 +20,7 @@
 
 #include <QTreeView>
 
+#include "proxy/driver/connection_health.h"
 #include "proxy/events/events_info.h"
 #include "proxy/proxy_fwd.h"
 
@@ -75,11 +76,24 @@ class ExplorerTreeView : public QTreeView {
   void closeServerConnection();
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
   void closeClusterConnection();
+  void scanClusterKeys();
+  void executeOnNodes();
+#if defined(BUILD_WITH_REDIS)
+  void viewClusterDashboard();
+#endif
   void closeSentinelConnection();
 #endif
 
   void importServer();
   void exportServer();
+  void dumpKeys();
+  void restoreKeys();
+#if defined(BUILD_WITH_REDIS)
+  void analyzeRdbFile();
+#endif
+  void backupLocalServer();
+  void incrementalBackupLocalServer();
+  void openLocalBackup();
 
   void loadContentDb();
   void removeAllKeys();
@@ -94,6 +108,11 @@ class ExplorerTreeView : public QTreeView {
   void viewKeys();
   void viewPubSub();
   void viewClientsMonitor();
+#if defined(BUILD_WITH_REDIS)
+  void viewSubscriberConsole();
+  void viewWorkloadAnalyzer();
+  void toggleLiveKeyUpdates(bool checked);
+#endif
 
   void deleteItem();  // branch or key
 
@@ -105,6 +124,11 @@ class ExplorerTreeView : public QTreeView {
   void setTTL();
   void removeTTL();
 
+  void startConnect(const proxy::events_info::ConnectInfoRequest& req);
+  void finishConnect(const proxy::events_info::ConnectInfoResponse& res);
+  void finishDisconnect(const proxy::events_info::DisConnectInfoResponse& res);
+  void changeHealth(const proxy::ConnectionHealthInfo& info);
+
   void startLoadDatabases(const proxy::events_info::LoadDatabasesInfoRequest& req);
   void finishLoadDatabases(const proxy::events_info::LoadDatabasesInfoResponse& res);
 
@@ -133,6 +157,7 @@ class ExplorerTreeView : public QTreeView {
  private:
   void syncWithServer(proxy::IServer* server);
   void unsyncWithServer(proxy::IServer* server);
+  void forgetKeyView(proxy::IServer* server, core::IDataBaseInfoSPtr db, const core::NKey& key);
 
   void retranslateUi();
   QModelIndexList selectedEqualTypeIndexes() const;
@@ -58,6 +58,7 @@
 #include "gui/dialogs/about_dialog.h"
 #include "gui/dialogs/connections_dialog.h"
 #include "gui/dialogs/encode_decode_dialog.h"
+#include "gui/dialogs/migration_dialog.h"
 #include "gui/dialogs/how_to_use_dialog.h"
 #include "gui/dialogs/preferences_dialog.h"
 #include "gui/explorer/explorer_tree_widget.h"
@@ -190,6 +191,11 @@ MainWindow::MainWindow() : QMainWindow() {
   VERIFY(connect(encode_decode_dialog_action_, &QAction::triggered, this, &MainWindow::openEncodeDecodeDialog));
   tools->addAction(encode_decode_dialog_action_);
 
+  migration_dialog_action_ = new QAction(this);
+  migration_dialog_action_->setIcon(GuiFactory::GetInstance().exportIcon());
+  VERIFY(connect(migration_dialog_action_, &QAction::triggered, this, &MainWindow::openMigrationDialog));
+  tools->addAction(migration_dialog_action_);
+
   // window menu
   QMenu* window = new QMenu(this);
   window_action_ = menuBar()->addMenu(window);
@@ -286,7 +292,12 @@ void MainWindow::showEvent(QShowEvent* ev) {
   if (!statistic_sent) {
     sendStatisticAndCheckVersion();
     statistic_sent = true;
-    QTimer::singleShot(0, this, SLOT(open()));
+    const bool auto_connect = proxy::SettingsManager::GetInstance()->GetAutoConnectSavedConnections();
+    if (auto_connect && !proxy::SettingsManager::GetInstance()->GetConnections().empty()) {
+      QTimer::singleShot(0, this, SLOT(autoConnectSavedConnections()));
+    } else {
+      QTimer::singleShot(0, this, SLOT(open()));
+    }
   }
 }
 
@@ -325,6 +336,24 @@ void MainWindow::open() {
   }
 }
 
+void MainWindow::autoConnectSavedConnections() {
+  proxy::ServersManager::servers_t servers;
+  auto conns = proxy::SettingsManager::GetInstance()->GetConnections();
+  for (auto it = conns.begin(); it != conns.end(); ++it) {
+    auto server = proxy::ServersManager::GetInstance().CreateServer(*it);
+    if (!server) {
+      continue;
+    }
+
+    exp_->addServer(server);
+    servers.push_back(server);
+  }
+
+  // explorer shows state of every connection, discovery and databases wait for node expand
+  auto job = proxy::ServersManager::GetInstance().CreateAutoConnect(servers, proxy::AutoConnectOptions());
+  job->Start();
+}
+
 void MainWindow::about() {
   auto dlg = createDialog<AboutDialog>(this);  // +
   dlg->exec();
@@ -390,6 +419,11 @@ void MainWindow::openEncodeDecodeDialog() {
   dlg->exec();
 }
 
+void MainWindow::openMigrationDialog() {
+  auto dlg = createDialog<MigrationDialog>(translations::trMigrateKeys, GuiFactory::GetInstance().exportIcon(), this);
+  dlg->exec();
+}
+
 void MainWindow::openRecentConnection() {
   QAction* action = qobject_cast<QAction*>(sender());
   if (!action) {
@@ -671,6 +705,7 @@ void MainWindow::retranslateUi() {
   file_action_->setText(translations::trFile);
   tools_action_->setText(translations::trTools);
   encode_decode_dialog_action_->setText(translations::trEncodeDecode);
+  migration_dialog_action_->setText(translations::trMigrateKeys + "...");
   preferences_action_->setText(translations::trPreferences);
   check_update_action_->setText(translations::trCheckUpdate + "...");
   edit_action_->setText(translations::trEdit);
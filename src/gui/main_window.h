@@ -63,6 +63,7 @@ class MainWindow : public QMainWindow {
 
  private Q_SLOTS:
   void open();
+  void autoConnectSavedConnections();
   void about();
   void howToUse();
   void openPreferences();
@@ -71,6 +72,7 @@ class MainWindow : public QMainWindow {
   void reportBug();
   void enterLeaveFullScreen();
   void openEncodeDecodeDialog();
+  void openMigrationDialog();
   void openRecentConnection();
 
   void loadConnection();
@@ -123,6 +125,7 @@ class MainWindow : public QMainWindow {
   QAction* check_update_action_;
   QAction* tools_action_;
   QAction* encode_decode_dialog_action_;
+  QAction* migration_dialog_action_;
   QAction* help_action_;
   QAction* explorer_action_;
   QAction* logs_action_;
@@ -18,6 +18,8 @@
 
 #include "gui/models/clients_table_model.h"
 
+#include <unordered_map>
+
 #include <QIcon>
 
 #include <common/qt/convert2string.h>
@@ -178,6 +180,77 @@ void ClientsTableModel::clear() {
   endResetModel();
 }
 
+void ClientsTableModel::updateClients(const std::vector<proxy::NDbClient>& clients) {
+  std::unordered_map<proxy::NDbClient::id_t, const proxy::NDbClient*> incoming;
+  incoming.reserve(clients.size());
+  for (const proxy::NDbClient& client : clients) {
+    incoming[client.GetId()] = &client;
+  }
+
+  // walk from the end, so pending ranges above current row keep their indexes
+  int changed_last = -1;
+  int removed_last = -1;
+  int row = static_cast<int>(data_.size()) - 1;
+  for (; row >= 0; --row) {
+    ClientTableItem* item = static_cast<ClientTableItem*>(data_[row]);
+    const auto it = incoming.find(item->client().GetId());
+    const bool removed = it == incoming.end();
+    const bool changed = !removed && item->client() != *it->second;
+    if (!changed && changed_last != -1) {
+      emit dataChanged(index(row + 1, 0), index(changed_last, kCountColumns - 1));
+      changed_last = -1;
+    }
+    if (!removed && removed_last != -1) {
+      removeClientRows(row + 1, removed_last);
+      removed_last = -1;
+    }
+
+    if (removed) {
+      if (removed_last == -1) {
+        removed_last = row;
+      }
+      continue;
+    }
+
+    if (changed) {
+      item->setClient(*it->second);
+      if (changed_last == -1) {
+        changed_last = row;
+      }
+    }
+    incoming.erase(it);
+  }
+
+  if (changed_last != -1) {
+    emit dataChanged(index(0, 0), index(changed_last, kCountColumns - 1));
+  }
+  if (removed_last != -1) {
+    removeClientRows(0, removed_last);
+  }
+
+  if (incoming.empty()) {
+    return;
+  }
+
+  const int first = static_cast<int>(data_.size());
+  beginInsertRows(QModelIndex(), first, first + static_cast<int>(incoming.size()) - 1);
+  for (const proxy::NDbClient& client : clients) {  // keep server order for new clients
+    if (incoming.erase(client.GetId())) {
+      data_.push_back(new ClientTableItem(client));
+    }
+  }
+  endInsertRows();
+}
+
+void ClientsTableModel::removeClientRows(int first, int last) {
+  beginRemoveRows(QModelIndex(), first, last);
+  for (int i = first; i <= last; ++i) {
+    delete data_[i];
+  }
+  data_.erase(data_.begin() + first, data_.begin() + last + 1);
+  endRemoveRows();
+}
+
 common::qt::gui::TableItem* ClientsTableModel::findChildById(int iden) const {
   for (size_t i = 0; i < data_.size(); ++i) {
     ClientTableItem* item = static_cast<ClientTableItem*>(data_[i]);
@@ -18,8 +18,12 @@
 
 #pragma once
 
+#include <vector>
+
 #include <common/qt/gui/base/table_model.h>
 
+#include "proxy/db_client.h"
+
 namespace fastonosql {
 namespace gui {
 
@@ -56,8 +60,13 @@ class ClientsTableModel : public common::qt::gui::TableModel {
 
   int columnCount(const QModelIndex& parent) const override;
   void clear();
+  // diffs by client id: only changed rows are repainted, gone and new clients removed/appended
+  void updateClients(const std::vector<proxy::NDbClient>& clients);
 
   common::qt::gui::TableItem* findChildById(int iden) const;
+
+ private:
+  void removeClientRows(int first, int last);
 };
 
 }  // namespace gui
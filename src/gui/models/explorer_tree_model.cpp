@@ -50,6 +50,12 @@ const QString trLocalServerToolTipTemplate_2S = QObject::tr(
     "<b>Name:</b> %1<br/>"
     "<b>Path:</b> %3<br/>");
 const QString trDbToolTipTemplate_1S = QObject::tr("<b>Db size:</b> %1 keys<br/>");
+const QString trStateToolTipTemplate_1S = QObject::tr("<b>State:</b> %1<br/>");
+const QString trLatencyToolTipTemplate_2S = QObject::tr("<b>Latency:</b> %1 ms (last %2 ms)<br/>");
+const QString trStateConnecting = QObject::tr("connecting...");
+const QString trStateConnected = QObject::tr("connected");
+const QString trStateFailedTemplate_1S = QObject::tr("failed, %1");
+const QString trStateDisconnected = QObject::tr("disconnected");
 const QString trNamespace_1S = QObject::tr("<b>Group size:</b> %1 keys<br/>");
 const QString trKey_1S = QObject::tr("Key displayed in: <b>%1</b> format<br/>");
 }  // namespace
@@ -57,6 +63,21 @@ const QString trKey_1S = QObject::tr("Key displayed in: <b>%1</b> format<br/>");
 namespace fastonosql {
 namespace gui {
 
+namespace {
+QString connectionStateText(ExplorerServerItem* server_node) {
+  switch (server_node->connectionState()) {
+    case ExplorerServerItem::eConnecting:
+      return trStateConnecting;
+    case ExplorerServerItem::eConnected:
+      return trStateConnected;
+    case ExplorerServerItem::eFailed:
+      return trStateFailedTemplate_1S.arg(server_node->connectionError());
+    default:
+      return trStateDisconnected;
+  }
+}
+}  // namespace
+
 ExplorerTreeModel::ExplorerTreeModel(QObject* parent) : TreeModel(parent) {}
 
 QVariant ExplorerTreeModel::data(const QModelIndex& index, int role) const {
@@ -77,6 +98,7 @@ QVariant ExplorerTreeModel::data(const QModelIndex& index, int role) const {
     if (type == IExplorerTreeItem::eServer) {
       ExplorerServerItem* server_node = static_cast<ExplorerServerItem*>(node);
       proxy::IServerSPtr server = server_node->server();
+      const QString state = trStateToolTipTemplate_1S.arg(connectionStateText(server_node));
       QString sname;
       common::ConvertFromString(server->GetName(), &sname);
       bool is_can_remote = server->IsCanRemote();
@@ -88,12 +110,17 @@ QVariant ExplorerTreeModel::data(const QModelIndex& index, int role) const {
         common::ConvertFromString(common::ConvertToString(rserver->GetMode()), &mtype);
         QString shost = translations::trCalculate + "...";
         common::ConvertFromString(common::ConvertToString(rserver->GetHost()), &shost);
-        return trRemoteServerToolTipTemplate_4S.arg(sname, stype, mtype, shost);
+        QString latency;
+        const proxy::ConnectionHealthInfo health = rserver->GetHealthInfo();
+        if (health.state == proxy::ConnectionHealthInfo::HEALTHY && health.avg_rtt_msec) {
+          latency = trLatencyToolTipTemplate_2S.arg(health.avg_rtt_msec).arg(health.last_rtt_msec);
+        }
+        return trRemoteServerToolTipTemplate_4S.arg(sname, stype, mtype, shost) + state + latency;
       } else {
         proxy::IServerLocal* lserver = static_cast<proxy::IServerLocal*>(server.get());
         QString spath = translations::trCalculate + "...";
         common::ConvertFromString(lserver->GetPath(), &spath);
-        return trLocalServerToolTipTemplate_2S.arg(sname, spath);
+        return trLocalServerToolTipTemplate_2S.arg(sname, spath) + state;
       }
     } else if (type == IExplorerTreeItem::eDatabase) {
       ExplorerDatabaseItem* db = static_cast<ExplorerDatabaseItem*>(node);
@@ -116,6 +143,11 @@ QVariant ExplorerTreeModel::data(const QModelIndex& index, int role) const {
   if (role == Qt::DecorationRole && col == eName) {
     if (type == IExplorerTreeItem::eServer) {
       ExplorerServerItem* server_node = static_cast<ExplorerServerItem*>(node);
+      if (server_node->connectionState() == ExplorerServerItem::eConnecting) {
+        return GuiFactory::GetInstance().timeIcon();
+      } else if (server_node->connectionState() == ExplorerServerItem::eFailed) {
+        return GuiFactory::GetInstance().failIcon();
+      }
       proxy::IServerSPtr server = server_node->server();
       return GuiFactory::GetInstance().icon(server->GetType());
     } else if (type == IExplorerTreeItem::eKey) {
@@ -205,6 +237,37 @@ int ExplorerTreeModel::columnCount(const QModelIndex& parent) const {
   return eCountColumns;
 }
 
+bool ExplorerTreeModel::hasChildren(const QModelIndex& parent) const {
+  if (canFetchMore(parent)) {
+    return true;
+  }
+
+  return base_class::hasChildren(parent);
+}
+
+bool ExplorerTreeModel::canFetchMore(const QModelIndex& parent) const {
+  if (!parent.isValid()) {
+    return false;
+  }
+
+  IExplorerTreeItem* node = common::qt::item<common::qt::gui::TreeItem*, IExplorerTreeItem*>(parent);
+  if (!node || node->type() != IExplorerTreeItem::eServer) {
+    return false;
+  }
+
+  ExplorerServerItem* server_node = static_cast<ExplorerServerItem*>(node);
+  return server_node->server()->IsDiscoveryDeferred();
+}
+
+void ExplorerTreeModel::fetchMore(const QModelIndex& parent) {
+  if (!canFetchMore(parent)) {
+    return;
+  }
+
+  ExplorerServerItem* server_node = common::qt::item<common::qt::gui::TreeItem*, ExplorerServerItem*>(parent);
+  server_node->loadDatabases();
+}
+
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
 void ExplorerTreeModel::addCluster(proxy::IClusterSPtr cluster) {
   if (!cluster) {
@@ -248,6 +311,20 @@ void ExplorerTreeModel::addServer(proxy::IServerSPtr server) {
   }
 }
 
+void ExplorerTreeModel::setServerConnectionState(proxy::IServer* server,
+                                                 ExplorerServerItem::eConnectionState state,
+                                                 const QString& error) {
+  ExplorerServerItem* server_item = findServerItem(server);
+  if (!server_item) {
+    return;
+  }
+
+  server_item->setConnectionState(state, error);
+  common::qt::gui::TreeItem* parent = server_item->parent();
+  const int row = parent->indexOf(server_item);
+  updateItem(createIndex(row, eName, server_item), createIndex(row, eCountColumns - 1, server_item));
+}
+
 void ExplorerTreeModel::removeServer(proxy::IServerSPtr server) {
   if (!server) {
     return;
@@ -27,19 +27,11 @@
 #include "proxy/proxy_fwd.h"
 #include "proxy/types.h"
 
+#include "gui/models/items/explorer_tree_item.h"
+
 namespace fastonosql {
 namespace gui {
 
-#if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
-class ExplorerClusterItem;
-class ExplorerSentinelItem;
-#endif
-class ExplorerServerItem;
-class ExplorerDatabaseItem;
-class ExplorerKeyItem;
-class ExplorerNSItem;
-class IExplorerTreeItem;
-
 class ExplorerTreeModel : public common::qt::gui::TreeModel {
   Q_OBJECT
 
@@ -54,6 +46,11 @@ class ExplorerTreeModel : public common::qt::gui::TreeModel {
   QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
   int columnCount(const QModelIndex& parent) const override;
 
+  // server connected with deferred discovery loads it together with databases on first expand
+  bool hasChildren(const QModelIndex& parent) const override;
+  bool canFetchMore(const QModelIndex& parent) const override;
+  void fetchMore(const QModelIndex& parent) override;
+
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
   void addCluster(proxy::IClusterSPtr cluster);
   void removeCluster(proxy::IClusterSPtr cluster);
@@ -64,6 +61,9 @@ class ExplorerTreeModel : public common::qt::gui::TreeModel {
 
   void addServer(proxy::IServerSPtr server);
   void removeServer(proxy::IServerSPtr server);
+  void setServerConnectionState(proxy::IServer* server,
+                                ExplorerServerItem::eConnectionState state,
+                                const QString& error = QString());
 
   void addDatabase(proxy::IServer* server, core::IDataBaseInfoSPtr db);
   void removeDatabase(proxy::IServer* server, core::IDataBaseInfoSPtr db);
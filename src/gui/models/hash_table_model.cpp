@@ -18,6 +18,8 @@
 
 #include "gui/models/hash_table_model.h"
 
+#include <set>
+
 #include <common/qt/convert2string.h>
 #include <common/qt/utils_qt.h>
 
@@ -29,7 +31,12 @@ namespace fastonosql {
 namespace gui {
 
 HashTableModel::HashTableModel(QObject* parent)
-    : common::qt::gui::TableModel(parent), first_column_name_(), second_column_name_() {
+    : common::qt::gui::TableModel(parent),
+      first_column_name_(),
+      second_column_name_(),
+      removed_(),
+      has_more_(false),
+      fetch_pending_(false) {
   insertItem(createEmptyRow());
 }
 
@@ -126,9 +133,29 @@ void HashTableModel::clear() {
   beginResetModel();
   clearData();
   insertItem(createEmptyRow());
+  has_more_ = false;
+  removed_.clear();
+  fetch_pending_ = false;
   endResetModel();
 }
 
+bool HashTableModel::canFetchMore(const QModelIndex& parent) const {
+  if (parent.isValid()) {
+    return false;
+  }
+
+  return has_more_ && !fetch_pending_;
+}
+
+void HashTableModel::fetchMore(const QModelIndex& parent) {
+  if (!canFetchMore(parent)) {
+    return;
+  }
+
+  fetch_pending_ = true;
+  emit moreRequested();
+}
+
 common::ZSetValue* HashTableModel::zsetValue() const {
   if (data_.size() < 2) {
     return nullptr;
@@ -179,11 +206,51 @@ void HashTableModel::removeRow(int row) {
   size_t stabled_index_row = static_cast<size_t>(row);
   beginRemoveRows(QModelIndex(), row, row);
   common::qt::gui::TableItem* child = data_[stabled_index_row];
+  KeyValueTableItem* node = static_cast<KeyValueTableItem*>(child);
+  if (node->isLoaded()) {
+    removed_.push_back(std::make_pair(node->originKey(), node->originValue()));
+  }
   data_.erase(data_.begin() + row);
   delete child;
   endRemoveRows();
 }
 
+void HashTableModel::appendRows(const rows_t& rows) {
+  if (rows.empty()) {
+    return;
+  }
+
+  // rows go before the trailing empty row
+  const size_t pos = data_.size() - 1;
+  beginInsertRows(QModelIndex(), pos, pos + rows.size() - 1);
+  std::vector<common::qt::gui::TableItem*> items;
+  items.reserve(rows.size());
+  for (const auto& row : rows) {
+    KeyValueTableItem* item = new KeyValueTableItem(row.first, row.second, KeyValueTableItem::RemoveAction);
+    item->setLoaded(true);
+    items.push_back(item);
+  }
+  data_.insert(data_.begin() + pos, items.begin(), items.end());
+  endInsertRows();
+}
+
+bool HashTableModel::hasMore() const {
+  return has_more_;
+}
+
+void HashTableModel::setHasMore(bool more) {
+  has_more_ = more;
+  fetch_pending_ = false;
+}
+
+void HashTableModel::hashChanges(proxy::KeyChangeSet* changes) const {
+  collectChanges(false, changes);
+}
+
+void HashTableModel::zsetChanges(proxy::KeyChangeSet* changes) const {
+  collectChanges(true, changes);
+}
+
 void HashTableModel::setFirstColumnName(const QString& name) {
   first_column_name_ = name;
 }
@@ -196,5 +263,43 @@ common::qt::gui::TableItem* HashTableModel::createEmptyRow() const {
   return new KeyValueTableItem(KeyValueTableItem::key_t(), KeyValueTableItem::value_t(), KeyValueTableItem::AddAction);
 }
 
+void HashTableModel::collectChanges(bool by_value, proxy::KeyChangeSet* changes) const {
+  // members are identified by field (key column) or by member (value column)
+  std::set<key_t> written;
+  std::vector<key_t> removed;
+  for (size_t i = 0; i < data_.size() - 1; ++i) {
+    KeyValueTableItem* node = static_cast<KeyValueTableItem*>(data_[i]);
+    const key_t key = node->key();
+    const value_t value = node->value();
+    const key_t id = by_value ? value : key;
+    if (!node->isLoaded()) {
+      changes->SetMember(key, value);
+      written.insert(id);
+      continue;
+    }
+
+    if (!node->isModified() || (node->originKey() == key && node->originValue() == value)) {
+      continue;
+    }
+
+    const key_t origin_id = by_value ? node->originValue() : node->originKey();
+    if (origin_id != id) {
+      removed.push_back(origin_id);
+    }
+    changes->SetMember(key, value);
+    written.insert(id);
+  }
+
+  for (const auto& row : removed_) {
+    removed.push_back(by_value ? row.second : row.first);
+  }
+
+  for (const auto& id : removed) {
+    if (written.find(id) == written.end()) {
+      changes->RemoveMember(id);
+    }
+  }
+}
+
 }  // namespace gui
 }  // namespace fastonosql
@@ -18,9 +18,14 @@
 
 #pragma once
 
+#include <utility>
+#include <vector>
+
 #include <common/qt/gui/base/table_model.h>
 #include <common/value.h>
 
+#include "proxy/key_change_set.h"
+
 namespace fastonosql {
 namespace gui {
 
@@ -30,6 +35,7 @@ class HashTableModel : public common::qt::gui::TableModel {
  public:
   typedef common::Value::string_t key_t;
   typedef common::Value::string_t value_t;
+  typedef std::vector<std::pair<key_t, value_t>> rows_t;
   enum eColumn : uint8_t { kKey = 0, kValue = 1, kAction = 2, kCountColumns = 3 };
 
   explicit HashTableModel(QObject* parent = Q_NULLPTR);
@@ -39,6 +45,9 @@ class HashTableModel : public common::qt::gui::TableModel {
   Qt::ItemFlags flags(const QModelIndex& index) const override;
   QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
 
+  bool canFetchMore(const QModelIndex& parent) const override;
+  void fetchMore(const QModelIndex& parent) override;
+
   int columnCount(const QModelIndex& parent) const override;
   void clear();
 
@@ -47,18 +56,33 @@ class HashTableModel : public common::qt::gui::TableModel {
 
   void insertRow(const key_t& key, const value_t& value);
   void removeRow(int row);
+  void appendRows(const rows_t& rows);  // loaded from server
+
+  bool hasMore() const;
+  void setHasMore(bool more);  // next page availible on server
+
+  // edits of loaded rows, hash members are addressed by field and sorted set ones by member
+  void hashChanges(proxy::KeyChangeSet* changes) const;
+  void zsetChanges(proxy::KeyChangeSet* changes) const;
 
   void setFirstColumnName(const QString& name);
   void setSecondColumnName(const QString& name);
 
+ Q_SIGNALS:
+  void moreRequested();
+
  private:
   using TableModel::insertItem;
   using TableModel::removeItem;
 
   common::qt::gui::TableItem* createEmptyRow() const;
+  void collectChanges(bool by_value, proxy::KeyChangeSet* changes) const;
 
   QString first_column_name_;
   QString second_column_name_;
+  rows_t removed_;  // key and value on server
+  bool has_more_;
+  bool fetch_pending_;
 };
 
 }  // namespace gui
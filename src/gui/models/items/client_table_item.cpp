@@ -25,9 +25,13 @@ namespace gui {
 
 ClientTableItem::ClientTableItem(const proxy::NDbClient& client) : client_(client) {}
 
-proxy::NDbClient ClientTableItem::client() const {
+const proxy::NDbClient& ClientTableItem::client() const {
   return client_;
 }
 
+void ClientTableItem::setClient(const proxy::NDbClient& client) {
+  client_ = client;
+}
+
 }  // namespace gui
 }  // namespace fastonosql
@@ -29,7 +29,8 @@ class ClientTableItem : public common::qt::gui::TableItem {
  public:
   explicit ClientTableItem(const proxy::NDbClient& client);
 
-  proxy::NDbClient client() const;
+  const proxy::NDbClient& client() const;
+  void setClient(const proxy::NDbClient& client);
 
  private:
   proxy::NDbClient client_;
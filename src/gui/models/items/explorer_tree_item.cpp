@@ -45,7 +45,10 @@ ExplorerServerItem::eType IExplorerTreeItem::type() const {
 }
 
 ExplorerServerItem::ExplorerServerItem(proxy::IServerSPtr server, TreeItem* parent)
-    : IExplorerTreeItem(parent, eServer), server_(server) {}
+    : IExplorerTreeItem(parent, eServer),
+      server_(server),
+      connection_state_(server->IsConnected() ? eConnected : eIdle),
+      connection_error_() {}
 
 QString ExplorerServerItem::name() const {
   QString qname;
@@ -61,7 +64,21 @@ proxy::IServerSPtr ExplorerServerItem::server() const {
   return server_;
 }
 
+ExplorerServerItem::eConnectionState ExplorerServerItem::connectionState() const {
+  return connection_state_;
+}
+
+QString ExplorerServerItem::connectionError() const {
+  return connection_error_;
+}
+
+void ExplorerServerItem::setConnectionState(eConnectionState state, const QString& error) {
+  connection_state_ = state;
+  connection_error_ = error;
+}
+
 void ExplorerServerItem::loadDatabases() {
+  server_->LoadDeferredDiscovery();
   proxy::events_info::LoadDatabasesInfoRequest req(this);
   return server_->LoadDatabases(req);
 }
@@ -374,6 +391,18 @@ void ExplorerDatabaseItem::editValue(const core::NDbKValue& key, const core::NVa
   createKey(copy_key);
 }
 
+void ExplorerDatabaseItem::changeValue(const core::NDbKValue& key, const proxy::KeyChangeSet& changes) {
+  proxy::IDatabaseSPtr dbs = db();
+  if (!dbs) {
+    DNOTREACHED();
+    return;
+  }
+
+  proxy::IServerSPtr server = dbs->GetServer();
+  proxy::events_info::ChangeKeyValueRequest req(this, key.GetKey(), key.GetType(), changes);
+  server->ChangeKeyValue(req);
+}
+
 void ExplorerDatabaseItem::setTTL(const core::NKey& key, core::ttl_t ttl) {
   proxy::IDatabaseSPtr dbs = db();
   if (!dbs) {
@@ -498,6 +527,13 @@ void ExplorerKeyItem::editValue(const core::NValue& value) {
   }
 }
 
+void ExplorerKeyItem::changeValue(const proxy::KeyChangeSet& changes) {
+  ExplorerDatabaseItem* par = db();
+  if (par) {
+    par->changeValue(dbv_, changes);
+  }
+}
+
 void ExplorerKeyItem::removeFromDb() {
   ExplorerDatabaseItem* par = db();
   if (par) {
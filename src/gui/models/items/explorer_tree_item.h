@@ -27,6 +27,7 @@
 
 #include <fastonosql/core/database/idatabase_info.h>
 
+#include "proxy/key_change_set.h"
 #include "proxy/proxy_fwd.h"
 #include "proxy/types.h"
 
@@ -60,18 +61,26 @@ class IExplorerTreeItem : public common::qt::gui::TreeItem {
 
 class ExplorerServerItem : public IExplorerTreeItem {
  public:
+  enum eConnectionState { eIdle = 0, eConnecting, eConnected, eFailed };
+
   ExplorerServerItem(proxy::IServerSPtr server, TreeItem* parent);
 
   QString name() const override;
   string_t basicStringName() const override;
   proxy::IServerSPtr server() const;
 
+  eConnectionState connectionState() const;
+  QString connectionError() const;
+  void setConnectionState(eConnectionState state, const QString& error = QString());
+
   void loadDatabases();
   void createDatabase(const QString& name);
   void removeDatabase(const QString& name);
 
  private:
   const proxy::IServerSPtr server_;
+  eConnectionState connection_state_;
+  QString connection_error_;
 };
 
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
@@ -127,6 +136,7 @@ class ExplorerDatabaseItem : public IExplorerTreeItem {
   void watchKey(const core::NDbKValue& key, int interval);
   void createKey(const core::NDbKValue& key);
   void editValue(const core::NDbKValue& key, const core::NValue& value);
+  void changeValue(const core::NDbKValue& key, const proxy::KeyChangeSet& changes);
   void setTTL(const core::NKey& key, core::ttl_t ttl);
 
   void removeAllKeys();
@@ -158,6 +168,7 @@ class ExplorerKeyItem : public IExplorerTreeItem {
 
   void renameKey(const QString& newName);
   void editValue(const core::NValue& value);
+  void changeValue(const proxy::KeyChangeSet& changes);
   void removeFromDb();
   void watchKey(int interval);
   void loadValueFromDb();
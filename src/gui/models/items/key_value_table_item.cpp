@@ -22,13 +22,20 @@ namespace fastonosql {
 namespace gui {
 
 KeyValueTableItem::KeyValueTableItem(const key_t& key, const key_t& value, Mode state)
-    : base_class(state), key_(key), value_(value) {}
+    : base_class(state),
+      key_(key),
+      value_(value),
+      origin_key_(),
+      origin_value_(),
+      loaded_(false),
+      modified_(false) {}
 
 KeyValueTableItem::key_t KeyValueTableItem::key() const {
   return key_;
 }
 
 void KeyValueTableItem::setKey(const key_t& key) {
+  saveOrigin();
   key_ = key;
 }
 
@@ -37,8 +44,37 @@ KeyValueTableItem::value_t KeyValueTableItem::value() const {
 }
 
 void KeyValueTableItem::setValue(const value_t& val) {
+  saveOrigin();
   value_ = val;
 }
 
+bool KeyValueTableItem::isLoaded() const {
+  return loaded_;
+}
+
+void KeyValueTableItem::setLoaded(bool loaded) {
+  loaded_ = loaded;
+}
+
+bool KeyValueTableItem::isModified() const {
+  return modified_;
+}
+
+KeyValueTableItem::key_t KeyValueTableItem::originKey() const {
+  return modified_ ? origin_key_ : key_;
+}
+
+KeyValueTableItem::value_t KeyValueTableItem::originValue() const {
+  return modified_ ? origin_value_ : value_;
+}
+
+void KeyValueTableItem::saveOrigin() {
+  if (loaded_ && !modified_) {
+    origin_key_ = key_;
+    origin_value_ = value_;
+    modified_ = true;
+  }
+}
+
 }  // namespace gui
 }  // namespace fastonosql
@@ -39,9 +39,23 @@ class KeyValueTableItem : public ActionTableItem {
   value_t value() const;
   void setValue(const value_t& val);
 
+  // rows loaded from server keep their first key and value there
+  bool isLoaded() const;
+  void setLoaded(bool loaded);
+
+  bool isModified() const;
+  key_t originKey() const;
+  value_t originValue() const;
+
  private:
+  void saveOrigin();
+
   key_t key_;
   value_t value_;
+  key_t origin_key_;
+  value_t origin_value_;
+  bool loaded_;
+  bool modified_;
 };
 
 }  // namespace gui
@@ -21,15 +21,41 @@
 namespace fastonosql {
 namespace gui {
 
-ValueTableItem::ValueTableItem(const value_t& value, Mode state) : base_class(state), value_(value) {}
+ValueTableItem::ValueTableItem(const value_t& value, Mode state)
+    : base_class(state), value_(value), origin_value_(), origin_index_(0), loaded_(false), modified_(false) {}
 
 ValueTableItem::value_t ValueTableItem::value() const {
   return value_;
 }
 
 void ValueTableItem::setValue(const value_t& val) {
+  if (loaded_ && !modified_) {
+    origin_value_ = value_;
+    modified_ = true;
+  }
   value_ = val;
 }
 
+bool ValueTableItem::isLoaded() const {
+  return loaded_;
+}
+
+size_t ValueTableItem::originIndex() const {
+  return origin_index_;
+}
+
+void ValueTableItem::setOriginIndex(size_t index) {
+  origin_index_ = index;
+  loaded_ = true;
+}
+
+bool ValueTableItem::isModified() const {
+  return modified_;
+}
+
+ValueTableItem::value_t ValueTableItem::originValue() const {
+  return modified_ ? origin_value_ : value_;
+}
+
 }  // namespace gui
 }  // namespace fastonosql
@@ -35,8 +35,20 @@ class ValueTableItem : public ActionTableItem {
   value_t value() const;
   void setValue(const value_t& val);
 
+  // rows loaded from server keep their position and first value there
+  bool isLoaded() const;
+  size_t originIndex() const;
+  void setOriginIndex(size_t index);
+
+  bool isModified() const;
+  value_t originValue() const;
+
  private:
   value_t value_;
+  value_t origin_value_;
+  size_t origin_index_;
+  bool loaded_;
+  bool modified_;
 };
 
 }  // namespace gui
@@ -18,6 +18,9 @@
 
 #include "gui/models/list_table_model.h"
 
+#include <set>
+
+#include <common/convert2string.h>
 #include <common/qt/convert2string.h>
 #include <common/qt/utils_qt.h>
 
@@ -28,7 +31,13 @@
 namespace fastonosql {
 namespace gui {
 
-ListTableModel::ListTableModel(QObject* parent) : common::qt::gui::TableModel(parent), first_column_name_() {
+ListTableModel::ListTableModel(QObject* parent)
+    : common::qt::gui::TableModel(parent),
+      first_column_name_(),
+      loaded_count_(0),
+      removed_(),
+      has_more_(false),
+      fetch_pending_(false) {
   insertItem(createEmptyRow());
 }
 
@@ -115,9 +124,30 @@ void ListTableModel::clear() {
   beginResetModel();
   clearData();
   insertItem(createEmptyRow());
+  has_more_ = false;
+  loaded_count_ = 0;
+  removed_.clear();
+  fetch_pending_ = false;
   endResetModel();
 }
 
+bool ListTableModel::canFetchMore(const QModelIndex& parent) const {
+  if (parent.isValid()) {
+    return false;
+  }
+
+  return has_more_ && !fetch_pending_;
+}
+
+void ListTableModel::fetchMore(const QModelIndex& parent) {
+  if (!canFetchMore(parent)) {
+    return;
+  }
+
+  fetch_pending_ = true;
+  emit moreRequested();
+}
+
 common::ArrayValue* ListTableModel::arrayValue() const {
   if (data_.size() < 2) {
     return nullptr;
@@ -165,11 +195,87 @@ void ListTableModel::removeRow(int row) {
   size_t stabled_index_row = static_cast<size_t>(row);
   beginRemoveRows(QModelIndex(), row, row);
   common::qt::gui::TableItem* child = data_[stabled_index_row];
+  ValueTableItem* node = static_cast<ValueTableItem*>(child);
+  if (node->isLoaded()) {
+    removed_.push_back(std::make_pair(node->originIndex(), node->originValue()));
+  }
   data_.erase(data_.begin() + row);
   delete child;
   endRemoveRows();
 }
 
+void ListTableModel::appendRows(const rows_t& rows) {
+  if (rows.empty()) {
+    return;
+  }
+
+  // rows go before the trailing empty row
+  const size_t pos = data_.size() - 1;
+  beginInsertRows(QModelIndex(), pos, pos + rows.size() - 1);
+  std::vector<common::qt::gui::TableItem*> items;
+  items.reserve(rows.size());
+  for (const auto& row : rows) {
+    ValueTableItem* item = new ValueTableItem(row, ValueTableItem::RemoveAction);
+    item->setOriginIndex(loaded_count_++);
+    items.push_back(item);
+  }
+  data_.insert(data_.begin() + pos, items.begin(), items.end());
+  endInsertRows();
+}
+
+bool ListTableModel::hasMore() const {
+  return has_more_;
+}
+
+void ListTableModel::setHasMore(bool more) {
+  has_more_ = more;
+  fetch_pending_ = false;
+}
+
+void ListTableModel::arrayChanges(proxy::KeyChangeSet* changes) const {
+  for (size_t i = 0; i < data_.size() - 1; ++i) {
+    ValueTableItem* node = static_cast<ValueTableItem*>(data_[i]);
+    if (!node->isLoaded()) {
+      changes->AddMember(node->value());
+    } else if (node->isModified() && node->originValue() != node->value()) {
+      changes->SetMember(common::ConvertToCharBytes(static_cast<uint64_t>(node->originIndex())), node->value());
+    }
+  }
+
+  for (const auto& removed : removed_) {
+    changes->RemoveMember(common::ConvertToCharBytes(static_cast<uint64_t>(removed.first)));
+  }
+}
+
+void ListTableModel::setChanges(proxy::KeyChangeSet* changes) const {
+  std::set<row_t> added;
+  std::vector<row_t> removed;
+  for (size_t i = 0; i < data_.size() - 1; ++i) {
+    ValueTableItem* node = static_cast<ValueTableItem*>(data_[i]);
+    const row_t value = node->value();
+    if (!node->isLoaded()) {
+      added.insert(value);
+    } else if (node->isModified() && node->originValue() != value) {
+      removed.push_back(node->originValue());
+      added.insert(value);
+    }
+  }
+
+  for (const auto& row : removed_) {
+    removed.push_back(row.second);
+  }
+
+  for (const auto& value : added) {
+    changes->AddMember(value);
+  }
+  for (const auto& value : removed) {
+    // member removed and typed again stays on server
+    if (added.find(value) == added.end()) {
+      changes->RemoveMember(value);
+    }
+  }
+}
+
 void ListTableModel::setFirstColumnName(const QString& name) {
   first_column_name_ = name;
 }
@@ -18,9 +18,14 @@
 
 #pragma once
 
+#include <utility>
+#include <vector>
+
 #include <common/qt/gui/base/table_model.h>
 #include <common/value.h>
 
+#include "proxy/key_change_set.h"
+
 namespace fastonosql {
 namespace gui {
 
@@ -29,6 +34,7 @@ class ListTableModel : public common::qt::gui::TableModel {
 
  public:
   typedef common::Value::string_t row_t;
+  typedef std::vector<row_t> rows_t;
   enum eColumn : uint8_t { kValue = 0, kAction = 1, kCountColumns = 2 };
 
   explicit ListTableModel(QObject* parent = Q_NULLPTR);
@@ -38,6 +44,9 @@ class ListTableModel : public common::qt::gui::TableModel {
   Qt::ItemFlags flags(const QModelIndex& index) const override;
   QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
 
+  bool canFetchMore(const QModelIndex& parent) const override;
+  void fetchMore(const QModelIndex& parent) override;
+
   int columnCount(const QModelIndex& parent) const override;
   void clear();
 
@@ -46,9 +55,20 @@ class ListTableModel : public common::qt::gui::TableModel {
 
   void insertRow(const row_t& value);
   void removeRow(int row);
+  void appendRows(const rows_t& rows);  // loaded from server
+
+  bool hasMore() const;
+  void setHasMore(bool more);  // next page availible on server
+
+  // edits of loaded rows, list members are addressed by index and sets by value
+  void arrayChanges(proxy::KeyChangeSet* changes) const;
+  void setChanges(proxy::KeyChangeSet* changes) const;
 
   void setFirstColumnName(const QString& name);
 
+ Q_SIGNALS:
+  void moreRequested();
+
  private:
   using TableModel::insertItem;
   using TableModel::removeItem;
@@ -56,6 +76,10 @@ class ListTableModel : public common::qt::gui::TableModel {
   common::qt::gui::TableItem* createEmptyRow() const;
 
   QString first_column_name_;
+  bool has_more_;
+  size_t loaded_count_;
+  std::vector<std::pair<size_t, row_t>> removed_;  // index and value on server
+  bool fetch_pending_;
 };
 
 }  // namespace gui
@@ -0,0 +1,325 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/output_view_detector.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+namespace fastonosql {
+namespace gui {
+
+namespace {
+
+typedef unsigned char byte_t;
+
+bool isSpace(byte_t c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+bool isGzip(const byte_t* data, size_t size) {
+  // ID1 ID2 CM(deflate)
+  return size >= 3 && data[0] == 0x1F && data[1] == 0x8B && data[2] == 0x08;
+}
+
+bool isZlib(const byte_t* data, size_t size) {
+  // CMF: deflate with window <= 32K, FLG: header checksum, at least header + block + adler32
+  if (size < 8) {
+    return false;
+  }
+
+  const byte_t cmf = data[0];
+  const byte_t flg = data[1];
+  return (cmf & 0x0F) == 0x08 && (cmf >> 4) <= 7 && ((cmf << 8) | flg) % 31 == 0;
+}
+
+bool isBzip2(const byte_t* data, size_t size) {
+  // "BZh" + block size
+  return size >= 4 && data[0] == 'B' && data[1] == 'Z' && data[2] == 'h' && data[3] >= '1' && data[3] <= '9';
+}
+
+bool isLz4(const byte_t* data, size_t size) {
+  // frame magic 0x184D2204 (little endian), legacy frame 0x184C2102
+  if (size < 4) {
+    return false;
+  }
+
+  if (data[0] == 0x04 && data[1] == 0x22 && data[2] == 0x4D && data[3] == 0x18) {
+    return true;
+  }
+
+  return data[0] == 0x02 && data[1] == 0x21 && data[2] == 0x4C && data[3] == 0x18;
+}
+
+bool isPickleNumber(const byte_t* line, size_t size) {
+  if (size == 0) {
+    return false;
+  }
+
+  for (size_t i = 0; i < size; ++i) {
+    if (!strchr("0123456789+-.eEL", line[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// newline terminated argument of text opcode, pos moves past the newline
+bool readPickleLine(const byte_t* data, size_t size, size_t* pos, const byte_t** line, size_t* line_size) {
+  const byte_t* begin = data + *pos;
+  const byte_t* end = static_cast<const byte_t*>(memchr(begin, '\n', size - *pos));
+  if (!end) {
+    return false;
+  }
+
+  *line = begin;
+  *line_size = end - begin;
+  *pos += *line_size + 1;
+  return true;
+}
+
+uint32_t readPickleLength(const byte_t* data) {
+  return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24);
+}
+
+// protocols 0 and 1 have no header, opcodes are walked up to STOP which has to be the last byte
+bool isPickleOpcodes(const byte_t* data, size_t size) {
+  size_t pos = 0;
+  bool has_value = false;
+  while (pos < size) {
+    const byte_t op = data[pos++];
+    const byte_t* line = nullptr;
+    size_t line_size = 0;
+    size_t arg_size = 0;
+    switch (op) {
+      case '.':  // STOP
+        return has_value && pos == size;
+      case '(':  // MARK
+        break;
+      case '0':  // POP, POP_MARK, DUP, stack and container builders
+      case '1':
+      case '2':
+      case 'N':
+      case ')':
+      case ']':
+      case '}':
+      case 'R':
+      case 'b':
+      case 'a':
+      case 'e':
+      case 's':
+      case 'u':
+      case 't':
+      case 'l':
+      case 'd':
+      case 'o':
+      case 'Q':
+        break;
+      case 'K':  // BININT1, BINGET, BINPUT
+      case 'h':
+      case 'q':
+        arg_size = 1;
+        break;
+      case 'M':  // BININT2
+        arg_size = 2;
+        break;
+      case 'J':  // BININT, LONG_BINGET, LONG_BINPUT
+      case 'j':
+      case 'r':
+        arg_size = 4;
+        break;
+      case 'G':  // BINFLOAT
+        arg_size = 8;
+        break;
+      case 'U':  // SHORT_BINSTRING
+        if (pos >= size) {
+          return false;
+        }
+        arg_size = 1 + data[pos];
+        break;
+      case 'T':  // BINSTRING, BINUNICODE
+      case 'X':
+        if (size - pos < 4) {
+          return false;
+        }
+        arg_size = 4 + static_cast<size_t>(readPickleLength(data + pos));
+        break;
+      case 'I':  // INT, LONG, FLOAT, PUT, GET
+      case 'L':
+      case 'F':
+      case 'p':
+      case 'g':
+        if (!readPickleLine(data, size, &pos, &line, &line_size) || !isPickleNumber(line, line_size)) {
+          return false;
+        }
+        break;
+      case 'S':  // STRING, quoted repr
+        if (!readPickleLine(data, size, &pos, &line, &line_size) || line_size < 2 ||
+            (line[0] != '\'' && line[0] != '"') || line[line_size - 1] != line[0]) {
+          return false;
+        }
+        break;
+      case 'V':  // UNICODE, PERSID
+      case 'P':
+        if (!readPickleLine(data, size, &pos, &line, &line_size)) {
+          return false;
+        }
+        break;
+      case 'c':  // GLOBAL, INST: module and name lines
+      case 'i':
+        if (!readPickleLine(data, size, &pos, &line, &line_size) || line_size == 0 ||
+            !readPickleLine(data, size, &pos, &line, &line_size) || line_size == 0) {
+          return false;
+        }
+        break;
+      default:
+        return false;
+    }
+
+    if (op != '(') {
+      has_value = true;
+    }
+    if (size - pos < arg_size) {
+      return false;
+    }
+    pos += arg_size;
+  }
+
+  return false;
+}
+
+bool isPickle(const byte_t* data, size_t size) {
+  // every pickle ends with STOP opcode, protocol 2+ starts with PROTO opcode
+  if (size < 2 || data[size - 1] != '.') {
+    return false;
+  }
+
+  if (data[0] == 0x80) {
+    return size >= 3 && data[1] >= 2 && data[1] <= 5;
+  }
+
+  return isPickleOpcodes(data, size);
+}
+
+bool isStructured(const byte_t* data, size_t size, byte_t open, byte_t close) {
+  size_t begin = 0;
+  while (begin < size && isSpace(data[begin])) {
+    begin++;
+  }
+
+  size_t end = size;
+  while (end > begin && isSpace(data[end - 1])) {
+    end--;
+  }
+
+  return end - begin >= 2 && data[begin] == open && data[end - 1] == close;
+}
+
+bool isJson(const byte_t* data, size_t size) {
+  return isStructured(data, size, '{', '}') || isStructured(data, size, '[', ']');
+}
+
+bool isXml(const byte_t* data, size_t size) {
+  return isStructured(data, size, '<', '>');
+}
+
+}  // namespace
+
+OutputView detectOutputView(const core::readable_string_t& data) {
+  if (data.empty()) {
+    return RAW_VIEW;
+  }
+
+  const byte_t* raw = reinterpret_cast<const byte_t*>(data.data());
+  const size_t size = data.size();
+  // binary signatures first, they are stricter than text heuristics
+  if (isGzip(raw, size)) {
+    return GZIP_VIEW;
+  } else if (isBzip2(raw, size)) {
+    return BZIP2_VIEW;
+  } else if (isLz4(raw, size)) {
+    return LZ4_VIEW;
+  } else if (isPickle(raw, size)) {
+    return FROM_PICKLE_VIEW;
+  } else if (isJson(raw, size)) {
+    return JSON_VIEW;
+  } else if (isXml(raw, size)) {
+    return XML_VIEW;
+  } else if (isZlib(raw, size)) {
+    return ZLIB_VIEW;
+  }
+
+  return RAW_VIEW;
+}
+
+OutputViewCache::OutputViewCache() : views_(), use_counter_(0) {}
+
+OutputViewCache::key_t OutputViewCache::makeKey(const std::string& connection,
+                                                const std::string& db,
+                                                const core::command_buffer_t& key) {
+  return std::make_tuple(connection, db, key);
+}
+
+bool OutputViewCache::find(const key_t& key, OutputView* view) {
+  if (!view) {
+    return false;
+  }
+
+  const auto it = views_.find(key);
+  if (it == views_.end()) {
+    return false;
+  }
+
+  it->second.last_used = ++use_counter_;
+  *view = it->second.view;
+  return true;
+}
+
+void OutputViewCache::insert(const key_t& key, OutputView view) {
+  if (views_.size() >= max_cached_keys && views_.find(key) == views_.end()) {
+    const auto oldest = std::min_element(views_.begin(), views_.end(),
+                                         [](const std::pair<const key_t, Entry>& lhs,
+                                            const std::pair<const key_t, Entry>& rhs) {
+                                           return lhs.second.last_used < rhs.second.last_used;
+                                         });
+    views_.erase(oldest);
+  }
+
+  Entry& entry = views_[key];
+  entry.view = view;
+  entry.last_used = ++use_counter_;
+}
+
+void OutputViewCache::remove(const key_t& key) {
+  views_.erase(key);
+}
+
+void OutputViewCache::removeDatabase(const std::string& connection, const std::string& db) {
+  auto it = views_.lower_bound(makeKey(connection, db, core::command_buffer_t()));
+  while (it != views_.end() && std::get<0>(it->first) == connection && std::get<1>(it->first) == db) {
+    it = views_.erase(it);
+  }
+}
+
+void OutputViewCache::clear() {
+  views_.clear();
+}
+
+}  // namespace gui
+}  // namespace fastonosql
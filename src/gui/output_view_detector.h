@@ -0,0 +1,66 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <tuple>
+
+#include <common/patterns/singleton_pattern.h>
+
+#include <fastonosql/core/basic_types.h>
+
+#include "gui/widgets/fasto_viewer.h"
+
+namespace fastonosql {
+namespace gui {
+
+// looks only at the first bytes of value (magic numbers, pickle opcodes, json/xml brackets),
+// returns RAW_VIEW if nothing matched
+OutputView detectOutputView(const core::readable_string_t& data);
+
+// detected views of keys, scoped by connection path and database so equal key names never share an entry
+class OutputViewCache : public common::patterns::LazySingleton<OutputViewCache> {
+ public:
+  friend class common::patterns::LazySingleton<OutputViewCache>;
+  typedef std::tuple<std::string, std::string, core::command_buffer_t> key_t;  // connection, db, key
+  enum { max_cached_keys = 4096 };
+
+  static key_t makeKey(const std::string& connection, const std::string& db, const core::command_buffer_t& key);
+
+  bool find(const key_t& key, OutputView* view);
+  void insert(const key_t& key, OutputView view);  // evicts the least recently used entry when full
+  void remove(const key_t& key);
+  void removeDatabase(const std::string& connection, const std::string& db);
+  void clear();
+
+ private:
+  struct Entry {
+    OutputView view;
+    uint64_t last_used;
+  };
+
+  OutputViewCache();
+
+  std::map<key_t, Entry> views_;
+  uint64_t use_counter_;
+};
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,379 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/result_writer.h"
+
+#include <stdio.h>
+
+#include <cmath>
+#include <string>
+
+#include <QFile>
+
+#include <common/convert2string.h>
+#include <common/qt/convert2string.h>
+
+#include <fastonosql/core/value.h>
+
+namespace fastonosql {
+namespace gui {
+
+namespace {
+
+std::string escapeCsv(const std::string& field) {
+  if (field.find_first_of(",\"\r\n") == std::string::npos) {
+    return field;
+  }
+
+  std::string result = "\"";
+  for (char c : field) {
+    if (c == '"') {
+      result += '"';
+    }
+    result += c;
+  }
+  result += '"';
+  return result;
+}
+
+// length of the well formed utf-8 sequence starting at pos, 0 if the byte there doesn't start one
+size_t utf8SequenceLength(const std::string& str, size_t pos) {
+  const unsigned char lead = static_cast<unsigned char>(str[pos]);
+  size_t len = 0;
+  unsigned char min_next = 0x80;
+  unsigned char max_next = 0xBF;
+  if (lead < 0x80) {
+    return 1;
+  } else if (lead >= 0xC2 && lead <= 0xDF) {
+    len = 2;
+  } else if (lead >= 0xE0 && lead <= 0xEF) {
+    len = 3;
+    if (lead == 0xE0) {
+      min_next = 0xA0;  // overlong
+    } else if (lead == 0xED) {
+      max_next = 0x9F;  // surrogates
+    }
+  } else if (lead >= 0xF0 && lead <= 0xF4) {
+    len = 4;
+    if (lead == 0xF0) {
+      min_next = 0x90;  // overlong
+    } else if (lead == 0xF4) {
+      max_next = 0x8F;  // above U+10FFFF
+    }
+  } else {
+    return 0;
+  }
+
+  if (pos + len > str.size()) {
+    return 0;
+  }
+
+  for (size_t i = 1; i < len; ++i) {
+    const unsigned char next = static_cast<unsigned char>(str[pos + i]);
+    if (next < min_next || next > max_next) {
+      return 0;
+    }
+    min_next = 0x80;
+    max_next = 0xBF;
+  }
+  return len;
+}
+
+// bytes which are not valid utf-8 are written as \u00XX, so the output is always valid json
+std::string escapeJson(const std::string& str) {
+  std::string result = "\"";
+  for (size_t i = 0; i < str.size(); ++i) {
+    const char c = str[i];
+    const unsigned char uc = static_cast<unsigned char>(c);
+    if (uc >= 0x80) {
+      const size_t len = utf8SequenceLength(str, i);
+      if (len) {
+        result.append(str, i, len);
+        i += len - 1;
+      } else {
+        char buff[8];
+        snprintf(buff, sizeof(buff), "\\u%04x", uc);
+        result += buff;
+      }
+    } else if (c == '"') {
+      result += "\\\"";
+    } else if (c == '\\') {
+      result += "\\\\";
+    } else if (c == '\n') {
+      result += "\\n";
+    } else if (c == '\r') {
+      result += "\\r";
+    } else if (c == '\t') {
+      result += "\\t";
+    } else if (uc < 0x20) {
+      char buff[8];
+      snprintf(buff, sizeof(buff), "\\u%04x", uc);
+      result += buff;
+    } else {
+      result += c;
+    }
+  }
+  result += '"';
+  return result;
+}
+
+bool isJsonNumber(common::Value::Type type) {
+  return type == common::Value::TYPE_INTEGER || type == common::Value::TYPE_UINTEGER ||
+         type == common::Value::TYPE_LONG_INTEGER || type == common::Value::TYPE_ULONG_INTEGER ||
+         type == common::Value::TYPE_LONG_LONG_INTEGER || type == common::Value::TYPE_ULONG_LONG_INTEGER ||
+         type == common::Value::TYPE_DOUBLE;
+}
+
+class ResultWriter {
+ public:
+  ResultWriter(QFile* file, ResultFormat format) : file_(file), format_(format), replies_(0) {}
+
+  common::Error begin() {
+    if (format_ == kCsvFormat) {
+      return write("command,type,key,value\n");
+    } else if (format_ == kJsonFormat) {
+      return write("[");
+    }
+    return common::Error();
+  }
+
+  common::Error writeCommand(core::FastoObjectCommand* command) {
+    const std::string command_str = common::ConvertToString(command->GetInputCommand());
+    const auto childs = command->GetChildrens();
+    for (const auto& child : childs) {
+      common::Error err = writeReply(command_str, child.get());
+      if (err) {
+        return err;
+      }
+    }
+    return common::Error();
+  }
+
+  common::Error end() {
+    if (format_ == kJsonFormat) {
+      return write(replies_ ? "\n]\n" : "]\n");
+    }
+    return common::Error();
+  }
+
+ private:
+  common::Error write(const std::string& data) {
+    if (data.empty()) {
+      return common::Error();
+    }
+
+    const qint64 size = static_cast<qint64>(data.size());
+    if (file_->write(data.data(), size) != size) {
+      return common::make_error(common::ConvertToString(file_->errorString()));
+    }
+    return common::Error();
+  }
+
+  std::string toText(common::Value* value, const std::string& delimiter) const {
+    return common::ConvertToString(core::ConvertValue(value, delimiter));
+  }
+
+  // nested replies come as children, plain values are written as is
+  common::Error writeReply(const std::string& command, core::FastoObject* reply) {
+    const auto childs = reply->GetChildrens();
+    if (!childs.empty()) {
+      for (const auto& child : childs) {
+        common::Error err = writeReply(command, child.get());
+        if (err) {
+          return err;
+        }
+      }
+      return common::Error();
+    }
+
+    auto value = reply->GetValue();
+    if (!value) {
+      return common::Error();
+    }
+
+    const std::string delimiter = reply->GetDelimiter();
+    if (format_ == kCsvFormat) {
+      return writeCsvRows(command, value.get(), delimiter);
+    }
+
+    std::string prefix;
+    if (format_ == kJsonFormat) {
+      prefix = replies_ ? ",\n" : "\n";
+    }
+    replies_++;
+    common::Error err = write(prefix + "{\"command\":" + escapeJson(command) +
+                              ",\"type\":" + escapeJson(common::Value::GetTypeName(value->GetType())) + ",\"result\":");
+    if (err) {
+      return err;
+    }
+
+    err = writeJsonValue(value.get(), delimiter);
+    if (err) {
+      return err;
+    }
+    return write(format_ == kNdJsonFormat ? "}\n" : "}");
+  }
+
+  common::Error writeCsvRow(const std::string& command,
+                            common::Value::Type type,
+                            const std::string& key,
+                            const std::string& value) {
+    return write(escapeCsv(command) + "," + escapeCsv(common::Value::GetTypeName(type)) + "," + escapeCsv(key) + "," +
+                 escapeCsv(value) + "\n");
+  }
+
+  // collections are split by members, one row each
+  common::Error writeCsvRows(const std::string& command, common::Value* value, const std::string& delimiter) {
+    common::ArrayValue* arr = nullptr;
+    common::SetValue* set = nullptr;
+    common::ZSetValue* zset = nullptr;
+    common::HashValue* hash = nullptr;
+    const common::Value::Type type = value->GetType();
+    size_t index = 0;
+    if (value->GetAsList(&arr)) {
+      for (auto it = arr->begin(); it != arr->end(); ++it, ++index) {
+        common::Error err = writeCsvRow(command, type, common::ConvertToString(index), toText(*it, delimiter));
+        if (err) {
+          return err;
+        }
+      }
+      return common::Error();
+    } else if (value->GetAsSet(&set)) {
+      for (auto it = set->begin(); it != set->end(); ++it, ++index) {
+        common::Error err = writeCsvRow(command, type, common::ConvertToString(index), toText(*it, delimiter));
+        if (err) {
+          return err;
+        }
+      }
+      return common::Error();
+    } else if (value->GetAsZSet(&zset)) {
+      for (auto it = zset->begin(); it != zset->end(); ++it) {
+        common::Error err = writeCsvRow(command, type, toText(it->first, delimiter), toText(it->second, delimiter));
+        if (err) {
+          return err;
+        }
+      }
+      return common::Error();
+    } else if (value->GetAsHash(&hash)) {
+      for (auto it = hash->begin(); it != hash->end(); ++it) {
+        common::Error err =
+            writeCsvRow(command, type, common::ConvertToString(it->first), toText(it->second, delimiter));
+        if (err) {
+          return err;
+        }
+      }
+      return common::Error();
+    }
+
+    return writeCsvRow(command, type, std::string(), toText(value, delimiter));
+  }
+
+  common::Error writeJsonValue(common::Value* value, const std::string& delimiter) {
+    common::ArrayValue* arr = nullptr;
+    common::SetValue* set = nullptr;
+    common::ZSetValue* zset = nullptr;
+    common::HashValue* hash = nullptr;
+    const common::Value::Type type = value->GetType();
+    if (type == common::Value::TYPE_NULL) {
+      return write("null");
+    } else if (type == common::Value::TYPE_BOOLEAN) {
+      bool val = false;
+      value->GetAsBoolean(&val);
+      return write(val ? "true" : "false");
+    } else if (type == common::Value::TYPE_DOUBLE) {
+      double val = 0;
+      value->GetAsDouble(&val);
+      return write(std::isfinite(val) ? toText(value, delimiter) : "null");  // json has no nan and infinity
+    } else if (isJsonNumber(type)) {
+      return write(toText(value, delimiter));
+    } else if (value->GetAsList(&arr)) {
+      return writeJsonList(arr->begin(), arr->end(), delimiter);
+    } else if (value->GetAsSet(&set)) {
+      return writeJsonList(set->begin(), set->end(), delimiter);
+    } else if (value->GetAsZSet(&zset)) {
+      common::Error err = write("[");
+      for (auto it = zset->begin(); it != zset->end() && !err; ++it) {
+        err = write(std::string(it == zset->begin() ? "[" : ",[") + escapeJson(toText(it->first, delimiter)) + "," +
+                    escapeJson(toText(it->second, delimiter)) + "]");
+      }
+      return err ? err : write("]");
+    } else if (value->GetAsHash(&hash)) {
+      common::Error err = write("{");
+      for (auto it = hash->begin(); it != hash->end() && !err; ++it) {
+        err = write(std::string(it == hash->begin() ? "" : ",") + escapeJson(common::ConvertToString(it->first)) + ":");
+        if (!err) {
+          err = writeJsonValue(it->second, delimiter);
+        }
+      }
+      return err ? err : write("}");
+    }
+
+    return write(escapeJson(toText(value, delimiter)));
+  }
+
+  template <typename It>
+  common::Error writeJsonList(It begin, It end, const std::string& delimiter) {
+    common::Error err = write("[");
+    for (It it = begin; it != end && !err; ++it) {
+      if (it != begin) {
+        err = write(",");
+      }
+      if (!err) {
+        err = writeJsonValue(*it, delimiter);
+      }
+    }
+    return err ? err : write("]");
+  }
+
+  QFile* const file_;
+  const ResultFormat format_;
+  size_t replies_;
+};
+
+}  // namespace
+
+common::Error exportCommandsResult(const std::vector<core::FastoObjectCommandIPtr>& commands,
+                                   ResultFormat format,
+                                   const QString& path,
+                                   export_progress_callback_t progress) {
+  QFile file(path);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    return common::make_error(common::ConvertToString(file.errorString()));
+  }
+
+  ResultWriter writer(&file, format);
+  common::Error err = writer.begin();
+  int last_percent = 0;
+  for (size_t i = 0; i < commands.size() && !err; ++i) {
+    err = writer.writeCommand(commands[i].get());
+    const int percent = static_cast<int>((i + 1) * 100 / commands.size());
+    if (progress && percent != last_percent) {
+      last_percent = percent;
+      progress(percent);
+    }
+  }
+  if (!err) {
+    err = writer.end();
+  }
+
+  file.close();
+  return err;
+}
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,43 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include <QString>
+
+#include <fastonosql/core/global.h>
+
+namespace fastonosql {
+namespace gui {
+
+enum ResultFormat : uint8_t { kCsvFormat = 0, kJsonFormat, kNdJsonFormat };
+
+typedef std::function<void(int)> export_progress_callback_t;  // percent of written commands
+
+// walks replies of executed commands and writes them to file one by one,
+// so exporting never builds the whole text of result in memory
+common::Error exportCommandsResult(const std::vector<core::FastoObjectCommandIPtr>& commands,
+                                   ResultFormat format,
+                                   const QString& path,
+                                   export_progress_callback_t progress) WARN_UNUSED_RESULT;
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -64,6 +64,8 @@ const QString trCantReadTemplate_2S = QObject::tr(PROJECT_NAME_TITLE " can't rea
 const QString trCantSaveTemplate_2S = QObject::tr(PROJECT_NAME_TITLE " can't save to %1:\n%2.");
 const QString trAdvancedOptions = QObject::tr("Advanced options");
 const QString trIntervalMsec = QObject::tr("Interval msec:");
+const QString trSilent = QObject::tr("Silent");
+const QString trSilentTooltip = QObject::tr("Don't show replies, result can still be exported");
 const QString trBasedOn_2S = QObject::tr("Based on <b>%1</b> version: <b>%2</b>");
 
 }  // namespace
@@ -120,6 +122,7 @@ BaseShellWidget::BaseShellWidget(proxy::IServerSPtr server, const QString& file_
       repeat_count_(nullptr),
       interval_msec_(nullptr),
       history_call_(nullptr),
+      silent_call_(nullptr),
       file_path_(file_path) {}
 
 QHBoxLayout* BaseShellWidget::createActionBar() {
@@ -232,12 +235,15 @@ void BaseShellWidget::init() {
 
   history_call_ = new QCheckBox;
   history_call_->setChecked(true);
+  silent_call_ = new QCheckBox;
+  silent_call_->setChecked(false);
   adv_opt_layout->addLayout(repeat_layout);
   adv_opt_layout->addLayout(interval_layout);
   QSplitter* hs = new QSplitter(Qt::Vertical);
   hs->setSizePolicy(QSizePolicy::MinimumExpanding, QSizePolicy::MinimumExpanding);
   adv_opt_layout->addWidget(hs);
   adv_opt_layout->addWidget(history_call_);
+  adv_opt_layout->addWidget(silent_call_);
   advanced_options_widget_->setLayout(adv_opt_layout);
 
   supported_commands_count_ = new QLabel;
@@ -299,6 +305,7 @@ void BaseShellWidget::init() {
   updateServerInfo(server_->GetCurrentServerInfo());
   updateDefaultDatabase(server_->GetCurrentDatabaseInfo());
   updateCommands(std::vector<const core::CommandInfo*>());
+  server_->LoadDeferredDiscovery();  // commands for autocompletion
 }
 
 QHBoxLayout* BaseShellWidget::createTopLayout(core::ConnectionType ct) {
@@ -345,6 +352,8 @@ void BaseShellWidget::retranslateUi() {
   stop_action_->setToolTip(translations::trStop);
 
   history_call_->setText(translations::trHistory);
+  silent_call_->setText(trSilent);
+  silent_call_->setToolTip(trSilentTooltip);
   setToolTip(trBasedOn_2S.arg(input_->basedOn(), input_->version()));
   advanced_options_->setText(trAdvancedOptions);
   supported_commands_count_->setText(trSupportedCommandsCountTemplate_1S.arg(input_->commandsCount()));
@@ -379,12 +388,13 @@ void BaseShellWidget::execute() {
   size_t repeat = static_cast<size_t>(repeat_count_->value());
   int interval = interval_msec_->value();
   bool history = history_call_->isChecked();
-  executeArgs(selected, repeat, interval, history);
+  bool silence = silent_call_->isChecked();
+  executeArgs(selected, repeat, interval, history, silence);
 }
 
-void BaseShellWidget::executeArgs(const QString& text, size_t repeat, int interval, bool history) {
+void BaseShellWidget::executeArgs(const QString& text, size_t repeat, int interval, bool history, bool silence) {
   core::command_buffer_t text_cmd = common::ConvertToCharBytes(text);
-  proxy::events_info::ExecuteInfoRequest req(this, text_cmd, repeat, interval, history);
+  proxy::events_info::ExecuteInfoRequest req(this, text_cmd, repeat, interval, history, silence);
   server_->Execute(req);
 }
 
@@ -479,7 +489,7 @@ void BaseShellWidget::validateClick() {
 }
 
 void BaseShellWidget::helpClick() {
-  executeArgs(DB_HELP_COMMAND, 0, 0, false);
+  executeArgs(DB_HELP_COMMAND, 0, 0, false, false);
 }
 
 void BaseShellWidget::inputTextChanged() {
@@ -587,6 +597,7 @@ void BaseShellWidget::startExecute(const proxy::events_info::ExecuteInfoRequest&
   repeat_count_->setEnabled(false);
   interval_msec_->setEnabled(false);
   history_call_->setEnabled(false);
+  silent_call_->setEnabled(false);
   execute_action_->setEnabled(false);
   stop_action_->setEnabled(true);
 }
@@ -596,6 +607,7 @@ void BaseShellWidget::finishExecute(const proxy::events_info::ExecuteInfoRespons
   repeat_count_->setEnabled(true);
   interval_msec_->setEnabled(true);
   history_call_->setEnabled(true);
+  silent_call_->setEnabled(true);
   execute_action_->setEnabled(true);
   stop_action_->setEnabled(false);
 }
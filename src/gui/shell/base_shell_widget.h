@@ -91,7 +91,7 @@ class BaseShellWidget : public BaseWidget {
  public Q_SLOTS:
   void setText(const QString& text);
   void executeText(const QString& text);
-  void executeArgs(const QString& text, size_t repeat, int interval, bool history);
+  void executeArgs(const QString& text, size_t repeat, int interval, bool history, bool silence);
 
  private Q_SLOTS:
   void execute();
@@ -190,6 +190,7 @@ class BaseShellWidget : public BaseWidget {
   QSpinBox* repeat_count_;
   QSpinBox* interval_msec_;
   QCheckBox* history_call_;
+  QCheckBox* silent_call_;
   QString file_path_;
 };
 
@@ -34,6 +34,7 @@ namespace gui {
 HashTypeView::HashTypeView(QWidget* parent) : QTableView(parent), model_(nullptr), mode_(kHash) {
   model_ = new HashTableModel(this);
   setModel(model_);
+  VERIFY(connect(model_, &HashTableModel::moreRequested, this, &HashTypeView::moreRequested));
 
   ActionDelegate* del = new ActionDelegate(this);
   VERIFY(connect(del, &ActionDelegate::addClicked, this, &HashTypeView::addRow));
@@ -63,6 +64,26 @@ void HashTypeView::clear() {
   emit dataChangedSignal();
 }
 
+void HashTypeView::appendRows(const rows_t& rows) {
+  model_->appendRows(rows);
+}
+
+bool HashTypeView::hasMore() const {
+  return model_->hasMore();
+}
+
+void HashTypeView::setHasMore(bool more) {
+  model_->setHasMore(more);
+}
+
+void HashTypeView::valueChanges(proxy::KeyChangeSet* changes) const {
+  if (mode_ == kHash) {
+    model_->hashChanges(changes);
+  } else {
+    model_->zsetChanges(changes);
+  }
+}
+
 common::ZSetValue* HashTypeView::zsetValue() const {
   return model_->zsetValue();
 }
@@ -18,11 +18,17 @@
 
 #pragma once
 
+#include <utility>
+#include <vector>
+
 #include <QTableView>
 
 #include <common/value.h>
 
 namespace fastonosql {
+namespace proxy {
+class KeyChangeSet;
+}  // namespace proxy
 namespace gui {
 
 class HashTableModel;
@@ -33,6 +39,7 @@ class HashTypeView : public QTableView {
  public:
   typedef common::Value::string_t key_t;
   typedef common::Value::string_t value_t;
+  typedef std::vector<std::pair<key_t, value_t>> rows_t;
   typedef QTableView base_class;
   enum Mode : uint8_t { kHash = 0, kZset };
 
@@ -41,6 +48,11 @@ class HashTypeView : public QTableView {
   void insertRow(const key_t& key, const value_t& value);
   void clear();
 
+  void appendRows(const rows_t& rows);  // page loaded from server
+  bool hasMore() const;
+  void setHasMore(bool more);
+  void valueChanges(proxy::KeyChangeSet* changes) const;  // edits since load from server
+
   common::ZSetValue* zsetValue() const;  // alocate memory
   common::HashValue* hashValue() const;  // alocate memory
 
@@ -50,6 +62,7 @@ class HashTypeView : public QTableView {
  Q_SIGNALS:
   void dataChangedSignal();
   void rowChanged(const key_t& key, const value_t& value);
+  void moreRequested();
 
  private Q_SLOTS:
   void addRow(const QModelIndex& index);
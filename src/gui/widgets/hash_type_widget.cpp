@@ -36,6 +36,7 @@ HashTypeWidget::HashTypeWidget(QWidget* parent)
   key_edit_ = createWidget<FastoViewer>();
 
   VERIFY(connect(view_, &HashTypeView::dataChangedSignal, this, &HashTypeWidget::dataChangedSignal));
+  VERIFY(connect(view_, &HashTypeView::moreRequested, this, &HashTypeWidget::moreRequested));
   VERIFY(connect(view_, &HashTypeView::rowChanged, this, &HashTypeWidget::valueUpdate, Qt::DirectConnection));
   VERIFY(connect(more_less_button_, &QPushButton::clicked, this, &HashTypeWidget::toggleVisibleValueView));
 
@@ -76,6 +77,22 @@ void HashTypeWidget::clear() {
   view_->clear();
 }
 
+void HashTypeWidget::appendRows(const HashTypeView::rows_t& rows) {
+  view_->appendRows(rows);
+}
+
+bool HashTypeWidget::hasMore() const {
+  return view_->hasMore();
+}
+
+void HashTypeWidget::setHasMore(bool more) {
+  view_->setHasMore(more);
+}
+
+void HashTypeWidget::valueChanges(proxy::KeyChangeSet* changes) const {
+  view_->valueChanges(changes);
+}
+
 common::ZSetValue* HashTypeWidget::zsetValue() const {
   return view_->zsetValue();
 }
@@ -39,6 +39,11 @@ class HashTypeWidget : public BaseWidget {
   void insertRow(const HashTypeView::key_t& key, const HashTypeView::value_t& value);
   void clear();
 
+  void appendRows(const HashTypeView::rows_t& rows);
+  bool hasMore() const;
+  void setHasMore(bool more);
+  void valueChanges(proxy::KeyChangeSet* changes) const;
+
   common::ZSetValue* zsetValue() const;  // alocate memory
   common::HashValue* hashValue() const;  // alocate memory
 
@@ -47,6 +52,7 @@ class HashTypeWidget : public BaseWidget {
 
  Q_SIGNALS:
   void dataChangedSignal();
+  void moreRequested();
 
  private Q_SLOTS:
   void valueUpdate(const HashTypeView::key_t& key, const HashTypeView::value_t& value);
@@ -18,21 +18,33 @@
 
 #include "gui/widgets/key_edit_widget.h"
 
+#include <cmath>
+#include <memory>
+#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include <QByteArray>
+#include <QCheckBox>
 #include <QComboBox>
+#include <QDateTimeEdit>
 #include <QGridLayout>
+#include <QHBoxLayout>
 #include <QLabel>
 #include <QLineEdit>
+#include <QPushButton>
 
 #include <common/convert2string.h>
 #include <common/qt/convert2string.h>
 
 #include <fastonosql/core/value.h>
 
+#include "proxy/server/iserver.h"
+
 #include "gui/gui_factory.h"
 #include "gui/models/hash_table_model.h"
+#include "gui/output_view_detector.h"
 
 #include "gui/widgets/fasto_viewer.h"
 #include "gui/widgets/hash_type_widget.h"
@@ -41,10 +53,146 @@
 
 #include "translations/global.h"
 
+namespace {
+const QString trNewestFirst = QObject::tr("Newest first");
+const QString trGoToTime = QObject::tr("Go to time");
+}  // namespace
+
 namespace fastonosql {
 namespace gui {
 
-KeyEditWidget::KeyEditWidget(QWidget* parent) : base_class(parent) {
+namespace {
+
+OutputView detectStringView(const OutputViewCache::key_t* key, const common::Value::string_t& text) {
+  if (!key) {
+    return detectOutputView(text);
+  }
+
+  OutputViewCache& cache = OutputViewCache::GetInstance();
+  OutputView view;
+  if (cache.find(*key, &view)) {
+    return view;
+  }
+
+  view = detectOutputView(text);
+  cache.insert(*key, view);
+  return view;
+}
+
+// scores are sent as typed, redis takes plain numbers and infinities
+bool isValidScore(const common::Value::string_t& score) {
+  const QByteArray raw(score.data(), static_cast<int>(score.size()));
+  const QByteArray lowered = raw.toLower();
+  if (lowered == "inf" || lowered == "+inf" || lowered == "-inf") {
+    return true;
+  }
+
+  bool ok = false;
+  const double val = raw.toDouble(&ok);
+  return ok && !std::isnan(val);
+}
+
+ListTypeView::rows_t makeListRows(common::Value* item) {
+  ListTypeView::rows_t rows;
+  common::ArrayValue* arr = nullptr;
+  common::SetValue* set = nullptr;
+  if (item->GetAsList(&arr)) {
+    rows.reserve(arr->GetSize());
+    for (auto it = arr->begin(); it != arr->end(); ++it) {
+      const auto val = core::ConvertValue(*it, core::NValue::default_delimiter);
+      if (!val.empty()) {
+        rows.push_back(val);
+      }
+    }
+  } else if (item->GetAsSet(&set)) {
+    for (auto it = set->begin(); it != set->end(); ++it) {
+      const auto val = core::ConvertValue(*it, core::NValue::default_delimiter);
+      if (!val.empty()) {
+        rows.push_back(val);
+      }
+    }
+  }
+  return rows;
+}
+
+HashTypeView::rows_t makeHashRows(common::Value* item) {
+  HashTypeView::rows_t rows;
+  common::ZSetValue* zset = nullptr;
+  common::HashValue* hash = nullptr;
+  if (item->GetAsZSet(&zset)) {
+    for (auto it = zset->begin(); it != zset->end(); ++it) {
+      const auto key_str = core::ConvertValue(it->first, core::NValue::default_delimiter);
+      const auto value_str = core::ConvertValue(it->second, core::NValue::default_delimiter);
+      if (!key_str.empty() && !value_str.empty()) {
+        rows.push_back(std::make_pair(key_str, value_str));
+      }
+    }
+  } else if (item->GetAsHash(&hash)) {
+    for (auto it = hash->begin(); it != hash->end(); ++it) {
+      const auto key_str = it->first;
+      const auto value_str = core::ConvertValue(it->second, core::NValue::default_delimiter);
+      if (!key_str.empty() && !value_str.empty()) {
+        rows.push_back(std::make_pair(key_str, value_str));
+      }
+    }
+  }
+  return rows;
+}
+
+// set rows are members
+const common::Value::string_t& getScanMember(const ListTypeView::row_t& row, common::Value::Type type) {
+  UNUSED(type);
+  return row;
+}
+
+// hash rows are (field, value), sorted set rows are (score, member)
+const common::Value::string_t& getScanMember(const HashTypeView::rows_t::value_type& row, common::Value::Type type) {
+  return type == common::Value::TYPE_ZSET ? row.second : row.first;
+}
+
+// keeps rows whose member wasn't returned by earlier pages of the same scan
+template <typename Rows>
+Rows dropScannedRows(const Rows& rows, common::Value::Type type, std::set<common::Value::string_t>* scanned) {
+  Rows unique;
+  unique.reserve(rows.size());
+  for (const auto& row : rows) {
+    if (scanned->insert(getScanMember(row, type)).second) {
+      unique.push_back(row);
+    }
+  }
+  return unique;
+}
+
+bool isPagedType(common::Value::Type type) {
+  return type == common::Value::TYPE_ARRAY || type == common::Value::TYPE_SET || type == common::Value::TYPE_ZSET ||
+         type == common::Value::TYPE_HASH || type == core::StreamValue::TYPE_STREAM;
+}
+
+// XRANGE paging is served by redis and keydb drivers only, other redis compatible load streams whole
+bool isStreamPagingSupported(core::ConnectionType type) {
+  return type == core::REDIS || type == core::KEYDB;
+}
+
+const core::StreamValue::stream_id kStreamFirstId = GEN_CMD_STRING("-");
+const core::StreamValue::stream_id kStreamLastId = GEN_CMD_STRING("+");
+
+}  // namespace
+
+KeyEditWidget::KeyEditWidget(QWidget* parent)
+    : base_class(parent),
+      view_cache_key_(),
+      view_cache_connection_(),
+      view_cache_db_(),
+      server_(),
+      paged_key_(),
+      paged_type_(common::Value::TYPE_NULL),
+      next_cursor_(0),
+      scanned_members_(),
+      stream_cursor_(),
+      stream_reverse_(false),
+      stream_from_start_(true),
+      paged_(false),
+      value_complete_(true) {
   type_label_ = new QLabel;
   types_combo_box_ = new QComboBox;
   typedef void (QComboBox::*ind)(int);
@@ -72,11 +220,31 @@ KeyEditWidget::KeyEditWidget(QWidget* parent) : base_class(parent) {
 
   value_list_edit_ = createWidget<ListTypeWidget>();
   VERIFY(connect(value_list_edit_, &ListTypeWidget::dataChangedSignal, this, &KeyEditWidget::keyChanged));
+  VERIFY(connect(value_list_edit_, &ListTypeWidget::moreRequested, this, &KeyEditWidget::loadNextPage));
   value_table_edit_ = createWidget<HashTypeWidget>();
   VERIFY(connect(value_table_edit_, &HashTypeWidget::dataChangedSignal, this, &KeyEditWidget::keyChanged));
+  VERIFY(connect(value_table_edit_, &HashTypeWidget::moreRequested, this, &KeyEditWidget::loadNextPage));
 
   stream_table_edit_ = new StreamTypeWidget;
   VERIFY(connect(stream_table_edit_, &StreamTypeWidget::dataChangedSignal, this, &KeyEditWidget::keyChanged));
+  VERIFY(connect(stream_table_edit_, &StreamTypeWidget::moreRequested, this, &KeyEditWidget::loadNextPage));
+
+  // stream navigation, ids start with milliseconds time
+  stream_nav_widget_ = new QWidget;
+  stream_time_edit_ = new QDateTimeEdit(QDateTime::currentDateTime());
+  stream_time_edit_->setCalendarPopup(true);
+  stream_time_edit_->setDisplayFormat("yyyy-MM-dd hh:mm:ss.zzz");
+  stream_jump_button_ = new QPushButton;
+  VERIFY(connect(stream_jump_button_, &QPushButton::clicked, this, &KeyEditWidget::jumpToStreamTime));
+  stream_reverse_check_ = new QCheckBox;
+  VERIFY(connect(stream_reverse_check_, &QCheckBox::toggled, this, &KeyEditWidget::changeStreamOrder));
+  QHBoxLayout* stream_nav_layout = new QHBoxLayout;
+  stream_nav_layout->setContentsMargins(0, 0, 0, 0);
+  stream_nav_layout->addWidget(stream_time_edit_);
+  stream_nav_layout->addWidget(stream_jump_button_);
+  stream_nav_layout->addWidget(stream_reverse_check_);
+  stream_nav_widget_->setLayout(stream_nav_layout);
+  stream_nav_widget_->setVisible(false);
 
   QGridLayout* main_layout = new QGridLayout;
   main_layout->addWidget(type_label_, 0, 0);
@@ -90,6 +258,7 @@ KeyEditWidget::KeyEditWidget(QWidget* parent) : base_class(parent) {
   main_layout->addWidget(value_list_edit_, 2, 1);
   main_layout->addWidget(value_table_edit_, 2, 1);
   main_layout->addWidget(stream_table_edit_, 2, 1);
+  main_layout->addWidget(stream_nav_widget_, 3, 1);
   main_layout->setContentsMargins(0, 0, 0, 0);
   setLayout(main_layout);
 
@@ -97,6 +266,35 @@ KeyEditWidget::KeyEditWidget(QWidget* parent) : base_class(parent) {
   syncControls(core::NValue());
 }
 
+void KeyEditWidget::setPageSource(proxy::IServerSPtr server) {
+  if (server_) {
+    VERIFY(disconnect(server_.get(), &proxy::IServer::LoadKeyPageFinished, this, &KeyEditWidget::finishLoadKeyPage));
+    VERIFY(disconnect(server_.get(), &proxy::IServer::LoadStreamPageFinished, this,
+                      &KeyEditWidget::finishLoadStreamPage));
+  }
+
+  server_ = server;
+  if (server_) {
+    VERIFY(connect(server_.get(), &proxy::IServer::LoadKeyPageFinished, this, &KeyEditWidget::finishLoadKeyPage));
+    VERIFY(
+        connect(server_.get(), &proxy::IServer::LoadStreamPageFinished, this, &KeyEditWidget::finishLoadStreamPage));
+  }
+}
+
+void KeyEditWidget::setViewCacheScope(const std::string& connection, const std::string& db) {
+  view_cache_connection_ = connection;
+  view_cache_db_ = db;
+}
+
+bool KeyEditWidget::getViewCacheKey(OutputViewCache::key_t* key) const {
+  if (!key || view_cache_connection_.empty() || view_cache_key_.empty()) {
+    return false;
+  }
+
+  *key = OutputViewCache::makeKey(view_cache_connection_, view_cache_db_, view_cache_key_);
+  return true;
+}
+
 void KeyEditWidget::initialize(const std::vector<common::Value::Type>& availible_types, const core::NDbKValue& key) {
   types_combo_box_->clear();
 
@@ -120,11 +318,16 @@ void KeyEditWidget::initialize(const std::vector<common::Value::Type>& availible
   QString qkey;
   const auto nkey = key.GetKey();
   const auto raw_key = nkey.GetKey();
-  if (common::ConvertFromBytes(raw_key.GetForCommandLine(), &qkey)) {
+  view_cache_key_ = raw_key.GetForCommandLine();
+  if (common::ConvertFromBytes(view_cache_key_, &qkey)) {
     key_edit_->setText(qkey);
   }
 
   types_combo_box_->setCurrentIndex(current_index);
+  if (startPagedLoading(nkey, current_type)) {
+    return;
+  }
+
   syncControls(val);
 }
 
@@ -235,6 +438,12 @@ void KeyEditWidget::changeType(int index) {
   QVariant var = types_combo_box_->itemData(index);
   common::Value::Type type = static_cast<common::Value::Type>(qvariant_cast<unsigned char>(var));
 
+  paged_ = false;
+  next_cursor_ = 0;
+  scanned_members_.clear();
+  stream_cursor_.clear();
+  value_complete_ = true;
+  stream_nav_widget_->setVisible(false);
   value_edit_->clear();
   json_value_edit_->clear();
   value_table_edit_->clear();
@@ -323,87 +532,36 @@ void KeyEditWidget::syncControls(const core::NValue& item) {
   value_list_edit_->clear();
 
   common::Value::Type type = item->GetType();
-  if (type == common::Value::TYPE_ARRAY) {
-    common::ArrayValue* arr = nullptr;
-    if (item->GetAsList(&arr)) {
-      for (auto it = arr->begin(); it != arr->end(); ++it) {
-        const auto val = core::ConvertValue(*it, core::NValue::default_delimiter);
-        if (val.empty()) {
-          continue;
-        }
-
-        value_list_edit_->insertRow(val);
-      }
-    }
-  } else if (type == common::Value::TYPE_SET) {
-    common::SetValue* set = nullptr;
-    if (item->GetAsSet(&set)) {
-      for (auto it = set->begin(); it != set->end(); ++it) {
-        const auto val = core::ConvertValue(*it, core::NValue::default_delimiter);
-        if (val.empty()) {
-          continue;
-        }
-
-        value_list_edit_->insertRow(val);
-      }
-    }
-  } else if (type == common::Value::TYPE_ZSET) {
-    common::ZSetValue* zset = nullptr;
-    if (item->GetAsZSet(&zset)) {
-      for (auto it = zset->begin(); it != zset->end(); ++it) {
-        auto element = (*it);
-        common::Value* key = element.first;
-        const auto key_str = core::ConvertValue(key, core::NValue::default_delimiter);
-        if (key_str.empty()) {
-          continue;
-        }
-
-        common::Value* value = element.second;
-        const auto value_str = core::ConvertValue(value, core::NValue::default_delimiter);
-        if (value_str.empty()) {
-          continue;
-        }
-
-        value_table_edit_->insertRow(key_str, value_str);
-      }
-    }
-  } else if (type == common::Value::TYPE_HASH) {
-    common::HashValue* hash = nullptr;
-    if (item->GetAsHash(&hash)) {
-      for (auto it = hash->begin(); it != hash->end(); ++it) {
-        auto element = (*it);
-        const auto key_str = element.first;
-        if (key_str.empty()) {
-          continue;
-        }
-
-        common::Value* value = element.second;
-        const auto value_str = core::ConvertValue(value, core::NValue::default_delimiter);
-        if (value_str.empty()) {
-          continue;
-        }
-
-        value_table_edit_->insertRow(key_str, value_str);
-      }
-    }
+  if (type == common::Value::TYPE_ARRAY || type == common::Value::TYPE_SET) {
+    value_list_edit_->appendRows(makeListRows(item.get()));
+  } else if (type == common::Value::TYPE_ZSET || type == common::Value::TYPE_HASH) {
+    value_table_edit_->appendRows(makeHashRows(item.get()));
   } else if (type == core::StreamValue::TYPE_STREAM) {
     core::StreamValue* stream = static_cast<core::StreamValue*>(item.get());
-    auto entr = stream->GetStreams();
-    for (size_t i = 0; i != entr.size(); ++i) {
-      auto ent = entr[i];
-      stream_table_edit_->insertStream(ent);
-    }
+    stream_table_edit_->appendStreams(stream->GetStreams());
   } else if (type == core::JsonValue::TYPE_JSON || type == common::Value::TYPE_STRING) {
     common::Value::string_t text;
     if (item->GetAsString(&text)) {
       if (type == core::JsonValue::TYPE_JSON) {
         json_value_edit_->setView(JSON_VIEW);
         json_value_edit_->setViewChangeEnabled(false);
-      } else {
+        json_value_edit_->setText(text);
+        return;
+      }
+
+      // pick decoder before the first conversion, fallback to raw if detection was wrong
+      OutputViewCache::key_t cache_key;
+      const bool cached = getViewCacheKey(&cache_key);
+      const OutputView view = detectStringView(cached ? &cache_key : nullptr, text);
+      json_value_edit_->setView(view);
+      json_value_edit_->setViewChangeEnabled(true);
+      if (!json_value_edit_->setText(text) && view != RAW_VIEW) {
+        if (cached) {
+          OutputViewCache::GetInstance().insert(cache_key, RAW_VIEW);
+        }
         json_value_edit_->setView(RAW_VIEW);
-        json_value_edit_->setViewChangeEnabled(true);
+        json_value_edit_->setText(text);
       }
-      json_value_edit_->setText(text);
     }
   } else if (type == common::Value::TYPE_BOOLEAN) {
     bool val;
@@ -456,10 +614,210 @@ bool KeyEditWidget::getKey(core::NDbKValue* key) const {
   return true;
 }
 
+bool KeyEditWidget::isValueComplete() const {
+  return value_complete_;
+}
+
+bool KeyEditWidget::valueChanges(proxy::KeyChangeSet* changes) const {
+  if (!changes || !paged_ || paged_type_ == core::StreamValue::TYPE_STREAM) {
+    return false;
+  }
+
+  proxy::KeyChangeSet result;
+  if (paged_type_ == common::Value::TYPE_ARRAY || paged_type_ == common::Value::TYPE_SET) {
+    value_list_edit_->valueChanges(&result);
+  } else {
+    value_table_edit_->valueChanges(&result);
+  }
+
+  // pushed elements go to the real tail, which is known only after the last page
+  if (paged_type_ == common::Value::TYPE_ARRAY && !value_complete_ && !result.GetAddedMembers().empty()) {
+    return false;
+  }
+
+  *changes = result;
+  return true;
+}
+
+bool KeyEditWidget::validateChanges(const proxy::KeyChangeSet& changes) const {
+  if (key_edit_->text().isEmpty()) {
+    return false;
+  }
+
+  if (paged_type_ == common::Value::TYPE_ZSET) {
+    for (const auto& pair : changes.GetSetMembers()) {
+      if (!isValidScore(pair.first)) {
+        return false;
+      }
+    }
+  }
+
+  // whole value is known, it can't be saved empty as in getKey
+  if (value_complete_) {
+    const std::unique_ptr<common::Value> value(createItem());
+    return value != nullptr;
+  }
+  return true;
+}
+
+void KeyEditWidget::loadNextPage() {
+  if (!paged_) {
+    return;
+  }
+
+  if (paged_type_ == core::StreamValue::TYPE_STREAM) {
+    if (!stream_cursor_.empty()) {
+      requestStreamPage(stream_cursor_);
+    }
+    return;
+  }
+
+  if (next_cursor_ != 0) {
+    requestPage(next_cursor_);
+  }
+}
+
+void KeyEditWidget::finishLoadKeyPage(const proxy::events_info::LoadKeyPageResponse& res) {
+  if (res.initiator() != this || !paged_ || res.type != paged_type_ || res.cursor_in != next_cursor_) {
+    return;
+  }
+
+  if (res.key.GetKey().GetForCommandLine() != view_cache_key_) {
+    return;
+  }
+
+  const bool is_list = paged_type_ == common::Value::TYPE_ARRAY || paged_type_ == common::Value::TYPE_SET;
+  common::Error err = res.errorInfo();
+  if (err || !res.page) {
+    // keep what is loaded, value stays incomplete so it can't be saved over the key
+    if (is_list) {
+      value_list_edit_->setHasMore(false);
+    } else {
+      value_table_edit_->setHasMore(false);
+    }
+    return;
+  }
+
+  next_cursor_ = res.cursor_out;
+  const bool has_more = next_cursor_ != 0;
+  value_complete_ = !has_more;
+  if (paged_type_ == common::Value::TYPE_ARRAY) {
+    value_list_edit_->appendRows(makeListRows(res.page.get()));
+    value_list_edit_->setHasMore(has_more);
+  } else if (is_list) {
+    value_list_edit_->appendRows(dropScannedRows(makeListRows(res.page.get()), paged_type_, &scanned_members_));
+    value_list_edit_->setHasMore(has_more);
+  } else {
+    value_table_edit_->appendRows(dropScannedRows(makeHashRows(res.page.get()), paged_type_, &scanned_members_));
+    value_table_edit_->setHasMore(has_more);
+  }
+}
+
+void KeyEditWidget::finishLoadStreamPage(const proxy::events_info::LoadStreamPageResponse& res) {
+  if (res.initiator() != this || !paged_ || paged_type_ != core::StreamValue::TYPE_STREAM) {
+    return;
+  }
+
+  if (res.start_id != stream_cursor_ || res.reverse != stream_reverse_ ||
+      res.key.GetKey().GetForCommandLine() != view_cache_key_) {
+    return;
+  }
+
+  common::Error err = res.errorInfo();
+  if (err) {
+    stream_table_edit_->setHasMore(false);
+    return;
+  }
+
+  stream_cursor_ = res.next_id;
+  const bool has_more = !stream_cursor_.empty();
+  // only whole stream read from the beginning can be saved back
+  value_complete_ = !has_more && stream_from_start_;
+  stream_table_edit_->appendStreams(res.streams);
+  stream_table_edit_->setHasMore(has_more);
+}
+
+void KeyEditWidget::jumpToStreamTime() {
+  if (!paged_ || paged_type_ != core::StreamValue::TYPE_STREAM) {
+    return;
+  }
+
+  const qint64 msec = stream_time_edit_->dateTime().toMSecsSinceEpoch();
+  if (msec < 0) {
+    return;
+  }
+
+  // XRANGE/XREVRANGE accept id without sequence part
+  restartStreamPaging(common::ConvertToCharBytes(static_cast<uint64_t>(msec)), false);
+}
+
+void KeyEditWidget::changeStreamOrder(bool reverse) {
+  if (stream_reverse_ == reverse) {
+    return;
+  }
+
+  stream_reverse_ = reverse;
+  if (!paged_ || paged_type_ != core::StreamValue::TYPE_STREAM) {
+    return;
+  }
+
+  restartStreamPaging(reverse ? kStreamLastId : kStreamFirstId, !reverse);
+}
+
+bool KeyEditWidget::startPagedLoading(const core::NKey& key, common::Value::Type type) {
+  paged_ = false;
+  next_cursor_ = 0;
+  scanned_members_.clear();
+  value_complete_ = true;
+  if (!server_ || !isPagedType(type) || !core::IsRedisCompatible(server_->GetType())) {
+    return false;
+  }
+
+  if (type == core::StreamValue::TYPE_STREAM && !isStreamPagingSupported(server_->GetType())) {
+    return false;
+  }
+
+  setEnabled(true);
+  value_list_edit_->clear();
+  value_table_edit_->clear();
+  paged_key_ = key;
+  paged_type_ = type;
+  paged_ = true;
+  value_complete_ = false;
+  if (type == core::StreamValue::TYPE_STREAM) {
+    stream_nav_widget_->setVisible(true);
+    restartStreamPaging(stream_reverse_ ? kStreamLastId : kStreamFirstId, !stream_reverse_);
+    return true;
+  }
+
+  requestPage(0);
+  return true;
+}
+
+void KeyEditWidget::requestPage(core::cursor_t cursor) {
+  proxy::events_info::LoadKeyPageRequest req(this, paged_key_, paged_type_, key_page_size, cursor);
+  server_->LoadKeyPage(req);
+}
+
+void KeyEditWidget::requestStreamPage(const core::StreamValue::stream_id& start_id) {
+  proxy::events_info::LoadStreamPageRequest req(this, paged_key_, start_id, key_page_size, stream_reverse_);
+  server_->LoadStreamPage(req);
+}
+
+void KeyEditWidget::restartStreamPaging(const core::StreamValue::stream_id& start_id, bool from_start) {
+  stream_table_edit_->clear();
+  stream_cursor_ = start_id;
+  stream_from_start_ = from_start;
+  value_complete_ = false;
+  requestStreamPage(stream_cursor_);
+}
+
 void KeyEditWidget::retranslateUi() {
   value_label_->setText(translations::trValue + ":");
   key_label_->setText(translations::trKey + ":");
   type_label_->setText(translations::trType + ":");
+  stream_jump_button_->setText(trGoToTime);
+  stream_reverse_check_->setText(trNewestFirst);
   base_class::retranslateUi();
 }
 
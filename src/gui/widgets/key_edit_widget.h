@@ -18,17 +18,33 @@
 
 #pragma once
 
+#include <set>
+#include <string>
 #include <vector>
 
 #include <fastonosql/core/db_key.h>
+#include <fastonosql/core/value.h>
 
+#include "proxy/key_change_set.h"
+#include "proxy/proxy_fwd.h"
+
+#include "gui/output_view_detector.h"
 #include "gui/widgets/base_widget.h"
 
 class QLineEdit;
 class QComboBox;
 class QLabel;
+class QCheckBox;
+class QDateTimeEdit;
+class QPushButton;
 
 namespace fastonosql {
+namespace proxy {
+namespace events_info {
+struct LoadKeyPageResponse;
+struct LoadStreamPageResponse;
+}  // namespace events_info
+}  // namespace proxy
 namespace gui {
 
 class FastoViewer;
@@ -43,12 +59,18 @@ class KeyEditWidget : public BaseWidget {
   typedef BaseWidget base_class;
   template <typename T, typename... Args>
   friend T* createWidget(Args&&... args);
+  enum { key_page_size = 500 };
 
+  void setPageSource(proxy::IServerSPtr server);  // collections of existing keys are loaded by pages
+  void setViewCacheScope(const std::string& connection, const std::string& db);  // views are cached only inside a scope
   void initialize(const std::vector<common::Value::Type>& availible_types, const core::NDbKValue& key);
 
   void setEnableKeyEdit(bool key_edit);
 
   bool getKey(core::NDbKValue* key) const;
+  bool isValueComplete() const;  // false while collection pages are still on server
+  bool valueChanges(proxy::KeyChangeSet* changes) const;  // false if the value can't be saved by changes
+  bool validateChanges(const proxy::KeyChangeSet& changes) const;  // rules of getKey applied to the changes
 
  Q_SIGNALS:
   void typeChanged(common::Value::Type type);
@@ -56,6 +78,11 @@ class KeyEditWidget : public BaseWidget {
 
  private Q_SLOTS:
   void changeType(int index);
+  void loadNextPage();
+  void finishLoadKeyPage(const proxy::events_info::LoadKeyPageResponse& res);
+  void finishLoadStreamPage(const proxy::events_info::LoadStreamPageResponse& res);
+  void jumpToStreamTime();
+  void changeStreamOrder(bool reverse);
 
  protected:
   explicit KeyEditWidget(QWidget* parent = Q_NULLPTR);
@@ -75,6 +102,32 @@ class KeyEditWidget : public BaseWidget {
   ListTypeWidget* value_list_edit_;
   HashTypeWidget* value_table_edit_;
   StreamTypeWidget* stream_table_edit_;
+  QWidget* stream_nav_widget_;
+  QDateTimeEdit* stream_time_edit_;
+  QPushButton* stream_jump_button_;
+  QCheckBox* stream_reverse_check_;
+
+ private:
+  bool startPagedLoading(const core::NKey& key, common::Value::Type type);
+  void requestPage(core::cursor_t cursor);
+  void requestStreamPage(const core::StreamValue::stream_id& start_id);
+  void restartStreamPaging(const core::StreamValue::stream_id& start_id, bool from_start);
+
+  bool getViewCacheKey(OutputViewCache::key_t* key) const;
+
+  core::command_buffer_t view_cache_key_;
+  std::string view_cache_connection_;
+  std::string view_cache_db_;
+  proxy::IServerSPtr server_;
+  core::NKey paged_key_;
+  common::Value::Type paged_type_;
+  core::cursor_t next_cursor_;
+  std::set<common::Value::string_t> scanned_members_;  // SCAN may return a member again on a later page
+  core::StreamValue::stream_id stream_cursor_;  // start of next stream page, empty if no more
+  bool stream_reverse_;
+  bool stream_from_start_;
+  bool paged_;
+  bool value_complete_;
 };
 
 }  // namespace gui
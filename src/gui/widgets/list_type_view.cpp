@@ -35,6 +35,7 @@ ListTypeView::ListTypeView(QWidget* parent) : QTableView(parent), model_(nullptr
   model_ = new ListTableModel(this);
   model_->setFirstColumnName(translations::trValue);
   setModel(model_);
+  VERIFY(connect(model_, &ListTableModel::moreRequested, this, &ListTypeView::moreRequested));
 
   ActionDelegate* del = new ActionDelegate(this);
   VERIFY(connect(del, &ActionDelegate::addClicked, this, &ListTypeView::addRow));
@@ -72,6 +73,26 @@ void ListTypeView::clear() {
   emit dataChangedSignal();
 }
 
+void ListTypeView::appendRows(const rows_t& values) {
+  model_->appendRows(values);
+}
+
+bool ListTypeView::hasMore() const {
+  return model_->hasMore();
+}
+
+void ListTypeView::setHasMore(bool more) {
+  model_->setHasMore(more);
+}
+
+void ListTypeView::valueChanges(proxy::KeyChangeSet* changes) const {
+  if (mode_ == kArray) {
+    model_->arrayChanges(changes);
+  } else {
+    model_->setChanges(changes);
+  }
+}
+
 ListTypeView::Mode ListTypeView::currentMode() const {
   return mode_;
 }
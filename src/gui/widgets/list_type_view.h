@@ -18,11 +18,16 @@
 
 #pragma once
 
+#include <vector>
+
 #include <QTableView>
 
 #include <common/value.h>
 
 namespace fastonosql {
+namespace proxy {
+class KeyChangeSet;
+}  // namespace proxy
 namespace gui {
 
 class ListTableModel;
@@ -33,6 +38,7 @@ class ListTypeView : public QTableView {
  public:
   typedef QTableView base_class;
   typedef common::Value::string_t row_t;
+  typedef std::vector<row_t> rows_t;
   enum Mode : uint8_t { kArray = 0, kSet };
 
   explicit ListTypeView(QWidget* parent = Q_NULLPTR);
@@ -43,12 +49,18 @@ class ListTypeView : public QTableView {
   void insertRow(const row_t& value);
   void clear();
 
+  void appendRows(const rows_t& values);  // page loaded from server
+  bool hasMore() const;
+  void setHasMore(bool more);
+  void valueChanges(proxy::KeyChangeSet* changes) const;  // edits since load from server
+
   Mode currentMode() const;
   void setCurrentMode(Mode mode);
 
  Q_SIGNALS:
   void dataChangedSignal();
   void rowChanged(const row_t& value);
+  void moreRequested();
 
  private Q_SLOTS:
   void addRow(const QModelIndex& index);
@@ -36,6 +36,7 @@ ListTypeWidget::ListTypeWidget(QWidget* parent)
   value_edit_ = createWidget<FastoViewer>();
 
   VERIFY(connect(view_, &ListTypeView::dataChangedSignal, this, &ListTypeWidget::dataChangedSignal));
+  VERIFY(connect(view_, &ListTypeView::moreRequested, this, &ListTypeWidget::moreRequested));
   VERIFY(connect(view_, &ListTypeView::rowChanged, this, &ListTypeWidget::valueUpdate, Qt::DirectConnection));
   VERIFY(connect(more_less_button_, &QPushButton::clicked, this, &ListTypeWidget::toggleVisibleValueView));
 
@@ -78,6 +79,22 @@ void ListTypeWidget::clear() {
   view_->clear();
 }
 
+void ListTypeWidget::appendRows(const ListTypeView::rows_t& values) {
+  view_->appendRows(values);
+}
+
+bool ListTypeWidget::hasMore() const {
+  return view_->hasMore();
+}
+
+void ListTypeWidget::setHasMore(bool more) {
+  view_->setHasMore(more);
+}
+
+void ListTypeWidget::valueChanges(proxy::KeyChangeSet* changes) const {
+  view_->valueChanges(changes);
+}
+
 ListTypeView::Mode ListTypeWidget::currentMode() const {
   return view_->currentMode();
 }
@@ -42,11 +42,17 @@ class ListTypeWidget : public BaseWidget {
   void insertRow(const ListTypeView::row_t& value);
   void clear();
 
+  void appendRows(const ListTypeView::rows_t& values);
+  bool hasMore() const;
+  void setHasMore(bool more);
+  void valueChanges(proxy::KeyChangeSet* changes) const;
+
   ListTypeView::Mode currentMode() const;
   void setCurrentMode(ListTypeView::Mode mode);
 
  Q_SIGNALS:
   void dataChangedSignal();
+  void moreRequested();
 
  private Q_SLOTS:
   void valueUpdate(const ListTypeView::row_t& value);
@@ -18,12 +18,16 @@
 
 #include "gui/widgets/output_widget.h"
 
+#include <string>
 #include <vector>
 
+#include <QFileInfo>
 #include <QHBoxLayout>
 #include <QHeaderView>
+#include <QProgressBar>
 #include <QPushButton>
 #include <QSplitter>
+#include <QThread>
 
 #include <common/qt/gui/icon_label.h>
 #include <common/qt/logger.h>
@@ -32,6 +36,8 @@
 #include "proxy/settings_manager.h"
 
 #include "gui/gui_factory.h"
+#include "gui/result_writer.h"
+#include "gui/utils.h"
 #include "gui/models/fasto_common_model.h"
 #include "gui/models/items/fasto_common_item.h"
 #include "gui/views/fasto_table_view.h"
@@ -40,6 +46,7 @@
 #include "gui/widgets/delegate/type_delegate.h"
 #include "gui/widgets/icon_button.h"
 #include "gui/widgets/save_key_edit_widget.h"
+#include "gui/workers/result_exporter.h"
 
 namespace {
 const QString trTreeViewTooltip = QObject::tr("Tree view");
@@ -47,6 +54,10 @@ const QString trTableViewTooltip = QObject::tr("Table view");
 const QString trTextViewTooltip = QObject::tr("Text view");
 const QString trKeyViewTooltip = QObject::tr("Key view");
 const QString trMsecTemplate_1S = QObject::tr("%1 msec");
+const QString trExportTooltip = QObject::tr("Export result");
+const QString trExportResult = QObject::tr("Export result");
+const QString trExportFilters =
+    QObject::tr("CSV files (*.csv);;JSON files (*.json);;Newline delimited JSON files (*.ndjson)");
 }  // namespace
 
 namespace fastonosql {
@@ -72,7 +83,8 @@ FastoCommonItem* CreateRootItem(core::FastoObject* item) {
 
 const QSize OutputWidget::kIconSize = QSize(24, 24);
 
-OutputWidget::OutputWidget(proxy::IServerSPtr server, QWidget* parent) : base_class(parent), server_(server) {
+OutputWidget::OutputWidget(proxy::IServerSPtr server, QWidget* parent)
+    : base_class(parent), server_(server), result_source_(nullptr), exporting_(false) {
   CHECK(server_);
 
   common_model_ = new FastoCommonModel(this);
@@ -119,15 +131,24 @@ OutputWidget::OutputWidget(proxy::IServerSPtr server, QWidget* parent) : base_cl
   table_button_ = new IconButton(GuiFactory::GetInstance().tableIcon(), kIconSize);
   text_button_ = new IconButton(GuiFactory::GetInstance().textIcon(), kIconSize);
   key_button_ = new IconButton(GuiFactory::GetInstance().keyIcon(), kIconSize);
+  export_button_ = new IconButton(GuiFactory::GetInstance().exportIcon(), kIconSize);
+  export_button_->setEnabled(false);
+  export_progress_ = new QProgressBar;
+  export_progress_->setRange(0, 100);
+  export_progress_->setMaximumWidth(kIconSize.width() * 5);
+  export_progress_->setVisible(false);
   time_label_ = new common::qt::gui::IconLabel(GuiFactory::GetInstance().timeIcon(), kIconSize, "0");
   VERIFY(connect(tree_button_, &IconButton::clicked, this, &OutputWidget::setTreeView));
   VERIFY(connect(table_button_, &IconButton::clicked, this, &OutputWidget::setTableView));
   VERIFY(connect(text_button_, &IconButton::clicked, this, &OutputWidget::setTextView));
   VERIFY(connect(key_button_, &IconButton::clicked, this, &OutputWidget::setEditKeyView));
+  VERIFY(connect(export_button_, &IconButton::clicked, this, &OutputWidget::exportResult));
   top_layout->addWidget(tree_button_);
   top_layout->addWidget(table_button_);
   top_layout->addWidget(text_button_);
   top_layout->addWidget(key_button_);
+  top_layout->addWidget(export_button_);
+  top_layout->addWidget(export_progress_);
   top_layout->addWidget(new QSplitter(Qt::Horizontal));
   top_layout->addWidget(time_label_);
   top_layout->setContentsMargins(0, 0, 0, 0);
@@ -175,19 +196,25 @@ void OutputWidget::rootCompleate(const proxy::events_info::CommandRootCompleated
 }
 
 void OutputWidget::addKey(core::IDataBaseInfoSPtr db, core::NDbKValue key) {
-  UNUSED(db);
   const auto inf = server_->GetCurrentServerInfo();
+  key_editor_->setViewCacheScope(server_->GetPath(), db ? db->GetName() : std::string());
   key_editor_->initialize(server_->GetSupportedValueTypes(inf->GetVersion()), key);
   common_model_->changeValue(key);
 }
 
 void OutputWidget::updateKey(core::IDataBaseInfoSPtr db, core::NDbKValue key) {
-  UNUSED(db);
   const auto inf = server_->GetCurrentServerInfo();
+  key_editor_->setViewCacheScope(server_->GetPath(), db ? db->GetName() : std::string());
   key_editor_->initialize(server_->GetSupportedValueTypes(inf->GetVersion()), key);
   common_model_->changeValue(key);
 }
 
+void OutputWidget::setResultSource(const QObject* source) {
+  result_source_ = source;
+  last_commands_.clear();
+  export_button_->setEnabled(false);  // running export keeps its own copy of commands
+}
+
 void OutputWidget::startExecuteCommand(const proxy::events_info::ExecuteInfoRequest& req) {
   if (req.initiator() == key_editor_) {
     key_editor_->startSaveKey();
@@ -197,6 +224,13 @@ void OutputWidget::startExecuteCommand(const proxy::events_info::ExecuteInfoRequ
 void OutputWidget::finishExecuteCommand(const proxy::events_info::ExecuteInfoResponse& res) {
   if (res.initiator() == key_editor_) {
     key_editor_->finishSaveKey();
+    return;
+  }
+
+  // the model shows replies of every request, export takes only ours; silent runs never reach the model
+  if (result_source_ && res.initiator() == result_source_) {
+    last_commands_ = res.executed_commands;
+    export_button_->setEnabled(!exporting_ && !last_commands_.empty());
   }
 }
 
@@ -311,11 +345,59 @@ void OutputWidget::setEditKeyView() {
   key_editor_->setVisible(true);
 }
 
+void OutputWidget::exportResult() {
+  if (last_commands_.empty()) {
+    return;
+  }
+
+  const QString filepath = showSaveFileDialog(this, trExportResult, QString(), trExportFilters);
+  if (filepath.isEmpty()) {
+    return;
+  }
+
+  const QString suffix = QFileInfo(filepath).suffix().toLower();
+  ResultFormat format = kJsonFormat;
+  if (suffix == "csv") {
+    format = kCsvFormat;
+  } else if (suffix == "ndjson" || suffix == "jsonl") {
+    format = kNdJsonFormat;
+  }
+
+  QThread* th = new QThread;
+  ResultExporter* exporter = new ResultExporter(last_commands_, format, filepath);
+  exporter->moveToThread(th);
+  VERIFY(connect(th, &QThread::started, exporter, &ResultExporter::routine));
+  VERIFY(connect(exporter, &ResultExporter::progressChanged, this, &OutputWidget::exportProgressed));
+  VERIFY(connect(exporter, &ResultExporter::exportFinished, this, &OutputWidget::exportFinished));
+  VERIFY(connect(exporter, &ResultExporter::exportFinished, th, &QThread::quit));
+  VERIFY(connect(th, &QThread::finished, exporter, &ResultExporter::deleteLater));
+  VERIFY(connect(th, &QThread::finished, th, &QThread::deleteLater));
+  exporting_ = true;
+  export_button_->setEnabled(false);
+  export_progress_->setValue(0);
+  export_progress_->setVisible(true);
+  th->start();
+}
+
+void OutputWidget::exportProgressed(int percent) {
+  export_progress_->setValue(percent);
+}
+
+void OutputWidget::exportFinished(common::Error err) {
+  exporting_ = false;
+  export_progress_->setVisible(false);
+  export_button_->setEnabled(!last_commands_.empty());
+  if (err) {
+    LOG_ERROR(err, common::logging::LOG_LEVEL_ERR, true);
+  }
+}
+
 void OutputWidget::retranslateUi() {
   tree_button_->setToolTip(trTreeViewTooltip);
   table_button_->setToolTip(trTableViewTooltip);
   text_button_->setToolTip(trTextViewTooltip);
   key_button_->setToolTip(trKeyViewTooltip);
+  export_button_->setToolTip(trExportTooltip);
   base_class::retranslateUi();
 }
 
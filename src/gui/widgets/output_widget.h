@@ -18,6 +18,10 @@
 
 #pragma once
 
+#include <vector>
+
+#include <common/error.h>
+
 #include <fastonosql/core/database/idatabase_info.h>
 #include <fastonosql/core/global.h>
 
@@ -26,6 +30,7 @@
 #include "proxy/proxy_fwd.h"
 #include "proxy/types.h"
 
+class QProgressBar;
 class QPushButton;
 class QTreeView;
 class QTableView;
@@ -63,6 +68,8 @@ class OutputWidget : public BaseWidget {
 
   static const QSize kIconSize;
 
+  void setResultSource(const QObject* source);  // only replies to requests of source are kept for export
+
  private Q_SLOTS:
   void createKey(const core::NDbKValue& dbv);
   void createKeyFromEditor(const core::NDbKValue& dbv);
@@ -85,6 +92,10 @@ class OutputWidget : public BaseWidget {
   void setTextView();
   void setEditKeyView();
 
+  void exportResult();
+  void exportProgressed(int percent);
+  void exportFinished(common::Error err);
+
  protected:
   explicit OutputWidget(proxy::IServerSPtr server, QWidget* parent = Q_NULLPTR);
   void retranslateUi() override;
@@ -99,6 +110,8 @@ class OutputWidget : public BaseWidget {
   QPushButton* table_button_;
   QPushButton* text_button_;
   QPushButton* key_button_;
+  QPushButton* export_button_;
+  QProgressBar* export_progress_;
 
   FastoCommonModel* common_model_;
   QTreeView* tree_view_;
@@ -106,7 +119,10 @@ class OutputWidget : public BaseWidget {
   FastoTextView* text_view_;
   SaveKeyEditWidget* key_editor_;
   const proxy::IServerSPtr server_;
+  const QObject* result_source_;
   proxy::SupportedView current_view_;
+  std::vector<core::FastoObjectCommandIPtr> last_commands_;  // result of last execution, for export
+  bool exporting_;
 };
 
 }  // namespace gui
@@ -36,6 +36,7 @@ namespace gui {
 QueryWidget::QueryWidget(proxy::IServerSPtr server, QWidget* parent) : base_class(parent), server_(server) {
   shell_widget_ = BaseShellWidget::createWidgetFactory(server);
   output_widget_ = createWidget<OutputWidget>(server);
+  output_widget_->setResultSource(shell_widget_);
 
   console_gb_ = new QGroupBox;
   QVBoxLayout* console_layout = new QVBoxLayout;
@@ -87,8 +88,8 @@ void QueryWidget::execute(const QString& text) {
   shell_widget_->executeText(text);
 }
 
-void QueryWidget::executeArgs(const QString& text, size_t repeat, int interval, bool history) {
-  shell_widget_->executeArgs(text, repeat, interval, history);
+void QueryWidget::executeArgs(const QString& text, size_t repeat, int interval, bool history, bool silence) {
+  shell_widget_->executeArgs(text, repeat, interval, history, silence);
 }
 
 void QueryWidget::reload() {}
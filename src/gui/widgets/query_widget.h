@@ -46,7 +46,7 @@ class QueryWidget : public BaseWidget {
   QString inputText() const;
   void setInputText(const QString& text);
 
-  void executeArgs(const QString& text, size_t repeat, int interval, bool history);
+  void executeArgs(const QString& text, size_t repeat, int interval, bool history, bool silence);
 
  public Q_SLOTS:
   void execute(const QString& text);
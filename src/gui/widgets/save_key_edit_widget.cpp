@@ -68,6 +68,10 @@ void SaveKeyEditWidget::setEnableKeyEdit(bool enable) {
   editor_->setEnableKeyEdit(enable);
 }
 
+void SaveKeyEditWidget::setViewCacheScope(const std::string& connection, const std::string& db) {
+  editor_->setViewCacheScope(connection, db);
+}
+
 void SaveKeyEditWidget::keySave() {
   if (!init_key_) {
     return;
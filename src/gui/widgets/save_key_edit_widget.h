@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <string>
 #include <vector>
 
 #include <common/optional.h>
@@ -52,6 +53,7 @@ class SaveKeyEditWidget : public BaseWidget {
 
   void initialize(const std::vector<common::Value::Type>& availible_types, const core::NDbKValue& key);
   void setEnableKeyEdit(bool enable);
+  void setViewCacheScope(const std::string& connection, const std::string& db);
 
   void startSaveKey();
   void finishSaveKey();
@@ -18,6 +18,8 @@
 
 #include "gui/widgets/stream_type_widget.h"
 
+#include <utility>
+
 #include <QHeaderView>
 
 #include <common/qt/convert2string.h>
@@ -54,6 +56,7 @@ class StreamTypeWidget::StreamTableModel : public HashTableModel {
 StreamTypeWidget::StreamTypeWidget(QWidget* parent) : QTableView(parent) {
   model_ = new StreamTableModel(this);
   setModel(model_);
+  VERIFY(connect(model_, &StreamTableModel::moreRequested, this, &StreamTypeWidget::moreRequested));
 
   setColumnHidden(HashTableModel::kValue, true);
 
@@ -78,6 +81,24 @@ void StreamTypeWidget::insertStream(const core::StreamValue::Stream& stream) {
   emit dataChangedSignal();
 }
 
+void StreamTypeWidget::appendStreams(const std::vector<core::StreamValue::Stream>& streams) {
+  StreamTableModel::rows_t rows;
+  rows.reserve(streams.size());
+  for (const auto& stream : streams) {
+    rows.push_back(std::make_pair(stream.sid, StreamTableModel::value_t()));
+  }
+  streams_.insert(streams_.end(), streams.begin(), streams.end());
+  model_->appendRows(rows);
+}
+
+bool StreamTypeWidget::hasMore() const {
+  return model_->hasMore();
+}
+
+void StreamTypeWidget::setHasMore(bool more) {
+  model_->setHasMore(more);
+}
+
 void StreamTypeWidget::updateStream(const QModelIndex& index, const core::StreamValue::Stream& stream) {
   if (!index.isValid()) {
     return;
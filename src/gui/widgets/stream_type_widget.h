@@ -38,8 +38,13 @@ class StreamTypeWidget : public QTableView {
   void insertStream(const core::StreamValue::Stream& stream);
   void clear();
 
+  void appendStreams(const std::vector<core::StreamValue::Stream>& streams);  // page loaded from server
+  bool hasMore() const;
+  void setHasMore(bool more);
+
  Q_SIGNALS:
   void dataChangedSignal();
+  void moreRequested();
 
  private Q_SLOTS:
   void editRow(const QModelIndex& index);
@@ -0,0 +1,39 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/workers/result_exporter.h"
+
+namespace fastonosql {
+namespace gui {
+
+ResultExporter::ResultExporter(const std::vector<core::FastoObjectCommandIPtr>& commands,
+                               ResultFormat format,
+                               const QString& path,
+                               QObject* parent)
+    : QObject(parent), commands_(commands), format_(format), path_(path) {
+  qRegisterMetaType<common::Error>("common::Error");
+}
+
+void ResultExporter::routine() {
+  const auto progress = [this](int percent) { emit progressChanged(percent); };
+  common::Error err = exportCommandsResult(commands_, format_, path_, progress);
+  emit exportFinished(err);
+}
+
+}  // namespace gui
+}  // namespace fastonosql
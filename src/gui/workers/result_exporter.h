@@ -0,0 +1,57 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include <QObject>
+#include <QString>
+
+#include <common/error.h>
+
+#include "gui/result_writer.h"
+
+namespace fastonosql {
+namespace gui {
+
+// writes replies of executed commands to file off the gui thread
+class ResultExporter : public QObject {
+  Q_OBJECT
+
+ public:
+  ResultExporter(const std::vector<core::FastoObjectCommandIPtr>& commands,
+                 ResultFormat format,
+                 const QString& path,
+                 QObject* parent = Q_NULLPTR);
+
+ Q_SIGNALS:
+  void progressChanged(int percent);
+  void exportFinished(common::Error err);
+
+ public Q_SLOTS:
+  void routine();
+
+ private:
+  const std::vector<core::FastoObjectCommandIPtr> commands_;
+  const ResultFormat format_;
+  const QString path_;
+};
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -26,8 +26,18 @@ namespace fastonosql {
 namespace gui {
 
 TestConnection::TestConnection(proxy::IConnectionSettingsBaseSPtr conn, QObject* parent)
-    : QObject(parent), connection_(conn), start_time_(common::time::current_utc_mstime()) {
+    : QObject(parent),
+      connection_(conn),
+      start_time_(common::time::current_utc_mstime()),
+      diagnose_(false),
+      options_() {
   qRegisterMetaType<common::Error>("common::Error");
+  qRegisterMetaType<proxy::ConnectionDiagnostics>("proxy::ConnectionDiagnostics");
+}
+
+void TestConnection::setDiagnosticsOptions(const proxy::DiagnosticsOptions& options) {
+  diagnose_ = true;
+  options_ = options;
 }
 
 common::time64_t TestConnection::elipsedTime() const {
@@ -40,6 +50,15 @@ void TestConnection::routine() {
     return;
   }
 
+  if (diagnose_) {
+    proxy::ConnectionDiagnostics diagnostics;
+    const common::Error err =
+        proxy::ServersManager::GetInstance().DiagnoseConnection(connection_, options_, &diagnostics);
+    emit diagnosticsResult(err, diagnostics);
+    emit connectionResult(err, elipsedTime());
+    return;
+  }
+
   const common::Error err = proxy::ServersManager::GetInstance().TestConnection(connection_);
   const qint64 msec_exec = elipsedTime();
   emit connectionResult(err, msec_exec);
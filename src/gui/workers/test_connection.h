@@ -20,6 +20,7 @@
 
 #include <QObject>
 
+#include "proxy/connection_diagnostics.h"
 #include "proxy/connection_settings/iconnection_settings.h"
 
 namespace fastonosql {
@@ -31,8 +32,12 @@ class TestConnection : public QObject {
  public:
   explicit TestConnection(proxy::IConnectionSettingsBaseSPtr conn, QObject* parent = Q_NULLPTR);
 
+  // routine runs full diagnostics instead of plain connect and reports them with diagnosticsResult
+  void setDiagnosticsOptions(const proxy::DiagnosticsOptions& options);
+
  Q_SIGNALS:
   void connectionResult(common::Error err, qint64 mstime_exec);
+  void diagnosticsResult(common::Error err, proxy::ConnectionDiagnostics diagnostics);
 
  public Q_SLOTS:
   void routine();
@@ -42,6 +47,8 @@ class TestConnection : public QObject {
 
   proxy::IConnectionSettingsBaseSPtr connection_;
   common::time64_t start_time_;
+  bool diagnose_;
+  proxy::DiagnosticsOptions options_;
 };
 
 }  // namespace gui
@@ -0,0 +1,152 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/auto_connect_job.h"
+
+#include <common/macros.h>
+
+#include "proxy/server/iserver.h"
+
+namespace fastonosql {
+namespace proxy {
+
+namespace {
+const size_t kDefaultConcurrency = 8;
+}  // namespace
+
+AutoConnectOptions::AutoConnectOptions() : concurrency(kDefaultConcurrency), defer_discovery(true) {}
+
+AutoConnectServerState::AutoConnectServerState() : name(), state(QUEUED), elapsed_msec(0), err() {}
+
+AutoConnectJob::AutoConnectJob(const servers_t& servers, const AutoConnectOptions& options, QObject* parent)
+    : QObject(parent), options_(options), batch_(options.concurrency), states_() {
+  batch_.Reset(servers);
+}
+
+AutoConnectJob::~AutoConnectJob() {
+  batch_.Close(this);
+}
+
+AutoConnectJob::servers_t AutoConnectJob::GetServers() const {
+  return batch_.GetServers();
+}
+
+AutoConnectJob::states_t AutoConnectJob::GetStates() const {
+  return states_;
+}
+
+bool AutoConnectJob::IsRunning() const {
+  return batch_.IsRunning();
+}
+
+void AutoConnectJob::Start() {
+  if (batch_.IsRunning()) {
+    return;
+  }
+
+  const servers_t servers = batch_.GetServers();
+  batch_.Reset(servers);
+  states_.assign(servers.size(), AutoConnectServerState());
+  for (size_t i = 0; i < servers.size(); ++i) {
+    states_[i].name = servers[i]->GetName();
+  }
+
+  if (servers.empty()) {
+    emit Finished(states_);
+    return;
+  }
+
+  batch_.Open();
+  for (auto server : servers) {
+    VERIFY(connect(server.get(), &IServer::ConnectFinished, this, &AutoConnectJob::ServerConnected,
+                   Qt::DirectConnection));
+  }
+  ConnectNext();
+}
+
+void AutoConnectJob::Stop() {
+  if (!batch_.IsRunning()) {
+    return;
+  }
+
+  batch_.SkipQueued();  // queued servers are left unconnected, started connects are interrupted
+  for (size_t i = 0; i < states_.size() && batch_.IsRunning(); ++i) {
+    if (states_[i].state == AutoConnectServerState::CONNECTING) {
+      batch_.GetServer(i)->StopCurrentEvent();
+    }
+    if (states_[i].state == AutoConnectServerState::QUEUED ||
+        states_[i].state == AutoConnectServerState::CONNECTING) {
+      FinishServer(i, common::make_error(common::COMMON_EINTR));
+    }
+  }
+}
+
+void AutoConnectJob::ConnectNext() {
+  size_t index = 0;
+  while (batch_.IsRunning() && batch_.TakeNext(&index)) {
+    IServerSPtr server = batch_.GetServer(index);
+    if (server->IsConnected()) {
+      FinishServer(index, common::Error());
+      continue;
+    }
+
+    batch_.StartClock(index);
+    states_[index].state = AutoConnectServerState::CONNECTING;
+    emit StateChanged(index, states_[index]);
+
+    events_info::ConnectInfoRequest req(this, options_.defer_discovery);
+    server->Connect(req);
+  }
+}
+
+void AutoConnectJob::ServerConnected(const events_info::ConnectInfoResponse& res) {
+  size_t index = 0;
+  if (res.initiator() != this || !batch_.IsRunning() || !batch_.FindServer(sender(), &index)) {
+    return;
+  }
+
+  if (states_[index].state == AutoConnectServerState::CONNECTING) {
+    FinishServer(index, res.errorInfo());
+  }
+}
+
+void AutoConnectJob::FinishServer(size_t index, common::Error err) {
+  AutoConnectServerState& state = states_[index];
+  state.elapsed_msec = batch_.FinishServer(index);
+  state.state = err ? AutoConnectServerState::FAILED : AutoConnectServerState::CONNECTED;
+  state.err = err;
+  emit StateChanged(index, state);
+
+  if (!batch_.IsAllDone()) {
+    ConnectNext();
+    return;
+  }
+
+  Finish();
+}
+
+void AutoConnectJob::Finish() {
+  if (!batch_.Close(this)) {
+    return;
+  }
+
+  emit Finished(states_);
+}
+
+}  // namespace proxy
+}  // namespace fastonosql
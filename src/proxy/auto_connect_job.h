@@ -0,0 +1,90 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <QObject>
+
+#include <common/error.h>
+
+#include "proxy/events/events_info.h"
+#include "proxy/proxy_fwd.h"
+#include "proxy/server_batch.h"
+
+namespace fastonosql {
+namespace proxy {
+
+struct AutoConnectOptions {
+  AutoConnectOptions();
+
+  size_t concurrency;    // connects in flight at once, 0 - all servers at once
+  bool defer_discovery;  // discovery and databases are loaded on first use of server
+};
+
+struct AutoConnectServerState {
+  enum State { QUEUED = 0, CONNECTING, CONNECTED, FAILED };
+  AutoConnectServerState();
+
+  std::string name;
+  State state;
+  common::time64_t elapsed_msec;
+  common::Error err;
+};
+
+// Connects many servers with bounded parallelism, each server connects in own driver thread.
+// Failed server does not stop others, states are kept per server in order of servers.
+class AutoConnectJob : public QObject {
+  Q_OBJECT
+
+ public:
+  typedef ServerBatch::servers_t servers_t;
+  typedef std::vector<AutoConnectServerState> states_t;
+
+  AutoConnectJob(const servers_t& servers, const AutoConnectOptions& options, QObject* parent = Q_NULLPTR);
+  ~AutoConnectJob() override;
+
+  servers_t GetServers() const;
+  states_t GetStates() const;
+  bool IsRunning() const;
+
+  void Start();
+  void Stop();
+
+ Q_SIGNALS:
+  void StateChanged(size_t index, const fastonosql::proxy::AutoConnectServerState& state);
+  void Finished(const fastonosql::proxy::AutoConnectJob::states_t& states);
+
+ private Q_SLOTS:
+  void ServerConnected(const events_info::ConnectInfoResponse& res);
+
+ private:
+  void ConnectNext();
+  void FinishServer(size_t index, common::Error err);
+  void Finish();
+
+  const AutoConnectOptions options_;
+
+  ServerBatch batch_;
+  states_t states_;
+};
+
+}  // namespace proxy
+}  // namespace fastonosql
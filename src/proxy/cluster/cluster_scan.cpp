@@ -0,0 +1,279 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/cluster/cluster_scan.h"
+
+#include <string>
+
+#include <common/convert2string.h>
+#include <common/macros.h>
+
+#include <fastonosql/core/macros.h>
+
+#include "proxy/cluster/icluster.h"
+#include "proxy/server/iserver_remote.h"
+
+namespace fastonosql {
+namespace proxy {
+
+namespace {
+const core::keys_limit_t kDefaultPageSize = 1000;
+}  // namespace
+
+ClusterScanOptions::ClusterScanOptions()
+    : pattern(ALL_KEYS_PATTERNS), page_size(kDefaultPageSize), keys_per_node_limit(0) {}
+
+ClusterScanNodeProgress::ClusterScanNodeProgress()
+    : name(), scanned_keys(0), merged_keys(0), pages(0), db_keys_count(0), elapsed_msec(0), done(false), err() {}
+
+ClusterScan::ClusterScan(IClusterSPtr cluster, const ClusterScanOptions& options, QObject* parent)
+    : QObject(parent), cluster_(cluster), options_(options), batch_(), nodes_(), progress_(), keys_() {
+  CHECK(cluster_);
+}
+
+ClusterScan::~ClusterScan() {
+  batch_.Close(this);
+}
+
+IClusterSPtr ClusterScan::GetCluster() const {
+  return cluster_;
+}
+
+ClusterScanOptions ClusterScan::GetOptions() const {
+  return options_;
+}
+
+ClusterScan::progress_t ClusterScan::GetProgress() const {
+  return progress_;
+}
+
+size_t ClusterScan::GetKeysCount() const {
+  return keys_.size();
+}
+
+bool ClusterScan::IsRunning() const {
+  return batch_.IsRunning();
+}
+
+void ClusterScan::Start() {
+  if (batch_.IsRunning()) {
+    return;
+  }
+
+  if (options_.page_size == 0) {
+    emit Finished(common::make_error_inval());
+    return;
+  }
+
+  ServerBatch::servers_t masters;
+  nodes_.clear();
+  progress_.clear();
+  keys_.clear();
+  for (auto node : cluster_->GetNodes()) {
+    IServerRemote* rserver = dynamic_cast<IServerRemote*>(node.get());  // +
+    if (!rserver || rserver->GetRole() != core::MASTER) {
+      continue;  // replicas hold the same keys
+    }
+
+    NodeState state;
+    state.cursor = 0;
+    state.in_flight = false;
+    nodes_.push_back(state);
+    masters.push_back(node);
+
+    ClusterScanNodeProgress progress;
+    progress.name = node->GetName();
+    progress_.push_back(progress);
+  }
+
+  if (nodes_.empty()) {
+    emit Finished(common::make_error("Cluster has no master nodes."));
+    return;
+  }
+
+  batch_.Reset(masters);
+  batch_.Open();
+  for (auto master : masters) {
+    IServer* server = master.get();
+    VERIFY(connect(server, &IServer::ConnectFinished, this, &ClusterScan::NodeConnected, Qt::DirectConnection));
+    VERIFY(connect(server, &IServer::LoadDiscoveryInfoFinished, this, &ClusterScan::NodeDiscovered,
+                   Qt::DirectConnection));
+    VERIFY(connect(server, &IServer::LoadDatabaseContentFinished, this, &ClusterScan::PageLoaded,
+                   Qt::DirectConnection));
+  }
+
+  // all requests go out before any answer, each node works in parallel
+  size_t index = 0;
+  while (batch_.IsRunning() && batch_.TakeNext(&index)) {
+    IServerSPtr server = batch_.GetServer(index);
+    if (!server->IsConnected()) {
+      events_info::ConnectInfoRequest req(this);
+      server->Connect(req);
+    } else if (server->GetCurrentDatabaseInfo()) {
+      ScanNext(index);
+    } else {
+      // connected in background without discovery (or it is still running), scan continues from NodeDiscovered
+      server->LoadDeferredDiscovery();
+    }
+  }
+}
+
+void ClusterScan::Stop() {
+  if (!batch_.IsRunning()) {
+    return;
+  }
+
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    if (nodes_[i].in_flight) {
+      batch_.GetServer(i)->StopCurrentEvent();
+    }
+  }
+  Finish(common::make_error(common::COMMON_EINTR));
+}
+
+void ClusterScan::NodeConnected(const events_info::ConnectInfoResponse& res) {
+  size_t index = 0;
+  if (!batch_.IsRunning() || !batch_.FindServer(sender(), &index)) {
+    return;
+  }
+
+  common::Error err = res.errorInfo();
+  if (err) {
+    FinishNode(index, err);
+  }
+}
+
+void ClusterScan::NodeDiscovered(const events_info::DiscoveryInfoResponse& res) {
+  size_t index = 0;
+  if (!batch_.IsRunning() || !batch_.FindServer(sender(), &index) || progress_[index].done ||
+      nodes_[index].in_flight) {
+    return;
+  }
+
+  common::Error err = res.errorInfo();
+  if (err) {
+    FinishNode(index, err);
+    return;
+  }
+
+  ScanNext(index);
+}
+
+void ClusterScan::ScanNext(size_t index) {
+  NodeState& state = nodes_[index];
+  batch_.StartClock(index);
+
+  core::keys_limit_t count = options_.page_size;
+  if (options_.keys_per_node_limit) {
+    const size_t left = options_.keys_per_node_limit - progress_[index].scanned_keys;
+    if (left < count) {
+      count = static_cast<core::keys_limit_t>(left);
+    }
+  }
+
+  state.in_flight = true;
+  IServerSPtr server = batch_.GetServer(index);
+  events_info::LoadDatabaseContentRequest req(this, server->GetCurrentDatabaseInfo(), options_.pattern, count,
+                                              state.cursor);
+  server->LoadDatabaseContent(req);
+}
+
+void ClusterScan::PageLoaded(const events_info::LoadDatabaseContentResponse& res) {
+  size_t index = 0;
+  if (res.initiator() != this || !batch_.IsRunning() || !batch_.FindServer(sender(), &index)) {
+    return;
+  }
+
+  NodeState& state = nodes_[index];
+  state.in_flight = false;
+  common::Error err = res.errorInfo();
+  if (err) {
+    FinishNode(index, err);
+    return;
+  }
+
+  ClusterScanNodeProgress& progress = progress_[index];
+  progress.pages++;
+  progress.scanned_keys += res.keys.size();
+  progress.db_keys_count = res.db_keys_count;
+  progress.elapsed_msec = batch_.GetElapsed(index);
+
+  keys_t merged;
+  merged.reserve(res.keys.size());
+  for (const core::NDbKValue& key : res.keys) {
+    const std::string key_str = common::ConvertToString(key.GetKey().GetKey().GetForCommandLine());
+    if (keys_.insert(std::make_pair(key_str, index)).second) {
+      merged.push_back({key, index});
+    }
+  }
+  progress.merged_keys += merged.size();
+  if (!merged.empty()) {
+    emit KeysMerged(merged);
+  }
+
+  state.cursor = res.cursor_out;
+  const bool limit_reached = options_.keys_per_node_limit && progress.scanned_keys >= options_.keys_per_node_limit;
+  if (state.cursor == 0 || limit_reached) {
+    FinishNode(index, common::Error());
+    return;
+  }
+
+  emit NodeProgressed(index, progress);
+  ScanNext(index);
+}
+
+void ClusterScan::FinishNode(size_t index, common::Error err) {
+  ClusterScanNodeProgress& progress = progress_[index];
+  if (progress.done) {
+    return;
+  }
+
+  progress.done = true;
+  progress.err = err;
+  progress.elapsed_msec = batch_.FinishServer(index);
+  emit NodeProgressed(index, progress);
+  if (!batch_.IsAllDone()) {
+    return;
+  }
+
+  size_t failed = 0;
+  for (const ClusterScanNodeProgress& node_progress : progress_) {
+    if (node_progress.err) {
+      failed++;
+    }
+  }
+
+  if (failed) {
+    Finish(common::make_error("Scan failed on " + std::to_string(failed) + " of " + std::to_string(progress_.size()) +
+                              " nodes."));
+    return;
+  }
+
+  Finish(common::Error());
+}
+
+void ClusterScan::Finish(common::Error err) {
+  if (!batch_.Close(this)) {
+    return;
+  }
+
+  emit Finished(err);
+}
+
+}  // namespace proxy
+}  // namespace fastonosql
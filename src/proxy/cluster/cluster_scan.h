@@ -0,0 +1,116 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <QObject>
+
+#include <common/error.h>
+
+#include <fastonosql/core/types.h>
+
+#include "proxy/events/events_info.h"
+#include "proxy/proxy_fwd.h"
+#include "proxy/server_batch.h"
+
+namespace fastonosql {
+namespace proxy {
+
+struct ClusterScanOptions {
+  ClusterScanOptions();
+
+  core::pattern_t pattern;
+  core::keys_limit_t page_size;  // keys per scan page
+  size_t keys_per_node_limit;    // 0 - unlimited
+};
+
+struct ClusterScanNodeProgress {
+  ClusterScanNodeProgress();
+
+  std::string name;
+  size_t scanned_keys;
+  size_t merged_keys;  // not seen on other nodes before
+  size_t pages;
+  core::keys_limit_t db_keys_count;
+  common::time64_t elapsed_msec;
+  bool done;
+  common::Error err;
+};
+
+struct ClusterScanKey {
+  core::NDbKValue key;
+  size_t node;  // index in progress
+};
+
+// Scans all cluster masters at once, every node pages SCAN in own driver thread,
+// so whole scan takes time of slowest shard. Keys are merged into one deduplicated set,
+// same key can come twice from replica reported as master or slot migrated during scan.
+class ClusterScan : public QObject {
+  Q_OBJECT
+
+ public:
+  typedef std::vector<ClusterScanNodeProgress> progress_t;
+  typedef std::vector<ClusterScanKey> keys_t;
+
+  ClusterScan(IClusterSPtr cluster, const ClusterScanOptions& options, QObject* parent = Q_NULLPTR);
+  ~ClusterScan() override;
+
+  IClusterSPtr GetCluster() const;
+  ClusterScanOptions GetOptions() const;
+  progress_t GetProgress() const;
+  size_t GetKeysCount() const;
+  bool IsRunning() const;
+
+  void Start();
+  void Stop();
+
+ Q_SIGNALS:
+  void NodeProgressed(size_t index, const fastonosql::proxy::ClusterScanNodeProgress& progress);
+  void KeysMerged(const fastonosql::proxy::ClusterScan::keys_t& keys);  // only new keys
+  void Finished(common::Error err);
+
+ private Q_SLOTS:
+  void NodeConnected(const events_info::ConnectInfoResponse& res);
+  void NodeDiscovered(const events_info::DiscoveryInfoResponse& res);
+  void PageLoaded(const events_info::LoadDatabaseContentResponse& res);
+
+ private:
+  struct NodeState {
+    core::cursor_t cursor;
+    bool in_flight;
+  };
+
+  void ScanNext(size_t index);
+  void FinishNode(size_t index, common::Error err);
+  void Finish(common::Error err);
+
+  const IClusterSPtr cluster_;
+  const ClusterScanOptions options_;
+
+  ServerBatch batch_;  // masters, all scanned at once
+  std::vector<NodeState> nodes_;
+  progress_t progress_;
+  std::unordered_map<std::string, size_t> keys_;  // key -> node which reported it first
+};
+
+}  // namespace proxy
+}  // namespace fastonosql
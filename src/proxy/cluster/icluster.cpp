@@ -18,12 +18,33 @@
 
 #include "proxy/cluster/icluster.h"
 
+#include <common/convert2string.h>
+#include <common/qt/logger.h>
+#include <common/sprintf.h>
+#include <common/time.h>
+
 #include "proxy/server/iserver_remote.h"
 
+#define CLUSTER_NODES_COMMAND "CLUSTER NODES"
+#define ASKING_COMMAND "ASKING"
+#define SLOTS_LOADING_TIMEOUT_MSEC 10000
+#define MAX_REDIRECTS 16
+
 namespace fastonosql {
 namespace proxy {
 
-ICluster::ICluster(const std::string& name) : name_(name) {}
+ICluster::PendingRequest::PendingRequest(IServer* origin, const events_info::ExecuteInfoRequest& request)
+    : origin(origin), response(request), parts(), redirects(0) {}
+
+ICluster::ICluster(const std::string& name)
+    : name_(name),
+      nodes_(),
+      nodes_by_host_(),
+      connecting_(),
+      slots_(),
+      slots_loading_(false),
+      slots_loading_msec_(0),
+      pending_() {}
 
 std::string ICluster::GetName() const {
   return name_;
@@ -34,7 +55,14 @@ ICluster::nodes_t ICluster::GetNodes() const {
 }
 
 void ICluster::AddServer(node_t serv) {
+  serv->SetCluster(this);
   VERIFY(QObject::connect(serv.get(), &IServer::RedirectRequested, this, &ICluster::RedirectRequest));
+  VERIFY(QObject::connect(serv.get(), &IServer::ConnectFinished, this, &ICluster::NodeConnected));
+  VERIFY(QObject::connect(serv.get(), &IServer::ExecuteFinished, this, &ICluster::SlotsLoaded));
+  IServerRemote* rserver = dynamic_cast<IServerRemote*>(serv.get());  // +
+  if (rserver) {
+    nodes_by_host_[common::ConvertToString(rserver->GetHost())] = serv;
+  }
   nodes_.push_back(serv);
 }
 
@@ -50,24 +78,320 @@ ICluster::node_t ICluster::GetRoot() const {
   return node_t();
 }
 
+ICluster::node_t ICluster::FindNodeBySlot(cluster_slot_t slot) const {
+  common::net::HostAndPort host;
+  if (slots_.GetNode(slot, &host)) {
+    node_t node = FindNodeByHost(host);
+    if (node) {
+      return node;
+    }
+  }
+
+  return GetRoot();  // redirect will fix it
+}
+
+ICluster::node_t ICluster::FindNodeForCommand(const core::command_buffer_t& command, IServer* origin) const {
+  node_t addressed = origin ? FindNode(origin) : GetRoot();
+  if (!addressed || slots_.IsEmpty()) {
+    return addressed;
+  }
+
+  const core::CommandHolder* cmd = nullptr;
+  core::commands_args_t argv;
+  size_t off = 0;
+  core::translator_t tran = addressed->GetTranslator();
+  common::Error err = tran->FindCommand(command, &cmd, &argv, &off);
+  if (err) {
+    return addressed;  // unknown command, let server answer
+  }
+
+  std::vector<std::string> args;
+  for (const auto& arg : argv) {
+    args.push_back(common::ConvertToString(arg));
+  }
+
+  std::string key;
+  if (!GetCommandKey(args, &key)) {
+    return addressed;  // keyless command, addressed node answers
+  }
+
+  return FindNodeBySlot(GetKeyHashSlot(key));
+}
+
+void ICluster::Execute(const events_info::ExecuteInfoRequest& req) {
+  Execute(nullptr, req);
+}
+
+void ICluster::Execute(IServer* origin, const events_info::ExecuteInfoRequest& req) {
+  node_t addressed = origin ? FindNode(origin) : GetRoot();
+  if (!addressed) {
+    return;
+  }
+
+  IServer* reporter = origin ? origin : addressed.get();
+  commands_t commands;
+  common::Error err = ParseCommands(req.text, &commands);
+  if (err || commands.empty()) {
+    ConnectNode(addressed);
+    reporter->ExecuteDirect(req, addressed.get());  // driver answers with parse error
+    return;
+  }
+
+  // consecutive commands for the same owner stay in one part
+  PendingRequest pending(reporter, req);
+  for (const core::command_buffer_t& command : commands) {
+    node_t node = FindNodeForCommand(command, origin);
+    if (!node) {
+      node = addressed;
+    }
+    if (pending.parts.empty() || pending.parts.back().node != node) {
+      pending.parts.push_back(Part{node, commands_t(), 0, false});
+    }
+    pending.parts.back().commands.push_back(command);
+  }
+
+  reporter->NotifyExecuteStarted(req);
+  if (pending.parts.size() > 1 && req.repeat) {
+    // rounds run inside one driver, they can't be kept in step over several nodes
+    pending.response.setErrorInfo(common::make_error("Repeat is not supported for commands of several cluster nodes"));
+    reporter->NotifyExecuteFinished(pending.response);
+    return;
+  }
+
+  pending.parts.front().repeat = req.repeat;
+  QObject* token = new QObject(this);
+  const auto it = pending_.emplace(token, pending).first;
+  ExecutePart(token, it->second);
+}
+
+void ICluster::RefreshSlots() {
+  const common::time64_t now = common::time::current_utc_mstime();
+  if (slots_loading_ && now - slots_loading_msec_ < SLOTS_LOADING_TIMEOUT_MSEC) {
+    return;
+  }
+
+  node_t source = GetRoot();
+  if (!source || !source->IsConnected()) {
+    source.reset();
+    for (auto node : nodes_) {
+      if (node->IsConnected()) {
+        source = node;
+        break;
+      }
+    }
+  }
+
+  if (!source) {
+    slots_loading_ = false;
+    return;  // loaded on first connect
+  }
+
+  // stale load (timed out or lost with its node) is replaced, answer of it is ignored by initiator check
+  slots_loading_ = true;
+  slots_loading_msec_ = now;
+  events_info::ExecuteInfoRequest req(this, GEN_CMD_STRING(CLUSTER_NODES_COMMAND), 0, 0, false, true, core::C_INNER);
+  source->ExecuteDirect(req);
+}
+
+bool ICluster::HandlePartExecuted(const events_info::ExecuteInfoResponse& res) {
+  const auto it = pending_.find(res.initiator());
+  if (it == pending_.end()) {
+    return false;
+  }
+
+  PendingRequest& pending = it->second;
+  const Part& part = pending.parts.front();
+  for (size_t i = 0; i < res.executed_commands.size(); ++i) {
+    if (!part.asking || i % 2) {  // answers of ASKING aren't part of user request
+      pending.response.executed_commands.push_back(res.executed_commands[i]);
+    }
+  }
+  pending.response.loaded_keys.insert(pending.response.loaded_keys.end(), res.loaded_keys.begin(),
+                                      res.loaded_keys.end());
+
+  common::Error err = res.errorInfo();
+  if (err) {
+    auto payload = err->GetPayload();
+    if (err->GetErrorCode() == common::COMMON_EINTR && payload) {
+      const common::net::HostAndPortAndSlot host = *static_cast<common::net::HostAndPortAndSlot*>(payload);
+      err = RedirectPart(host, res, &pending);
+      if (!err) {
+        ExecutePart(it->first, pending);
+        return true;
+      }
+    }
+
+    pending.response.setErrorInfo(err);
+    FinishRequest(it);
+    return true;
+  }
+
+  pending.parts.pop_front();
+  if (pending.parts.empty()) {
+    FinishRequest(it);
+    return true;
+  }
+
+  ExecutePart(it->first, pending);
+  return true;
+}
+
 void ICluster::RedirectRequest(const common::net::HostAndPortAndSlot& host,
                                const events_info::ExecuteInfoRequest& req) {
+  UNUSED(req);
+  // direct requests skip routing and are answered by the node they were sent to, only owner of slot is learned
+  const common::net::HostAndPort owner = host;  // without slot
+  if (!slots_.IsImporting(host.GetSlot(), owner)) {
+    slots_.SetNode(host.GetSlot(), owner);
+  }
+  RefreshSlots();
+}
+
+void ICluster::NodeConnected(const events_info::ConnectInfoResponse& res) {
+  IServer* node = qobject_cast<IServer*>(sender());
+  connecting_.erase(node);
+  if (res.errorInfo()) {
+    return;
+  }
+
+  if (slots_.IsEmpty()) {
+    RefreshSlots();
+  }
+}
+
+void ICluster::SlotsLoaded(const events_info::ExecuteInfoResponse& res) {
+  if (res.initiator() != this || !slots_loading_) {
+    return;
+  }
+
+  slots_loading_ = false;
+  common::Error err = res.errorInfo();
+  if (err) {
+    LOG_ERROR(err, common::logging::LOG_LEVEL_WARNING, false);
+    return;
+  }
+
+  if (res.executed_commands.size() != 1) {
+    return;
+  }
+
+  const auto childs = res.executed_commands[0]->GetChildrens();
+  if (childs.size() != 1) {
+    return;
+  }
+
+  common::Value::string_t nodes_text;
+  if (!childs[0]->GetValue()->GetAsString(&nodes_text)) {
+    return;
+  }
+
+  err = slots_.LoadFromClusterNodes(common::ConvertToString(nodes_text));
+  if (err) {
+    LOG_ERROR(err, common::logging::LOG_LEVEL_WARNING, false);
+    return;
+  }
+
+  // keep owners connected, so routed commands never wait for connect
+  for (const common::net::HostAndPort& host : slots_.GetHosts()) {
+    node_t node = FindNodeByHost(host);
+    if (node) {
+      ConnectNode(node);
+    }
+  }
+}
+
+ICluster::node_t ICluster::FindNodeByHost(const common::net::HostAndPort& host) const {
+  const auto it = nodes_by_host_.find(common::ConvertToString(host));
+  if (it == nodes_by_host_.end()) {
+    return node_t();
+  }
+
+  return it->second;
+}
+
+ICluster::node_t ICluster::FindNode(IServer* server) const {
   for (auto node : nodes_) {
-    IServerRemote* rserver = dynamic_cast<IServerRemote*>(node.get());  // +
-    if (!rserver) {
-      continue;
+    if (node.get() == server) {
+      return node;
     }
+  }
+
+  return node_t();
+}
+
+void ICluster::ConnectNode(node_t node) {
+  // driver handles events in order, so execute waits behind queued connect
+  if (!node->IsConnected() && connecting_.insert(node.get()).second) {
+    events_info::ConnectInfoRequest connect_req(this);
+    node->Connect(connect_req);
+  }
+}
 
-    common::net::HostAndPort server_host = rserver->GetHost();
-    if (server_host == host) {
-      proxy::events_info::ConnectInfoRequest connect_req(this);
-      rserver->Connect(connect_req);
-      events_info::ExecuteInfoRequest exec_req(req.initiator(), req.text, req.repeat, req.msec_repeat_interval,
-                                               req.history, req.silence, req.logtype);
-      rserver->Execute(exec_req);
-      return;
+void ICluster::ExecutePart(QObject* token, const PendingRequest& pending) {
+  const Part& part = pending.parts.front();
+  core::command_buffer_writer_t wr;
+  for (const core::command_buffer_t& command : part.commands) {
+    if (part.asking) {
+      wr << GEN_CMD_STRING(ASKING_COMMAND) << "\n";
     }
+    wr << command << "\n";
   }
+
+  const events_info::ExecuteInfoResponse& req = pending.response;
+  events_info::ExecuteInfoRequest part_req(token, wr.str(), part.repeat, req.msec_repeat_interval, req.history,
+                                           req.silence, req.logtype, req.notify_keys);
+  ConnectNode(part.node);
+  pending.origin->ExecutePart(part_req, part.node.get());
+}
+
+common::Error ICluster::RedirectPart(const common::net::HostAndPortAndSlot& host,
+                                     const events_info::ExecuteInfoResponse& res,
+                                     PendingRequest* pending) {
+  const common::net::HostAndPort owner = host;  // without slot
+  node_t node = FindNodeByHost(owner);
+  if (!node) {
+    return common::make_error("Redirect to unknown cluster node: " + common::ConvertToString(owner));
+  }
+
+  if (++pending->redirects > MAX_REDIRECTS) {
+    return common::make_error("Too many cluster redirects");
+  }
+
+  // commands before the redirected one already ran, only it and the rest are sent again
+  Part& part = pending->parts.front();
+  const size_t step = part.asking ? 2 : 1;
+  const size_t round_size = part.commands.size() * step;
+  const size_t rounds_done = res.executed_commands.size() / round_size;
+  const size_t index = (res.executed_commands.size() % round_size) / step;
+  if (index != 0 && rounds_done < part.repeat) {
+    return common::make_error("Redirected in the middle of a round, " +
+                              common::ConvertToString(part.repeat - rounds_done) + " rounds were not executed");
+  }
+
+  part.commands.erase(part.commands.begin(), part.commands.begin() + index);
+  part.repeat -= rounds_done;
+  part.node = node;
+  // core reports MOVED and ASK alike, ASKING in front is harmless for a new owner and required by importing node;
+  // owner changes only when CLUSTER NODES doesn't show the slot migrating to that node
+  part.asking = true;
+  if (!slots_.IsImporting(host.GetSlot(), owner)) {
+    slots_.SetNode(host.GetSlot(), owner);
+  }
+
+  const std::string redirect_str = common::MemSPrintf("-> Redirected to slot [%d] located at %s:%d", host.GetSlot(),
+                                                      host.GetHost(), host.GetPort());
+  LOG_ERROR(common::make_error(redirect_str), common::logging::LOG_LEVEL_WARNING, true);
+  RefreshSlots();  // slot moved (neighbours likely too) or is migrating
+  return common::Error();
+}
+
+void ICluster::FinishRequest(pending_requests_t::iterator it) {
+  QObject* token = it->first;
+  IServer* origin = it->second.origin;
+  const events_info::ExecuteInfoResponse res = it->second.response;
+  pending_.erase(it);
+  token->deleteLater();
+  origin->NotifyExecuteFinished(res);
 }
 
 }  // namespace proxy
@@ -18,8 +18,16 @@
 
 #pragma once
 
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 #include <common/net/types.h>
+#include <common/types.h>
 
+#include "proxy/cluster/slot_map.h"
 #include "proxy/events/events_info.h"
 #include "proxy/proxy_fwd.h"
 #include "proxy/server/iserver_base.h"
@@ -38,15 +46,67 @@ class ICluster : public IServerBase {
 
   node_t GetRoot() const;
 
+  // client side routing, owners come from cached slot map, root when slot is unknown
+  node_t FindNodeBySlot(cluster_slot_t slot) const;
+  // keyless commands stay on origin (root when origin is null)
+  node_t FindNodeForCommand(const core::command_buffer_t& command, IServer* origin = nullptr) const;
+  // every keyed command goes straight to owner of its key slot, nodes connections are reused,
+  // results are delivered by origin so callers keep listening to the server they asked,
+  // as one ExecuteStarted/ExecuteFinished pair however many nodes the commands went to
+  void Execute(IServer* origin, const events_info::ExecuteInfoRequest& req);
+  void Execute(const events_info::ExecuteInfoRequest& req);
+  void RefreshSlots();
+
+  // answer of a part of routed request, false if response isn't one
+  bool HandlePartExecuted(const events_info::ExecuteInfoResponse& res);
+
  private Q_SLOTS:
   void RedirectRequest(const common::net::HostAndPortAndSlot& host, const events_info::ExecuteInfoRequest& req);
+  void NodeConnected(const events_info::ConnectInfoResponse& res);
+  void SlotsLoaded(const events_info::ExecuteInfoResponse& res);
 
  protected:
   explicit ICluster(const std::string& name);
 
  private:
+  typedef std::vector<core::command_buffer_t> commands_t;
+
+  // consecutive commands of one request for the same node
+  struct Part {
+    node_t node;
+    commands_t commands;
+    size_t repeat;  // request repeat, only when whole request is one part
+    bool asking;    // commands are sent after ASKING, slot is being imported by node
+  };
+
+  // request routed by cluster, parts run one after another so order of commands is kept across nodes
+  struct PendingRequest {
+    PendingRequest(IServer* origin, const events_info::ExecuteInfoRequest& request);
+
+    IServer* origin;                            // reports started and finished of whole request
+    events_info::ExecuteInfoResponse response;  // answers of finished parts are merged into it
+    std::deque<Part> parts;                     // front one is running
+    size_t redirects;
+  };
+  typedef std::unordered_map<QObject*, PendingRequest> pending_requests_t;  // by initiator of parts
+
+  node_t FindNodeByHost(const common::net::HostAndPort& host) const;
+  node_t FindNode(IServer* server) const;
+  void ConnectNode(node_t node);
+  void ExecutePart(QObject* token, const PendingRequest& pending);
+  common::Error RedirectPart(const common::net::HostAndPortAndSlot& host,
+                             const events_info::ExecuteInfoResponse& res,
+                             PendingRequest* pending) WARN_UNUSED_RESULT;
+  void FinishRequest(pending_requests_t::iterator it);
+
   const std::string name_;
   nodes_t nodes_;
+  std::unordered_map<std::string, node_t> nodes_by_host_;
+  std::unordered_set<IServer*> connecting_;  // connect requested, commands are queued behind it
+  ClusterSlotMap slots_;
+  bool slots_loading_;
+  common::time64_t slots_loading_msec_;
+  pending_requests_t pending_;
 };
 
 }  // namespace proxy
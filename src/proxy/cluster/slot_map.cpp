@@ -0,0 +1,363 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "proxy/cluster/slot_map.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+
+#include <common/convert2string.h>
+
+#define CLUSTER_NODES_FIELDS_DELEMITER ' '
+#define CLUSTER_NODES_LINES_DELEMITER '\n'
+#define CLUSTER_NODE_BUS_PORT_DELEMITER '@'
+#define CLUSTER_SLOTS_RANGE_DELEMITER '-'
+#define CLUSTER_MIGRATION_SLOT_MARK '['
+#define CLUSTER_IMPORTING_SLOT_DELEMITER "-<-"
+#define CLUSTER_MASTER_FLAG "master"
+#define CLUSTER_FAIL_FLAG "fail"
+
+#define SCRIPT_NUMKEYS_POS 2
+#define STREAMS_ARG "STREAMS"
+
+#define CLUSTER_NODE_ADDR_FIELD 1
+#define CLUSTER_NODE_FLAGS_FIELD 2
+#define CLUSTER_NODE_FIRST_SLOT_FIELD 8
+
+namespace fastonosql {
+namespace proxy {
+
+namespace {
+
+const uint16_t kCrc16Table[256] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7, 0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad,
+    0xe1ce, 0xf1ef, 0x1231, 0x0210, 0x3273, 0x2252, 0x52b5, 0x4294, 0x72f7, 0x62d6, 0x9339, 0x8318, 0xb37b, 0xa35a,
+    0xd3bd, 0xc39c, 0xf3ff, 0xe3de, 0x2462, 0x3443, 0x0420, 0x1401, 0x64e6, 0x74c7, 0x44a4, 0x5485, 0xa56a, 0xb54b,
+    0x8528, 0x9509, 0xe5ee, 0xf5cf, 0xc5ac, 0xd58d, 0x3653, 0x2672, 0x1611, 0x0630, 0x76d7, 0x66f6, 0x5695, 0x46b4,
+    0xb75b, 0xa77a, 0x9719, 0x8738, 0xf7df, 0xe7fe, 0xd79d, 0xc7bc, 0x48c4, 0x58e5, 0x6886, 0x78a7, 0x0840, 0x1861,
+    0x2802, 0x3823, 0xc9cc, 0xd9ed, 0xe98e, 0xf9af, 0x8948, 0x9969, 0xa90a, 0xb92b, 0x5af5, 0x4ad4, 0x7ab7, 0x6a96,
+    0x1a71, 0x0a50, 0x3a33, 0x2a12, 0xdbfd, 0xcbdc, 0xfbbf, 0xeb9e, 0x9b79, 0x8b58, 0xbb3b, 0xab1a, 0x6ca6, 0x7c87,
+    0x4ce4, 0x5cc5, 0x2c22, 0x3c03, 0x0c60, 0x1c41, 0xedae, 0xfd8f, 0xcdec, 0xddcd, 0xad2a, 0xbd0b, 0x8d68, 0x9d49,
+    0x7e97, 0x6eb6, 0x5ed5, 0x4ef4, 0x3e13, 0x2e32, 0x1e51, 0x0e70, 0xff9f, 0xefbe, 0xdfdd, 0xcffc, 0xbf1b, 0xaf3a,
+    0x9f59, 0x8f78, 0x9188, 0x81a9, 0xb1ca, 0xa1eb, 0xd10c, 0xc12d, 0xf14e, 0xe16f, 0x1080, 0x00a1, 0x30c2, 0x20e3,
+    0x5004, 0x4025, 0x7046, 0x6067, 0x83b9, 0x9398, 0xa3fb, 0xb3da, 0xc33d, 0xd31c, 0xe37f, 0xf35e, 0x02b1, 0x1290,
+    0x22f3, 0x32d2, 0x4235, 0x5214, 0x6277, 0x7256, 0xb5ea, 0xa5cb, 0x95a8, 0x8589, 0xf56e, 0xe54f, 0xd52c, 0xc50d,
+    0x34e2, 0x24c3, 0x14a0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405, 0xa7db, 0xb7fa, 0x8799, 0x97b8, 0xe75f, 0xf77e,
+    0xc71d, 0xd73c, 0x26d3, 0x36f2, 0x0691, 0x16b0, 0x6657, 0x7676, 0x4615, 0x5634, 0xd94c, 0xc96d, 0xf90e, 0xe92f,
+    0x99c8, 0x89e9, 0xb98a, 0xa9ab, 0x5844, 0x4865, 0x7806, 0x6827, 0x18c0, 0x08e1, 0x3882, 0x28a3, 0xcb7d, 0xdb5c,
+    0xeb3f, 0xfb1e, 0x8bf9, 0x9bd8, 0xabbb, 0xbb9a, 0x4a75, 0x5a54, 0x6a37, 0x7a16, 0x0af1, 0x1ad0, 0x2ab3, 0x3a92,
+    0xfd2e, 0xed0f, 0xdd6c, 0xcd4d, 0xbdaa, 0xad8b, 0x9de8, 0x8dc9, 0x7c26, 0x6c07, 0x5c64, 0x4c45, 0x3ca2, 0x2c83,
+    0x1ce0, 0x0cc1, 0xef1f, 0xff3e, 0xcf5d, 0xdf7c, 0xaf9b, 0xbfba, 0x8fd9, 0x9ff8, 0x6e17, 0x7e36, 0x4e55, 0x5e74,
+    0x2e93, 0x3eb2, 0x0ed1, 0x1ef0};
+
+uint16_t Crc16(const char* data, size_t size) {
+  uint16_t crc = 0;
+  for (size_t i = 0; i < size; ++i) {
+    crc = (crc << 8) ^ kCrc16Table[((crc >> 8) ^ static_cast<uint8_t>(data[i])) & 0xff];
+  }
+  return crc;
+}
+
+bool ParseSlot(const std::string& text, cluster_slot_t* slot) {
+  unsigned int value;
+  if (!common::ConvertFromString(text, &value) || value >= kClusterSlotsCount) {
+    return false;
+  }
+
+  *slot = static_cast<cluster_slot_t>(value);
+  return true;
+}
+
+std::vector<std::string> SplitFields(const std::string& line) {
+  std::vector<std::string> fields;
+  size_t start = 0;
+  while (start < line.size()) {
+    size_t end = line.find(CLUSTER_NODES_FIELDS_DELEMITER, start);
+    if (end == std::string::npos) {
+      end = line.size();
+    }
+    if (end != start) {
+      fields.push_back(line.substr(start, end - start));
+    }
+    start = end + 1;
+  }
+  return fields;
+}
+
+std::string ToUpper(const std::string& text) {
+  std::string result = text;
+  std::transform(result.begin(), result.end(), result.begin(), [](char c) { return ::toupper(c); });
+  return result;
+}
+
+// position of first key in argv as COMMAND reports it, commands with numkeys and STREAMS are resolved apart
+int GetFirstKeyPosition(const std::string& name) {
+  static const std::map<std::string, int> positions = {
+      {"APPEND", 1},           {"BITCOUNT", 1},          {"BITFIELD", 1},             {"BITFIELD_RO", 1},
+      {"BITOP", 2},            {"BITPOS", 1},            {"BLMOVE", 1},               {"BLMPOP", 3},
+      {"BLPOP", 1},            {"BRPOP", 1},             {"BRPOPLPUSH", 1},           {"BZMPOP", 3},
+      {"BZPOPMAX", 1},         {"BZPOPMIN", 1},          {"COPY", 1},                 {"DECR", 1},
+      {"DECRBY", 1},           {"DEL", 1},               {"DUMP", 1},                 {"EXISTS", 1},
+      {"EXPIRE", 1},           {"EXPIREAT", 1},          {"EXPIREMEMBER", 1},         {"EXPIRETIME", 1},
+      {"GEOADD", 1},           {"GEODIST", 1},           {"GEOHASH", 1},              {"GEOPOS", 1},
+      {"GEORADIUS", 1},        {"GEORADIUSBYMEMBER", 1}, {"GEORADIUSBYMEMBER_RO", 1}, {"GEORADIUS_RO", 1},
+      {"GEOSEARCH", 1},        {"GEOSEARCHSTORE", 1},    {"GET", 1},                  {"GETBIT", 1},
+      {"GETDEL", 1},           {"GETEX", 1},             {"GETRANGE", 1},             {"GETSET", 1},
+      {"HDEL", 1},             {"HEXISTS", 1},           {"HGET", 1},                 {"HGETALL", 1},
+      {"HINCRBY", 1},          {"HINCRBYFLOAT", 1},      {"HKEYS", 1},                {"HLEN", 1},
+      {"HMGET", 1},            {"HMSET", 1},             {"HRANDFIELD", 1},           {"HSCAN", 1},
+      {"HSET", 1},             {"HSETNX", 1},            {"HSTRLEN", 1},              {"HVALS", 1},
+      {"INCR", 1},             {"INCRBY", 1},            {"INCRBYFLOAT", 1},          {"LINDEX", 1},
+      {"LINSERT", 1},          {"LLEN", 1},              {"LMOVE", 1},                {"LMPOP", 2},
+      {"LPOP", 1},             {"LPOS", 1},              {"LPUSH", 1},                {"LPUSHX", 1},
+      {"LRANGE", 1},           {"LREM", 1},              {"LSET", 1},                 {"LTRIM", 1},
+      {"MEMORY", 2},           {"MGET", 1},              {"MSET", 1},                 {"MSETNX", 1},
+      {"OBJECT", 2},           {"PERSIST", 1},           {"PEXPIRE", 1},              {"PEXPIREAT", 1},
+      {"PEXPIRETIME", 1},      {"PFADD", 1},             {"PFCOUNT", 1},              {"PFMERGE", 1},
+      {"PSETEX", 1},           {"PTTL", 1},              {"RENAME", 1},               {"RENAMENX", 1},
+      {"RESTORE", 1},          {"RPOP", 1},              {"RPOPLPUSH", 1},            {"RPUSH", 1},
+      {"RPUSHX", 1},           {"SADD", 1},              {"SCARD", 1},                {"SDIFF", 1},
+      {"SDIFFSTORE", 1},       {"SET", 1},               {"SETBIT", 1},               {"SETEX", 1},
+      {"SETNX", 1},            {"SETRANGE", 1},          {"SINTER", 1},               {"SINTERCARD", 2},
+      {"SINTERSTORE", 1},      {"SISMEMBER", 1},         {"SMEMBERS", 1},             {"SMISMEMBER", 1},
+      {"SMOVE", 1},            {"SORT", 1},              {"SORT_RO", 1},              {"SPOP", 1},
+      {"SRANDMEMBER", 1},      {"SREM", 1},              {"SSCAN", 1},                {"STRLEN", 1},
+      {"SUBSTR", 1},           {"SUNION", 1},            {"SUNIONSTORE", 1},          {"TOUCH", 1},
+      {"TTL", 1},              {"TYPE", 1},              {"UNLINK", 1},               {"WATCH", 1},
+      {"XACK", 1},             {"XADD", 1},              {"XAUTOCLAIM", 1},           {"XCLAIM", 1},
+      {"XDEL", 1},             {"XGROUP", 2},            {"XINFO", 2},                {"XLEN", 1},
+      {"XPENDING", 1},         {"XRANGE", 1},            {"XREVRANGE", 1},            {"XSETID", 1},
+      {"XTRIM", 1},            {"ZADD", 1},              {"ZCARD", 1},                {"ZCOUNT", 1},
+      {"ZDIFF", 2},            {"ZDIFFSTORE", 1},        {"ZINCRBY", 1},              {"ZINTER", 2},
+      {"ZINTERCARD", 2},       {"ZINTERSTORE", 1},       {"ZLEXCOUNT", 1},            {"ZMPOP", 2},
+      {"ZMSCORE", 1},          {"ZPOPMAX", 1},           {"ZPOPMIN", 1},              {"ZRANDMEMBER", 1},
+      {"ZRANGE", 1},           {"ZRANGEBYLEX", 1},       {"ZRANGEBYSCORE", 1},        {"ZRANGESTORE", 1},
+      {"ZRANK", 1},            {"ZREM", 1},              {"ZREMRANGEBYLEX", 1},       {"ZREMRANGEBYRANK", 1},
+      {"ZREMRANGEBYSCORE", 1}, {"ZREVRANGE", 1},         {"ZREVRANGEBYLEX", 1},       {"ZREVRANGEBYSCORE", 1},
+      {"ZREVRANK", 1},         {"ZSCAN", 1},             {"ZSCORE", 1},               {"ZUNION", 2},
+      {"ZUNIONSTORE", 1}};
+  const auto it = positions.find(name);
+  return it == positions.end() ? -1 : it->second;
+}
+
+bool HasFlag(const std::string& flags, const char* flag) {
+  const size_t size = strlen(flag);
+  size_t start = 0;
+  while (start <= flags.size()) {
+    size_t end = flags.find(',', start);
+    if (end == std::string::npos) {
+      end = flags.size();
+    }
+    if (end - start == size && flags.compare(start, size, flag) == 0) {
+      return true;
+    }
+    start = end + 1;
+  }
+  return false;
+}
+
+}  // namespace
+
+cluster_slot_t GetKeyHashSlot(const char* key, size_t size) {
+  // only part between first '{' and next '}' is hashed, if it is not empty
+  const char* open = static_cast<const char*>(memchr(key, '{', size));
+  if (open) {
+    const char* tag = open + 1;
+    const char* close = static_cast<const char*>(memchr(tag, '}', size - (tag - key)));
+    if (close && close != tag) {
+      return Crc16(tag, close - tag) & (kClusterSlotsCount - 1);
+    }
+  }
+
+  return Crc16(key, size) & (kClusterSlotsCount - 1);
+}
+
+cluster_slot_t GetKeyHashSlot(const std::string& key) {
+  return GetKeyHashSlot(key.data(), key.size());
+}
+
+bool GetCommandKey(const std::vector<std::string>& argv, std::string* key) {
+  if (argv.empty() || !key) {
+    return false;
+  }
+
+  const std::string name = ToUpper(argv[0]);
+  size_t pos = 0;
+  if (name == "EVAL" || name == "EVALSHA" || name == "EVAL_RO" || name == "EVALSHA_RO" || name == "FCALL" ||
+      name == "FCALL_RO") {
+    unsigned int numkeys = 0;
+    if (argv.size() <= SCRIPT_NUMKEYS_POS || !common::ConvertFromString(argv[SCRIPT_NUMKEYS_POS], &numkeys) ||
+        numkeys == 0) {
+      return false;  // script without keys may run anywhere
+    }
+    pos = SCRIPT_NUMKEYS_POS + 1;
+  } else if (name == "XREAD" || name == "XREADGROUP") {
+    const auto streams = std::find_if(argv.begin(), argv.end(),
+                                      [](const std::string& arg) { return ToUpper(arg) == STREAMS_ARG; });
+    if (streams == argv.end()) {
+      return false;
+    }
+    pos = std::distance(argv.begin(), streams) + 1;
+  } else {
+    const int first = GetFirstKeyPosition(name);
+    if (first < 0) {
+      return false;
+    }
+    pos = static_cast<size_t>(first);
+  }
+
+  if (pos >= argv.size()) {
+    return false;
+  }
+
+  *key = argv[pos];
+  return true;
+}
+
+ClusterSlotMap::ClusterSlotMap() : hosts_(), owners_(kClusterSlotsCount, -1), importing_() {}
+
+bool ClusterSlotMap::IsEmpty() const {
+  return hosts_.empty();
+}
+
+size_t ClusterSlotMap::GetCoveredSlotsCount() const {
+  return owners_.size() - std::count(owners_.begin(), owners_.end(), -1);
+}
+
+ClusterSlotMap::hosts_t ClusterSlotMap::GetHosts() const {
+  return hosts_;
+}
+
+bool ClusterSlotMap::GetNode(cluster_slot_t slot, common::net::HostAndPort* host) const {
+  if (!host || slot >= kClusterSlotsCount) {
+    return false;
+  }
+
+  const host_index_t index = owners_[slot];
+  if (index == -1) {
+    return false;
+  }
+
+  *host = hosts_[index];
+  return true;
+}
+
+void ClusterSlotMap::SetNode(cluster_slot_t slot, const common::net::HostAndPort& host) {
+  if (slot >= kClusterSlotsCount) {
+    return;
+  }
+
+  owners_[slot] = GetHostIndex(host);
+  importing_.erase(slot);  // moved, so migration is over
+}
+
+bool ClusterSlotMap::IsImporting(cluster_slot_t slot, const common::net::HostAndPort& host) const {
+  const auto it = importing_.find(slot);
+  return it != importing_.end() && hosts_[it->second] == host;
+}
+
+void ClusterSlotMap::Clear() {
+  hosts_.clear();
+  std::fill(owners_.begin(), owners_.end(), -1);
+  importing_.clear();
+}
+
+common::Error ClusterSlotMap::LoadFromClusterNodes(const std::string& text) {
+  hosts_t hosts;
+  std::vector<host_index_t> owners(kClusterSlotsCount, -1);
+  hosts_.swap(hosts);
+  owners_.swap(owners);
+  importing_.clear();
+
+  size_t start = 0;
+  while (start < text.size()) {
+    size_t end = text.find(CLUSTER_NODES_LINES_DELEMITER, start);
+    if (end == std::string::npos) {
+      end = text.size();
+    }
+    const std::vector<std::string> fields = SplitFields(text.substr(start, end - start));
+    start = end + 1;
+
+    // <id> <ip:port@cport> <flags> <master> <ping-sent> <pong-recv> <epoch> <link-state> <slot> ...
+    if (fields.size() <= CLUSTER_NODE_FIRST_SLOT_FIELD) {
+      continue;  // replica or master without slots
+    }
+
+    const std::string& flags = fields[CLUSTER_NODE_FLAGS_FIELD];
+    if (!HasFlag(flags, CLUSTER_MASTER_FLAG) || HasFlag(flags, CLUSTER_FAIL_FLAG)) {
+      continue;
+    }
+
+    const std::string& addr = fields[CLUSTER_NODE_ADDR_FIELD];
+    common::net::HostAndPort host;
+    if (!common::ConvertFromString(addr.substr(0, addr.find(CLUSTER_NODE_BUS_PORT_DELEMITER)), &host)) {
+      continue;
+    }
+
+    const host_index_t index = GetHostIndex(host);
+    for (size_t i = CLUSTER_NODE_FIRST_SLOT_FIELD; i < fields.size(); ++i) {
+      const std::string& range = fields[i];
+      if (range[0] == CLUSTER_MIGRATION_SLOT_MARK) {
+        // [slot->-target] on owner, [slot-<-source] on importing node; slot stays with owner until MOVED
+        const size_t importing = range.find(CLUSTER_IMPORTING_SLOT_DELEMITER);
+        cluster_slot_t slot;
+        if (importing != std::string::npos && ParseSlot(range.substr(1, importing - 1), &slot)) {
+          importing_[slot] = index;
+        }
+        continue;
+      }
+
+      const size_t delem = range.find(CLUSTER_SLOTS_RANGE_DELEMITER);
+      cluster_slot_t first;
+      cluster_slot_t last;
+      if (!ParseSlot(range.substr(0, delem), &first)) {
+        continue;
+      }
+      if (delem == std::string::npos) {
+        last = first;
+      } else if (!ParseSlot(range.substr(delem + 1), &last) || last < first) {
+        continue;
+      }
+      SetRange(first, last, index);
+    }
+  }
+
+  if (hosts_.empty()) {
+    return common::make_error("Cluster nodes reply has no masters with slots");
+  }
+  return common::Error();
+}
+
+ClusterSlotMap::host_index_t ClusterSlotMap::GetHostIndex(const common::net::HostAndPort& host) {
+  for (size_t i = 0; i < hosts_.size(); ++i) {
+    if (hosts_[i] == host) {
+      return static_cast<host_index_t>(i);
+    }
+  }
+
+  hosts_.push_back(host);
+  return static_cast<host_index_t>(hosts_.size() - 1);
+}
+
+void ClusterSlotMap::SetRange(cluster_slot_t first, cluster_slot_t last, host_index_t index) {
+  std::fill(owners_.begin() + first, owners_.begin() + last + 1, index);
+}
+
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,73 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <common/error.h>
+#include <common/net/types.h>
+
+namespace fastonosql {
+namespace proxy {
+
+typedef uint16_t cluster_slot_t;
+
+enum { kClusterSlotsCount = 16384 };
+
+// CRC16-XMODEM of key or of its non empty {hash tag}, modulo slots count
+cluster_slot_t GetKeyHashSlot(const char* key, size_t size);
+cluster_slot_t GetKeyHashSlot(const std::string& key);
+
+// first key of command by its key spec (argv[0] is command name), false for keyless or unknown commands
+bool GetCommandKey(const std::vector<std::string>& argv, std::string* key);
+
+// Owner of every hash slot, built from CLUSTER NODES and patched by redirects. Slots in the middle of migration
+// also remember their importing node, redirects to it are ASK ones (the owner stays the same).
+class ClusterSlotMap {
+ public:
+  typedef std::vector<common::net::HostAndPort> hosts_t;
+
+  ClusterSlotMap();
+
+  bool IsEmpty() const;
+  size_t GetCoveredSlotsCount() const;
+  hosts_t GetHosts() const;
+
+  bool GetNode(cluster_slot_t slot, common::net::HostAndPort* host) const;
+  void SetNode(cluster_slot_t slot, const common::net::HostAndPort& host);
+  bool IsImporting(cluster_slot_t slot, const common::net::HostAndPort& host) const;
+  void Clear();
+
+  // replaces whole map with slot ranges of masters from CLUSTER NODES reply
+  common::Error LoadFromClusterNodes(const std::string& text) WARN_UNUSED_RESULT;
+
+ private:
+  typedef int16_t host_index_t;
+
+  host_index_t GetHostIndex(const common::net::HostAndPort& host);
+  void SetRange(cluster_slot_t first, cluster_slot_t last, host_index_t index);
+
+  hosts_t hosts_;
+  std::vector<host_index_t> owners_;  // slot -> index in hosts_, -1 for unassigned slot
+  std::map<cluster_slot_t, host_index_t> importing_;  // migrating slot -> index of node importing it
+};
+
+}  // namespace proxy
+}  // namespace fastonosql
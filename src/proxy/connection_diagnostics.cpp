@@ -0,0 +1,121 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "proxy/connection_diagnostics.h"
+
+#include <algorithm>
+
+namespace fastonosql {
+namespace proxy {
+
+namespace {
+const LatencyHistogram::usec_t kBucketBounds[] = {100,   250,   500,    1000,   2500,   5000,
+                                                  10000, 25000, 50000, 100000, 250000, 500000};
+const size_t kBucketBoundsCount = sizeof(kBucketBounds) / sizeof(kBucketBounds[0]);
+}  // namespace
+
+DiagnosticsOptions::DiagnosticsOptions()
+    : ping_count(100), payload_size(1024), pipeline_depth(32), throughput_msec(1000) {}
+
+LatencyHistogram::LatencyHistogram() : samples_(), buckets_(kBucketBoundsCount + 1, 0) {}
+
+void LatencyHistogram::Add(usec_t usec) {
+  samples_.insert(std::upper_bound(samples_.begin(), samples_.end(), usec), usec);
+  const size_t index = std::lower_bound(kBucketBounds, kBucketBounds + kBucketBoundsCount, usec) - kBucketBounds;
+  buckets_[index]++;
+}
+
+size_t LatencyHistogram::GetCount() const {
+  return samples_.size();
+}
+
+LatencyHistogram::usec_t LatencyHistogram::GetMin() const {
+  return samples_.empty() ? 0 : samples_.front();
+}
+
+LatencyHistogram::usec_t LatencyHistogram::GetMax() const {
+  return samples_.empty() ? 0 : samples_.back();
+}
+
+LatencyHistogram::usec_t LatencyHistogram::GetAverage() const {
+  if (samples_.empty()) {
+    return 0;
+  }
+
+  usec_t total = 0;
+  for (usec_t sample : samples_) {
+    total += sample;
+  }
+  return total / static_cast<usec_t>(samples_.size());
+}
+
+LatencyHistogram::usec_t LatencyHistogram::GetPercentile(double percent) const {
+  if (samples_.empty()) {
+    return 0;
+  }
+
+  const double clamped = std::min(std::max(percent, 0.0), 100.0);
+  const size_t index = static_cast<size_t>(clamped / 100.0 * (samples_.size() - 1) + 0.5);
+  return samples_[index];
+}
+
+size_t LatencyHistogram::GetBucketsCount() const {
+  return buckets_.size();
+}
+
+LatencyHistogram::usec_t LatencyHistogram::GetBucketUpperBound(size_t index) const {
+  if (index < kBucketBoundsCount) {
+    return kBucketBounds[index];
+  }
+  return GetMax();
+}
+
+size_t LatencyHistogram::GetBucketCount(size_t index) const {
+  if (index >= buckets_.size()) {
+    return 0;
+  }
+  return buckets_[index];
+}
+
+ConnectionDiagnostics::ConnectionDiagnostics()
+    : ssh_usec(phase_skipped),
+      ssh_session_reused(false),
+      ssh_channel_usec(phase_skipped),
+      tcp_usec(phase_skipped),
+      tls_usec(phase_skipped),
+      auth_usec(phase_skipped),
+      ping(),
+      payload_size(0),
+      pipeline_depth(0),
+      throughput_ops(0),
+      throughput_usec(0),
+      throughput_skipped() {}
+
+double ConnectionDiagnostics::GetOpsPerSecond() const {
+  if (throughput_usec <= 0) {
+    return 0;
+  }
+  return throughput_ops * 1000000.0 / throughput_usec;
+}
+
+double ConnectionDiagnostics::GetBytesPerSecond() const {
+  // every SET uploads the payload and every GET downloads it back
+  return GetOpsPerSecond() * payload_size;
+}
+
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,89 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <common/types.h>
+
+namespace fastonosql {
+namespace proxy {
+
+struct DiagnosticsOptions {
+  enum { max_batch_size = 16 * 1024 * 1024 };  // pipeline depth is lowered so that one write stays under it
+
+  DiagnosticsOptions();
+
+  size_t ping_count;
+  size_t payload_size;    // bytes per SET value in throughput probe
+  size_t pipeline_depth;  // SET/GET pairs sent in one write
+  common::time64_t throughput_msec;
+};
+
+// ping latencies in microseconds grouped into fixed buckets (100us ... 500ms, overflow)
+class LatencyHistogram {
+ public:
+  typedef common::time64_t usec_t;
+
+  LatencyHistogram();
+
+  void Add(usec_t usec);
+
+  size_t GetCount() const;
+  usec_t GetMin() const;
+  usec_t GetMax() const;
+  usec_t GetAverage() const;
+  usec_t GetPercentile(double percent) const;
+
+  size_t GetBucketsCount() const;
+  usec_t GetBucketUpperBound(size_t index) const;  // last bucket has no bound and returns max sample
+  size_t GetBucketCount(size_t index) const;
+
+ private:
+  std::vector<usec_t> samples_;  // sorted
+  std::vector<size_t> buckets_;
+};
+
+struct ConnectionDiagnostics {
+  typedef LatencyHistogram::usec_t usec_t;
+  enum { phase_skipped = -1 };
+
+  ConnectionDiagnostics();
+
+  double GetOpsPerSecond() const;
+  double GetBytesPerSecond() const;
+
+  usec_t ssh_usec;  // session setup, close to zero when shared session was reused
+  bool ssh_session_reused;
+  usec_t ssh_channel_usec;  // direct-tcpip channel of this connection
+  usec_t tcp_usec;
+  usec_t tls_usec;
+  usec_t auth_usec;
+
+  LatencyHistogram ping;
+
+  size_t payload_size;
+  size_t pipeline_depth;
+  size_t throughput_ops;
+  usec_t throughput_usec;
+  std::string throughput_skipped;  // reason when node refuses probe writes (replica, slot of other node)
+};
+
+}  // namespace proxy
+}  // namespace fastonosql
@@ -19,6 +19,7 @@
 #include "proxy/db/keydb/driver.h"
 
 #include <algorithm>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -36,16 +37,19 @@
 #include "proxy/command/command_logger.h"
 #include "proxy/db/keydb/command.h"
 #include "proxy/db/keydb/connection_settings.h"
+#include "proxy/db/redis_compatible/channels.h"
+#include "proxy/db/redis_compatible/key_changes.h"
+#include "proxy/db/redis_compatible/key_page.h"
+#include "proxy/db/redis_compatible/pipeline_connection.h"
+#include "proxy/db/redis_compatible/rdb_stream.h"
 #include "proxy/db_client.h"
 
 #define REDIS_TYPE_COMMAND "TYPE"
 #define REDIS_SHUTDOWN_COMMAND "SHUTDOWN"
-#define REDIS_BACKUP_COMMAND "SAVE"
 #define REDIS_SET_PASSWORD_COMMAND "CONFIG SET requirepass"
 #define REDIS_SET_MAX_CONNECTIONS_COMMAND "CONFIG SET maxclients"
 #define REDIS_GET_PROPERTY_SERVER_COMMAND "CONFIG GET *"
 #define REDIS_PUBSUB_CHANNELS_COMMAND "PUBSUB CHANNELS"
-#define REDIS_PUBSUB_NUMSUB_COMMAND "PUBSUB NUMSUB"
 #define REDIS_CLIENT_LIST_COMMAND "CLIENT LIST"
 #define REDIS_GET_COMMANDS "COMMAND"
 
@@ -56,11 +60,8 @@
 
 #define REDIS_SET_DEFAULT_DATABASE_COMMAND_1ARGS_S "SELECT %s"
 
-#define BACKUP_DEFAULT_PATH "/var/lib/redis/dump.rdb"
 #define EXPORT_DEFAULT_PATH "/var/lib/redis/dump.rdb"
 
-#define REDIS_NEW_LINE_MARKER "\n"
-
 namespace fastonosql {
 namespace core {
 namespace {
@@ -96,6 +97,7 @@ Driver::Driver(IConnectionSettingsBaseSPtr settings)
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
       proxy_(nullptr),
 #endif
+      ssh_tunnel_(),
       impl_(nullptr) {
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
   proxy_ = new ProxyModuleClient(this);
@@ -156,19 +158,30 @@ core::IDataBaseInfoSPtr Driver::CreateDatabaseInfo(const core::db_name_t& name,
 
 common::Error Driver::SyncConnect() {
   auto redis_settings = GetSpecificSettings<ConnectionSettings>();
-  core::keydb::RConfig rconf(redis_settings->GetInfo(), redis_settings->GetSSHInfo());
-  common::Error err = impl_->Connect(rconf);
+  core::keydb::Config config = redis_settings->GetInfo();
+  config.host = GetHost();  // sentinel may have re-pointed node
+  core::SSHInfo ssh_info = redis_settings->GetSSHInfo();
+  common::Error err = redis_compatible::RouteThroughSSHTunnel(&config.host, &ssh_info, &ssh_tunnel_);
   if (err) {
     return err;
   }
 
+  core::keydb::RConfig rconf(config, ssh_info);
+  err = impl_->Connect(rconf);
+  if (err) {
+    ssh_tunnel_.reset();
+    return err;
+  }
+
   err = impl_->SetClientName(PROJECT_NAME_LOWERCASE);
   UNUSED(err);
   return common::Error();
 }
 
 common::Error Driver::SyncDisconnect() {
-  return impl_->Disconnect();
+  common::Error err = impl_->Disconnect();
+  ssh_tunnel_.reset();
+  return err;
 }
 
 common::Error Driver::ExecuteImpl(const core::command_buffer_t& command, core::FastoObject* out) {
@@ -317,18 +330,21 @@ void Driver::HandleBackupEvent(events::BackupRequestEvent* ev) {
   QObject* sender = ev->sender();
   NotifyProgress(sender, 0);
   events::BackupResponseEvent::value_type res(ev->value());
-  NotifyProgress(sender, 25);
-  core::FastoObjectCommandIPtr cmd = CreateCommandFast(GEN_CMD_STRING(REDIS_BACKUP_COMMAND), core::C_INNER);
-  common::Error err = Execute(cmd);
-  if (err) {
-    res.setErrorInfo(err);
+  auto redis_settings = GetSpecificSettings<ConnectionSettings>();
+  const auto config = redis_settings->GetInfo();
+  if (!config.hostsocket.empty() || config.is_ssl) {
+    res.setErrorInfo(common::make_error("Backup streaming requires direct TCP connection"));
   } else {
-    common::ErrnoError err = common::file_system::copy_file(BACKUP_DEFAULT_PATH, res.path);
+    const auto progress = [this, sender](int percent) {
+      NotifyProgress(sender, percent);
+      return !IsInterrupted();
+    };
+    common::Error err = redis_compatible::StreamRdbSnapshot(GetHost(), redis_settings->GetSSHInfo(), config.auth,
+                                                            res.path, progress);
     if (err) {
-      res.setErrorInfo(common::make_error_from_errno(err));
+      res.setErrorInfo(err);
     }
   }
-  NotifyProgress(sender, 75);
   Reply(sender, new events::BackupResponseEvent(this, res));
   NotifyProgress(sender, 100);
 }
@@ -347,6 +363,71 @@ void Driver::HandleRestoreEvent(events::RestoreRequestEvent* ev) {
   NotifyProgress(sender, 100);
 }
 
+void Driver::HandleDumpKeysEvent(events::DumpKeysRequestEvent* ev) {
+  QObject* sender = ev->sender();
+  NotifyProgress(sender, 0);
+  events::DumpKeysResponseEvent::value_type res(ev->value());
+  const auto progress = [this, sender](int percent) {
+    NotifyProgress(sender, percent);
+    return !IsInterrupted();
+  };
+  common::Error err = redis_compatible::DumpKeys(MakePipelineConnectionFactory(), progress, &res);
+  if (err) {
+    res.setErrorInfo(err);
+  }
+  Reply(sender, new events::DumpKeysResponseEvent(this, res));
+  NotifyProgress(sender, 100);
+}
+
+void Driver::HandleRestoreKeysEvent(events::RestoreKeysRequestEvent* ev) {
+  QObject* sender = ev->sender();
+  NotifyProgress(sender, 0);
+  events::RestoreKeysResponseEvent::value_type res(ev->value());
+  const auto progress = [this, sender](int percent) {
+    NotifyProgress(sender, percent);
+    return !IsInterrupted();
+  };
+  const std::string target = common::ConvertToString(GetHost()) + "/" + impl_->GetCurrentDBName();
+  common::Error err = redis_compatible::RestoreKeys(MakePipelineConnectionFactory(), target, progress, &res);
+  if (err) {
+    res.setErrorInfo(err);
+  }
+  Reply(sender, new events::RestoreKeysResponseEvent(this, res));
+  NotifyProgress(sender, 100);
+}
+
+redis_compatible::pipeline_connection_factory_t Driver::MakePipelineConnectionFactory() const {
+  auto redis_settings = GetSpecificSettings<ConnectionSettings>();
+  core::keydb::Config config = redis_settings->GetInfo();
+  config.host = GetHost();
+  const core::SSHInfo ssh_info = redis_settings->GetSSHInfo();
+  const core::db_name_t db_name = impl_->GetCurrentDBName();
+  return [config, ssh_info, db_name](redis_compatible::pipeline_connection_t* connection) -> common::Error {
+    // every worker goes through own tunnel, it stays open even if driver disconnects in the middle
+    core::keydb::Config worker_config = config;
+    core::SSHInfo worker_ssh_info = ssh_info;
+    redis_compatible::ssh_tunnel_t tunnel;
+    common::Error err = redis_compatible::RouteThroughSSHTunnel(&worker_config.host, &worker_ssh_info, &tunnel);
+    if (err) {
+      return err;
+    }
+
+    typedef redis_compatible::PipelineConnection<core::keydb::DBConnection, Command> worker_connection_t;
+#if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
+    auto result = std::make_shared<worker_connection_t>(new core::keydb::DBConnection(nullptr, nullptr), tunnel);
+#else
+    auto result = std::make_shared<worker_connection_t>(new core::keydb::DBConnection(nullptr), tunnel);
+#endif
+    err = result->Connect(core::keydb::RConfig(worker_config, worker_ssh_info), db_name);
+    if (err) {
+      return err;
+    }
+
+    *connection = result;
+    return common::Error();
+  };
+}
+
 void Driver::HandleLoadDatabaseContentEvent(events::LoadDatabaseContentRequestEvent* ev) {
   QObject* sender = ev->sender();
   NotifyProgress(sender, 0);
@@ -491,6 +572,43 @@ done:
   NotifyProgress(sender, 100);
 }
 
+void Driver::HandleLoadKeyPageEvent(events::LoadKeyPageRequestEvent* ev) {
+  HandleInnerCommandEvent<events::LoadKeyPageResponseEvent>(ev, &redis_compatible::GetKeyPageCommand,
+                                                            &redis_compatible::ParseKeyPageReply);
+}
+
+void Driver::HandleChangeKeyValueEvent(events::ChangeKeyValueRequestEvent* ev) {
+  QObject* sender = ev->sender();
+  NotifyProgress(sender, 0);
+  events::ChangeKeyValueResponseEvent::value_type res(ev->value());
+  std::vector<core::command_buffer_t> commands;
+  common::Error err = redis_compatible::GetKeyChangesCommands(res, &commands);
+  if (err) {
+    res.setErrorInfo(err);
+  } else if (!commands.empty()) {
+    std::vector<core::FastoObjectCommandIPtr> cmds;
+    cmds.reserve(commands.size());
+    for (const auto& command : commands) {
+      cmds.push_back(CreateCommandFast(command, core::C_USER));
+    }
+    NotifyProgress(sender, 50);
+    err = impl_->ExecuteAsPipeline(cmds, &LOG_COMMAND);
+    if (err) {
+      res.setErrorInfo(err);
+    } else {
+      res.commands_count = cmds.size();
+    }
+  }
+  NotifyProgress(sender, 75);
+  Reply(sender, new events::ChangeKeyValueResponseEvent(this, res));
+  NotifyProgress(sender, 100);
+}
+
+void Driver::HandleLoadStreamPageEvent(events::LoadStreamPageRequestEvent* ev) {
+  HandleInnerCommandEvent<events::LoadStreamPageResponseEvent>(ev, &redis_compatible::GetStreamPageCommand,
+                                                               &redis_compatible::ParseStreamPageReply);
+}
+
 void Driver::HandleDiscoveryInfoEvent(events::DiscoveryInfoRequestEvent* ev) {
   QObject* sender = ev->sender();
   NotifyProgress(sender, 0);
@@ -584,76 +702,33 @@ void Driver::HandleLoadServerChannelsRequestEvent(events::LoadServerChannelsRequ
   const core::command_buffer_t load_channels_request = wr.str();
   core::FastoObjectCommandIPtr cmd = CreateCommandFast(load_channels_request, core::C_INNER);
   common::Error err = Execute(cmd);
-  if (err) {
-    res.setErrorInfo(err);
-    goto done;
-  } else {
-    core::FastoObject::childs_t rchildrens = cmd->GetChildrens();
-    if (rchildrens.size()) {
-      CHECK_EQ(rchildrens.size(), 1);
-      core::FastoObject* array = rchildrens[0].get();
-      if (array) {
-        auto array_value = array->GetValue();
-        common::ArrayValue* arm = nullptr;
-        if (!array_value->GetAsList(&arm) || !arm->GetSize()) {
-          goto done;
-        }
+  if (!err) {
+    err = redis_compatible::ParseChannelsReply(cmd.get(), &res.channels);
+  }
 
-        std::vector<core::FastoObjectCommandIPtr> cmds;
-        cmds.reserve(arm->GetSize());
-        for (size_t i = 0; i < arm->GetSize(); ++i) {
-          common::Value::string_t channel;
-          bool isok = arm->GetString(i, &channel);
-          if (isok) {
-            core::command_buffer_writer_t wr2;
-            wr2 << REDIS_PUBSUB_NUMSUB_COMMAND " " << channel;
-            proxy::NDbPSChannel ch(core::ReadableString(channel), 0);
-            cmds.push_back(CreateCommandFast(wr2.str(), core::C_INNER));
-            res.channels.push_back(ch);
-          }
-        }
+  std::vector<core::command_buffer_t> numsub_requests;
+  if (!err) {
+    err = redis_compatible::GetChannelsNumSubCommands(res.channels, &numsub_requests);
+  }
 
-        err = impl_->ExecuteAsPipeline(cmds, &LOG_COMMAND);
-        if (err) {
-          res.setErrorInfo(err);
-          goto done;
-        }
+  if (!err && !numsub_requests.empty()) {
+    std::vector<core::FastoObjectCommandIPtr> cmds;
+    cmds.reserve(numsub_requests.size());
+    for (const auto& numsub_request : numsub_requests) {
+      cmds.push_back(CreateCommandFast(numsub_request, core::C_INNER));
+    }
 
-        for (size_t i = 0; i < res.channels.size(); ++i) {
-          core::FastoObjectIPtr subCount = cmds[i];
-          core::FastoObject::childs_t tchildrens = subCount->GetChildrens();
-          if (tchildrens.size()) {
-            DCHECK_EQ(tchildrens.size(), 1);
-            if (tchildrens.size() == 1) {
-              core::FastoObject* array_sub = tchildrens[0].get();
-              auto arr_value = array_sub->GetValue();
-              common::ArrayValue* array_sub_inner = nullptr;
-              if (arr_value->GetAsList(&array_sub_inner)) {
-                common::Value* fund_sub = nullptr;
-                if (array_sub_inner->Get(1, &fund_sub)) {
-                  common::Value::Type t = fund_sub->GetType();
-                  if (t == common::Value::TYPE_LONG_LONG_INTEGER) {
-                    long long lsub;
-                    if (fund_sub->GetAsLongLongInteger(&lsub)) {
-                      res.channels[i].SetNumberOfSubscribers(lsub);
-                    }
-                  } else if (t == common::Value::TYPE_STRING) {
-                    common::Value::string_t lsub_str;
-                    size_t lsub;
-                    if (fund_sub->GetAsString(&lsub_str) && common::ConvertFromBytes(lsub_str, &lsub)) {
-                      res.channels[i].SetNumberOfSubscribers(lsub);
-                    }
-                  }
-                }
-              }
-            }
-          }
-        }
-      }
+    err = impl_->ExecuteAsPipeline(cmds, &LOG_COMMAND);
+    size_t offset = 0;
+    for (size_t i = 0; !err && i < cmds.size(); ++i) {
+      err = redis_compatible::ParseChannelsNumSubReply(cmds[i].get(), &offset, &res.channels);
     }
   }
 
-done:
+  if (err) {
+    res.setErrorInfo(err);
+  }
+
   NotifyProgress(sender, 75);
   Reply(sender, new events::LoadServerChannelsResponseEvent(this, res));
   NotifyProgress(sender, 100);
@@ -681,17 +756,8 @@ void Driver::HandleLoadServerClientsRequestEvent(events::LoadServerClientsReques
           goto done;
         }
 
-        size_t pos = 0;
-        size_t start = 0;
-        std::string clients_text = common::ConvertToString(string_value);  // #FIXME
-        while ((pos = clients_text.find(REDIS_NEW_LINE_MARKER, start)) != std::string::npos) {
-          std::string line = clients_text.substr(start, pos - start);
-          NDbClient cl(line);
-          if (cl.IsValid()) {
-            res.clients.push_back(cl);
-          }
-          start = pos + SIZEOFMASS(REDIS_NEW_LINE_MARKER) - 1;
-        }
+        const std::string clients_text = common::ConvertToString(string_value);  // #FIXME
+        ParseClientList(clients_text, &res.clients);
       }
     }
   }
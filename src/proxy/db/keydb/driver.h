@@ -21,6 +21,8 @@
 #include <string>
 #include <vector>
 
+#include "proxy/db/redis_compatible/logical_dump.h"
+#include "proxy/db/redis_compatible/ssh_tunnel.h"
 #include "proxy/driver/idriver_remote.h"
 
 namespace fastonosql {
@@ -92,14 +94,23 @@ class Driver : public IDriverRemote {
   void HandleLoadServerClientsRequestEvent(events::LoadServerClientsRequestEvent* ev) override;
   void HandleBackupEvent(events::BackupRequestEvent* ev) override;
   void HandleRestoreEvent(events::RestoreRequestEvent* ev) override;
+  void HandleDumpKeysEvent(events::DumpKeysRequestEvent* ev) override;
+  void HandleRestoreKeysEvent(events::RestoreKeysRequestEvent* ev) override;
 
   void HandleLoadDatabaseContentEvent(events::LoadDatabaseContentRequestEvent* ev) override;
+  void HandleLoadKeyPageEvent(events::LoadKeyPageRequestEvent* ev) override;
+  void HandleChangeKeyValueEvent(events::ChangeKeyValueRequestEvent* ev) override;
+  void HandleLoadStreamPageEvent(events::LoadStreamPageRequestEvent* ev) override;
 
   core::IServerInfoSPtr MakeServerInfoFromString(const std::string& val) override;
 
+  // extra connections to current database for parallel dump/restore workers
+  redis_compatible::pipeline_connection_factory_t MakePipelineConnectionFactory() const;
+
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
   core::IModuleConnectionClient* proxy_;
 #endif
+  redis_compatible::ssh_tunnel_t ssh_tunnel_;
   core::keydb::DBConnection* impl_;
 };
 
@@ -18,7 +18,16 @@
 
 #include "proxy/db/leveldb/driver.h"
 
+#include <algorithm>
+#include <functional>
+#include <memory>
+
+#include <leveldb/db.h>
+#include <leveldb/env.h>
+#include <leveldb/write_batch.h>
+
 #include <fastonosql/core/db/leveldb/db_connection.h>
+#include <fastonosql/core/macros.h>
 
 #include "proxy/command/command.h"
 #include "proxy/command/command_logger.h"
@@ -26,9 +35,62 @@
 #include "proxy/db/leveldb/connection_settings.h"
 #include "proxy/db/leveldb/database.h"
 
+#define LEVELDB_BACKUP_BATCH_SIZE 1000
+#define LEVELDB_BACKUP_TEMP_SUFFIX ".tmp"
+
 namespace fastonosql {
 namespace proxy {
 namespace leveldb {
+namespace {
+
+common::Error MakeError(const ::leveldb::Status& status) {
+  if (status.ok()) {
+    return common::Error();
+  }
+  return common::make_error(status.ToString());
+}
+
+common::Error OpenDB(const std::string& path, bool create, ::leveldb::DB** db) {
+  ::leveldb::Options options;
+  options.create_if_missing = create;
+  options.error_if_exists = create;
+  return MakeError(::leveldb::DB::Open(options, path, db));
+}
+
+bool GetScanReply(core::FastoObjectCommandIPtr cmd, core::cursor_t* cursor, std::vector<core::command_buffer_t>* keys) {
+  core::FastoObject::childs_t childrens = cmd->GetChildrens();
+  if (childrens.size() != 1) {
+    return false;
+  }
+
+  common::ArrayValue* arm = nullptr;
+  common::ArrayValue* ar = nullptr;
+  auto value = childrens[0]->GetValue();
+  if (!value || !value->GetAsList(&arm) || arm->GetSize() != 2 || !arm->GetUInteger(0, cursor) ||
+      !arm->GetList(1, &ar)) {
+    return false;
+  }
+
+  for (size_t i = 0; i < ar->GetSize(); ++i) {
+    core::command_buffer_t key;
+    if (ar->GetString(i, &key)) {
+      keys->push_back(key);
+    }
+  }
+  return true;
+}
+
+bool GetStringReply(core::FastoObjectCommandIPtr cmd, common::Value::string_t* result) {
+  core::FastoObject::childs_t childrens = cmd->GetChildrens();
+  if (childrens.size() != 1) {
+    return false;
+  }
+
+  auto value = childrens[0]->GetValue();
+  return value && value->GetAsString(result);
+}
+
+}  // namespace
 
 Driver::Driver(IConnectionSettingsBaseSPtr settings)
     : IDriverLocal(settings), impl_(new core::leveldb::DBConnection(this)) {
@@ -132,6 +194,125 @@ core::IServerInfoSPtr Driver::MakeServerInfoFromString(const std::string& val) {
   return core::IServerInfoSPtr(impl_->MakeServerInfo(val));
 }
 
+void Driver::HandleBackupEvent(events::BackupRequestEvent* ev) {
+  QObject* sender = ev->sender();
+  NotifyProgress(sender, 0);
+  events::BackupResponseEvent::value_type res(ev->value());
+  core::keys_limit_t keys_count = 0;
+  common::Error err = impl_->DBKeysCount(&keys_count);
+  if (!err && ::leveldb::Env::Default()->FileExists(res.path)) {
+    err = common::make_error("Backup path already exists: " + res.path);
+  }
+
+  if (!err) {
+    // half written copy never appears under backup name
+    const std::string temp_path = res.path + LEVELDB_BACKUP_TEMP_SUFFIX;
+    const auto progress = [this, sender](int percent) {
+      NotifyProgress(sender, percent);
+      return !IsInterrupted();
+    };
+    err = CopyContent(temp_path, keys_count, progress);
+    if (!err) {
+      err = MakeError(::leveldb::Env::Default()->RenameFile(temp_path, res.path));
+    }
+    if (err) {
+      ::leveldb::DestroyDB(temp_path, ::leveldb::Options());
+    }
+  }
+
+  if (err) {
+    res.setErrorInfo(err);
+  }
+  Reply(sender, new events::BackupResponseEvent(this, res));
+  NotifyProgress(sender, 100);
+}
+
+common::Error Driver::CopyContent(const std::string& path,
+                                  core::keys_limit_t keys_count,
+                                  const std::function<bool(int)>& progress) {
+  ::leveldb::DB* target_db = nullptr;
+  common::Error err = OpenDB(path, true, &target_db);
+  if (err) {
+    return err;
+  }
+
+  // driver thread is busy for the whole copy, so nothing is written through this session meanwhile
+  std::unique_ptr<::leveldb::DB> target(target_db);
+  core::translator_t tran = GetTranslator();
+  core::cursor_t cursor = 0;
+  core::keys_limit_t copied = 0;
+  do {
+    core::FastoObjectCommandIPtr scan =
+        CreateCommandFast(core::GetKeysPattern(cursor, ALL_KEYS_PATTERNS, LEVELDB_BACKUP_BATCH_SIZE), core::C_INNER);
+    err = Execute(scan);
+    if (err) {
+      return err;
+    }
+
+    std::vector<core::command_buffer_t> keys;
+    if (!GetScanReply(scan, &cursor, &keys)) {
+      return common::make_error("Invalid scan reply");
+    }
+
+    ::leveldb::WriteBatch batch;
+    for (const core::command_buffer_t& key : keys) {
+      core::command_buffer_t get_cmd;
+      err = tran->LoadKeyCommand(core::NKey(core::nkey_t(key)), common::Value::TYPE_STRING, &get_cmd);
+      if (err) {
+        return err;
+      }
+
+      core::FastoObjectCommandIPtr get = CreateCommandFast(get_cmd, core::C_INNER);
+      err = Execute(get);
+      if (err) {
+        return err;
+      }
+
+      common::Value::string_t value;
+      if (!GetStringReply(get, &value)) {
+        return common::make_error("Invalid get reply");
+      }
+      batch.Put(::leveldb::Slice(key.data(), key.size()), ::leveldb::Slice(value.data(), value.size()));
+      copied++;
+    }
+
+    ::leveldb::WriteOptions wopts;
+    wopts.sync = cursor == 0;
+    err = MakeError(target->Write(wopts, &batch));
+    if (err) {
+      return err;
+    }
+
+    const int percent = keys_count ? static_cast<int>(copied * 100 / keys_count) : 0;
+    if (cursor != 0 && !progress(std::min(percent, 99))) {
+      return common::make_error(common::COMMON_EINTR);
+    }
+  } while (cursor != 0);
+
+  return common::Error();
+}
+
+void Driver::HandleRestoreEvent(events::RestoreRequestEvent* ev) {
+  QObject* sender = ev->sender();
+  NotifyProgress(sender, 0);
+  events::RestoreResponseEvent::value_type res(ev->value());
+  auto config = GetSpecificSettings<ConnectionSettings>()->GetInfo();
+  config.create_if_missing = false;
+  config.db_path = res.path;
+  // switches this session to the backup, reconnect returns to the settings path
+  common::Error err = impl_->Disconnect();
+  NotifyProgress(sender, 50);
+  if (!err) {
+    err = impl_->Connect(config);
+  }
+
+  if (err) {
+    res.setErrorInfo(err);
+  }
+  Reply(sender, new events::RestoreResponseEvent(this, res));
+  NotifyProgress(sender, 100);
+}
+
 }  // namespace leveldb
 }  // namespace proxy
 }  // namespace fastonosql
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -74,6 +75,14 @@ class Driver : public IDriverLocal {
 
   core::IServerInfoSPtr MakeServerInfoFromString(const std::string& val) override;
 
+  void HandleBackupEvent(events::BackupRequestEvent* ev) override;
+  void HandleRestoreEvent(events::RestoreRequestEvent* ev) override;
+
+  // pages keys and values through the open connection, it keeps its lock and session is not interrupted
+  common::Error CopyContent(const std::string& path,
+                            core::keys_limit_t keys_count,
+                            const std::function<bool(int)>& progress) WARN_UNUSED_RESULT;
+
   core::leveldb::DBConnection* const impl_;
 };
 
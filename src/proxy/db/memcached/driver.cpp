@@ -29,6 +29,7 @@
 #include "proxy/db/memcached/connection_settings.h"
 
 #define MEMCACHED_INFO_REQUEST "STATS"
+#define MEMCACHED_PING_REQUEST "VERSION"
 
 namespace fastonosql {
 namespace proxy {
@@ -92,6 +93,11 @@ common::Error Driver::SyncDisconnect() {
   return impl_->Disconnect();
 }
 
+common::Error Driver::SyncPing() {
+  core::FastoObjectCommandIPtr cmd = CreateCommandFast(GEN_CMD_STRING(MEMCACHED_PING_REQUEST), core::C_INNER);
+  return Execute(cmd);
+}
+
 common::Error Driver::ExecuteImpl(const core::command_buffer_t& command, core::FastoObject* out) {
   return impl_->Execute(command, out);
 }
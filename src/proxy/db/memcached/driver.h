@@ -64,6 +64,7 @@ class Driver : public IDriverRemote {
 
   common::Error SyncConnect() override WARN_UNUSED_RESULT;
   common::Error SyncDisconnect() override WARN_UNUSED_RESULT;
+  common::Error SyncPing() override WARN_UNUSED_RESULT;
 
   common::Error ExecuteImpl(const core::command_buffer_t& command, core::FastoObject* out) override WARN_UNUSED_RESULT;
   common::Error DBkcountImpl(core::keys_limit_t* size) override WARN_UNUSED_RESULT;
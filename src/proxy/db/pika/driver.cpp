@@ -28,6 +28,9 @@
 #include "proxy/command/command_logger.h"
 #include "proxy/db/pika/command.h"              // for Command
 #include "proxy/db/pika/connection_settings.h"  // for ConnectionSettings
+#include "proxy/db/redis_compatible/channels.h"
+#include "proxy/db/redis_compatible/key_changes.h"
+#include "proxy/db/redis_compatible/key_page.h"
 
 #define REDIS_TYPE_COMMAND "TYPE"
 #define REDIS_SHUTDOWN_COMMAND "SHUTDOWN"
@@ -36,7 +39,6 @@
 #define REDIS_SET_MAX_CONNECTIONS_COMMAND "CONFIG SET maxclients"
 #define REDIS_GET_PROPERTY_SERVER_COMMAND "CONFIG GET *"
 #define REDIS_PUBSUB_CHANNELS_COMMAND "PUBSUB CHANNELS"
-#define REDIS_PUBSUB_NUMSUB_COMMAND "PUBSUB NUMSUB"
 
 #define REDIS_SET_DEFAULT_DATABASE_COMMAND_1ARGS_S "SELECT %s"
 
@@ -71,7 +73,7 @@ namespace proxy {
 namespace pika {
 
 Driver::Driver(IConnectionSettingsBaseSPtr settings)
-    : IDriverRemote(settings), impl_(new core::pika::DBConnection(this)) {
+    : IDriverRemote(settings), ssh_tunnel_(), impl_(new core::pika::DBConnection(this)) {
   COMPILE_ASSERT(core::pika::DBConnection::GetConnectionType() == core::PIKA,
                  "DBConnection must be the same type as Driver!");
   CHECK(GetType() == core::PIKA);
@@ -122,12 +124,25 @@ core::IDataBaseInfoSPtr Driver::CreateDatabaseInfo(const core::db_name_t& name,
 
 common::Error Driver::SyncConnect() {
   auto pika_settings = GetSpecificSettings<ConnectionSettings>();
-  core::pika::RConfig rconf(pika_settings->GetInfo(), pika_settings->GetSSHInfo());
-  return impl_->Connect(rconf);
+  core::pika::Config config = pika_settings->GetInfo();
+  core::SSHInfo ssh_info = pika_settings->GetSSHInfo();
+  common::Error err = redis_compatible::RouteThroughSSHTunnel(&config.host, &ssh_info, &ssh_tunnel_);
+  if (err) {
+    return err;
+  }
+
+  core::pika::RConfig rconf(config, ssh_info);
+  err = impl_->Connect(rconf);
+  if (err) {
+    ssh_tunnel_.reset();
+  }
+  return err;
 }
 
 common::Error Driver::SyncDisconnect() {
-  return impl_->Disconnect();
+  common::Error err = impl_->Disconnect();
+  ssh_tunnel_.reset();
+  return err;
 }
 
 common::Error Driver::ExecuteImpl(const core::command_buffer_t& command, core::FastoObject* out) {
@@ -309,6 +324,38 @@ done:
   NotifyProgress(sender, 100);
 }
 
+void Driver::HandleLoadKeyPageEvent(events::LoadKeyPageRequestEvent* ev) {
+  HandleInnerCommandEvent<events::LoadKeyPageResponseEvent>(ev, &redis_compatible::GetKeyPageCommand,
+                                                            &redis_compatible::ParseKeyPageReply);
+}
+
+void Driver::HandleChangeKeyValueEvent(events::ChangeKeyValueRequestEvent* ev) {
+  QObject* sender = ev->sender();
+  NotifyProgress(sender, 0);
+  events::ChangeKeyValueResponseEvent::value_type res(ev->value());
+  std::vector<core::command_buffer_t> commands;
+  common::Error err = redis_compatible::GetKeyChangesCommands(res, &commands);
+  if (err) {
+    res.setErrorInfo(err);
+  } else if (!commands.empty()) {
+    std::vector<core::FastoObjectCommandIPtr> cmds;
+    cmds.reserve(commands.size());
+    for (const auto& command : commands) {
+      cmds.push_back(CreateCommandFast(command, core::C_USER));
+    }
+    NotifyProgress(sender, 50);
+    err = impl_->ExecuteAsPipeline(cmds, &LOG_COMMAND);
+    if (err) {
+      res.setErrorInfo(err);
+    } else {
+      res.commands_count = cmds.size();
+    }
+  }
+  NotifyProgress(sender, 75);
+  Reply(sender, new events::ChangeKeyValueResponseEvent(this, res));
+  NotifyProgress(sender, 100);
+}
+
 void Driver::HandleLoadServerPropertyEvent(events::ServerPropertyInfoRequestEvent* ev) {
   QObject* sender = ev->sender();
   NotifyProgress(sender, 0);
@@ -368,75 +415,33 @@ void Driver::HandleLoadServerChannelsRequestEvent(events::LoadServerChannelsRequ
   const core::command_buffer_t load_channels_request = wr.str();
   core::FastoObjectCommandIPtr cmd = CreateCommandFast(load_channels_request, core::C_INNER);
   common::Error err = Execute(cmd);
-  if (err) {
-    res.setErrorInfo(err);
-    goto done;
-  } else {
-    core::FastoObject::childs_t rchildrens = cmd->GetChildrens();
-    if (rchildrens.size()) {
-      CHECK_EQ(rchildrens.size(), 1);
-      core::FastoObject* array = rchildrens[0].get();
-      CHECK(array);
-      auto array_value = array->GetValue();
-      common::ArrayValue* arm = nullptr;
-      if (!array_value->GetAsList(&arm) || !arm->GetSize()) {
-        goto done;
-      }
+  if (!err) {
+    err = redis_compatible::ParseChannelsReply(cmd.get(), &res.channels);
+  }
 
-      std::vector<core::FastoObjectCommandIPtr> cmds;
-      cmds.reserve(arm->GetSize());
-      for (size_t i = 0; i < arm->GetSize(); ++i) {
-        core::command_buffer_t channel;
-        bool isok = arm->GetString(i, &channel);
-        if (isok) {
-          core::command_buffer_writer_t wr2;
-          wr2 << REDIS_PUBSUB_NUMSUB_COMMAND " " << channel;
-          proxy::NDbPSChannel c(core::ReadableString(channel), 0);
-          cmds.push_back(CreateCommandFast(wr2.str(), core::C_INNER));
-          res.channels.push_back(c);
-        }
-      }
+  std::vector<core::command_buffer_t> numsub_requests;
+  if (!err) {
+    err = redis_compatible::GetChannelsNumSubCommands(res.channels, &numsub_requests);
+  }
 
-      err = impl_->ExecuteAsPipeline(cmds, &LOG_COMMAND);
-      if (err) {
-        res.setErrorInfo(err);
-        goto done;
-      }
+  if (!err && !numsub_requests.empty()) {
+    std::vector<core::FastoObjectCommandIPtr> cmds;
+    cmds.reserve(numsub_requests.size());
+    for (const auto& numsub_request : numsub_requests) {
+      cmds.push_back(CreateCommandFast(numsub_request, core::C_INNER));
+    }
 
-      for (size_t i = 0; i < res.channels.size(); ++i) {
-        core::FastoObjectIPtr subCount = cmds[i];
-        core::FastoObject::childs_t tchildrens = subCount->GetChildrens();
-        if (tchildrens.size()) {
-          DCHECK_EQ(tchildrens.size(), 1);
-          if (tchildrens.size() == 1) {
-            core::FastoObject* array_sub = tchildrens[0].get();
-            auto arr_value = array_sub->GetValue();
-            common::ArrayValue* array_sub_inner = nullptr;
-            if (arr_value->GetAsList(&array_sub_inner)) {
-              common::Value* fund_sub = nullptr;
-              if (array_sub_inner->Get(1, &fund_sub)) {
-                common::Value::Type t = fund_sub->GetType();
-                if (t == common::Value::TYPE_LONG_LONG_INTEGER) {
-                  long long lsub;
-                  if (fund_sub->GetAsLongLongInteger(&lsub)) {
-                    res.channels[i].SetNumberOfSubscribers(lsub);
-                  }
-                } else if (t == common::Value::TYPE_STRING) {
-                  core::command_buffer_t lsub_str;
-                  long long lsub;
-                  if (fund_sub->GetAsString(&lsub_str) && common::ConvertFromBytes(lsub_str, &lsub)) {
-                    res.channels[i].SetNumberOfSubscribers(lsub);
-                  }
-                }
-              }
-            }
-          }
-        }
-      }
+    err = impl_->ExecuteAsPipeline(cmds, &LOG_COMMAND);
+    size_t offset = 0;
+    for (size_t i = 0; !err && i < cmds.size(); ++i) {
+      err = redis_compatible::ParseChannelsNumSubReply(cmds[i].get(), &offset, &res.channels);
     }
   }
 
-done:
+  if (err) {
+    res.setErrorInfo(err);
+  }
+
   NotifyProgress(sender, 75);
   Reply(sender, new events::LoadServerChannelsResponseEvent(this, res));
   NotifyProgress(sender, 100);
@@ -21,6 +21,7 @@
 #include <string>
 #include <vector>
 
+#include "proxy/db/redis_compatible/ssh_tunnel.h"
 #include "proxy/driver/idriver_remote.h"
 
 namespace fastonosql {
@@ -80,9 +81,12 @@ class Driver : public IDriverRemote {
   void HandleRestoreEvent(events::RestoreRequestEvent* ev) override;
 
   void HandleLoadDatabaseContentEvent(events::LoadDatabaseContentRequestEvent* ev) override;
+  void HandleLoadKeyPageEvent(events::LoadKeyPageRequestEvent* ev) override;
+  void HandleChangeKeyValueEvent(events::ChangeKeyValueRequestEvent* ev) override;
 
   core::IServerInfoSPtr MakeServerInfoFromString(const std::string& val) override;
 
+  redis_compatible::ssh_tunnel_t ssh_tunnel_;
   core::pika::DBConnection* const impl_;
 };
 
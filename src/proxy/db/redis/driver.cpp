@@ -19,6 +19,10 @@
 #include "proxy/db/redis/driver.h"
 
 #include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -36,19 +40,30 @@
 #include "proxy/command/command_logger.h"
 #include "proxy/db/redis/command.h"
 #include "proxy/db/redis/connection_settings.h"
+#include "proxy/db/redis_compatible/channels.h"
+#include "proxy/db/redis_compatible/key_changes.h"
+#include "proxy/db/redis_compatible/key_page.h"
+#include "proxy/db/redis_compatible/pipeline_connection.h"
+#include "proxy/db/redis_compatible/rdb_stream.h"
 #include "proxy/db_client.h"
+#include "proxy/discovery_cache.h"
 
 #define REDIS_TYPE_COMMAND "TYPE"
 #define REDIS_SHUTDOWN_COMMAND "SHUTDOWN"
-#define REDIS_BACKUP_COMMAND "SAVE"
 #define REDIS_SET_PASSWORD_COMMAND "CONFIG SET requirepass"
 #define REDIS_SET_MAX_CONNECTIONS_COMMAND "CONFIG SET maxclients"
 #define REDIS_GET_PROPERTY_SERVER_COMMAND "CONFIG GET *"
 #define REDIS_PUBSUB_CHANNELS_COMMAND "PUBSUB CHANNELS"
-#define REDIS_PUBSUB_NUMSUB_COMMAND "PUBSUB NUMSUB"
 #define REDIS_CLIENT_LIST_COMMAND "CLIENT LIST"
 #define REDIS_GET_COMMANDS "COMMAND"
 
+#define REDIS_INFO_SERVER_COMMAND "INFO server"
+#define REDIS_INFO_MODULES_COMMAND "INFO modules"
+#define REDIS_COMMAND_COUNT_COMMAND "COMMAND COUNT"
+#define REDIS_INFO_VERSION_FIELD "redis_version:"
+#define REDIS_INFO_MODULES_SECTION "# Modules"
+#define REDIS_INFO_MODULE_FIELD "module:"
+
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
 #include <fastonosql/core/imodule_connection_client.h>
 #define REDIS_GET_LOADED_MODULES_COMMANDS "MODULE LIST"
@@ -56,11 +71,8 @@
 
 #define REDIS_SET_DEFAULT_DATABASE_COMMAND_1ARGS_S "SELECT %s"
 
-#define BACKUP_DEFAULT_PATH "/var/lib/redis/dump.rdb"
 #define EXPORT_DEFAULT_PATH "/var/lib/redis/dump.rdb"
 
-#define REDIS_NEW_LINE_MARKER "\n"
-
 namespace fastonosql {
 namespace core {
 namespace {
@@ -73,6 +85,37 @@ command_buffer_t GetKeysOldPattern(const pattern_t& pattern) {
 }  // namespace core
 namespace proxy {
 namespace redis {
+namespace {
+
+bool StartsWith(const std::string& line, const char* prefix) {
+  return line.compare(0, strlen(prefix), prefix) == 0;
+}
+
+// "module:name=ReJSON,ver=20007,api=1,..." -> name and version
+bool ParseInfoModuleLine(const std::string& line, std::string* name, std::string* version) {
+  std::istringstream fields(line.substr(strlen(REDIS_INFO_MODULE_FIELD)));
+  std::string field;
+  std::string lname;
+  std::string lversion;
+  while (std::getline(fields, field, ',')) {
+    if (StartsWith(field, "name=")) {
+      lname = field.substr(5);
+    } else if (StartsWith(field, "ver=")) {
+      lversion = field.substr(4);
+    }
+  }
+
+  if (lname.empty()) {
+    return false;
+  }
+
+  *name = lname;
+  *version = lversion;
+  return true;
+}
+
+}  // namespace
+
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
 namespace {
 const struct RedisRegisterTypes {
@@ -95,11 +138,20 @@ Driver::Driver(IConnectionSettingsBaseSPtr settings)
     : IDriverRemote(settings),
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
       proxy_(nullptr),
+      discovery_modules_(),
+      discovery_modules_known_(false),
 #endif
+      discovery_key_(),
+      ssh_tunnel_(),
       impl_(nullptr) {
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
   proxy_ = new ProxyModuleClient(this);
   impl_ = new core::redis::DBConnection(this, proxy_);
+  // commands table of this server changed, cached one must not be reused
+  VERIFY(connect(this, &Driver::ModuleLoaded, this, [this]() { DiscoveryCache::GetInstance().Remove(discovery_key_); },
+                 Qt::DirectConnection));
+  VERIFY(connect(this, &Driver::ModuleUnLoaded, this,
+                 [this]() { DiscoveryCache::GetInstance().Remove(discovery_key_); }, Qt::DirectConnection));
 #else
   impl_ = new core::redis::DBConnection(this);
 #endif
@@ -156,9 +208,19 @@ core::IDataBaseInfoSPtr Driver::CreateDatabaseInfo(const core::db_name_t& name,
 
 common::Error Driver::SyncConnect() {
   auto redis_settings = GetSpecificSettings<ConnectionSettings>();
-  core::redis::RConfig rconf(redis_settings->GetInfo(), redis_settings->GetSSHInfo());
-  common::Error err = impl_->Connect(rconf);
+  core::redis::Config config = redis_settings->GetInfo();
+  config.host = GetHost();  // sentinel may have re-pointed node
+  core::SSHInfo ssh_info = redis_settings->GetSSHInfo();
+  // session to bastion is shared between connections, only own channel is opened here
+  common::Error err = redis_compatible::RouteThroughSSHTunnel(&config.host, &ssh_info, &ssh_tunnel_);
+  if (err) {
+    return err;
+  }
+
+  core::redis::RConfig rconf(config, ssh_info);
+  err = impl_->Connect(rconf);
   if (err) {
+    ssh_tunnel_.reset();
     return err;
   }
 
@@ -168,7 +230,27 @@ common::Error Driver::SyncConnect() {
 }
 
 common::Error Driver::SyncDisconnect() {
-  return impl_->Disconnect();
+  common::Error err = impl_->Disconnect();
+  ssh_tunnel_.reset();
+  return err;
+}
+
+common::Error Driver::SyncReconnect() {
+  // client name is set by SyncConnect, selected database is restored here
+  const core::db_name_t db_name = impl_->GetCurrentDBName();
+  common::Error err = IDriverRemote::SyncReconnect();
+  if (err) {
+    return err;
+  }
+
+  if (db_name == impl_->GetCurrentDBName()) {
+    return common::Error();
+  }
+
+  core::IDataBaseInfo* info = nullptr;
+  err = impl_->Select(db_name, &info);
+  core::IDataBaseInfoSPtr selected(info);
+  return err;
 }
 
 common::Error Driver::ExecuteImpl(const core::command_buffer_t& command, core::FastoObject* out) {
@@ -197,25 +279,91 @@ common::Error Driver::GetCurrentServerInfo(core::IServerInfo** info) {
   return common::Error();
 }
 
-common::Error Driver::GetServerCommands(std::vector<const core::CommandInfo*>* commands) {
+common::Error Driver::UpdateDiscoveryKey() {
+  discovery_key_.clear();
+#if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
+  discovery_modules_.clear();
+  discovery_modules_known_ = false;
+#endif
+
+  // small replies in one pipelined round trip instead of the full INFO
+  std::vector<core::FastoObjectCommandIPtr> cmds = {
+      CreateCommandFast(GEN_CMD_STRING(REDIS_INFO_SERVER_COMMAND), core::C_INNER),
+      CreateCommandFast(GEN_CMD_STRING(REDIS_INFO_MODULES_COMMAND), core::C_INNER),
+      CreateCommandFast(GEN_CMD_STRING(REDIS_COMMAND_COUNT_COMMAND), core::C_INNER)};
+  common::Error err = impl_->ExecuteAsPipeline(cmds, &LOG_COMMAND);
+  if (err) {
+    return err;
+  }
+
+  std::string version;
+  std::vector<std::string> modules;
+  bool modules_section = false;
+  for (size_t i = 0; i < 2; ++i) {
+    std::istringstream content(common::ConvertToString(common::ConvertToString(cmds[i].get())));  // #FIXME
+    std::string line;
+    while (std::getline(content, line)) {
+      if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
+      }
+
+      if (StartsWith(line, REDIS_INFO_VERSION_FIELD)) {
+        version = line.substr(strlen(REDIS_INFO_VERSION_FIELD));
+      } else if (StartsWith(line, REDIS_INFO_MODULES_SECTION)) {
+        modules_section = true;
+      } else if (StartsWith(line, REDIS_INFO_MODULE_FIELD)) {
+        std::string name;
+        std::string module_version;
+        if (ParseInfoModuleLine(line, &name, &module_version)) {
+          modules.push_back(name + "@" + module_version);
+#if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
+          core::ModuleInfo mod;
+          mod.name = name;
+          mod.version = static_cast<uint32_t>(strtoul(module_version.c_str(), nullptr, 10));
+          discovery_modules_.push_back(mod);
+#endif
+        }
+      }
+    }
+  }
+
+  std::string commands_count;
+  core::FastoObject::childs_t count_childrens = cmds[2]->GetChildrens();
+  if (count_childrens.size() == 1) {
+    commands_count = common::ConvertToString(count_childrens[0]->ToString());
+  }
+
+  if (version.empty() || commands_count.empty()) {
+    return common::make_error("Invalid " REDIS_INFO_SERVER_COMMAND " or " REDIS_COMMAND_COUNT_COMMAND " output");
+  }
+
+  // all nodes and restarts of one build share the entry: version and modules pick the commands table,
+  // the count tells apart servers that disabled commands, modules load at runtime so they are keyed too
+  std::sort(modules.begin(), modules.end());
+  std::string key = "redis|" + version + "|commands=" + commands_count + "|";
+  for (size_t i = 0; i < modules.size(); ++i) {
+    key += (i ? "," : "") + modules[i];
+  }
+
+  discovery_key_ = key;
+#if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
+  discovery_modules_known_ = modules_section;
+#endif
+  return common::Error();
+}
+
+common::Error Driver::GetServerCommandNames(std::vector<std::string>* names) {
   core::FastoObjectCommandIPtr cmd = CreateCommandFast(GEN_CMD_STRING(REDIS_GET_COMMANDS), core::C_INNER);
   common::Error err = Execute(cmd.get());
   if (err) {
     return err;
   }
 
-  core::translator_t tran = impl_->GetTranslator();
-
   core::FastoObject::childs_t rchildrens = cmd->GetChildrens();
   CHECK_EQ(rchildrens.size(), 1);
   core::FastoObject* array = rchildrens[0].get();
-  std::vector<const core::CommandInfo*> lcommands;
+  std::vector<std::string> lnames;
   if (array) {
-    const core::CommandHolder* cmd_help = nullptr;
-    err = tran->FindCommand(GEN_CMD_STRING(DB_HELP_COMMAND), &cmd_help);
-    CHECK(!err);
-    lcommands.push_back(cmd_help);
-
     auto array_value = array->GetValue();
     common::ArrayValue* commands_array = nullptr;
     if (array_value && array_value->GetAsList(&commands_array)) {
@@ -238,21 +386,58 @@ common::Error Driver::GetServerCommands(std::vector<const core::CommandInfo*>* c
             return common::make_error("Invalid " REDIS_GET_COMMANDS " command output");
           }
 
-          const core::CommandHolder* cmd = nullptr;
-          common::Error err = tran->FindCommandFirstName(command_name, &cmd);  // #FIXME
-          if (err) {
-            if (!impl_->IsInternalCommand(command_name)) {
-              WARNING_LOG() << "Found not handled command: " << command_name;
-            }
-            continue;
-          }
-
-          lcommands.push_back(cmd);
+          lnames.push_back(common::ConvertToString(command_name));  // #FIXME
         }
       }
     }
   }
 
+  *names = lnames;
+  return common::Error();
+}
+
+common::Error Driver::GetServerCommands(std::vector<const core::CommandInfo*>* commands) {
+  DiscoveryCache& cache = DiscoveryCache::GetInstance();
+  std::vector<const core::CommandInfo*> lcommands;
+  if (cache.FindResolved(discovery_key_, &lcommands)) {
+    *commands = lcommands;
+    return common::Error();
+  }
+
+  std::vector<std::string> names;
+  const bool cached = cache.Find(discovery_key_, &names);
+  if (!cached) {
+    common::Error err = GetServerCommandNames(&names);
+    if (err) {
+      return err;
+    }
+  }
+
+  core::translator_t tran = impl_->GetTranslator();
+  const core::CommandHolder* cmd_help = nullptr;
+  common::Error err = tran->FindCommand(GEN_CMD_STRING(DB_HELP_COMMAND), &cmd_help);
+  CHECK(!err);
+  lcommands.push_back(cmd_help);
+
+  for (const std::string& name : names) {
+    const core::command_buffer_t command_name = common::ConvertToCharBytes(name);
+    const core::CommandHolder* cmd = nullptr;
+    common::Error err = tran->FindCommandFirstName(command_name, &cmd);  // #FIXME
+    if (err) {
+      if (!cached && !impl_->IsInternalCommand(command_name)) {
+        WARNING_LOG() << "Found not handled command: " << command_name;
+      }
+      continue;
+    }
+
+    lcommands.push_back(cmd);
+  }
+
+  if (!cached) {
+    cache.Insert(discovery_key_, names);
+  }
+  cache.SetResolved(discovery_key_, tran, lcommands);
+
   *commands = lcommands;
   return common::Error();
 }
@@ -313,22 +498,44 @@ common::Error Driver::GetCurrentDataBaseInfo(core::IDataBaseInfo** info) {
   return impl_->Select(impl_->GetCurrentDBName(), info);
 }
 
+common::Error Driver::GetDirectConnectionInfo(common::net::HostAndPort* host,
+                                              core::SSHInfo* ssh_info,
+                                              std::string* password) const {
+  if (!host || !ssh_info || !password) {
+    DNOTREACHED();
+    return common::make_error_inval();
+  }
+
+  auto redis_settings = GetSpecificSettings<ConnectionSettings>();
+  const auto config = redis_settings->GetInfo();
+  if (!config.hostsocket.empty() || config.is_ssl) {
+    return common::make_error("Operation requires direct TCP connection");
+  }
+
+  *host = GetHost();
+  *ssh_info = redis_settings->GetSSHInfo();
+  *password = config.auth;
+  return common::Error();
+}
+
 void Driver::HandleBackupEvent(events::BackupRequestEvent* ev) {
   QObject* sender = ev->sender();
   NotifyProgress(sender, 0);
   events::BackupResponseEvent::value_type res(ev->value());
-  NotifyProgress(sender, 25);
-  core::FastoObjectCommandIPtr cmd = CreateCommandFast(GEN_CMD_STRING(REDIS_BACKUP_COMMAND), core::C_INNER);
-  common::Error err = Execute(cmd);
+  common::net::HostAndPort host;
+  core::SSHInfo ssh_info;
+  std::string password;
+  common::Error err = GetDirectConnectionInfo(&host, &ssh_info, &password);
+  if (!err) {
+    const auto progress = [this, sender](int percent) {
+      NotifyProgress(sender, percent);
+      return !IsInterrupted();
+    };
+    err = redis_compatible::StreamRdbSnapshot(host, ssh_info, password, res.path, progress);
+  }
   if (err) {
     res.setErrorInfo(err);
-  } else {
-    common::ErrnoError err = common::file_system::copy_file(BACKUP_DEFAULT_PATH, res.path);
-    if (err) {
-      res.setErrorInfo(common::make_error_from_errno(err));
-    }
   }
-  NotifyProgress(sender, 75);
   Reply(sender, new events::BackupResponseEvent(this, res));
   NotifyProgress(sender, 100);
 }
@@ -347,6 +554,71 @@ void Driver::HandleRestoreEvent(events::RestoreRequestEvent* ev) {
   NotifyProgress(sender, 100);
 }
 
+void Driver::HandleDumpKeysEvent(events::DumpKeysRequestEvent* ev) {
+  QObject* sender = ev->sender();
+  NotifyProgress(sender, 0);
+  events::DumpKeysResponseEvent::value_type res(ev->value());
+  const auto progress = [this, sender](int percent) {
+    NotifyProgress(sender, percent);
+    return !IsInterrupted();
+  };
+  common::Error err = redis_compatible::DumpKeys(MakePipelineConnectionFactory(), progress, &res);
+  if (err) {
+    res.setErrorInfo(err);
+  }
+  Reply(sender, new events::DumpKeysResponseEvent(this, res));
+  NotifyProgress(sender, 100);
+}
+
+void Driver::HandleRestoreKeysEvent(events::RestoreKeysRequestEvent* ev) {
+  QObject* sender = ev->sender();
+  NotifyProgress(sender, 0);
+  events::RestoreKeysResponseEvent::value_type res(ev->value());
+  const auto progress = [this, sender](int percent) {
+    NotifyProgress(sender, percent);
+    return !IsInterrupted();
+  };
+  const std::string target = common::ConvertToString(GetHost()) + "/" + impl_->GetCurrentDBName();
+  common::Error err = redis_compatible::RestoreKeys(MakePipelineConnectionFactory(), target, progress, &res);
+  if (err) {
+    res.setErrorInfo(err);
+  }
+  Reply(sender, new events::RestoreKeysResponseEvent(this, res));
+  NotifyProgress(sender, 100);
+}
+
+redis_compatible::pipeline_connection_factory_t Driver::MakePipelineConnectionFactory() const {
+  auto redis_settings = GetSpecificSettings<ConnectionSettings>();
+  core::redis::Config config = redis_settings->GetInfo();
+  config.host = GetHost();
+  const core::SSHInfo ssh_info = redis_settings->GetSSHInfo();
+  const core::db_name_t db_name = impl_->GetCurrentDBName();
+  return [config, ssh_info, db_name](redis_compatible::pipeline_connection_t* connection) -> common::Error {
+    // every worker goes through own tunnel, it stays open even if driver disconnects in the middle
+    core::redis::Config worker_config = config;
+    core::SSHInfo worker_ssh_info = ssh_info;
+    redis_compatible::ssh_tunnel_t tunnel;
+    common::Error err = redis_compatible::RouteThroughSSHTunnel(&worker_config.host, &worker_ssh_info, &tunnel);
+    if (err) {
+      return err;
+    }
+
+    typedef redis_compatible::PipelineConnection<core::redis::DBConnection, Command> worker_connection_t;
+#if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
+    auto result = std::make_shared<worker_connection_t>(new core::redis::DBConnection(nullptr, nullptr), tunnel);
+#else
+    auto result = std::make_shared<worker_connection_t>(new core::redis::DBConnection(nullptr), tunnel);
+#endif
+    err = result->Connect(core::redis::RConfig(worker_config, worker_ssh_info), db_name);
+    if (err) {
+      return err;
+    }
+
+    *connection = result;
+    return common::Error();
+  };
+}
+
 void Driver::HandleLoadDatabaseContentEvent(events::LoadDatabaseContentRequestEvent* ev) {
   QObject* sender = ev->sender();
   NotifyProgress(sender, 0);
@@ -491,6 +763,43 @@ done:
   NotifyProgress(sender, 100);
 }
 
+void Driver::HandleLoadKeyPageEvent(events::LoadKeyPageRequestEvent* ev) {
+  HandleInnerCommandEvent<events::LoadKeyPageResponseEvent>(ev, &redis_compatible::GetKeyPageCommand,
+                                                            &redis_compatible::ParseKeyPageReply);
+}
+
+void Driver::HandleChangeKeyValueEvent(events::ChangeKeyValueRequestEvent* ev) {
+  QObject* sender = ev->sender();
+  NotifyProgress(sender, 0);
+  events::ChangeKeyValueResponseEvent::value_type res(ev->value());
+  std::vector<core::command_buffer_t> commands;
+  common::Error err = redis_compatible::GetKeyChangesCommands(res, &commands);
+  if (err) {
+    res.setErrorInfo(err);
+  } else if (!commands.empty()) {
+    std::vector<core::FastoObjectCommandIPtr> cmds;
+    cmds.reserve(commands.size());
+    for (const auto& command : commands) {
+      cmds.push_back(CreateCommandFast(command, core::C_USER));
+    }
+    NotifyProgress(sender, 50);
+    err = impl_->ExecuteAsPipeline(cmds, &LOG_COMMAND);
+    if (err) {
+      res.setErrorInfo(err);
+    } else {
+      res.commands_count = cmds.size();
+    }
+  }
+  NotifyProgress(sender, 75);
+  Reply(sender, new events::ChangeKeyValueResponseEvent(this, res));
+  NotifyProgress(sender, 100);
+}
+
+void Driver::HandleLoadStreamPageEvent(events::LoadStreamPageRequestEvent* ev) {
+  HandleInnerCommandEvent<events::LoadStreamPageResponseEvent>(ev, &redis_compatible::GetStreamPageCommand,
+                                                               &redis_compatible::ParseStreamPageReply);
+}
+
 void Driver::HandleDiscoveryInfoEvent(events::DiscoveryInfoRequestEvent* ev) {
   QObject* sender = ev->sender();
   NotifyProgress(sender, 0);
@@ -498,9 +807,15 @@ void Driver::HandleDiscoveryInfoEvent(events::DiscoveryInfoRequestEvent* ev) {
   NotifyProgress(sender, 50);
 
   if (IsConnected()) {
+    common::Error err = UpdateDiscoveryKey();
+    if (err) {
+      // fingerprint unknown, discovery falls back to the full round trips without cache
+      WARNING_LOG() << "Discovery cache is not used: " << err->GetDescription();
+    }
+
     core::IDataBaseInfo* db = nullptr;
     std::vector<const core::CommandInfo*> cmds;
-    common::Error err = GetServerDiscoveryInfo(&db, &cmds);
+    err = GetServerDiscoveryInfo(&db, &cmds);
     if (err) {
       res.setErrorInfo(err);
     } else {
@@ -511,8 +826,10 @@ void Driver::HandleDiscoveryInfoEvent(events::DiscoveryInfoRequestEvent* ev) {
       res.dbinfo = current_database_info;
       res.commands = cmds;
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
-      std::vector<core::ModuleInfo> lmodules;
-      GetServerLoadedModules(&lmodules);  // can be failed
+      std::vector<core::ModuleInfo> lmodules = discovery_modules_;
+      if (!discovery_modules_known_) {
+        GetServerLoadedModules(&lmodules);  // can be failed
+      }
       res.loaded_modules = lmodules;
 #endif
     }
@@ -584,76 +901,33 @@ void Driver::HandleLoadServerChannelsRequestEvent(events::LoadServerChannelsRequ
   const core::command_buffer_t load_channels_request = wr.str();
   core::FastoObjectCommandIPtr cmd = CreateCommandFast(load_channels_request, core::C_INNER);
   common::Error err = Execute(cmd);
-  if (err) {
-    res.setErrorInfo(err);
-    goto done;
-  } else {
-    core::FastoObject::childs_t rchildrens = cmd->GetChildrens();
-    if (rchildrens.size()) {
-      CHECK_EQ(rchildrens.size(), 1);
-      core::FastoObject* array = rchildrens[0].get();
-      if (array) {
-        auto array_value = array->GetValue();
-        common::ArrayValue* arm = nullptr;
-        if (!array_value->GetAsList(&arm) || !arm->GetSize()) {
-          goto done;
-        }
+  if (!err) {
+    err = redis_compatible::ParseChannelsReply(cmd.get(), &res.channels);
+  }
 
-        std::vector<core::FastoObjectCommandIPtr> cmds;
-        cmds.reserve(arm->GetSize());
-        for (size_t i = 0; i < arm->GetSize(); ++i) {
-          common::Value::string_t channel;
-          bool isok = arm->GetString(i, &channel);
-          if (isok) {
-            core::command_buffer_writer_t wr2;
-            wr2 << REDIS_PUBSUB_NUMSUB_COMMAND " " << channel;
-            proxy::NDbPSChannel ch(core::ReadableString(channel), 0);
-            cmds.push_back(CreateCommandFast(wr2.str(), core::C_INNER));
-            res.channels.push_back(ch);
-          }
-        }
+  std::vector<core::command_buffer_t> numsub_requests;
+  if (!err) {
+    err = redis_compatible::GetChannelsNumSubCommands(res.channels, &numsub_requests);
+  }
 
-        err = impl_->ExecuteAsPipeline(cmds, &LOG_COMMAND);
-        if (err) {
-          res.setErrorInfo(err);
-          goto done;
-        }
+  if (!err && !numsub_requests.empty()) {
+    std::vector<core::FastoObjectCommandIPtr> cmds;
+    cmds.reserve(numsub_requests.size());
+    for (const auto& numsub_request : numsub_requests) {
+      cmds.push_back(CreateCommandFast(numsub_request, core::C_INNER));
+    }
 
-        for (size_t i = 0; i < res.channels.size(); ++i) {
-          core::FastoObjectIPtr subCount = cmds[i];
-          core::FastoObject::childs_t tchildrens = subCount->GetChildrens();
-          if (tchildrens.size()) {
-            DCHECK_EQ(tchildrens.size(), 1);
-            if (tchildrens.size() == 1) {
-              core::FastoObject* array_sub = tchildrens[0].get();
-              auto arr_value = array_sub->GetValue();
-              common::ArrayValue* array_sub_inner = nullptr;
-              if (arr_value->GetAsList(&array_sub_inner)) {
-                common::Value* fund_sub = nullptr;
-                if (array_sub_inner->Get(1, &fund_sub)) {
-                  common::Value::Type t = fund_sub->GetType();
-                  if (t == common::Value::TYPE_LONG_LONG_INTEGER) {
-                    long long lsub;
-                    if (fund_sub->GetAsLongLongInteger(&lsub)) {
-                      res.channels[i].SetNumberOfSubscribers(lsub);
-                    }
-                  } else if (t == common::Value::TYPE_STRING) {
-                    common::Value::string_t lsub_str;
-                    size_t lsub;
-                    if (fund_sub->GetAsString(&lsub_str) && common::ConvertFromBytes(lsub_str, &lsub)) {
-                      res.channels[i].SetNumberOfSubscribers(lsub);
-                    }
-                  }
-                }
-              }
-            }
-          }
-        }
-      }
+    err = impl_->ExecuteAsPipeline(cmds, &LOG_COMMAND);
+    size_t offset = 0;
+    for (size_t i = 0; !err && i < cmds.size(); ++i) {
+      err = redis_compatible::ParseChannelsNumSubReply(cmds[i].get(), &offset, &res.channels);
     }
   }
 
-done:
+  if (err) {
+    res.setErrorInfo(err);
+  }
+
   NotifyProgress(sender, 75);
   Reply(sender, new events::LoadServerChannelsResponseEvent(this, res));
   NotifyProgress(sender, 100);
@@ -681,17 +955,8 @@ void Driver::HandleLoadServerClientsRequestEvent(events::LoadServerClientsReques
           goto done;
         }
 
-        size_t pos = 0;
-        size_t start = 0;
-        std::string clients_text = common::ConvertToString(string_value);  // #FIXME
-        while ((pos = clients_text.find(REDIS_NEW_LINE_MARKER, start)) != std::string::npos) {
-          std::string line = clients_text.substr(start, pos - start);
-          NDbClient cl(line);
-          if (cl.IsValid()) {
-            res.clients.push_back(cl);
-          }
-          start = pos + SIZEOFMASS(REDIS_NEW_LINE_MARKER) - 1;
-        }
+        const std::string clients_text = common::ConvertToString(string_value);  // #FIXME
+        ParseClientList(clients_text, &res.clients);
       }
     }
   }
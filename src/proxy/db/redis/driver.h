@@ -21,6 +21,8 @@
 #include <string>
 #include <vector>
 
+#include "proxy/db/redis_compatible/logical_dump.h"
+#include "proxy/db/redis_compatible/ssh_tunnel.h"
 #include "proxy/driver/idriver_remote.h"
 
 namespace fastonosql {
@@ -53,6 +55,12 @@ class Driver : public IDriverRemote {
   bool IsConnected() const override;
   bool IsAuthenticated() const override;
 
+  // endpoint for extra plain connections (replication, pub/sub), ssh info is valid when each of them has to
+  // acquire own tunnel, unix socket and encrypted connections are rejected
+  common::Error GetDirectConnectionInfo(common::net::HostAndPort* host,
+                                        core::SSHInfo* ssh_info,
+                                        std::string* password) const WARN_UNUSED_RESULT;
+
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
  Q_SIGNALS:
   void ModuleLoaded(core::ModuleInfo module);
@@ -74,15 +82,19 @@ class Driver : public IDriverRemote {
 
   common::Error SyncConnect() override WARN_UNUSED_RESULT;
   common::Error SyncDisconnect() override WARN_UNUSED_RESULT;
+  common::Error SyncReconnect() override WARN_UNUSED_RESULT;
 
   common::Error ExecuteImpl(const core::command_buffer_t& command, core::FastoObject* out) override WARN_UNUSED_RESULT;
   common::Error DBkcountImpl(core::keys_limit_t* size) override WARN_UNUSED_RESULT;
 
   common::Error GetCurrentServerInfo(core::IServerInfo** info) override;
   common::Error GetServerCommands(std::vector<const core::CommandInfo*>* commands) override;
+  common::Error GetServerCommandNames(std::vector<std::string>* names);
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
   common::Error GetServerLoadedModules(std::vector<core::ModuleInfo>* modules);
 #endif
+  // cheap INFO fingerprint used as the discovery cache key
+  common::Error UpdateDiscoveryKey();
   common::Error GetCurrentDataBaseInfo(core::IDataBaseInfo** info) override;
 
   void HandleDiscoveryInfoEvent(events::DiscoveryInfoRequestEvent* ev) override;
@@ -92,14 +104,26 @@ class Driver : public IDriverRemote {
   void HandleLoadServerClientsRequestEvent(events::LoadServerClientsRequestEvent* ev) override;
   void HandleBackupEvent(events::BackupRequestEvent* ev) override;
   void HandleRestoreEvent(events::RestoreRequestEvent* ev) override;
+  void HandleDumpKeysEvent(events::DumpKeysRequestEvent* ev) override;
+  void HandleRestoreKeysEvent(events::RestoreKeysRequestEvent* ev) override;
 
   void HandleLoadDatabaseContentEvent(events::LoadDatabaseContentRequestEvent* ev) override;
+  void HandleLoadKeyPageEvent(events::LoadKeyPageRequestEvent* ev) override;
+  void HandleChangeKeyValueEvent(events::ChangeKeyValueRequestEvent* ev) override;
+  void HandleLoadStreamPageEvent(events::LoadStreamPageRequestEvent* ev) override;
 
   core::IServerInfoSPtr MakeServerInfoFromString(const std::string& val) override;
 
+  // extra connections to current database for parallel dump/restore workers
+  redis_compatible::pipeline_connection_factory_t MakePipelineConnectionFactory() const;
+
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
   core::IModuleConnectionClient* proxy_;
+  std::vector<core::ModuleInfo> discovery_modules_;
+  bool discovery_modules_known_;
 #endif
+  std::string discovery_key_;
+  redis_compatible::ssh_tunnel_t ssh_tunnel_;
   core::redis::DBConnection* impl_;
 };
 
@@ -18,6 +18,12 @@
 
 #include "proxy/db/redis/server.h"
 
+#include <set>
+
+#include <QThread>
+
+#include <common/qt/logger.h>
+
 #include <fastonosql/core/db/redis/server_info.h>
 
 #include "proxy/db/redis/driver.h"
@@ -34,17 +40,26 @@ namespace proxy {
 namespace redis {
 
 Server::Server(IConnectionSettingsBaseSPtr settings)
-    : IServerRemote(new Driver(settings)), role_(core::MASTER), mode_(core::STANDALONE) {
+    : IServerRemote(new Driver(settings)),
+      role_(core::MASTER),
+      mode_(core::STANDALONE),
+      keyspace_listener_(),
+      keyspace_notifications_(false) {
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
   Driver* drv = static_cast<Driver*>(drv_);
   VERIFY(QObject::connect(drv, &Driver::ModuleLoaded, this, &Server::LoadModule));
   VERIFY(QObject::connect(drv, &Driver::ModuleUnLoaded, this, &Server::UnLoadModule));
 #endif
+  VERIFY(QObject::connect(this, &Server::DatabaseChanged, this, &Server::RestartKeyspaceNotifications));
+  VERIFY(QObject::connect(this, &Server::Disconnected, this, &Server::DropKeyspaceNotifications));
 
   StartCheckKeyExistTimer();
 }
 
 Server::~Server() {
+  if (keyspace_listener_) {
+    keyspace_listener_->Stop();
+  }
   StopCheckKeyExistTimer();
 }
 
@@ -65,10 +80,149 @@ common::net::HostAndPort Server::GetHost() const {
   return rdrv->GetHost();
 }
 
+common::Error Server::GetDirectConnectionInfo(common::net::HostAndPort* host,
+                                              core::SSHInfo* ssh_info,
+                                              std::string* password) const {
+  Driver* rdrv = static_cast<Driver*>(drv_);
+  return rdrv->GetDirectConnectionInfo(host, ssh_info, password);
+}
+
+common::Error Server::StartKeyspaceNotifications() {
+  if (keyspace_notifications_) {
+    return common::Error();
+  }
+
+  common::Error err = StartKeyspaceListener(GetCurrentDatabaseInfo());
+  if (err) {
+    return err;
+  }
+
+  keyspace_notifications_ = true;
+  return common::Error();
+}
+
+void Server::StopKeyspaceNotifications() {
+  keyspace_notifications_ = false;
+  if (keyspace_listener_) {
+    keyspace_listener_->Stop();
+    keyspace_listener_.clear();  // finished signal of stopped listener is not reported
+  }
+}
+
+bool Server::IsKeyspaceNotificationsActive() const {
+  return keyspace_notifications_;
+}
+
 IDatabaseSPtr Server::CreateDatabase(core::IDataBaseInfoSPtr info) {
   return IDatabaseSPtr(new redis_compatible::Database(shared_from_this(), info));
 }
 
+common::Error Server::StartKeyspaceListener(core::IDataBaseInfoSPtr db) {
+  if (!db) {
+    return common::make_error("Database not loaded");
+  }
+
+  common::net::HostAndPort host;
+  core::SSHInfo ssh_info;
+  std::string password;
+  common::Error err = GetDirectConnectionInfo(&host, &ssh_info, &password);
+  if (err) {
+    return err;
+  }
+
+  redis_compatible::KeyspaceListener* listener =
+      new redis_compatible::KeyspaceListener(host, ssh_info, password, db->GetName());
+  QThread* th = new QThread;
+  listener->moveToThread(th);
+  VERIFY(QObject::connect(th, &QThread::started, listener, &redis_compatible::KeyspaceListener::Routine));
+  VERIFY(QObject::connect(listener, &redis_compatible::KeyspaceListener::KeysChanged, this,
+                          &Server::ApplyKeyspaceChanges));
+  VERIFY(QObject::connect(listener, &redis_compatible::KeyspaceListener::Finished, this,
+                          &Server::FinishKeyspaceNotifications));
+  VERIFY(QObject::connect(listener, &redis_compatible::KeyspaceListener::Finished, th, &QThread::quit));
+  VERIFY(QObject::connect(th, &QThread::finished, listener, &redis_compatible::KeyspaceListener::deleteLater));
+  VERIFY(QObject::connect(th, &QThread::finished, th, &QThread::deleteLater));
+  keyspace_listener_ = listener;
+  th->start();
+  return common::Error();
+}
+
+void Server::ApplyKeyspaceChanges(const redis_compatible::KeyspaceChanges& changes) {
+  if (sender() != keyspace_listener_.data()) {  // queued batch of previous database
+    return;
+  }
+
+  if (changes.dropped) {
+    WARNING_LOG() << "Keyspace notifications dropped: " << changes.dropped << ", explorer may be stale.";
+  }
+
+  database_t cdb = GetCurrentDatabaseInfo();
+  if (!cdb) {
+    return;
+  }
+
+  // explorer shows a scanned page, keys written outside of it must not grow the view
+  std::set<core::command_buffer_t> loaded;
+  for (const core::NDbKValue& key : cdb->GetKeys()) {
+    loaded.insert(key.GetKey().GetKey().GetForCommandLine());
+  }
+
+  for (const core::NKey& key : changes.removed) {
+    if (loaded.count(key.GetKey().GetForCommandLine())) {
+      RemoveKey(key);
+    }
+  }
+
+  for (const core::NDbKValue& key : changes.updated) {
+    if (!loaded.count(key.GetKey().GetKey().GetForCommandLine())) {
+      continue;
+    }
+
+    AddKey(key);  // reloads value type of existing key
+    ChangeKeyTTL(key.GetKey(), key.GetKey().GetTTL());
+  }
+}
+
+void Server::FinishKeyspaceNotifications(common::Error err) {
+  if (sender() != keyspace_listener_.data()) {
+    return;
+  }
+
+  keyspace_listener_.clear();
+  keyspace_notifications_ = false;
+  if (err) {
+    LOG_ERROR(err, common::logging::LOG_LEVEL_ERR, true);
+  }
+  emit KeyspaceNotificationsStopped(err);
+}
+
+void Server::RestartKeyspaceNotifications(core::IDataBaseInfoSPtr db) {
+  if (!keyspace_notifications_) {
+    return;
+  }
+
+  if (keyspace_listener_) {
+    keyspace_listener_->Stop();
+    keyspace_listener_.clear();
+  }
+
+  common::Error err = StartKeyspaceListener(db);
+  if (err) {
+    keyspace_notifications_ = false;
+    LOG_ERROR(err, common::logging::LOG_LEVEL_ERR, true);
+    emit KeyspaceNotificationsStopped(err);
+  }
+}
+
+void Server::DropKeyspaceNotifications() {
+  if (!keyspace_notifications_) {
+    return;
+  }
+
+  StopKeyspaceNotifications();
+  emit KeyspaceNotificationsStopped(common::Error());
+}
+
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
 void Server::LoadModule(core::ModuleInfo module) {
   emit ModuleLoaded(module);
@@ -18,7 +18,12 @@
 
 #pragma once
 
+#include <string>
+
+#include <QPointer>
+
 #include "proxy/connection_settings/iconnection_settings.h"
+#include "proxy/db/redis_compatible/keyspace_listener.h"
 #include "proxy/server/iserver_remote.h"
 
 #include <fastonosql/core/module_info.h>
@@ -38,6 +43,19 @@ class Server : public IServerRemote {
   core::ServerMode GetMode() const override;
   core::ServerState GetState() const override;
   common::net::HostAndPort GetHost() const override;
+
+  common::Error GetDirectConnectionInfo(common::net::HostAndPort* host,
+                                        core::SSHInfo* ssh_info,
+                                        std::string* password) const WARN_UNUSED_RESULT;
+
+  // live explorer updates for current database, follows database changes until stopped
+  common::Error StartKeyspaceNotifications() WARN_UNUSED_RESULT;
+  void StopKeyspaceNotifications();
+  bool IsKeyspaceNotificationsActive() const;
+
+ Q_SIGNALS:
+  void KeyspaceNotificationsStopped(common::Error err);
+
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
  Q_SIGNALS:
   void ModuleLoaded(core::ModuleInfo module);
@@ -47,13 +65,23 @@ class Server : public IServerRemote {
   void LoadModule(core::ModuleInfo module);
   void UnLoadModule(core::ModuleInfo module);
 #endif
+ private Q_SLOTS:
+  void ApplyKeyspaceChanges(const fastonosql::proxy::redis_compatible::KeyspaceChanges& changes);
+  void FinishKeyspaceNotifications(common::Error err);
+  void RestartKeyspaceNotifications(core::IDataBaseInfoSPtr db);
+  void DropKeyspaceNotifications();
+
  protected:
   void HandleLoadServerInfoEvent(events::ServerInfoResponseEvent* ev) override;
 
  private:
   IDatabaseSPtr CreateDatabase(core::IDataBaseInfoSPtr info) override;
+  common::Error StartKeyspaceListener(core::IDataBaseInfoSPtr db) WARN_UNUSED_RESULT;
+
   core::ServerType role_;
   core::ServerMode mode_;
+  QPointer<redis_compatible::KeyspaceListener> keyspace_listener_;
+  bool keyspace_notifications_;  // requested by user, survives database changes
 };
 
 }  // namespace redis
@@ -0,0 +1,144 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "proxy/db/redis_compatible/channels.h"
+
+#include <algorithm>
+
+#include <common/convert2string.h>
+
+#define REDIS_PUBSUB_NUMSUB_COMMAND "PUBSUB NUMSUB"
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+namespace {
+
+const size_t kChannelsPerNumSub = 1000;
+
+common::Error GetReplyArray(core::FastoObject* reply, common::ArrayValue** arm) {
+  core::FastoObject::childs_t rchildrens = reply->GetChildrens();
+  if (rchildrens.empty()) {
+    *arm = nullptr;
+    return common::Error();
+  }
+
+  if (rchildrens.size() != 1) {
+    return common::make_error("Invalid channels reply");
+  }
+
+  auto array_value = rchildrens[0]->GetValue();
+  if (!array_value || !array_value->GetAsList(arm)) {
+    return common::make_error("Invalid channels reply");
+  }
+
+  return common::Error();
+}
+
+bool GetNumberOfSubscribers(common::Value* value, size_t* nos) {
+  long long lsub;
+  if (value->GetType() == common::Value::TYPE_LONG_LONG_INTEGER) {
+    if (!value->GetAsLongLongInteger(&lsub)) {
+      return false;
+    }
+  } else {
+    common::Value::string_t lsub_str;
+    if (!value->GetAsString(&lsub_str) || !common::ConvertFromBytes(lsub_str, &lsub)) {
+      return false;
+    }
+  }
+
+  *nos = static_cast<size_t>(lsub);
+  return true;
+}
+
+}  // namespace
+
+common::Error ParseChannelsReply(core::FastoObject* reply, std::vector<NDbPSChannel>* channels) {
+  if (!reply || !channels) {
+    return common::make_error_inval();
+  }
+
+  common::ArrayValue* arm = nullptr;
+  common::Error err = GetReplyArray(reply, &arm);
+  if (err || !arm) {
+    return err;
+  }
+
+  channels->reserve(channels->size() + arm->GetSize());
+  for (size_t i = 0; i < arm->GetSize(); ++i) {
+    common::Value::string_t channel;
+    if (arm->GetString(i, &channel)) {
+      channels->push_back(NDbPSChannel(core::ReadableString(channel), 0));
+    }
+  }
+  return common::Error();
+}
+
+common::Error GetChannelsNumSubCommands(const std::vector<NDbPSChannel>& channels,
+                                        std::vector<core::command_buffer_t>* cmds) {
+  if (!cmds) {
+    return common::make_error_inval();
+  }
+
+  cmds->clear();
+  for (size_t start = 0; start < channels.size(); start += kChannelsPerNumSub) {
+    const size_t stop = std::min(channels.size(), start + kChannelsPerNumSub);
+    core::command_buffer_writer_t wr;
+    wr << REDIS_PUBSUB_NUMSUB_COMMAND;
+    for (size_t i = start; i < stop; ++i) {
+      wr << " " << channels[i].GetName().GetForCommandLine();
+    }
+    cmds->push_back(wr.str());
+  }
+  return common::Error();
+}
+
+common::Error ParseChannelsNumSubReply(core::FastoObject* reply, size_t* offset, std::vector<NDbPSChannel>* channels) {
+  if (!reply || !offset || !channels) {
+    return common::make_error_inval();
+  }
+
+  common::ArrayValue* arm = nullptr;
+  common::Error err = GetReplyArray(reply, &arm);
+  if (err) {
+    return err;
+  }
+  if (!arm || arm->GetSize() % 2 != 0) {
+    return common::make_error("Invalid PUBSUB NUMSUB reply");
+  }
+
+  const size_t pairs = arm->GetSize() / 2;
+  if (*offset + pairs > channels->size()) {
+    return common::make_error("Invalid PUBSUB NUMSUB reply");
+  }
+
+  for (size_t i = 0; i < pairs; ++i) {
+    common::Value* count = nullptr;
+    size_t nos;
+    if (arm->Get(i * 2 + 1, &count) && GetNumberOfSubscribers(count, &nos)) {
+      (*channels)[*offset + i].SetNumberOfSubscribers(nos);
+    }
+  }
+  *offset += pairs;
+  return common::Error();
+}
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,43 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <vector>
+
+#include <fastonosql/core/global.h>
+
+#include "proxy/db_ps_channel.h"
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+// channel names from PUBSUB CHANNELS reply, subscribers are unknown yet
+common::Error ParseChannelsReply(core::FastoObject* reply, std::vector<NDbPSChannel>* channels) WARN_UNUSED_RESULT;
+
+// PUBSUB NUMSUB accepts many channels, one command is built per chunk instead of one per channel
+common::Error GetChannelsNumSubCommands(const std::vector<NDbPSChannel>& channels,
+                                        std::vector<core::command_buffer_t>* cmds) WARN_UNUSED_RESULT;
+// flat name/count pairs come in request order, counts are stored from *offset which is advanced past them
+common::Error ParseChannelsNumSubReply(core::FastoObject* reply,
+                                       size_t* offset,
+                                       std::vector<NDbPSChannel>* channels) WARN_UNUSED_RESULT;
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
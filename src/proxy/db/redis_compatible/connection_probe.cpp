@@ -0,0 +1,246 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "proxy/db/redis_compatible/connection_probe.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include <common/convert2string.h>
+#include <common/time.h>
+
+#include "proxy/db/redis_compatible/resp_connection.h"
+#include "proxy/db/redis_compatible/ssh_tunnel.h"
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+namespace {
+const char kProbeKeyPrefix[] = "fastonosql:diagnostics:";
+const char kProbeKeyTtlMsec[] = "60000";  // key expires even if final DEL never arrives
+const int kChannelOpenTimeoutMsec = 10000;
+
+class StopWatch {
+ public:
+  StopWatch() : start_(std::chrono::steady_clock::now()) {}
+
+  ConnectionDiagnostics::usec_t Elapsed() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_).count();
+  }
+
+ private:
+  const std::chrono::steady_clock::time_point start_;
+};
+
+common::Error ReadOkReply(RespConnection* connection, RespReply* reply) {
+  common::Error err = connection->ReadReply(reply);
+  if (err) {
+    return err;
+  }
+
+  if (reply->type == RespReply::ERROR) {
+    return common::make_error(reply->str);
+  }
+  return common::Error();
+}
+
+common::Error MeasurePings(RespConnection* connection, size_t count, LatencyHistogram* histogram) {
+  const std::string ping = MakeRespCommand({"PING"});
+  RespReply reply;
+  for (size_t i = 0; i < count; ++i) {
+    StopWatch watch;
+    common::Error err = connection->SendRaw(ping);
+    if (err) {
+      return err;
+    }
+
+    err = ReadOkReply(connection, &reply);
+    if (err) {
+      return err;
+    }
+    histogram->Add(watch.Elapsed());
+  }
+  return common::Error();
+}
+
+// replicas refuse writes or silently diverge from master, probe key is never written there
+common::Error CheckWritable(RespConnection* connection, std::string* reason) {
+  common::Error err = connection->SendCommand({"ROLE"});
+  if (err) {
+    return err;
+  }
+
+  RespReply reply;
+  err = connection->ReadReply(&reply);
+  if (err) {
+    return err;
+  }
+
+  // ROLE may be renamed or missing on old servers, then write is just attempted
+  if (reply.type == RespReply::ARRAY && !reply.elements.empty() && reply.elements[0].type == RespReply::BULK &&
+      reply.elements[0].str != "master") {
+    *reason = "node is " + reply.elements[0].str;
+  }
+  return common::Error();
+}
+
+// cluster node which doesn't serve slot of probe key redirects, replica with read only flag refuses
+bool IsWriteRejected(const std::string& error) {
+  return error.compare(0, 6, "MOVED ") == 0 || error.compare(0, 4, "ASK ") == 0 ||
+         error.compare(0, 8, "READONLY") == 0;
+}
+
+common::Error MeasureThroughput(RespConnection* connection,
+                                const DiagnosticsOptions& options,
+                                ConnectionDiagnostics* out) {
+  out->payload_size = options.payload_size;
+  common::Error err = CheckWritable(connection, &out->throughput_skipped);
+  if (err || !out->throughput_skipped.empty()) {
+    return err;
+  }
+
+  const std::string key = kProbeKeyPrefix + common::ConvertToString(common::time::current_utc_mstime());
+  const std::string payload(options.payload_size, 'x');
+  const size_t payload_size = std::max<size_t>(payload.size(), 1);
+  const size_t max_depth = std::max<size_t>(DiagnosticsOptions::max_batch_size / payload_size, 1);
+  const size_t depth = std::min(std::max<size_t>(options.pipeline_depth, 1), max_depth);
+  std::string batch;
+  for (size_t i = 0; i < depth; ++i) {
+    batch += MakeRespCommand({"SET", key, payload, "PX", kProbeKeyTtlMsec});
+    batch += MakeRespCommand({"GET", key});
+  }
+
+  out->pipeline_depth = depth;
+  RespReply reply;
+  StopWatch watch;
+  // at least one batch even with zero budget, so result never stays empty
+  do {
+    err = connection->SendRaw(batch);
+    if (err) {
+      break;
+    }
+
+    // whole batch is read even after error reply, so connection stays in sync for DEL
+    std::string error;
+    for (size_t i = 0; i < depth * 2 && !err; ++i) {
+      err = connection->ReadReply(&reply);
+      if (!err && reply.type == RespReply::ERROR && error.empty()) {
+        error = reply.str;
+      }
+    }
+    if (err) {
+      break;
+    }
+
+    if (!error.empty()) {
+      if (out->throughput_ops == 0 && IsWriteRejected(error)) {
+        out->throughput_skipped = error;
+      } else {
+        err = common::make_error(error);
+      }
+      break;
+    }
+    out->throughput_ops += depth * 2;
+  } while (watch.Elapsed() < options.throughput_msec * 1000);
+  out->throughput_usec = watch.Elapsed();
+
+  common::Error del_err = connection->SendCommand({"DEL", key});
+  if (!del_err) {
+    del_err = connection->ReadReply(&reply);
+  }
+  UNUSED(del_err);
+  return err;
+}
+
+}  // namespace
+
+common::Error ProbeConnection(const common::net::HostAndPort& host,
+                              const std::string& password,
+                              bool is_ssl,
+                              const core::SSHInfo& ssh_info,
+                              const DiagnosticsOptions& options,
+                              ConnectionDiagnostics* out) {
+  if (!out) {
+    DNOTREACHED();
+    return common::make_error_inval();
+  }
+
+  *out = ConnectionDiagnostics();
+  common::net::HostAndPort endpoint = host;
+  ssh_tunnel_t tunnel;
+  if (ssh_info.IsValid()) {
+    out->ssh_session_reused = SSHTunnelManager::GetInstance().HasSession(ssh_info);
+    StopWatch watch;
+    common::Error err = SSHTunnelManager::GetInstance().Acquire(ssh_info, host, &tunnel);
+    if (err) {
+      return err;
+    }
+    out->ssh_usec = watch.Elapsed();
+    endpoint = tunnel->GetLocalHost();
+  }
+
+  RespConnection connection(endpoint);
+  {
+    // over ssh this is loopback connect, channel to database is timed on its own
+    StopWatch watch;
+    common::Error err = connection.Open();
+    if (err) {
+      return err;
+    }
+    out->tcp_usec = watch.Elapsed();
+  }
+
+  if (tunnel) {
+    StopWatch watch;
+    common::Error err = tunnel->WaitForChannel(kChannelOpenTimeoutMsec);
+    if (err) {
+      return err;
+    }
+    out->ssh_channel_usec = watch.Elapsed();
+  }
+
+  if (is_ssl) {
+    StopWatch watch;
+    common::Error err = connection.StartTls();
+    if (err) {
+      return err;
+    }
+    out->tls_usec = watch.Elapsed();
+  }
+
+  if (!password.empty()) {
+    StopWatch watch;
+    common::Error err = connection.Auth(password);
+    if (err) {
+      return err;
+    }
+    out->auth_usec = watch.Elapsed();
+  }
+
+  common::Error err = MeasurePings(&connection, options.ping_count, &out->ping);
+  if (err) {
+    return err;
+  }
+
+  return MeasureThroughput(&connection, options, out);
+}
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
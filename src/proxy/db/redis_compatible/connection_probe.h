@@ -0,0 +1,45 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <string>
+
+#include <common/error.h>
+#include <common/net/types.h>
+
+#include <fastonosql/core/ssh_info.h>
+
+#include "proxy/connection_diagnostics.h"
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+// Times every connection step (ssh session, tcp, ssh channel, tls, auth) on its own connection, then measures
+// PING latency distribution and pipelined SET/GET throughput with a short lived probe key,
+// throughput is reported as skipped on nodes which can't take the key (replicas, other slots of cluster).
+common::Error ProbeConnection(const common::net::HostAndPort& host,
+                              const std::string& password,
+                              bool is_ssl,
+                              const core::SSHInfo& ssh_info,
+                              const DiagnosticsOptions& options,
+                              ConnectionDiagnostics* out) WARN_UNUSED_RESULT;
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
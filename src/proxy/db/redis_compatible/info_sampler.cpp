@@ -0,0 +1,427 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/db/redis_compatible/info_sampler.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include <common/macros.h>
+
+#define REDIS_INFO_COMMAND "INFO"
+
+#define INFO_ROLE_FIELD "role"
+#define INFO_ROLE_MASTER "master"
+#define INFO_USED_MEMORY_FIELD "used_memory"
+#define INFO_MAXMEMORY_FIELD "maxmemory"
+#define INFO_CONNECTED_CLIENTS_FIELD "connected_clients"
+#define INFO_TOTAL_COMMANDS_FIELD "total_commands_processed"
+#define INFO_KEYSPACE_HITS_FIELD "keyspace_hits"
+#define INFO_KEYSPACE_MISSES_FIELD "keyspace_misses"
+#define INFO_EVICTED_KEYS_FIELD "evicted_keys"
+#define INFO_MASTER_REPL_OFFSET_FIELD "master_repl_offset"
+#define INFO_SLAVE_REPL_OFFSET_FIELD "slave_repl_offset"
+#define INFO_SLAVE_FIELD_PREFIX "slave"  // slave0:ip=127.0.0.1,port=6380,state=online,offset=42,lag=0
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+namespace {
+
+const uint32_t kDefaultIntervalMsec = 1000;
+const size_t kDefaultMaxConnections = 8;
+const int kDefaultIoTimeoutMsec = 5000;
+const common::time64_t kStopCheckMsec = 100;
+
+struct Token {
+  const char* data;
+  size_t size;
+
+  bool Equals(const char* str) const {
+    const size_t len = strlen(str);
+    return len == size && memcmp(data, str, len) == 0;
+  }
+
+  bool StartsWith(const char* str) const {
+    const size_t len = strlen(str);
+    return len <= size && memcmp(data, str, len) == 0;
+  }
+};
+
+uint64_t ToUInt64(const Token& value) {
+  uint64_t result = 0;
+  for (size_t i = 0; i < value.size && value.data[i] >= '0' && value.data[i] <= '9'; ++i) {
+    result = result * 10 + static_cast<uint64_t>(value.data[i] - '0');
+  }
+  return result;
+}
+
+int64_t ToInt64(const Token& value) {
+  if (value.size && value.data[0] == '-') {
+    return -static_cast<int64_t>(ToUInt64({value.data + 1, value.size - 1}));
+  }
+  return static_cast<int64_t>(ToUInt64(value));
+}
+
+// ip=127.0.0.1,port=6380,state=online,offset=42,lag=0
+bool ParseReplicaLine(const Token& value, ReplicaOffset* replica) {
+  std::string ip;
+  uint16_t port = 0;
+  bool has_offset = false;
+  const char* pos = value.data;
+  const char* end = value.data + value.size;
+  while (pos < end) {
+    const char* comma = static_cast<const char*>(memchr(pos, ',', end - pos));
+    const char* item_end = comma ? comma : end;
+    const char* eq = static_cast<const char*>(memchr(pos, '=', item_end - pos));
+    if (eq) {
+      const Token name = {pos, static_cast<size_t>(eq - pos)};
+      const Token val = {eq + 1, static_cast<size_t>(item_end - eq - 1)};
+      if (name.Equals("ip")) {
+        ip.assign(val.data, val.size);
+      } else if (name.Equals("port")) {
+        port = static_cast<uint16_t>(ToUInt64(val));
+      } else if (name.Equals("offset")) {
+        replica->offset = ToInt64(val);
+        has_offset = true;
+      }
+    }
+    pos = item_end + 1;
+  }
+
+  if (ip.empty() || !port || !has_offset) {
+    return false;
+  }
+
+  replica->host = common::net::HostAndPort(ip, port);
+  return true;
+}
+
+double PerSecond(uint64_t prev, uint64_t cur, common::time64_t msec) {
+  if (msec <= 0 || cur < prev) {  // counters reset by CONFIG RESETSTAT or restart
+    return 0;
+  }
+  return static_cast<double>(cur - prev) * 1000 / static_cast<double>(msec);
+}
+
+}  // namespace
+
+InfoCounters::InfoCounters()
+    : is_master(true),
+      used_memory(0),
+      maxmemory(0),
+      connected_clients(0),
+      total_commands_processed(0),
+      keyspace_hits(0),
+      keyspace_misses(0),
+      evicted_keys(0),
+      repl_offset(0),
+      replicas() {}
+
+bool ParseInfoCounters(const std::string& info, InfoCounters* counters) {
+  if (!counters) {
+    DNOTREACHED();
+    return false;
+  }
+
+  *counters = InfoCounters();
+  bool has_role = false;
+  const char* pos = info.data();
+  const char* end = info.data() + info.size();
+  while (pos < end) {
+    const char* nl = static_cast<const char*>(memchr(pos, '\n', end - pos));
+    const char* line_end = nl ? nl : end;
+    const char* value_end = (line_end > pos && *(line_end - 1) == '\r') ? line_end - 1 : line_end;
+    const char* colon = static_cast<const char*>(memchr(pos, ':', value_end - pos));
+    if (colon && *pos != '#') {
+      const Token name = {pos, static_cast<size_t>(colon - pos)};
+      const Token value = {colon + 1, static_cast<size_t>(value_end - colon - 1)};
+      if (name.Equals(INFO_ROLE_FIELD)) {
+        counters->is_master = value.Equals(INFO_ROLE_MASTER);
+        has_role = true;
+      } else if (name.Equals(INFO_USED_MEMORY_FIELD)) {
+        counters->used_memory = ToUInt64(value);
+      } else if (name.Equals(INFO_MAXMEMORY_FIELD)) {
+        counters->maxmemory = ToUInt64(value);
+      } else if (name.Equals(INFO_CONNECTED_CLIENTS_FIELD)) {
+        counters->connected_clients = ToUInt64(value);
+      } else if (name.Equals(INFO_TOTAL_COMMANDS_FIELD)) {
+        counters->total_commands_processed = ToUInt64(value);
+      } else if (name.Equals(INFO_KEYSPACE_HITS_FIELD)) {
+        counters->keyspace_hits = ToUInt64(value);
+      } else if (name.Equals(INFO_KEYSPACE_MISSES_FIELD)) {
+        counters->keyspace_misses = ToUInt64(value);
+      } else if (name.Equals(INFO_EVICTED_KEYS_FIELD)) {
+        counters->evicted_keys = ToUInt64(value);
+      } else if (name.Equals(INFO_MASTER_REPL_OFFSET_FIELD)) {
+        if (counters->is_master) {
+          counters->repl_offset = ToInt64(value);
+        }
+      } else if (name.Equals(INFO_SLAVE_REPL_OFFSET_FIELD)) {
+        counters->repl_offset = ToInt64(value);
+      } else if (name.StartsWith(INFO_SLAVE_FIELD_PREFIX) && name.size > strlen(INFO_SLAVE_FIELD_PREFIX) &&
+                 isdigit(static_cast<unsigned char>(name.data[strlen(INFO_SLAVE_FIELD_PREFIX)]))) {
+        ReplicaOffset replica;
+        if (ParseReplicaLine(value, &replica)) {
+          counters->replicas.push_back(replica);
+        }
+      }
+    }
+    pos = line_end + 1;
+  }
+
+  return has_role;
+}
+
+NodeStats::NodeStats()
+    : name(),
+      error(),
+      is_master(true),
+      ops_per_sec(0),
+      reads_per_sec(0),
+      hit_ratio(-1),
+      evictions_per_sec(0),
+      used_memory(0),
+      maxmemory(0),
+      connected_clients(0),
+      repl_lag_bytes(-1) {}
+
+ClusterStats::ClusterStats() : sample_msec(0), nodes(), totals() {}
+
+InfoSamplerOptions::InfoSamplerOptions()
+    : interval_msec(kDefaultIntervalMsec),
+      max_connections(kDefaultMaxConnections),
+      io_timeout_msec(kDefaultIoTimeoutMsec) {}
+
+InfoSampler::InfoSampler(const std::vector<InfoSamplerNode>& nodes, const InfoSamplerOptions& options)
+    : nodes_(nodes),
+      options_(options),
+      stopped_(false),
+      states_(nodes.size()),
+      workers_(std::min(std::max<size_t>(options.max_connections, 1), std::max<size_t>(nodes.size(), 1))),
+      round_mutex_(),
+      round_cond_(),
+      round_(0),
+      busy_workers_(0) {
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    states_[i].has_counters = false;
+    states_[i].counters_msec = 0;
+    states_[i].stats.name = nodes_[i].name;
+  }
+}
+
+InfoSampler::~InfoSampler() {}
+
+void InfoSampler::Run(cluster_stats_callback_t callback) {
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    threads.push_back(std::thread(&InfoSampler::WorkerRoutine, this, i));
+  }
+
+  while (!stopped_) {
+    const common::time64_t round_start = common::time::current_utc_mstime();
+    SampleRound();
+    if (stopped_ || (callback && !callback(MakeStats()))) {
+      break;
+    }
+
+    // sleep in small steps, Stop does not wait whole interval
+    const common::time64_t next_round = round_start + options_.interval_msec;
+    for (common::time64_t now = common::time::current_utc_mstime(); now < next_round && !stopped_;
+         now = common::time::current_utc_mstime()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(std::min(kStopCheckMsec, next_round - now)));
+    }
+  }
+
+  Stop();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (Worker& worker : workers_) {
+    worker.connection.reset();
+  }
+}
+
+void InfoSampler::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(round_mutex_);
+    stopped_ = true;
+  }
+  round_cond_.notify_all();
+}
+
+void InfoSampler::WorkerRoutine(size_t index) {
+  Worker* worker = &workers_[index];
+  uint64_t done_round = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(round_mutex_);
+      round_cond_.wait(lock, [this, done_round]() { return stopped_ || round_ != done_round; });
+      if (stopped_) {
+        return;
+      }
+      done_round = round_;
+    }
+
+    for (size_t i = index; i < nodes_.size() && !stopped_; i += workers_.size()) {
+      SampleNode(worker, i);
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(round_mutex_);
+      busy_workers_--;
+    }
+    round_cond_.notify_all();
+  }
+}
+
+void InfoSampler::SampleRound() {
+  {
+    std::lock_guard<std::mutex> lock(round_mutex_);
+    busy_workers_ = workers_.size();
+    round_++;
+  }
+  round_cond_.notify_all();
+
+  std::unique_lock<std::mutex> lock(round_mutex_);
+  round_cond_.wait(lock, [this]() { return stopped_ || busy_workers_ == 0; });
+}
+
+void InfoSampler::SampleNode(Worker* worker, size_t index) {
+  const InfoSamplerNode& node = nodes_[index];
+  NodeState& state = states_[index];
+  if (worker->connection && worker->node != index) {
+    worker->connection.reset();  // socket budget is per worker, not per node
+  }
+
+  if (!worker->connection) {
+    std::unique_ptr<RespConnection> connection(new RespConnection(node.host, node.ssh_info));
+    connection->SetTimeout(options_.io_timeout_msec);
+    common::Error err = connection->Connect(node.password);
+    if (err) {
+      state.stats.error = err->GetDescription();
+      state.has_counters = false;
+      return;
+    }
+    worker->connection = std::move(connection);
+    worker->node = index;
+  }
+
+  RespReply reply;
+  common::Error err = worker->connection->SendCommand({REDIS_INFO_COMMAND});
+  if (!err) {
+    err = worker->connection->ReadReply(&reply);
+  }
+  if (err) {
+    worker->connection.reset();  // reconnect on next round
+    state.stats.error = err->GetDescription();
+    state.has_counters = false;
+    return;
+  }
+
+  if (reply.type != RespReply::BULK) {
+    state.stats.error = reply.type == RespReply::ERROR ? reply.str : "Unexpected INFO reply";
+    return;
+  }
+
+  InfoCounters counters;
+  if (!ParseInfoCounters(reply.str, &counters)) {
+    state.stats.error = "Unexpected INFO reply";
+    return;
+  }
+
+  const common::time64_t now = common::time::current_utc_mstime();
+  NodeStats& stats = state.stats;
+  stats.error.clear();
+  stats.is_master = counters.is_master;
+  stats.used_memory = counters.used_memory;
+  stats.maxmemory = counters.maxmemory;
+  stats.connected_clients = counters.connected_clients;
+  if (state.has_counters) {
+    const InfoCounters& prev = state.counters;
+    const common::time64_t msec = now - state.counters_msec;
+    stats.ops_per_sec = PerSecond(prev.total_commands_processed, counters.total_commands_processed, msec);
+    stats.evictions_per_sec = PerSecond(prev.evicted_keys, counters.evicted_keys, msec);
+    const double hits_per_sec = PerSecond(prev.keyspace_hits, counters.keyspace_hits, msec);
+    const double misses_per_sec = PerSecond(prev.keyspace_misses, counters.keyspace_misses, msec);
+    stats.reads_per_sec = hits_per_sec + misses_per_sec;
+    stats.hit_ratio = stats.reads_per_sec > 0 ? hits_per_sec / stats.reads_per_sec : -1;
+  }
+
+  state.counters = counters;
+  state.counters_msec = now;
+  state.has_counters = true;
+}
+
+ClusterStats InfoSampler::MakeStats() const {
+  ClusterStats result;
+  result.sample_msec = common::time::current_utc_mstime();
+  result.nodes.reserve(states_.size());
+  for (const NodeState& state : states_) {
+    result.nodes.push_back(state.stats);
+  }
+
+  // replicas are matched by address which master reports for them
+  for (size_t i = 0; i < states_.size(); ++i) {
+    const NodeState& master = states_[i];
+    if (!master.has_counters || !master.counters.is_master) {
+      continue;
+    }
+
+    for (const ReplicaOffset& replica : master.counters.replicas) {
+      const int64_t lag = std::max<int64_t>(master.counters.repl_offset - replica.offset, 0);
+      result.nodes[i].repl_lag_bytes = std::max(result.nodes[i].repl_lag_bytes, lag);
+      for (size_t j = 0; j < nodes_.size(); ++j) {
+        if (nodes_[j].host == replica.host) {
+          result.nodes[j].repl_lag_bytes = lag;
+        }
+      }
+    }
+  }
+
+  NodeStats& totals = result.totals;
+  double hits_per_sec = 0;
+  for (size_t i = 0; i < states_.size(); ++i) {
+    const NodeStats& stats = result.nodes[i];
+    if (!stats.error.empty()) {
+      continue;
+    }
+
+    totals.ops_per_sec += stats.ops_per_sec;
+    totals.reads_per_sec += stats.reads_per_sec;
+    totals.evictions_per_sec += stats.evictions_per_sec;
+    totals.used_memory += stats.used_memory;
+    totals.maxmemory += stats.maxmemory;
+    totals.connected_clients += stats.connected_clients;
+    totals.repl_lag_bytes = std::max(totals.repl_lag_bytes, stats.repl_lag_bytes);
+    if (stats.hit_ratio >= 0) {
+      hits_per_sec += stats.hit_ratio * stats.reads_per_sec;
+    }
+  }
+  totals.hit_ratio = totals.reads_per_sec > 0 ? hits_per_sec / totals.reads_per_sec : -1;
+  return result;
+}
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,146 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <common/time.h>
+
+#include "proxy/db/redis_compatible/resp_connection.h"
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+struct ReplicaOffset {
+  common::net::HostAndPort host;
+  int64_t offset;
+};
+
+// counters from one INFO reply, only fields used by dashboard
+struct InfoCounters {
+  InfoCounters();
+
+  bool is_master;
+  uint64_t used_memory;
+  uint64_t maxmemory;
+  uint64_t connected_clients;
+  uint64_t total_commands_processed;
+  uint64_t keyspace_hits;
+  uint64_t keyspace_misses;
+  uint64_t evicted_keys;
+  int64_t repl_offset;  // master_repl_offset on master, slave_repl_offset on replica
+  std::vector<ReplicaOffset> replicas;
+};
+
+bool ParseInfoCounters(const std::string& info, InfoCounters* counters);
+
+struct InfoSamplerNode {
+  std::string name;
+  common::net::HostAndPort host;
+  core::SSHInfo ssh_info;
+  std::string password;
+};
+
+struct NodeStats {
+  NodeStats();
+
+  std::string name;
+  std::string error;  // empty when sample is valid
+  bool is_master;
+  double ops_per_sec;
+  double reads_per_sec;  // keyspace hits and misses
+  double hit_ratio;      // 0..1, -1 - no reads between samples
+  double evictions_per_sec;
+  uint64_t used_memory;
+  uint64_t maxmemory;
+  uint64_t connected_clients;
+  int64_t repl_lag_bytes;  // behind master for replicas, worst replica for masters, -1 - unknown
+};
+
+struct ClusterStats {
+  ClusterStats();
+
+  common::time64_t sample_msec;
+  std::vector<NodeStats> nodes;
+  NodeStats totals;  // sums, hit ratio of all reads, worst lag
+};
+
+struct InfoSamplerOptions {
+  InfoSamplerOptions();
+
+  uint32_t interval_msec;
+  size_t max_connections;  // workers, nodes are split between them and each keeps at most one connection
+  int io_timeout_msec;     // connect and INFO round trip, hung node is reported and retried next round
+};
+
+// called on sampler thread after every round, return false to stop
+typedef std::function<bool(const ClusterStats&)> cluster_stats_callback_t;
+
+// Polls INFO of every node on own connections, never through driver of server.
+// Fixed pool of workers lives while Run does, every worker serves same nodes each round, so connection
+// is kept when worker has one node and reopened when it has several; rates come from difference between rounds.
+class InfoSampler {
+ public:
+  InfoSampler(const std::vector<InfoSamplerNode>& nodes, const InfoSamplerOptions& options);
+  ~InfoSampler();
+
+  // blocks until Stop is called or callback refuses to continue
+  void Run(cluster_stats_callback_t callback);
+  void Stop();  // thread safe
+
+ private:
+  struct NodeState {
+    bool has_counters;
+    InfoCounters counters;
+    common::time64_t counters_msec;
+    NodeStats stats;
+  };
+
+  struct Worker {
+    std::unique_ptr<RespConnection> connection;
+    size_t node;  // node of connection
+  };
+
+  void WorkerRoutine(size_t index);
+  void SampleRound();
+  void SampleNode(Worker* worker, size_t index);
+  ClusterStats MakeStats() const;
+
+  const std::vector<InfoSamplerNode> nodes_;
+  const InfoSamplerOptions options_;
+  std::atomic<bool> stopped_;
+  std::vector<NodeState> states_;
+  std::vector<Worker> workers_;
+
+  std::mutex round_mutex_;
+  std::condition_variable round_cond_;
+  uint64_t round_;       // incremented to start round
+  size_t busy_workers_;  // not yet done with current round
+};
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,160 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/db/redis_compatible/key_changes.h"
+
+#include <algorithm>
+#include <random>
+
+#include <common/convert2string.h>
+#include <common/time.h>
+
+#define REDIS_HMSET_COMMAND "HMSET"
+#define REDIS_HDEL_COMMAND "HDEL"
+#define REDIS_SADD_COMMAND "SADD"
+#define REDIS_SREM_COMMAND "SREM"
+#define REDIS_ZADD_COMMAND "ZADD"
+#define REDIS_ZREM_COMMAND "ZREM"
+#define REDIS_LSET_COMMAND "LSET"
+#define REDIS_LREM_COMMAND "LREM"
+#define REDIS_RPUSH_COMMAND "RPUSH"
+#define REDIS_REMOVED_MARK_PREFIX "fastonosql:removed:"
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+namespace {
+
+typedef std::vector<core::command_buffer_t> args_t;
+
+// keeps single commands small on big edits, the pipeline still makes one round trip
+const size_t kMembersPerCommand = 512;
+
+core::command_buffer_t Quote(const KeyChangeSet::member_t& member) {
+  return core::ReadableString(member).GetForCommandLine();
+}
+
+// unique per save, so LREM can't meet an element written by somebody else
+core::command_buffer_t MakeRemovedMark() {
+  std::random_device device;
+  const uint64_t salt = (static_cast<uint64_t>(device()) << 32) | device();
+  core::command_buffer_writer_t wr;
+  wr << REDIS_REMOVED_MARK_PREFIX << common::ConvertToCharBytes(common::time::current_utc_mstime()) << ":"
+     << common::ConvertToCharBytes(salt);
+  return Quote(wr.str());
+}
+
+args_t MakeArgs(const KeyChangeSet::members_t& members) {
+  args_t args;
+  args.reserve(members.size());
+  for (const auto& member : members) {
+    args.push_back(Quote(member));
+  }
+  return args;
+}
+
+args_t MakePairArgs(const KeyChangeSet::pairs_t& pairs) {
+  args_t args;
+  args.reserve(pairs.size());
+  for (const auto& pair : pairs) {
+    core::command_buffer_writer_t wr;
+    wr << Quote(pair.first) << " " << Quote(pair.second);
+    args.push_back(wr.str());
+  }
+  return args;
+}
+
+void AppendBatched(const char* command,
+                   const core::command_buffer_t& key,
+                   const args_t& args,
+                   std::vector<core::command_buffer_t>* cmds) {
+  for (size_t i = 0; i < args.size(); i += kMembersPerCommand) {
+    core::command_buffer_writer_t wr;
+    wr << command << " " << key;
+    const size_t end = std::min(args.size(), i + kMembersPerCommand);
+    for (size_t j = i; j < end; ++j) {
+      wr << " " << args[j];
+    }
+    cmds->push_back(wr.str());
+  }
+}
+
+void AppendListChanges(const core::command_buffer_t& key,
+                       const KeyChangeSet& changes,
+                       std::vector<core::command_buffer_t>* cmds) {
+  // indexes are positions on server before save, so LSET goes before anything shifts them
+  for (const auto& pair : changes.GetSetMembers()) {
+    core::command_buffer_writer_t wr;
+    wr << REDIS_LSET_COMMAND " " << key << " " << pair.first << " " << Quote(pair.second);
+    cmds->push_back(wr.str());
+  }
+
+  // lists have no remove by index, mark elements first and then drop exactly one mark per removed element
+  const KeyChangeSet::members_t removed = changes.GetRemovedMembers();
+  if (!removed.empty()) {
+    const core::command_buffer_t quoted_mark = MakeRemovedMark();
+    for (const auto& index : removed) {
+      core::command_buffer_writer_t wr;
+      wr << REDIS_LSET_COMMAND " " << key << " " << index << " " << quoted_mark;
+      cmds->push_back(wr.str());
+    }
+    for (size_t i = 0; i < removed.size(); ++i) {
+      core::command_buffer_writer_t wr;
+      wr << REDIS_LREM_COMMAND " " << key << " 1 " << quoted_mark;
+      cmds->push_back(wr.str());
+    }
+  }
+
+  AppendBatched(REDIS_RPUSH_COMMAND, key, MakeArgs(changes.GetAddedMembers()), cmds);
+}
+
+}  // namespace
+
+common::Error GetKeyChangesCommands(const events_info::ChangeKeyValueRequest& req,
+                                    std::vector<core::command_buffer_t>* cmds) {
+  if (!cmds) {
+    return common::make_error_inval();
+  }
+
+  const core::nkey_t key_str = req.key.GetKey();
+  const core::command_buffer_t key = key_str.GetForCommandLine();
+  const KeyChangeSet& changes = req.changes;
+  std::vector<core::command_buffer_t> result;
+  if (req.type == common::Value::TYPE_HASH) {
+    AppendBatched(REDIS_HDEL_COMMAND, key, MakeArgs(changes.GetRemovedMembers()), &result);
+    AppendBatched(REDIS_HMSET_COMMAND, key, MakePairArgs(changes.GetSetMembers()), &result);
+  } else if (req.type == common::Value::TYPE_SET) {
+    AppendBatched(REDIS_SREM_COMMAND, key, MakeArgs(changes.GetRemovedMembers()), &result);
+    AppendBatched(REDIS_SADD_COMMAND, key, MakeArgs(changes.GetAddedMembers()), &result);
+  } else if (req.type == common::Value::TYPE_ZSET) {
+    AppendBatched(REDIS_ZREM_COMMAND, key, MakeArgs(changes.GetRemovedMembers()), &result);
+    AppendBatched(REDIS_ZADD_COMMAND, key, MakePairArgs(changes.GetSetMembers()), &result);
+  } else if (req.type == common::Value::TYPE_ARRAY) {
+    AppendListChanges(key, changes, &result);
+  } else {
+    return common::make_error("Changes are not supported for this value type");
+  }
+
+  *cmds = result;
+  return common::Error();
+}
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
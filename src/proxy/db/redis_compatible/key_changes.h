@@ -0,0 +1,37 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include <fastonosql/core/global.h>
+
+#include "proxy/events/events_info.h"
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+// minimal write commands for edited collection members, safe to send as one pipeline
+common::Error GetKeyChangesCommands(const events_info::ChangeKeyValueRequest& req,
+                                    std::vector<core::command_buffer_t>* cmds) WARN_UNUSED_RESULT;
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,284 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/db/redis_compatible/key_page.h"
+
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <common/convert2string.h>
+
+#define REDIS_HSCAN_COMMAND "HSCAN"
+#define REDIS_SSCAN_COMMAND "SSCAN"
+#define REDIS_ZSCAN_COMMAND "ZSCAN"
+#define REDIS_LRANGE_COMMAND "LRANGE"
+#define REDIS_COUNT_ARG "COUNT"
+#define REDIS_XRANGE_COMMAND "XRANGE"
+#define REDIS_XREVRANGE_COMMAND "XREVRANGE"
+#define REDIS_STREAM_FIRST_ID "-"
+#define REDIS_STREAM_LAST_ID "+"
+#define REDIS_STREAM_ID_SEPARATOR '-'
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+namespace {
+
+common::Error ParseScanReply(common::ArrayValue* arm, core::cursor_t* cursor_out, common::ArrayValue** items) {
+  if (arm->GetSize() != 2) {
+    return common::make_error("Invalid scan reply");
+  }
+
+  if (!arm->GetUInteger(0, cursor_out)) {
+    return common::make_error("Invalid scan cursor");
+  }
+
+  if (!arm->GetList(1, items)) {
+    return common::make_error("Invalid scan items");
+  }
+
+  return common::Error();
+}
+
+// stream ids are <ms>-<seq>, neighbour ids are used as exclusive bounds
+bool ParseStreamId(const core::StreamValue::stream_id& sid, uint64_t* ms, uint64_t* seq) {
+  const std::string sid_str = common::ConvertToString(sid);
+  const size_t pos = sid_str.find(REDIS_STREAM_ID_SEPARATOR);
+  if (pos == std::string::npos) {
+    return false;
+  }
+
+  return common::ConvertFromString(sid_str.substr(0, pos), ms) &&
+         common::ConvertFromString(sid_str.substr(pos + 1), seq);
+}
+
+core::StreamValue::stream_id MakeStreamId(uint64_t ms, uint64_t seq) {
+  core::command_buffer_writer_t wr;
+  wr << common::ConvertToCharBytes(ms) << "-" << common::ConvertToCharBytes(seq);
+  return wr.str();
+}
+
+bool GetNextStreamId(const core::StreamValue::stream_id& sid, bool reverse, core::StreamValue::stream_id* next) {
+  uint64_t ms;
+  uint64_t seq;
+  if (!ParseStreamId(sid, &ms, &seq)) {
+    return false;
+  }
+
+  static const uint64_t max_part = std::numeric_limits<uint64_t>::max();
+  if (!reverse) {
+    if (seq != max_part) {
+      *next = MakeStreamId(ms, seq + 1);
+      return true;
+    }
+    if (ms != max_part) {
+      *next = MakeStreamId(ms + 1, 0);
+      return true;
+    }
+    return false;
+  }
+
+  if (seq != 0) {
+    *next = MakeStreamId(ms, seq - 1);
+    return true;
+  }
+  if (ms != 0) {
+    *next = MakeStreamId(ms - 1, max_part);
+    return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+common::Error GetKeyPageCommand(const events_info::LoadKeyPageRequest& req, core::command_buffer_t* cmd) {
+  if (!cmd || req.count == 0) {
+    return common::make_error_inval();
+  }
+
+  const core::nkey_t key_str = req.key.GetKey();
+  core::command_buffer_writer_t wr;
+  if (req.type == common::Value::TYPE_ARRAY) {
+    const core::cursor_t stop = req.cursor_in + req.count - 1;
+    wr << REDIS_LRANGE_COMMAND " " << key_str.GetForCommandLine() << " " << common::ConvertToCharBytes(req.cursor_in)
+       << " " << common::ConvertToCharBytes(stop);
+    *cmd = wr.str();
+    return common::Error();
+  }
+
+  if (req.type == common::Value::TYPE_HASH) {
+    wr << REDIS_HSCAN_COMMAND " ";
+  } else if (req.type == common::Value::TYPE_SET) {
+    wr << REDIS_SSCAN_COMMAND " ";
+  } else if (req.type == common::Value::TYPE_ZSET) {
+    wr << REDIS_ZSCAN_COMMAND " ";
+  } else {
+    return common::make_error("Paged loading is not supported for this type");
+  }
+
+  wr << key_str.GetForCommandLine() << " " << common::ConvertToCharBytes(req.cursor_in) << " " REDIS_COUNT_ARG " "
+     << common::ConvertToCharBytes(req.count);
+  *cmd = wr.str();
+  return common::Error();
+}
+
+common::Error ParseKeyPageReply(core::FastoObject* reply, events_info::LoadKeyPageResponse* res) {
+  if (!reply || !res) {
+    return common::make_error_inval();
+  }
+
+  core::FastoObject::childs_t rchildrens = reply->GetChildrens();
+  if (rchildrens.size() != 1) {
+    return common::make_error("Invalid key page reply");
+  }
+
+  auto array_value = rchildrens[0]->GetValue();
+  common::ArrayValue* arm = nullptr;
+  if (!array_value || !array_value->GetAsList(&arm)) {
+    return common::make_error("Invalid key page reply");
+  }
+
+  if (res->type == common::Value::TYPE_ARRAY) {
+    common::ArrayValue* page = common::Value::CreateArrayValue();
+    for (size_t i = 0; i < arm->GetSize(); ++i) {
+      common::Value::string_t item;
+      if (arm->GetString(i, &item)) {
+        page->AppendString(item);
+      }
+    }
+    res->page = core::NValue(page);
+    res->cursor_out = arm->GetSize() < res->count ? 0 : res->cursor_in + res->count;
+    return common::Error();
+  }
+
+  common::ArrayValue* items = nullptr;
+  common::Error err = ParseScanReply(arm, &res->cursor_out, &items);
+  if (err) {
+    return err;
+  }
+
+  if (res->type == common::Value::TYPE_SET) {
+    common::SetValue* page = common::Value::CreateSetValue();
+    for (size_t i = 0; i < items->GetSize(); ++i) {
+      common::Value::string_t member;
+      if (items->GetString(i, &member)) {
+        page->Insert(member);
+      }
+    }
+    res->page = core::NValue(page);
+    return common::Error();
+  }
+
+  if (items->GetSize() % 2 != 0) {
+    return common::make_error("Invalid key page reply");
+  }
+
+  if (res->type == common::Value::TYPE_HASH) {
+    common::HashValue* page = common::Value::CreateHashValue();
+    for (size_t i = 0; i < items->GetSize(); i += 2) {
+      common::Value::string_t field;
+      common::Value::string_t value;
+      if (items->GetString(i, &field) && items->GetString(i + 1, &value)) {
+        page->Insert(field, common::Value::CreateStringValue(value));
+      }
+    }
+    res->page = core::NValue(page);
+    return common::Error();
+  }
+
+  // ZSCAN replies with member, score pairs
+  common::ZSetValue* page = common::Value::CreateZSetValue();
+  for (size_t i = 0; i < items->GetSize(); i += 2) {
+    common::Value::string_t member;
+    common::Value::string_t score;
+    if (items->GetString(i, &member) && items->GetString(i + 1, &score)) {
+      page->Insert(score, member);
+    }
+  }
+  res->page = core::NValue(page);
+  return common::Error();
+}
+
+common::Error GetStreamPageCommand(const events_info::LoadStreamPageRequest& req, core::command_buffer_t* cmd) {
+  if (!cmd || req.count == 0 || req.start_id.empty()) {
+    return common::make_error_inval();
+  }
+
+  const core::nkey_t key_str = req.key.GetKey();
+  core::command_buffer_writer_t wr;
+  if (req.reverse) {
+    wr << REDIS_XREVRANGE_COMMAND " " << key_str.GetForCommandLine() << " " << req.start_id
+       << " " REDIS_STREAM_FIRST_ID;
+  } else {
+    wr << REDIS_XRANGE_COMMAND " " << key_str.GetForCommandLine() << " " << req.start_id << " " REDIS_STREAM_LAST_ID;
+  }
+  wr << " " REDIS_COUNT_ARG " " << common::ConvertToCharBytes(req.count);
+  *cmd = wr.str();
+  return common::Error();
+}
+
+common::Error ParseStreamPageReply(core::FastoObject* reply, events_info::LoadStreamPageResponse* res) {
+  if (!reply || !res) {
+    return common::make_error_inval();
+  }
+
+  core::FastoObject::childs_t rchildrens = reply->GetChildrens();
+  if (rchildrens.size() != 1) {
+    return common::make_error("Invalid stream page reply");
+  }
+
+  auto array_value = rchildrens[0]->GetValue();
+  common::ArrayValue* arm = nullptr;
+  if (!array_value || !array_value->GetAsList(&arm)) {
+    return common::make_error("Invalid stream page reply");
+  }
+
+  for (size_t i = 0; i < arm->GetSize(); ++i) {
+    common::ArrayValue* entry = nullptr;
+    common::ArrayValue* fields = nullptr;
+    core::StreamValue::stream_id sid;
+    if (!arm->GetList(i, &entry) || !entry->GetString(0, &sid) || !entry->GetList(1, &fields)) {
+      return common::make_error("Invalid stream entry");
+    }
+
+    std::vector<core::StreamValue::Entry> entries;
+    for (size_t j = 0; j + 1 < fields->GetSize(); j += 2) {
+      common::Value::string_t name;
+      common::Value::string_t value;
+      if (fields->GetString(j, &name) && fields->GetString(j + 1, &value)) {
+        entries.push_back(core::StreamValue::Entry{name, value});
+      }
+    }
+    res->streams.push_back(core::StreamValue::Stream{sid, entries});
+  }
+
+  res->next_id = core::StreamValue::stream_id();
+  if (!res->streams.empty() && res->streams.size() >= res->count) {
+    core::StreamValue::stream_id next;
+    if (GetNextStreamId(res->streams.back().sid, res->reverse, &next)) {
+      res->next_id = next;
+    }
+  }
+  return common::Error();
+}
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
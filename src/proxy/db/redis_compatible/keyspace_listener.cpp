@@ -0,0 +1,300 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "proxy/db/redis_compatible/keyspace_listener.h"
+
+#include <map>
+#include <utility>
+
+#include <QTimerEvent>
+
+#include <common/convert2string.h>
+
+#include <fastonosql/core/value.h>
+
+#define REDIS_CONFIG_COMMAND "CONFIG"
+#define REDIS_GET_SUBCOMMAND "GET"
+#define REDIS_NOTIFY_CONFIG "notify-keyspace-events"
+#define REDIS_TYPE_COMMAND "TYPE"
+#define REDIS_TTL_COMMAND "TTL"
+
+#define REDIS_NONE_TYPE "none"
+#define REDIS_NO_KEY_TTL -2
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+namespace {
+
+const size_t kMaxDrainMessages = 65536;
+
+bool IsRemovalEvent(const std::string& event) {
+  return event == "del" || event == "expired" || event == "evicted" || event == "rename_from" ||
+         event == "move_from";
+}
+
+bool ConvertType(const std::string& type, common::Value::Type* ctype) {
+  static const std::map<std::string, common::Value::Type> types = {
+      {"string", common::Value::TYPE_STRING}, {"list", common::Value::TYPE_ARRAY},
+      {"set", common::Value::TYPE_SET},       {"zset", common::Value::TYPE_ZSET},
+      {"hash", common::Value::TYPE_HASH},     {"stream", core::StreamValue::TYPE_STREAM}};
+  const auto it = types.find(type);
+  if (it == types.end()) {
+    return false;
+  }
+
+  *ctype = it->second;
+  return true;
+}
+
+// K plus at least one event class, otherwise server publishes nothing for keyspace channels
+common::Error CheckNotifyConfig(const std::string& flags) {
+  if (flags.find('K') == std::string::npos) {
+    return common::make_error("Keyspace notifications disabled on server (notify-keyspace-events has no 'K' flag)");
+  }
+
+  if (flags.find_first_not_of("KE") == std::string::npos) {
+    return common::make_error("Keyspace notifications have no event classes (notify-keyspace-events: " + flags + ")");
+  }
+  return common::Error();
+}
+
+}  // namespace
+
+KeyspaceChanges::KeyspaceChanges() : updated(), removed(), dropped(0) {}
+
+KeyspaceListener::KeyspaceListener(const common::net::HostAndPort& host,
+                                   const core::SSHInfo& ssh_info,
+                                   const std::string& password,
+                                   const core::db_name_t& db_name,
+                                   QObject* parent)
+    : QObject(parent),
+      password_(password),
+      prefix_("__keyspace@" + db_name + "__:"),
+      subscriber_(host, ssh_info, password),
+      connection_(host, ssh_info),
+      receiver_(),
+      stopped_(false),
+      subscribed_(false),
+      receive_finished_(false),
+      receive_error_(),
+      pending_(),
+      dropped_(0),
+      pending_dropped_(0),
+      timer_id_(0) {
+  qRegisterMetaType<common::Error>("common::Error");
+  qRegisterMetaType<KeyspaceChanges>("fastonosql::proxy::redis_compatible::KeyspaceChanges");
+}
+
+KeyspaceListener::~KeyspaceListener() {
+  Stop();
+  if (receiver_.joinable()) {
+    receiver_.join();
+  }
+}
+
+void KeyspaceListener::Stop() {
+  stopped_ = true;
+  if (subscribed_) {
+    common::Error err = subscriber_.Stop();
+    UNUSED(err);
+  }
+}
+
+void KeyspaceListener::Routine() {
+  if (stopped_) {
+    emit Finished(common::Error());
+    return;
+  }
+
+  common::Error err = Prepare();
+  if (err) {
+    emit Finished(err);
+    return;
+  }
+
+  // Stop may have missed subscription which was sent after its check
+  subscribed_ = true;
+  if (stopped_) {
+    err = subscriber_.Stop();
+    UNUSED(err);
+  }
+
+  receiver_ = std::thread([this]() {
+    receive_error_ = subscriber_.Run();
+    receive_finished_ = true;
+  });
+  timer_id_ = startTimer(drain_interval_msec);
+  emit Started();
+}
+
+void KeyspaceListener::timerEvent(QTimerEvent* event) {
+  if (event->timerId() != timer_id_) {
+    QObject::timerEvent(event);
+    return;
+  }
+
+  const bool finished = receive_finished_;  // read before drain, so nothing received is lost
+  common::Error err = Drain();
+  if (!finished && !err) {
+    return;
+  }
+
+  killTimer(timer_id_);
+  timer_id_ = 0;
+  if (err) {
+    Stop();
+  }
+  receiver_.join();
+  emit Finished(err ? err : receive_error_);
+}
+
+common::Error KeyspaceListener::Prepare() {
+  common::Error err = connection_.Connect(password_);
+  if (err) {
+    return err;
+  }
+
+  err = connection_.SendCommand({REDIS_CONFIG_COMMAND, REDIS_GET_SUBCOMMAND, REDIS_NOTIFY_CONFIG});
+  if (err) {
+    return err;
+  }
+
+  RespReply reply;
+  err = connection_.ReadReply(&reply);
+  if (err) {
+    return err;
+  }
+
+  // CONFIG may be renamed or forbidden (managed services), then just listen
+  if (reply.type == RespReply::ARRAY && reply.elements.size() == 2) {
+    err = CheckNotifyConfig(reply.elements[1].str);
+    if (err) {
+      return err;
+    }
+  }
+
+  err = subscriber_.Connect();
+  if (err) {
+    return err;
+  }
+
+  return subscriber_.PSubscribe({prefix_ + "*"});
+}
+
+common::Error KeyspaceListener::Drain() {
+  std::vector<PubSubMessage> messages;
+  subscriber_.PopMessages(kMaxDrainMessages, &messages);
+  KeyspaceChanges changes;
+  for (const PubSubMessage& message : messages) {
+    if (message.channel.compare(0, prefix_.size(), prefix_) != 0) {
+      continue;
+    }
+
+    // only last event matters, key is resolved once per drain
+    const std::string key = message.channel.substr(prefix_.size());
+    const auto it = pending_.find(key);
+    if (it != pending_.end()) {
+      it->second = IsRemovalEvent(message.payload);
+    } else if (pending_.size() < max_pending_keys) {
+      pending_.insert(std::make_pair(key, IsRemovalEvent(message.payload)));
+    } else {
+      pending_dropped_++;  // resolving falls behind write rate, keep memory bounded
+    }
+  }
+
+  const uint64_t dropped = subscriber_.GetDroppedCount();
+  changes.dropped = dropped - dropped_ + pending_dropped_;
+  dropped_ = dropped;
+  pending_dropped_ = 0;
+
+  std::vector<std::string> keys;
+  for (auto it = pending_.begin(); it != pending_.end();) {
+    if (it->second) {
+      changes.removed.push_back(core::NKey(core::nkey_t(common::ConvertToCharBytes(it->first))));
+    } else if (keys.size() < max_resolved_keys) {
+      keys.push_back(it->first);
+    } else {
+      ++it;  // resolved on next drain
+      continue;
+    }
+    it = pending_.erase(it);
+  }
+
+  common::Error err = Resolve(keys, &changes);
+  if (err) {
+    return err;
+  }
+
+  if (changes.updated.empty() && changes.removed.empty() && changes.dropped == 0) {
+    return common::Error();
+  }
+
+  emit KeysChanged(changes);
+  return common::Error();
+}
+
+common::Error KeyspaceListener::Resolve(const std::vector<std::string>& keys, KeyspaceChanges* changes) {
+  for (const std::string& key : keys) {
+    common::Error err = connection_.SendCommand({REDIS_TYPE_COMMAND, key});
+    if (err) {
+      return err;
+    }
+
+    err = connection_.SendCommand({REDIS_TTL_COMMAND, key});
+    if (err) {
+      return err;
+    }
+  }
+
+  for (const std::string& key : keys) {
+    RespReply type;
+    common::Error err = connection_.ReadReply(&type);
+    if (err) {
+      return err;
+    }
+
+    RespReply ttl;
+    err = connection_.ReadReply(&ttl);
+    if (err) {
+      return err;
+    }
+
+    core::NKey nkey(core::nkey_t(common::ConvertToCharBytes(key)));
+    // key may be gone already, then it is a removal
+    if (type.str == REDIS_NONE_TYPE || (ttl.type == RespReply::INTEGER && ttl.integer == REDIS_NO_KEY_TTL)) {
+      changes->removed.push_back(nkey);
+      continue;
+    }
+
+    common::Value::Type ctype;
+    if (type.type != RespReply::STATUS || !ConvertType(type.str, &ctype)) {
+      continue;  // module types can't be shown in explorer
+    }
+
+    if (ttl.type == RespReply::INTEGER) {
+      nkey.SetTTL(ttl.integer);
+    }
+    changes->updated.push_back(core::NDbKValue(nkey, core::NValue(core::CreateEmptyValueFromType(ctype))));
+  }
+  return common::Error();
+}
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
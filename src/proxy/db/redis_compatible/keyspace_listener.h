@@ -0,0 +1,95 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <QObject>
+
+#include <fastonosql/core/db_key.h>
+
+#include "proxy/db/redis_compatible/subscriber.h"
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+struct KeyspaceChanges {
+  KeyspaceChanges();
+
+  std::vector<core::NDbKValue> updated;  // current type (empty value) and ttl of written keys
+  std::vector<core::NKey> removed;
+  uint64_t dropped;  // notifications lost since previous batch
+};
+
+// Follows __keyspace@<db>__ notifications on side connections. Notifications are captured by
+// receive thread, coalesced per key every drain interval, and types/ttls of written keys are
+// resolved in one pipeline, so explorer gets one batch instead of a command per event.
+class KeyspaceListener : public QObject {
+  Q_OBJECT
+
+ public:
+  enum { drain_interval_msec = 500, max_resolved_keys = 500, max_pending_keys = 65536 };
+
+  KeyspaceListener(const common::net::HostAndPort& host,
+                   const core::SSHInfo& ssh_info,
+                   const std::string& password,
+                   const core::db_name_t& db_name,
+                   QObject* parent = Q_NULLPTR);
+  ~KeyspaceListener() override;
+
+  void Stop();  // thread safe
+
+ Q_SIGNALS:
+  void Started();
+  void KeysChanged(const fastonosql::proxy::redis_compatible::KeyspaceChanges& changes);
+  void Finished(common::Error err);
+
+ public Q_SLOTS:
+  void Routine();
+
+ protected:
+  void timerEvent(QTimerEvent* event) override;
+
+ private:
+  common::Error Prepare() WARN_UNUSED_RESULT;
+  common::Error Resolve(const std::vector<std::string>& keys, KeyspaceChanges* changes) WARN_UNUSED_RESULT;
+  common::Error Drain() WARN_UNUSED_RESULT;
+
+  const std::string password_;
+  const std::string prefix_;  // __keyspace@<db>__:
+  Subscriber subscriber_;
+  RespConnection connection_;  // subscribed connection can't run lookups
+  std::thread receiver_;
+  std::atomic<bool> stopped_;
+  std::atomic<bool> subscribed_;
+  std::atomic<bool> receive_finished_;
+  common::Error receive_error_;  // published by receive_finished_
+  std::map<std::string, bool> pending_;  // key -> removed, waiting for resolve, at most max_pending_keys
+  uint64_t dropped_;
+  uint64_t pending_dropped_;  // new keys not queued because pending_ was full, reported with next batch
+  int timer_id_;
+};
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,631 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/db/redis_compatible/logical_dump.h"
+
+#include <algorithm>
+#include <cctype>
+#include <thread>
+
+#include <QByteArray>
+#include <QFile>
+#include <QList>
+
+#include <common/convert2string.h>
+#include <common/time.h>
+
+#define DUMP_FILE_MAGIC "FNDUMP01"
+#define DUMP_INDEX_EXTENSION ".index"
+#define DUMP_RESTORED_EXTENSION ".restored"
+
+#define REDIS_DBSIZE_COMMAND "DBSIZE"
+#define REDIS_DUMP_COMMAND "DUMP"
+#define REDIS_PTTL_COMMAND "PTTL"
+#define REDIS_RESTORE_COMMAND "RESTORE"
+#define REDIS_REPLACE_ARG "REPLACE"
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+namespace {
+
+const size_t kKeysPerChunk = 1000;
+const core::keys_limit_t kScanCount = 500;
+
+struct DumpIndexEntry {
+  DumpIndexEntry() : offset(0), size(0), keys_count(0), cursor(0) {}
+
+  qint64 offset;  // of compressed block in dump file
+  qint64 size;
+  size_t keys_count;
+  core::cursor_t cursor;  // SCAN cursor after chunk, 0 for last one
+};
+
+struct DumpChunk {
+  DumpChunk() : keys(), cursor(0), data(), keys_count(0), err() {}
+
+  std::vector<common::Value::string_t> keys;
+  core::cursor_t cursor;
+  QByteArray data;  // compressed records
+  size_t keys_count;
+  common::Error err;
+};
+
+QString GetIndexPath(const std::string& path) {
+  return QString::fromStdString(path + DUMP_INDEX_EXTENSION);
+}
+
+QString GetRestoredPath(const std::string& path, const std::string& target) {
+  std::string suffix = target;
+  std::replace_if(suffix.begin(), suffix.end(), [](char ch) { return !isalnum(static_cast<unsigned char>(ch)); },
+                  '_');
+  return QString::fromStdString(path + DUMP_RESTORED_EXTENSION "." + suffix);
+}
+
+common::Error MakeFileError(const QFile& file) {
+  return common::make_error(file.fileName().toStdString() + ": " + file.errorString().toStdString());
+}
+
+void AppendUInt32(uint32_t value, QByteArray* out) {
+  for (int i = 0; i < 4; ++i) {
+    out->append(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+void AppendInt64(int64_t value, QByteArray* out) {
+  const uint64_t uvalue = static_cast<uint64_t>(value);
+  for (int i = 0; i < 8; ++i) {
+    out->append(static_cast<char>((uvalue >> (8 * i)) & 0xff));
+  }
+}
+
+void AppendBytes(const std::string& data, QByteArray* out) {
+  AppendUInt32(static_cast<uint32_t>(data.size()), out);
+  out->append(data.data(), static_cast<int>(data.size()));
+}
+
+class RecordsReader {
+ public:
+  explicit RecordsReader(const QByteArray& data) : data_(data), pos_(0) {}
+
+  bool AtEnd() const { return pos_ >= data_.size(); }
+
+  bool ReadUInt32(uint32_t* value) {
+    if (data_.size() - pos_ < 4) {
+      return false;
+    }
+
+    uint32_t result = 0;
+    for (int i = 0; i < 4; ++i) {
+      result |= static_cast<uint32_t>(static_cast<unsigned char>(data_[pos_ + i])) << (8 * i);
+    }
+    pos_ += 4;
+    *value = result;
+    return true;
+  }
+
+  bool ReadInt64(int64_t* value) {
+    if (data_.size() - pos_ < 8) {
+      return false;
+    }
+
+    uint64_t result = 0;
+    for (int i = 0; i < 8; ++i) {
+      result |= static_cast<uint64_t>(static_cast<unsigned char>(data_[pos_ + i])) << (8 * i);
+    }
+    pos_ += 8;
+    *value = static_cast<int64_t>(result);
+    return true;
+  }
+
+  bool ReadBytes(std::string* out) {
+    uint32_t size;
+    if (!ReadUInt32(&size) || static_cast<uint32_t>(data_.size() - pos_) < size) {
+      return false;
+    }
+
+    *out = std::string(data_.constData() + pos_, size);
+    pos_ += size;
+    return true;
+  }
+
+ private:
+  const QByteArray& data_;
+  int pos_;
+};
+
+bool GetSingleReply(core::FastoObjectCommandIPtr cmd, common::Value** value) {
+  core::FastoObject::childs_t childrens = cmd->GetChildrens();
+  if (childrens.size() != 1) {
+    return false;
+  }
+
+  common::Value* result = childrens[0]->GetValue().get();
+  if (!result) {
+    return false;
+  }
+
+  *value = result;
+  return true;
+}
+
+common::Error ReadIndex(const std::string& path, const core::pattern_t& pattern, std::vector<DumpIndexEntry>* entries) {
+  QFile index(GetIndexPath(path));
+  if (!index.open(QIODevice::ReadOnly)) {
+    return MakeFileError(index);
+  }
+
+  const QByteArray magic = index.readLine().trimmed();
+  const QByteArray saved_pattern = index.readLine();
+  if (magic != DUMP_FILE_MAGIC || !saved_pattern.endsWith('\n')) {
+    return common::make_error("Invalid dump index");
+  }
+
+  if (!pattern.empty() && saved_pattern.left(saved_pattern.size() - 1).toStdString() != pattern) {
+    return common::make_error("Dump was started with another pattern");
+  }
+
+  std::vector<DumpIndexEntry> result;
+  while (!index.atEnd()) {
+    const QByteArray line = index.readLine();
+    if (!line.endsWith('\n')) {
+      break;  // torn write, chunk is not completed
+    }
+
+    const QList<QByteArray> parts = line.trimmed().split(' ');
+    if (parts.size() != 4) {
+      return common::make_error("Invalid dump index");
+    }
+
+    DumpIndexEntry entry;
+    bool offset_ok, size_ok, keys_ok, cursor_ok;
+    entry.offset = parts[0].toLongLong(&offset_ok);
+    entry.size = parts[1].toLongLong(&size_ok);
+    entry.keys_count = parts[2].toULongLong(&keys_ok);
+    entry.cursor = parts[3].toULongLong(&cursor_ok);
+    if (!offset_ok || !size_ok || !keys_ok || !cursor_ok) {
+      return common::make_error("Invalid dump index");
+    }
+    result.push_back(entry);
+  }
+
+  *entries = result;
+  return common::Error();
+}
+
+common::Error WriteIndexHeader(QFile* index, const core::pattern_t& pattern) {
+  const QByteArray header = DUMP_FILE_MAGIC "\n" + QByteArray::fromStdString(pattern) + "\n";
+  if (index->write(header) != header.size() || !index->flush()) {
+    return MakeFileError(*index);
+  }
+  return common::Error();
+}
+
+common::Error AppendIndexEntry(QFile* index, const DumpIndexEntry& entry) {
+  const std::string line = common::ConvertToString(entry.offset) + " " + common::ConvertToString(entry.size) + " " +
+                           common::ConvertToString(entry.keys_count) + " " + common::ConvertToString(entry.cursor) +
+                           "\n";
+  if (index->write(line.data(), line.size()) != static_cast<qint64>(line.size()) || !index->flush()) {
+    return MakeFileError(*index);
+  }
+  return common::Error();
+}
+
+common::Error OpenConnections(pipeline_connection_factory_t factory,
+                              size_t count,
+                              std::vector<pipeline_connection_t>* connections) {
+  std::vector<pipeline_connection_t> result;
+  for (size_t i = 0; i < std::max<size_t>(count, 1); ++i) {
+    pipeline_connection_t connection;
+    common::Error err = factory(&connection);
+    if (err) {
+      return err;
+    }
+    result.push_back(connection);
+  }
+
+  *connections = result;
+  return common::Error();
+}
+
+common::Error GetDatabaseSize(pipeline_connection_t connection, core::keys_limit_t* size) {
+  std::vector<core::FastoObjectCommandIPtr> executed;
+  common::Error err = connection->ExecutePipeline({GEN_CMD_STRING(REDIS_DBSIZE_COMMAND)}, &executed);
+  if (err) {
+    return err;
+  }
+
+  common::Value* value = nullptr;
+  long long result = 0;
+  if (!GetSingleReply(executed[0], &value) || !value->GetAsLongLongInteger(&result)) {
+    return common::make_error("Invalid " REDIS_DBSIZE_COMMAND " reply");
+  }
+
+  *size = static_cast<core::keys_limit_t>(result);
+  return common::Error();
+}
+
+// chunk boundary is always SCAN reply boundary so its cursor is valid to resume from
+common::Error ScanChunk(pipeline_connection_t connection,
+                        const core::pattern_t& pattern,
+                        core::cursor_t cursor,
+                        DumpChunk* chunk) {
+  do {
+    std::vector<core::FastoObjectCommandIPtr> executed;
+    common::Error err = connection->ExecutePipeline({core::GetKeysPattern(cursor, pattern, kScanCount)}, &executed);
+    if (err) {
+      return err;
+    }
+
+    common::Value* value = nullptr;
+    common::ArrayValue* arm = nullptr;
+    common::ArrayValue* keys = nullptr;
+    if (!GetSingleReply(executed[0], &value) || !value->GetAsList(&arm) || arm->GetSize() != 2 ||
+        !arm->GetUInteger(0, &cursor) || !arm->GetList(1, &keys)) {
+      return common::make_error("Invalid scan reply");
+    }
+
+    for (size_t i = 0; i < keys->GetSize(); ++i) {
+      common::Value::string_t key;
+      if (keys->GetString(i, &key)) {
+        chunk->keys.push_back(key);
+      }
+    }
+  } while (cursor != 0 && chunk->keys.size() < kKeysPerChunk);
+
+  chunk->cursor = cursor;
+  return common::Error();
+}
+
+// DUMP and PTTL in one pipeline, expire is stored as absolute utc msec
+void FetchChunk(pipeline_connection_t connection, DumpChunk* chunk) {
+  std::vector<core::command_buffer_t> commands;
+  commands.reserve(chunk->keys.size() * 2);
+  for (const auto& key : chunk->keys) {
+    const core::command_buffer_t key_str = core::ReadableString(key).GetForCommandLine();
+    core::command_buffer_writer_t wr_dump;
+    wr_dump << REDIS_DUMP_COMMAND " " << key_str;
+    commands.push_back(wr_dump.str());
+
+    core::command_buffer_writer_t wr_ttl;
+    wr_ttl << REDIS_PTTL_COMMAND " " << key_str;
+    commands.push_back(wr_ttl.str());
+  }
+
+  std::vector<core::FastoObjectCommandIPtr> executed;
+  if (!commands.empty()) {
+    chunk->err = connection->ExecutePipeline(commands, &executed);
+    if (chunk->err) {
+      return;
+    }
+  }
+
+  const common::time64_t now = common::time::current_utc_mstime();
+  QByteArray records;
+  for (size_t i = 0; i < chunk->keys.size(); ++i) {
+    common::Value* payload_value = nullptr;
+    common::Value* ttl_value = nullptr;
+    common::Value::string_t payload;
+    long long ttl = 0;
+    if (!GetSingleReply(executed[i * 2], &payload_value) || !payload_value->GetAsString(&payload) ||
+        !GetSingleReply(executed[i * 2 + 1], &ttl_value) || !ttl_value->GetAsLongLongInteger(&ttl)) {
+      continue;  // removed while dumping
+    }
+
+    if (ttl == -2) {
+      continue;
+    }
+
+    AppendBytes(chunk->keys[i].as_string(), &records);
+    AppendInt64(ttl < 0 ? 0 : now + ttl, &records);
+    AppendBytes(payload.as_string(), &records);
+    chunk->keys_count++;
+  }
+
+  chunk->data = qCompress(records);
+}
+
+void RestoreChunk(pipeline_connection_t connection, const QByteArray& data, DumpChunk* chunk) {
+  const QByteArray records = qUncompress(data);
+  if (records.isEmpty() && !data.isEmpty()) {
+    chunk->err = common::make_error("Corrupted dump chunk");
+    return;
+  }
+
+  const common::time64_t now = common::time::current_utc_mstime();
+  std::vector<core::command_buffer_t> commands;
+  RecordsReader reader(records);
+  while (!reader.AtEnd()) {
+    std::string key;
+    int64_t expire_at;
+    std::string payload;
+    if (!reader.ReadBytes(&key) || !reader.ReadInt64(&expire_at) || !reader.ReadBytes(&payload)) {
+      chunk->err = common::make_error("Corrupted dump chunk");
+      return;
+    }
+
+    if (expire_at != 0 && expire_at <= now) {
+      continue;  // expired since dump
+    }
+
+    const int64_t ttl = expire_at == 0 ? 0 : expire_at - now;
+    core::command_buffer_writer_t wr;
+    wr << REDIS_RESTORE_COMMAND " " << core::ReadableString(common::ConvertToCharBytes(key)).GetForCommandLine()
+       << " " << common::ConvertToCharBytes(ttl) << " "
+       << core::ReadableString(common::ConvertToCharBytes(payload)).GetForCommandLine() << " " REDIS_REPLACE_ARG;
+    commands.push_back(wr.str());
+  }
+
+  if (commands.empty()) {
+    return;
+  }
+
+  std::vector<core::FastoObjectCommandIPtr> executed;
+  chunk->err = connection->ExecutePipeline(commands, &executed);
+  if (chunk->err) {
+    return;
+  }
+
+  for (const auto& cmd : executed) {
+    core::FastoObject::childs_t childrens = cmd->GetChildrens();
+    if (childrens.size() != 1) {
+      chunk->err = common::make_error("Invalid " REDIS_RESTORE_COMMAND " reply");
+      return;
+    }
+
+    auto value = childrens[0]->GetValue();
+    if (!value || value->GetType() == common::Value::TYPE_ERROR) {
+      chunk->err = common::make_error(REDIS_RESTORE_COMMAND " failed: " + childrens[0]->ToString());
+      return;
+    }
+  }
+  chunk->keys_count = commands.size();
+}
+
+template <typename Func>
+common::Error RunParallel(const std::vector<pipeline_connection_t>& connections,
+                          std::vector<DumpChunk>* chunks,
+                          Func func) {
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < chunks->size(); ++i) {
+    workers.push_back(std::thread(func, connections[i], i));
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  for (const auto& chunk : *chunks) {
+    if (chunk.err) {
+      return chunk.err;
+    }
+  }
+  return common::Error();
+}
+
+int GetPercent(size_t done, size_t total) {
+  if (total == 0) {
+    return 0;
+  }
+  return static_cast<int>(std::min<size_t>(done * 100 / total, 99));
+}
+
+}  // namespace
+
+IPipelineConnection::~IPipelineConnection() {}
+
+common::Error DumpKeys(pipeline_connection_factory_t factory,
+                       dump_progress_callback_t progress,
+                       events_info::DumpKeysResponse* res) {
+  if (!factory || !res) {
+    return common::make_error_inval();
+  }
+
+  std::vector<DumpIndexEntry> entries;
+  if (res->resume && QFile::exists(GetIndexPath(res->path))) {
+    common::Error err = ReadIndex(res->path, res->pattern, &entries);
+    if (err) {
+      return err;
+    }
+  }
+
+  core::cursor_t cursor = 0;
+  for (const auto& entry : entries) {
+    res->keys_count += entry.keys_count;
+    cursor = entry.cursor;
+  }
+  res->chunks_count = entries.size();
+  if (!entries.empty() && cursor == 0) {
+    return common::Error();  // completed before
+  }
+
+  QFile dump(QString::fromStdString(res->path));
+  if (entries.empty()) {
+    const QByteArray magic = DUMP_FILE_MAGIC;
+    if (!dump.open(QIODevice::WriteOnly | QIODevice::Truncate) || dump.write(magic) != magic.size() ||
+        !dump.flush()) {
+      return MakeFileError(dump);
+    }
+  } else {
+    // data after last indexed chunk is a torn write
+    const qint64 dump_size = entries.back().offset + entries.back().size;
+    if (!dump.open(QIODevice::ReadWrite) || !dump.resize(dump_size) || !dump.seek(dump_size)) {
+      return MakeFileError(dump);
+    }
+  }
+
+  // rewritten on resume too, so torn last line is dropped
+  QFile index(GetIndexPath(res->path));
+  if (!index.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    return MakeFileError(index);
+  }
+
+  common::Error err = WriteIndexHeader(&index, res->pattern);
+  if (err) {
+    return err;
+  }
+
+  for (const auto& entry : entries) {
+    err = AppendIndexEntry(&index, entry);
+    if (err) {
+      return err;
+    }
+  }
+
+  std::vector<pipeline_connection_t> connections;
+  err = OpenConnections(factory, res->workers_count, &connections);
+  if (err) {
+    return err;
+  }
+
+  core::keys_limit_t db_size = 0;
+  err = GetDatabaseSize(connections[0], &db_size);
+  if (err) {
+    return err;
+  }
+
+  do {
+    std::vector<DumpChunk> chunks;
+    while (chunks.size() < connections.size()) {
+      DumpChunk chunk;
+      err = ScanChunk(connections[0], res->pattern, cursor, &chunk);
+      if (err) {
+        return err;
+      }
+      cursor = chunk.cursor;
+      chunks.push_back(chunk);
+      if (cursor == 0) {
+        break;
+      }
+    }
+
+    err = RunParallel(connections, &chunks, [&chunks](pipeline_connection_t connection, size_t pos) {
+      FetchChunk(connection, &chunks[pos]);
+    });
+    if (err) {
+      return err;
+    }
+
+    // chunks are appended in SCAN order, so index is always a resumable prefix
+    for (const auto& chunk : chunks) {
+      DumpIndexEntry entry;
+      entry.offset = dump.pos();
+      entry.size = chunk.data.size();
+      entry.keys_count = chunk.keys_count;
+      entry.cursor = chunk.cursor;
+      if (dump.write(chunk.data) != entry.size || !dump.flush()) {
+        return MakeFileError(dump);
+      }
+
+      err = AppendIndexEntry(&index, entry);
+      if (err) {
+        return err;
+      }
+      res->keys_count += chunk.keys_count;
+      res->chunks_count++;
+    }
+
+    if (progress && !progress(GetPercent(res->keys_count, db_size))) {
+      return common::make_error("Dump interrupted");
+    }
+  } while (cursor != 0);
+
+  return common::Error();
+}
+
+common::Error RestoreKeys(pipeline_connection_factory_t factory,
+                          const std::string& target,
+                          dump_progress_callback_t progress,
+                          events_info::RestoreKeysResponse* res) {
+  if (!factory || !res) {
+    return common::make_error_inval();
+  }
+
+  std::vector<DumpIndexEntry> entries;
+  common::Error err = ReadIndex(res->path, core::pattern_t(), &entries);
+  if (err) {
+    return err;
+  }
+
+  QFile dump(QString::fromStdString(res->path));
+  if (!dump.open(QIODevice::ReadOnly)) {
+    return MakeFileError(dump);
+  }
+  if (dump.read(sizeof(DUMP_FILE_MAGIC) - 1) != DUMP_FILE_MAGIC) {
+    return common::make_error("Invalid dump file");
+  }
+
+  QFile restored(GetRestoredPath(res->path, target));
+  size_t start = 0;
+  if (res->resume && restored.open(QIODevice::ReadOnly)) {
+    start = std::min<size_t>(restored.readAll().trimmed().toULongLong(), entries.size());
+    restored.close();
+  }
+
+  std::vector<pipeline_connection_t> connections;
+  err = OpenConnections(factory, res->workers_count, &connections);
+  if (err) {
+    return err;
+  }
+
+  res->chunks_count = start;
+  while (res->chunks_count < entries.size()) {
+    const size_t count = std::min(connections.size(), entries.size() - res->chunks_count);
+    std::vector<DumpChunk> chunks(count);
+    std::vector<QByteArray> blocks;
+    for (size_t i = 0; i < count; ++i) {
+      const DumpIndexEntry& entry = entries[res->chunks_count + i];
+      if (!dump.seek(entry.offset)) {
+        return MakeFileError(dump);
+      }
+      blocks.push_back(dump.read(entry.size));
+      if (blocks.back().size() != entry.size) {
+        return common::make_error("Dump file is truncated");
+      }
+    }
+
+    err = RunParallel(connections, &chunks, [&chunks, &blocks](pipeline_connection_t connection, size_t pos) {
+      RestoreChunk(connection, blocks[pos], &chunks[pos]);
+    });
+    if (err) {
+      return err;
+    }
+
+    for (const auto& chunk : chunks) {
+      res->keys_count += chunk.keys_count;
+    }
+    res->chunks_count += count;
+
+    if (!restored.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+      return MakeFileError(restored);
+    }
+    restored.write(QByteArray::number(static_cast<qulonglong>(res->chunks_count)));
+    restored.close();
+
+    if (progress && !progress(GetPercent(res->chunks_count, entries.size()))) {
+      return common::make_error("Restore interrupted");
+    }
+  }
+
+  restored.remove();
+  return common::Error();
+}
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,64 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fastonosql/core/global.h>
+
+#include "proxy/events/events_info.h"
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+// independent connection owned by one dump/restore worker
+class IPipelineConnection {
+ public:
+  virtual ~IPipelineConnection();
+
+  // replies are attached to executed commands as childrens
+  virtual common::Error ExecutePipeline(const std::vector<core::command_buffer_t>& commands,
+                                        std::vector<core::FastoObjectCommandIPtr>* executed) WARN_UNUSED_RESULT = 0;
+};
+
+typedef std::shared_ptr<IPipelineConnection> pipeline_connection_t;
+typedef std::function<common::Error(pipeline_connection_t* connection)> pipeline_connection_factory_t;
+// called with done percents, return false to abort
+typedef std::function<bool(int)> dump_progress_callback_t;
+
+// SCAN keys by pattern and store DUMP payloads with expire times into compressed chunks,
+// every completed chunk is appended to <path>.index together with SCAN cursor to resume from
+common::Error DumpKeys(pipeline_connection_factory_t factory,
+                       dump_progress_callback_t progress,
+                       events_info::DumpKeysResponse* res) WARN_UNUSED_RESULT;
+
+// replay chunks listed in index with RESTORE ... REPLACE, count of restored chunks is kept in
+// <path>.restored.<target>, so restore of the same dump into another server starts from scratch
+common::Error RestoreKeys(pipeline_connection_factory_t factory,
+                          const std::string& target,  // server and database keys go to, e.g. host:port/0
+                          dump_progress_callback_t progress,
+                          events_info::RestoreKeysResponse* res) WARN_UNUSED_RESULT;
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,460 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "proxy/db/redis_compatible/monitor_analyzer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#define REDIS_MONITOR_COMMAND "MONITOR"
+#define REDIS_QUIT_COMMAND "QUIT"
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+namespace {
+
+const common::time64_t kReportIntervalMsec = 1000;
+
+uint64_t HashToken(const MonitorToken& token) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < token.size; ++i) {
+    hash ^= static_cast<unsigned char>(token.data[i]);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+bool IsSameToken(const std::string& name, const MonitorToken& token) {
+  return name.size() == token.size && memcmp(name.data(), token.data, token.size) == 0;
+}
+
+void SkipSpaces(char** ptr, char* end) {
+  while (*ptr < end && **ptr == ' ') {
+    ++(*ptr);
+  }
+}
+
+// strtod depends on locale of application, timestamps always use dot
+bool ParseTimestamp(char** ptr, char* end, double* timestamp) {
+  char* cur = *ptr;
+  double result = 0;
+  bool has_digits = false;
+  while (cur < end && *cur >= '0' && *cur <= '9') {
+    result = result * 10 + (*cur - '0');
+    has_digits = true;
+    ++cur;
+  }
+
+  if (cur < end && *cur == '.') {
+    ++cur;
+    double scale = 0.1;
+    while (cur < end && *cur >= '0' && *cur <= '9') {
+      result += (*cur - '0') * scale;
+      scale /= 10;
+      ++cur;
+    }
+  }
+
+  if (!has_digits) {
+    return false;
+  }
+
+  *timestamp = result;
+  *ptr = cur;
+  return true;
+}
+
+bool NextQuotedToken(char** ptr, char* end, MonitorToken* token) {
+  SkipSpaces(ptr, end);
+  if (*ptr >= end || **ptr != '"') {
+    return false;
+  }
+
+  char* start = *ptr + 1;
+  char* cur = start;
+  while (cur < end && *cur != '"') {
+    cur += *cur == '\\' ? 2 : 1;
+  }
+  if (cur >= end) {
+    return false;
+  }
+
+  token->data = start;
+  token->size = cur - start;
+  *ptr = cur + 1;
+  return true;
+}
+
+bool HitGreater(const MonitorHit& lhs, const MonitorHit& rhs) {
+  return lhs.count > rhs.count;
+}
+
+}  // namespace
+
+MonitorToken::MonitorToken() : data(nullptr), size(0) {}
+
+MonitorEvent::MonitorEvent() : timestamp(0), client(), command(), key() {}
+
+bool ParseMonitorLine(std::string* line, MonitorEvent* event) {
+  if (!line || !event || line->empty()) {
+    return false;
+  }
+
+  char* ptr = &(*line)[0];
+  char* end = ptr + line->size();
+  if (*ptr == '+') {
+    ++ptr;
+  }
+
+  MonitorEvent result;
+  if (!ParseTimestamp(&ptr, end, &result.timestamp)) {
+    return false;
+  }
+
+  SkipSpaces(&ptr, end);
+  if (ptr >= end || *ptr != '[') {
+    return false;
+  }
+
+  // [<db> <client>], client is address, unix:<path> or lua
+  char* db_end = static_cast<char*>(memchr(ptr, ' ', end - ptr));
+  if (!db_end) {
+    return false;
+  }
+  char* client_end = static_cast<char*>(memchr(db_end, ']', end - db_end));
+  if (!client_end) {
+    return false;
+  }
+  result.client.data = db_end + 1;
+  result.client.size = client_end - db_end - 1;
+  ptr = client_end + 1;
+
+  if (!NextQuotedToken(&ptr, end, &result.command)) {
+    return false;
+  }
+  char* command = const_cast<char*>(result.command.data);
+  for (size_t i = 0; i < result.command.size; ++i) {
+    if (command[i] >= 'A' && command[i] <= 'Z') {
+      command[i] = command[i] - 'A' + 'a';
+    }
+  }
+
+  if (!NextQuotedToken(&ptr, end, &result.key)) {
+    result.key = MonitorToken();
+  }
+
+  *event = result;
+  return true;
+}
+
+MonitorHit::MonitorHit() : name(), count(0), rate(0) {}
+
+SlidingTopK::SlidingTopK(size_t k, size_t buckets_count)
+    : k_(k),
+      buckets_(std::max<size_t>(buckets_count, 1), std::vector<uint32_t>(sketch_depth * sketch_width, 0)),
+      current_(0),
+      heap_() {
+  heap_.reserve(k_ + 1);
+}
+
+void SlidingTopK::Add(const MonitorToken& token) {
+  const uint64_t hash = HashToken(token);
+  size_t indexes[sketch_depth];
+  Indexes(hash, indexes);
+
+  std::vector<uint32_t>& counters = buckets_[current_];
+  for (size_t i = 0; i < sketch_depth; ++i) {
+    if (counters[indexes[i]] != std::numeric_limits<uint32_t>::max()) {
+      counters[indexes[i]]++;
+    }
+  }
+
+  const uint64_t estimate = Estimate(indexes);
+  for (Candidate& candidate : heap_) {
+    if (candidate.hash == hash && IsSameToken(candidate.name, token)) {
+      candidate.count = estimate;
+      std::make_heap(heap_.begin(), heap_.end(), &SlidingTopK::CandidateGreater);
+      return;
+    }
+  }
+
+  if (heap_.size() == k_) {
+    if (k_ == 0 || estimate <= heap_.front().count) {
+      return;
+    }
+    std::pop_heap(heap_.begin(), heap_.end(), &SlidingTopK::CandidateGreater);
+    heap_.pop_back();
+  }
+
+  heap_.push_back({std::string(token.data, token.size), hash, estimate});
+  std::push_heap(heap_.begin(), heap_.end(), &SlidingTopK::CandidateGreater);
+}
+
+void SlidingTopK::Rotate() {
+  current_ = (current_ + 1) % buckets_.size();
+  std::fill(buckets_[current_].begin(), buckets_[current_].end(), 0);
+
+  size_t indexes[sketch_depth];
+  for (Candidate& candidate : heap_) {
+    Indexes(candidate.hash, indexes);
+    candidate.count = Estimate(indexes);
+  }
+  heap_.erase(std::remove_if(heap_.begin(), heap_.end(), [](const Candidate& item) { return item.count == 0; }),
+              heap_.end());
+  std::make_heap(heap_.begin(), heap_.end(), &SlidingTopK::CandidateGreater);
+}
+
+std::vector<MonitorHit> SlidingTopK::GetTop() const {
+  std::vector<MonitorHit> result;
+  result.reserve(heap_.size());
+  for (const Candidate& candidate : heap_) {
+    MonitorHit hit;
+    hit.name = candidate.name;
+    hit.count = candidate.count;
+    result.push_back(hit);
+  }
+  std::sort(result.begin(), result.end(), &HitGreater);
+  return result;
+}
+
+bool SlidingTopK::CandidateGreater(const Candidate& lhs, const Candidate& rhs) {
+  return lhs.count > rhs.count;
+}
+
+void SlidingTopK::Indexes(uint64_t hash, size_t* indexes) const {
+  // double hashing gives independent enough rows from single 64 bit hash
+  const uint64_t h1 = hash & 0xffffffff;
+  const uint64_t h2 = (hash >> 32) | 1;
+  for (size_t i = 0; i < sketch_depth; ++i) {
+    indexes[i] = i * sketch_width + (h1 + i * h2) % sketch_width;
+  }
+}
+
+uint64_t SlidingTopK::Estimate(const size_t* indexes) const {
+  uint64_t result = std::numeric_limits<uint64_t>::max();
+  for (size_t i = 0; i < sketch_depth; ++i) {
+    uint64_t row_sum = 0;
+    for (const auto& counters : buckets_) {
+      row_sum += counters[indexes[i]];
+    }
+    result = std::min(result, row_sum);
+  }
+  return result;
+}
+
+MonitorOptions::MonitorOptions() : duration_sec(60), max_samples(1000000), top_k(20), window_sec(60) {}
+
+MonitorReport::MonitorReport()
+    : samples(0), parse_errors(0), elapsed_msec(0), commands(), keys(), clients() {}
+
+MonitorAnalyzer::MonitorAnalyzer(const common::net::HostAndPort& host,
+                                 const core::SSHInfo& ssh_info,
+                                 const std::string& password,
+                                 const MonitorOptions& options)
+    : connection_(host, ssh_info),
+      password_(password),
+      options_(options),
+      stopped_(false),
+      commands_(options.top_k, window_buckets),
+      keys_(options.top_k, window_buckets),
+      clients_(),
+      current_bucket_(-1),
+      filled_buckets_(0),
+      last_timestamp_(0),
+      samples_(0),
+      parse_errors_(0),
+      start_msec_(0) {}
+
+common::Error MonitorAnalyzer::Connect() {
+  common::Error err = connection_.Connect(password_);
+  if (err) {
+    return err;
+  }
+
+  err = connection_.SendCommand({REDIS_MONITOR_COMMAND});
+  if (err) {
+    return err;
+  }
+
+  RespReply reply;
+  err = connection_.ReadReply(&reply);
+  if (err) {
+    return err;
+  }
+  if (reply.type == RespReply::ERROR) {
+    return common::make_error(reply.str);
+  }
+  return common::Error();
+}
+
+common::Error MonitorAnalyzer::Run(monitor_report_callback_t callback, MonitorReport* report) {
+  if (!report) {
+    DNOTREACHED();
+    return common::make_error_inval();
+  }
+
+  start_msec_ = common::time::current_utc_mstime();
+  common::time64_t last_report_msec = start_msec_;
+  std::string line;
+  MonitorEvent event;
+  while (!stopped_) {
+    // huge values (bulk SET of blobs) must not end the session, their lines are skipped
+    bool truncated = false;
+    common::Error err = connection_.ReadLine(max_line_size, &line, &truncated);
+    if (err) {
+      if (stopped_) {
+        break;
+      }
+      return err;
+    }
+
+    if (!truncated && !line.empty() && line[0] == '-') {
+      return common::make_error(line.substr(1));
+    }
+
+    if (!truncated && ParseMonitorLine(&line, &event)) {
+      samples_++;
+      Process(event);
+    } else {
+      parse_errors_++;
+    }
+
+    const common::time64_t now = common::time::current_utc_mstime();
+    const common::time64_t duration_msec = static_cast<common::time64_t>(options_.duration_sec) * 1000;
+    if (samples_ >= options_.max_samples || now - start_msec_ >= duration_msec) {
+      Stop();
+    }
+
+    if (now - last_report_msec >= kReportIntervalMsec) {
+      last_report_msec = now;
+      if (callback && !callback(MakeReport())) {
+        Stop();
+      }
+    }
+  }
+
+  *report = MakeReport();
+  return common::Error();
+}
+
+void MonitorAnalyzer::Stop() {
+  if (stopped_.exchange(true)) {
+    return;
+  }
+
+  // server answers QUIT and closes connection, this wakes up blocked reader
+  common::Error err = connection_.SendCommand({REDIS_QUIT_COMMAND});
+  UNUSED(err);
+}
+
+void MonitorAnalyzer::Process(const MonitorEvent& event) {
+  const uint32_t bucket_sec = std::max<uint32_t>(options_.window_sec / window_buckets, 1);
+  const int64_t bucket = static_cast<int64_t>(event.timestamp) / bucket_sec;
+  if (current_bucket_ < 0) {
+    current_bucket_ = bucket;
+    filled_buckets_ = 1;
+  } else if (bucket > current_bucket_) {
+    RotateTo(bucket);
+  }
+  last_timestamp_ = std::max(last_timestamp_, event.timestamp);
+
+  commands_.Add(event.command);
+  if (event.key.size) {
+    keys_.Add(event.key);
+  }
+
+  const uint64_t client_hash = HashToken(event.client);
+  auto it = clients_.find(client_hash);
+  if (it == clients_.end()) {
+    if (clients_.size() >= max_clients) {
+      return;
+    }
+    ClientCounter counter;
+    counter.name.assign(event.client.data, event.client.size);
+    counter.buckets.resize(window_buckets, 0);
+    it = clients_.insert(std::make_pair(client_hash, counter)).first;
+  }
+  it->second.buckets[current_bucket_ % window_buckets]++;
+}
+
+void MonitorAnalyzer::RotateTo(int64_t bucket) {
+  const int64_t steps = std::min<int64_t>(bucket - current_bucket_, window_buckets);
+  for (int64_t i = 1; i <= steps; ++i) {
+    commands_.Rotate();
+    keys_.Rotate();
+    const size_t slot = (current_bucket_ + i) % window_buckets;
+    for (auto& client : clients_) {
+      client.second.buckets[slot] = 0;
+    }
+  }
+
+  for (auto it = clients_.begin(); it != clients_.end();) {
+    const auto& buckets = it->second.buckets;
+    if (std::all_of(buckets.begin(), buckets.end(), [](uint64_t count) { return count == 0; })) {
+      it = clients_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  filled_buckets_ = std::min<size_t>(filled_buckets_ + steps, window_buckets);
+  current_bucket_ = bucket;
+}
+
+MonitorReport MonitorAnalyzer::MakeReport() const {
+  MonitorReport report;
+  report.samples = samples_;
+  report.parse_errors = parse_errors_;
+  report.elapsed_msec = common::time::current_utc_mstime() - start_msec_;
+
+  // current bucket is only partially filled
+  const uint32_t bucket_sec = std::max<uint32_t>(options_.window_sec / window_buckets, 1);
+  double window = 1;
+  if (current_bucket_ >= 0) {
+    const double current_part = last_timestamp_ - static_cast<double>(current_bucket_ * bucket_sec);
+    window = std::max(1.0, (filled_buckets_ - 1) * bucket_sec + current_part);
+  }
+
+  report.commands = commands_.GetTop();
+  report.keys = keys_.GetTop();
+  for (const auto& client : clients_) {
+    MonitorHit hit;
+    hit.name = client.second.name;
+    for (uint64_t count : client.second.buckets) {
+      hit.count += count;
+    }
+    report.clients.push_back(hit);
+  }
+  std::sort(report.clients.begin(), report.clients.end(), &HitGreater);
+  if (report.clients.size() > options_.top_k) {
+    report.clients.resize(options_.top_k);
+  }
+
+  for (auto* hits : {&report.commands, &report.keys, &report.clients}) {
+    for (MonitorHit& hit : *hits) {
+      hit.rate = hit.count / window;
+    }
+  }
+  return report;
+}
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,158 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <common/time.h>
+
+#include "proxy/db/redis_compatible/resp_connection.h"
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+// view into MONITOR line, valid until next line is read
+struct MonitorToken {
+  MonitorToken();
+
+  const char* data;
+  size_t size;
+};
+
+struct MonitorEvent {
+  MonitorEvent();
+
+  double timestamp;  // seconds, server clock
+  MonitorToken client;
+  MonitorToken command;  // lower case
+  MonitorToken key;      // first argument, empty for commands without arguments
+};
+
+// Tokenizes `<ts> [<db> <client>] "cmd" "arg" ...` in place without allocations,
+// quoted tokens keep MONITOR escaping.
+bool ParseMonitorLine(std::string* line, MonitorEvent* event);
+
+struct MonitorHit {
+  MonitorHit();
+
+  std::string name;
+  uint64_t count;  // within window
+  double rate;     // per second
+};
+
+// Heavy hitters over sliding window: count-min sketch per window bucket estimates frequencies,
+// min-heap keeps k current leaders. Memory is fixed by k and sketch dimensions.
+class SlidingTopK {
+ public:
+  enum { sketch_depth = 4, sketch_width = 4096 };
+
+  SlidingTopK(size_t k, size_t buckets_count);
+
+  void Add(const MonitorToken& token);
+  void Rotate();  // oldest bucket is dropped, leaders are re-estimated
+  std::vector<MonitorHit> GetTop() const;  // descending, rate is filled by caller
+
+ private:
+  struct Candidate {
+    std::string name;
+    uint64_t hash;
+    uint64_t count;
+  };
+
+  static bool CandidateGreater(const Candidate& lhs, const Candidate& rhs);
+  void Indexes(uint64_t hash, size_t* indexes) const;
+  uint64_t Estimate(const size_t* indexes) const;
+
+  const size_t k_;
+  std::vector<std::vector<uint32_t>> buckets_;  // depth * width counters per bucket
+  size_t current_;
+  std::vector<Candidate> heap_;  // min-heap by count, smallest leader on top
+};
+
+struct MonitorOptions {
+  MonitorOptions();
+
+  uint32_t duration_sec;  // hard limit of MONITOR session
+  uint64_t max_samples;   // hard limit of processed lines
+  size_t top_k;
+  uint32_t window_sec;  // sliding window of counters
+};
+
+struct MonitorReport {
+  MonitorReport();
+
+  uint64_t samples;
+  uint64_t parse_errors;
+  common::time64_t elapsed_msec;
+  std::vector<MonitorHit> commands;
+  std::vector<MonitorHit> keys;
+  std::vector<MonitorHit> clients;
+};
+
+// called on receive thread about once a second, return false to stop
+typedef std::function<bool(const MonitorReport&)> monitor_report_callback_t;
+
+class MonitorAnalyzer {
+ public:
+  enum { window_buckets = 6, max_clients = 10000, max_line_size = 64 * 1024 };
+
+  MonitorAnalyzer(const common::net::HostAndPort& host,
+                  const core::SSHInfo& ssh_info,
+                  const std::string& password,
+                  const MonitorOptions& options);
+
+  common::Error Connect() WARN_UNUSED_RESULT;
+  // blocks until limits are reached, Stop is called or callback refuses to continue
+  common::Error Run(monitor_report_callback_t callback, MonitorReport* report) WARN_UNUSED_RESULT;
+  // thread safe, closes MONITOR session even if server is idle
+  void Stop();
+
+ private:
+  struct ClientCounter {
+    std::string name;
+    std::vector<uint64_t> buckets;
+  };
+
+  void Process(const MonitorEvent& event);
+  void RotateTo(int64_t bucket);
+  MonitorReport MakeReport() const;
+
+  RespConnection connection_;
+  const std::string password_;
+  const MonitorOptions options_;
+  std::atomic<bool> stopped_;
+
+  SlidingTopK commands_;
+  SlidingTopK keys_;
+  std::unordered_map<uint64_t, ClientCounter> clients_;  // by name hash, lookups do not allocate
+  int64_t current_bucket_;  // -1 before first event
+  size_t filled_buckets_;
+  double last_timestamp_;
+  uint64_t samples_;
+  uint64_t parse_errors_;
+  common::time64_t start_msec_;
+};
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
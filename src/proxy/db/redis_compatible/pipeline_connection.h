@@ -0,0 +1,83 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "proxy/command/command.h"
+#include "proxy/db/redis_compatible/logical_dump.h"
+#include "proxy/db/redis_compatible/ssh_tunnel.h"
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+// wraps extra native connection of driver, commands are executed without logging,
+// tunnel is own ssh tunnel of connection if any, released after disconnect
+template <typename DBConnection, typename Command>
+class PipelineConnection : public IPipelineConnection {
+ public:
+  explicit PipelineConnection(DBConnection* connection, ssh_tunnel_t tunnel = ssh_tunnel_t())
+      : connection_(connection), tunnel_(tunnel) {}
+
+  ~PipelineConnection() override {
+    common::Error err = connection_->Disconnect();
+    UNUSED(err);
+    delete connection_;
+  }
+
+  template <typename Config>
+  common::Error Connect(const Config& config, const core::db_name_t& db_name) WARN_UNUSED_RESULT {
+    common::Error err = connection_->Connect(config);
+    if (err) {
+      return err;
+    }
+
+    if (connection_->GetCurrentDBName() == db_name) {
+      return common::Error();
+    }
+
+    core::IDataBaseInfo* info = nullptr;
+    err = connection_->Select(db_name, &info);
+    delete info;
+    return err;
+  }
+
+  common::Error ExecutePipeline(const std::vector<core::command_buffer_t>& commands,
+                                std::vector<core::FastoObjectCommandIPtr>* executed) override {
+    if (!executed) {
+      return common::make_error_inval();
+    }
+
+    executed->clear();
+    executed->reserve(commands.size());
+    for (const auto& command : commands) {
+      executed->push_back(CreateCommandFast<Command>(command, core::C_INNER));
+    }
+    return connection_->ExecuteAsPipeline(*executed, &SkipLogging);
+  }
+
+ private:
+  static void SkipLogging(core::FastoObjectCommandIPtr command) { UNUSED(command); }
+
+  DBConnection* const connection_;
+  const ssh_tunnel_t tunnel_;
+};
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,815 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "proxy/db/redis_compatible/rdb_analyzer.h"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+
+#include <QFile>
+
+#include <common/convert2string.h>
+#include <common/sprintf.h>
+#include <common/time.h>
+
+#define RDB_MAGIC "REDIS"
+#define RDB_MAGIC_SIZE 5
+#define RDB_VERSION_SIZE 4
+
+// opcodes
+#define RDB_OPCODE_SLOT_INFO 244
+#define RDB_OPCODE_FUNCTION2 245
+#define RDB_OPCODE_MODULE_AUX 247
+#define RDB_OPCODE_IDLE 248
+#define RDB_OPCODE_FREQ 249
+#define RDB_OPCODE_AUX 250
+#define RDB_OPCODE_RESIZEDB 251
+#define RDB_OPCODE_EXPIRETIME_MS 252
+#define RDB_OPCODE_EXPIRETIME 253
+#define RDB_OPCODE_SELECTDB 254
+#define RDB_OPCODE_EOF 255
+
+// value types
+#define RDB_TYPE_STRING 0
+#define RDB_TYPE_LIST 1
+#define RDB_TYPE_SET 2
+#define RDB_TYPE_ZSET 3
+#define RDB_TYPE_HASH 4
+#define RDB_TYPE_ZSET_2 5
+#define RDB_TYPE_MODULE 6
+#define RDB_TYPE_MODULE_2 7
+#define RDB_TYPE_HASH_ZIPMAP 9
+#define RDB_TYPE_LIST_ZIPLIST 10
+#define RDB_TYPE_SET_INTSET 11
+#define RDB_TYPE_ZSET_ZIPLIST 12
+#define RDB_TYPE_HASH_ZIPLIST 13
+#define RDB_TYPE_LIST_QUICKLIST 14
+#define RDB_TYPE_STREAM_LISTPACKS 15
+#define RDB_TYPE_HASH_LISTPACK 16
+#define RDB_TYPE_ZSET_LISTPACK 17
+#define RDB_TYPE_LIST_QUICKLIST_2 18
+#define RDB_TYPE_STREAM_LISTPACKS_2 19
+#define RDB_TYPE_SET_LISTPACK 20
+#define RDB_TYPE_STREAM_LISTPACKS_3 21
+
+// length encodings
+#define RDB_6BITLEN 0
+#define RDB_14BITLEN 1
+#define RDB_32BITLEN 0x80
+#define RDB_64BITLEN 0x81
+#define RDB_ENCVAL 3
+#define RDB_ENC_INT8 0
+#define RDB_ENC_INT16 1
+#define RDB_ENC_INT32 2
+#define RDB_ENC_LZF 3
+
+// module value opcodes
+#define RDB_MODULE_OPCODE_EOF 0
+#define RDB_MODULE_OPCODE_SINT 1
+#define RDB_MODULE_OPCODE_UINT 2
+#define RDB_MODULE_OPCODE_FLOAT 3
+#define RDB_MODULE_OPCODE_DOUBLE 4
+#define RDB_MODULE_OPCODE_STRING 5
+
+#define RDB_AUX_CTIME "ctime"
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+namespace {
+
+const qint64 kReadBufferSize = 64 * 1024;
+const qint64 kProgressStep = 1024 * 1024;
+const int64_t kHour = 3600;
+const int64_t kDay = 24 * kHour;
+
+const char* kTTLBucketNames[RDB_TTL_BUCKETS_COUNT] = {"no expire", "expired", "< 1 hour", "< 1 day",
+                                                      "< 1 week",  "< 30 days", ">= 30 days"};
+
+const char* GetTypeName(uint8_t type) {
+  switch (type) {
+    case RDB_TYPE_STRING:
+      return "string";
+    case RDB_TYPE_LIST:
+    case RDB_TYPE_LIST_ZIPLIST:
+    case RDB_TYPE_LIST_QUICKLIST:
+    case RDB_TYPE_LIST_QUICKLIST_2:
+      return "list";
+    case RDB_TYPE_SET:
+    case RDB_TYPE_SET_INTSET:
+    case RDB_TYPE_SET_LISTPACK:
+      return "set";
+    case RDB_TYPE_ZSET:
+    case RDB_TYPE_ZSET_2:
+    case RDB_TYPE_ZSET_ZIPLIST:
+    case RDB_TYPE_ZSET_LISTPACK:
+      return "zset";
+    case RDB_TYPE_HASH:
+    case RDB_TYPE_HASH_ZIPMAP:
+    case RDB_TYPE_HASH_ZIPLIST:
+    case RDB_TYPE_HASH_LISTPACK:
+      return "hash";
+    case RDB_TYPE_STREAM_LISTPACKS:
+    case RDB_TYPE_STREAM_LISTPACKS_2:
+    case RDB_TYPE_STREAM_LISTPACKS_3:
+      return "stream";
+    case RDB_TYPE_MODULE:
+    case RDB_TYPE_MODULE_2:
+      return "module";
+    default:
+      return nullptr;
+  }
+}
+
+RdbTTLBucket GetTTLBucket(int64_t ttl) {
+  if (ttl < 0) {
+    return RDB_TTL_NONE;
+  }
+  if (ttl == 0) {
+    return RDB_TTL_EXPIRED;
+  }
+  if (ttl < kHour) {
+    return RDB_TTL_HOUR;
+  }
+  if (ttl < kDay) {
+    return RDB_TTL_DAY;
+  }
+  if (ttl < 7 * kDay) {
+    return RDB_TTL_WEEK;
+  }
+  if (ttl < 30 * kDay) {
+    return RDB_TTL_MONTH;
+  }
+  return RDB_TTL_LONGER;
+}
+
+// liblzf format, only keys are decompressed
+bool LzfDecompress(const std::string& in, size_t out_len, std::string* out) {
+  std::string result(out_len, 0);
+  const uint8_t* ip = reinterpret_cast<const uint8_t*>(in.data());
+  const uint8_t* const in_end = ip + in.size();
+  char* const out_begin = &result[0];
+  char* op = out_begin;
+  char* const out_end = out_begin + out_len;
+  while (ip < in_end) {
+    size_t ctrl = *ip++;
+    if (ctrl < (1 << 5)) {  // literal run
+      ctrl++;
+      if (op + ctrl > out_end || ip + ctrl > in_end) {
+        return false;
+      }
+      std::copy(ip, ip + ctrl, op);
+      ip += ctrl;
+      op += ctrl;
+      continue;
+    }
+
+    size_t len = ctrl >> 5;  // back reference
+    if (ip >= in_end) {
+      return false;
+    }
+    if (len == 7) {
+      len += *ip++;
+      if (ip >= in_end) {
+        return false;
+      }
+    }
+    const size_t distance = ((ctrl & 0x1f) << 8) + *ip++ + 1;
+    len += 2;
+    if (op + len > out_end || static_cast<size_t>(op - out_begin) < distance) {
+      return false;
+    }
+    const char* ref = op - distance;
+    for (size_t i = 0; i < len; ++i) {
+      *op++ = *ref++;
+    }
+  }
+
+  if (op != out_end) {
+    return false;
+  }
+  *out = result;
+  return true;
+}
+
+class RdbReader {
+ public:
+  explicit RdbReader(QFile* file) : file_(file), buffer_(), pos_(0), offset_(0) {}
+
+  qint64 GetOffset() const { return offset_; }
+
+  common::Error Read(void* data, size_t size) {
+    char* out = static_cast<char*>(data);
+    while (size) {
+      if (pos_ == buffer_.size()) {
+        common::Error err = Fill();
+        if (err) {
+          return err;
+        }
+      }
+      const size_t chunk = std::min(size, static_cast<size_t>(buffer_.size() - pos_));
+      std::copy(buffer_.constData() + pos_, buffer_.constData() + pos_ + chunk, out);
+      pos_ += static_cast<int>(chunk);
+      offset_ += chunk;
+      out += chunk;
+      size -= chunk;
+    }
+    return common::Error();
+  }
+
+  common::Error Skip(uint64_t size) {
+    const uint64_t buffered = buffer_.size() - pos_;
+    if (size <= buffered) {
+      pos_ += static_cast<int>(size);
+      offset_ += size;
+      return common::Error();
+    }
+
+    const qint64 target = offset_ + static_cast<qint64>(size);
+    if (target > file_->size() || !file_->seek(target)) {
+      return MakeTruncatedError();
+    }
+    buffer_.clear();
+    pos_ = 0;
+    offset_ = target;
+    return common::Error();
+  }
+
+  common::Error ReadByte(uint8_t* byte) { return Read(byte, 1); }
+
+  // little endian, as stored by redis
+  common::Error ReadUInt(size_t bytes, uint64_t* value) {
+    uint8_t raw[8];
+    common::Error err = Read(raw, bytes);
+    if (err) {
+      return err;
+    }
+
+    uint64_t result = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+      result |= static_cast<uint64_t>(raw[i]) << (8 * i);
+    }
+    *value = result;
+    return common::Error();
+  }
+
+  common::Error ReadLength(uint64_t* length, bool* encoded) {
+    *encoded = false;
+    uint8_t first;
+    common::Error err = ReadByte(&first);
+    if (err) {
+      return err;
+    }
+
+    const uint8_t type = (first & 0xC0) >> 6;
+    if (type == RDB_ENCVAL) {
+      *encoded = true;
+      *length = first & 0x3F;
+      return common::Error();
+    }
+    if (type == RDB_6BITLEN) {
+      *length = first & 0x3F;
+      return common::Error();
+    }
+    if (type == RDB_14BITLEN) {
+      uint8_t next;
+      err = ReadByte(&next);
+      if (err) {
+        return err;
+      }
+      *length = (static_cast<uint64_t>(first & 0x3F) << 8) | next;
+      return common::Error();
+    }
+
+    size_t bytes = 0;
+    if (first == RDB_32BITLEN) {
+      bytes = 4;
+    } else if (first == RDB_64BITLEN) {
+      bytes = 8;
+    } else {
+      return common::make_error("Unknown RDB length encoding");
+    }
+
+    uint8_t raw[8];
+    err = Read(raw, bytes);
+    if (err) {
+      return err;
+    }
+    uint64_t result = 0;
+    for (size_t i = 0; i < bytes; ++i) {  // big endian
+      result = (result << 8) | raw[i];
+    }
+    *length = result;
+    return common::Error();
+  }
+
+  common::Error ReadLength(uint64_t* length) {
+    bool encoded;
+    common::Error err = ReadLength(length, &encoded);
+    if (err) {
+      return err;
+    }
+    if (encoded) {
+      return common::make_error("Unexpected RDB encoded length");
+    }
+    return common::Error();
+  }
+
+  common::Error ReadString(std::string* str) { return ProcessString(str); }
+
+  common::Error SkipString() { return ProcessString(nullptr); }
+
+  common::Error SkipLengths(size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      uint64_t length;
+      common::Error err = ReadLength(&length);
+      if (err) {
+        return err;
+      }
+    }
+    return common::Error();
+  }
+
+ private:
+  common::Error MakeTruncatedError() const { return common::make_error("Unexpected end of RDB file"); }
+
+  common::Error Fill() {
+    buffer_ = file_->read(kReadBufferSize);
+    pos_ = 0;
+    if (buffer_.isEmpty()) {
+      return MakeTruncatedError();
+    }
+    return common::Error();
+  }
+
+  // str is nullptr when value only should be skipped
+  common::Error ProcessString(std::string* str) {
+    uint64_t length;
+    bool encoded;
+    common::Error err = ReadLength(&length, &encoded);
+    if (err) {
+      return err;
+    }
+
+    if (!encoded) {
+      if (!str) {
+        return Skip(length);
+      }
+      str->resize(length);
+      return length ? Read(&(*str)[0], length) : common::Error();
+    }
+
+    if (length == RDB_ENC_INT8 || length == RDB_ENC_INT16 || length == RDB_ENC_INT32) {
+      const size_t bytes = length == RDB_ENC_INT8 ? 1 : length == RDB_ENC_INT16 ? 2 : 4;
+      uint64_t raw;
+      err = ReadUInt(bytes, &raw);
+      if (err || !str) {
+        return err;
+      }
+      const int shift = 64 - static_cast<int>(bytes) * 8;
+      const int64_t value = static_cast<int64_t>(raw << shift) >> shift;  // sign extend
+      *str = common::ConvertToString(value);
+      return common::Error();
+    }
+
+    if (length != RDB_ENC_LZF) {
+      return common::make_error("Unknown RDB string encoding");
+    }
+
+    uint64_t compressed_length, length_out;
+    err = ReadLength(&compressed_length);
+    if (err) {
+      return err;
+    }
+    err = ReadLength(&length_out);
+    if (err) {
+      return err;
+    }
+    if (!str) {
+      return Skip(compressed_length);
+    }
+
+    std::string compressed(compressed_length, 0);
+    err = compressed_length ? Read(&compressed[0], compressed_length) : common::Error();
+    if (err) {
+      return err;
+    }
+    if (!LzfDecompress(compressed, length_out, str)) {
+      return common::make_error("Invalid LZF compressed RDB string");
+    }
+    return common::Error();
+  }
+
+  QFile* const file_;
+  QByteArray buffer_;
+  int pos_;
+  qint64 offset_;
+};
+
+common::Error SkipModuleOpcodes(RdbReader* reader) {
+  while (true) {
+    uint64_t opcode;
+    common::Error err = reader->ReadLength(&opcode);
+    if (err) {
+      return err;
+    }
+
+    switch (opcode) {
+      case RDB_MODULE_OPCODE_EOF:
+        return common::Error();
+      case RDB_MODULE_OPCODE_SINT:
+      case RDB_MODULE_OPCODE_UINT:
+        err = reader->SkipLengths(1);
+        break;
+      case RDB_MODULE_OPCODE_FLOAT:
+        err = reader->Skip(4);
+        break;
+      case RDB_MODULE_OPCODE_DOUBLE:
+        err = reader->Skip(8);
+        break;
+      case RDB_MODULE_OPCODE_STRING:
+        err = reader->SkipString();
+        break;
+      default:
+        return common::make_error("Unknown RDB module opcode");
+    }
+
+    if (err) {
+      return err;
+    }
+  }
+}
+
+common::Error SkipStream(RdbReader* reader, uint8_t type) {
+  uint64_t listpacks;
+  common::Error err = reader->ReadLength(&listpacks);
+  for (uint64_t i = 0; !err && i < listpacks; ++i) {
+    err = reader->SkipString();  // master id
+    if (!err) {
+      err = reader->SkipString();  // listpack
+    }
+  }
+  if (err) {
+    return err;
+  }
+
+  // length, last id; first id, max deleted id, entries added since v2
+  err = reader->SkipLengths(type == RDB_TYPE_STREAM_LISTPACKS ? 3 : 8);
+  if (err) {
+    return err;
+  }
+
+  uint64_t groups;
+  err = reader->ReadLength(&groups);
+  for (uint64_t g = 0; !err && g < groups; ++g) {
+    err = reader->SkipString();
+    if (!err) {
+      err = reader->SkipLengths(type == RDB_TYPE_STREAM_LISTPACKS ? 2 : 3);  // last id, entries read
+    }
+
+    uint64_t pending = 0;
+    if (!err) {
+      err = reader->ReadLength(&pending);
+    }
+    for (uint64_t p = 0; !err && p < pending; ++p) {
+      err = reader->Skip(16 + 8);  // raw id, delivery time
+      if (!err) {
+        err = reader->SkipLengths(1);  // delivery count
+      }
+    }
+
+    uint64_t consumers = 0;
+    if (!err) {
+      err = reader->ReadLength(&consumers);
+    }
+    for (uint64_t c = 0; !err && c < consumers; ++c) {
+      err = reader->SkipString();
+      if (!err) {
+        err = reader->Skip(type == RDB_TYPE_STREAM_LISTPACKS_3 ? 16 : 8);  // seen time, active time
+      }
+      uint64_t consumer_pending = 0;
+      if (!err) {
+        err = reader->ReadLength(&consumer_pending);
+      }
+      if (!err) {
+        err = reader->Skip(consumer_pending * 16);
+      }
+    }
+  }
+  return err;
+}
+
+common::Error SkipValue(RdbReader* reader, uint8_t type) {
+  uint64_t count;
+  common::Error err;
+  switch (type) {
+    case RDB_TYPE_STRING:
+    case RDB_TYPE_HASH_ZIPMAP:
+    case RDB_TYPE_LIST_ZIPLIST:
+    case RDB_TYPE_SET_INTSET:
+    case RDB_TYPE_ZSET_ZIPLIST:
+    case RDB_TYPE_HASH_ZIPLIST:
+    case RDB_TYPE_HASH_LISTPACK:
+    case RDB_TYPE_ZSET_LISTPACK:
+    case RDB_TYPE_SET_LISTPACK:
+      return reader->SkipString();
+    case RDB_TYPE_LIST:
+    case RDB_TYPE_SET:
+    case RDB_TYPE_LIST_QUICKLIST:
+      err = reader->ReadLength(&count);
+      for (uint64_t i = 0; !err && i < count; ++i) {
+        err = reader->SkipString();
+      }
+      return err;
+    case RDB_TYPE_LIST_QUICKLIST_2:
+      err = reader->ReadLength(&count);
+      for (uint64_t i = 0; !err && i < count; ++i) {
+        err = reader->SkipLengths(1);  // container
+        if (!err) {
+          err = reader->SkipString();
+        }
+      }
+      return err;
+    case RDB_TYPE_HASH:
+      err = reader->ReadLength(&count);
+      for (uint64_t i = 0; !err && i < count * 2; ++i) {
+        err = reader->SkipString();
+      }
+      return err;
+    case RDB_TYPE_ZSET:
+      err = reader->ReadLength(&count);
+      for (uint64_t i = 0; !err && i < count; ++i) {
+        err = reader->SkipString();
+        uint8_t score_length = 0;
+        if (!err) {
+          err = reader->ReadByte(&score_length);
+        }
+        if (!err && score_length < 253) {  // 253-255: nan and infinities
+          err = reader->Skip(score_length);
+        }
+      }
+      return err;
+    case RDB_TYPE_ZSET_2:
+      err = reader->ReadLength(&count);
+      for (uint64_t i = 0; !err && i < count; ++i) {
+        err = reader->SkipString();
+        if (!err) {
+          err = reader->Skip(8);  // binary double
+        }
+      }
+      return err;
+    case RDB_TYPE_MODULE_2:
+      err = reader->SkipLengths(1);  // module id
+      if (err) {
+        return err;
+      }
+      return SkipModuleOpcodes(reader);
+    case RDB_TYPE_STREAM_LISTPACKS:
+    case RDB_TYPE_STREAM_LISTPACKS_2:
+    case RDB_TYPE_STREAM_LISTPACKS_3:
+      return SkipStream(reader, type);
+    default:
+      return common::make_error(common::MemSPrintf("Unsupported RDB value type: %d", static_cast<int>(type)));
+  }
+}
+
+class RdbAggregator {
+ public:
+  RdbAggregator(const std::string& ns_separator, size_t largest_keys_count, RdbReport* report)
+      : ns_separator_(ns_separator), largest_keys_count_(largest_keys_count), report_(report), largest_() {}
+
+  void AddKey(const std::string& key, uint8_t type, uint64_t bytes, int64_t ttl) {
+    const char* type_name = GetTypeName(type);
+    report_->total.Add(bytes);
+    report_->types[type_name].Add(bytes);
+    report_->ttls[GetTTLBucket(ttl)].Add(bytes);
+
+    std::string ns;
+    if (!ns_separator_.empty()) {
+      const size_t pos = key.find(ns_separator_);
+      if (pos != std::string::npos) {
+        ns = key.substr(0, pos);
+      }
+    }
+    report_->namespaces[ns].Add(bytes);
+
+    if (!largest_keys_count_) {
+      return;
+    }
+    if (largest_.size() == largest_keys_count_) {
+      if (largest_.top().bytes >= bytes) {
+        return;
+      }
+      largest_.pop();
+    }
+
+    RdbLargestKey item;
+    item.key = key;
+    item.type = type_name;
+    item.bytes = bytes;
+    item.ttl = ttl;
+    largest_.push(item);
+  }
+
+  void Finish() {
+    report_->largest_keys.clear();
+    while (!largest_.empty()) {
+      report_->largest_keys.push_back(largest_.top());
+      largest_.pop();
+    }
+    std::reverse(report_->largest_keys.begin(), report_->largest_keys.end());
+  }
+
+ private:
+  struct LargerFirst {
+    bool operator()(const RdbLargestKey& lhs, const RdbLargestKey& rhs) const { return lhs.bytes > rhs.bytes; }
+  };
+
+  const std::string ns_separator_;
+  const size_t largest_keys_count_;
+  RdbReport* const report_;
+  std::priority_queue<RdbLargestKey, std::vector<RdbLargestKey>, LargerFirst> largest_;  // smallest on top
+};
+
+common::Error ReadHeader(RdbReader* reader, int* version) {
+  char header[RDB_MAGIC_SIZE + RDB_VERSION_SIZE];
+  common::Error err = reader->Read(header, sizeof(header));
+  if (err) {
+    return err;
+  }
+
+  if (std::string(header, RDB_MAGIC_SIZE) != RDB_MAGIC) {
+    return common::make_error("Invalid RDB file, wrong magic");
+  }
+
+  const std::string version_str(header + RDB_MAGIC_SIZE, RDB_VERSION_SIZE);
+  if (!common::ConvertFromString(version_str, version)) {
+    return common::make_error("Invalid RDB file, wrong version");
+  }
+  return common::Error();
+}
+
+}  // namespace
+
+RdbKeysStats::RdbKeysStats() : keys(0), bytes(0) {}
+
+void RdbKeysStats::Add(uint64_t serialized_bytes) {
+  keys++;
+  bytes += serialized_bytes;
+}
+
+RdbLargestKey::RdbLargestKey() : key(), type(), bytes(0), ttl(-1) {}
+
+const char* GetRdbTTLBucketName(RdbTTLBucket bucket) {
+  if (bucket >= RDB_TTL_BUCKETS_COUNT) {
+    DNOTREACHED();
+    return nullptr;
+  }
+  return kTTLBucketNames[bucket];
+}
+
+RdbReport::RdbReport() : version(0), file_size(0), total(), namespaces(), types(), ttls(), largest_keys() {}
+
+common::Error AnalyzeRdbFile(const std::string& path,
+                             const std::string& ns_separator,
+                             size_t largest_keys_count,
+                             rdb_progress_callback_t progress,
+                             RdbReport* report) {
+  if (path.empty() || !report) {
+    DNOTREACHED();
+    return common::make_error_inval();
+  }
+
+  QFile file(QString::fromStdString(path));
+  if (!file.open(QIODevice::ReadOnly)) {
+    return common::make_error(path + ": " + file.errorString().toStdString());
+  }
+
+  RdbReport result;
+  result.file_size = file.size();
+  RdbReader reader(&file);
+  common::Error err = ReadHeader(&reader, &result.version);
+  if (err) {
+    return err;
+  }
+
+  RdbAggregator aggregator(ns_separator, largest_keys_count, &result);
+  // expire times are compared with snapshot creation time, stored by redis 4+ as aux field
+  int64_t snapshot_msec = common::time::current_utc_mstime();
+  int64_t expire_msec = -1;
+  qint64 next_progress = kProgressStep;
+  while (true) {
+    if (reader.GetOffset() >= next_progress) {
+      next_progress = reader.GetOffset() + kProgressStep;
+      const int percent = result.file_size ? static_cast<int>(reader.GetOffset() * 100 / result.file_size) : 0;
+      if (progress && !progress(percent)) {
+        return common::make_error(common::COMMON_EINTR);
+      }
+    }
+
+    const qint64 record_offset = reader.GetOffset();
+    uint8_t type;
+    err = reader.ReadByte(&type);
+    if (err) {
+      return err;
+    }
+
+    uint64_t value = 0;
+    switch (type) {
+      case RDB_OPCODE_EOF:
+        aggregator.Finish();
+        *report = result;
+        return common::Error();
+      case RDB_OPCODE_SELECTDB:
+        err = reader.SkipLengths(1);
+        break;
+      case RDB_OPCODE_RESIZEDB:
+        err = reader.SkipLengths(2);
+        break;
+      case RDB_OPCODE_SLOT_INFO:
+        err = reader.SkipLengths(3);
+        break;
+      case RDB_OPCODE_EXPIRETIME:
+        err = reader.ReadUInt(4, &value);
+        expire_msec = static_cast<int64_t>(value) * 1000;
+        break;
+      case RDB_OPCODE_EXPIRETIME_MS:
+        err = reader.ReadUInt(8, &value);
+        expire_msec = static_cast<int64_t>(value);
+        break;
+      case RDB_OPCODE_FREQ:
+        err = reader.Skip(1);
+        break;
+      case RDB_OPCODE_IDLE:
+        err = reader.SkipLengths(1);
+        break;
+      case RDB_OPCODE_FUNCTION2:
+        err = reader.SkipString();
+        break;
+      case RDB_OPCODE_MODULE_AUX:
+        err = reader.SkipLengths(3);  // module id, when opcode, when
+        if (!err) {
+          err = SkipModuleOpcodes(&reader);
+        }
+        break;
+      case RDB_OPCODE_AUX: {
+        std::string aux_key, aux_value;
+        err = reader.ReadString(&aux_key);
+        if (!err) {
+          err = reader.ReadString(&aux_value);
+        }
+        int64_t ctime;
+        if (!err && aux_key == RDB_AUX_CTIME && common::ConvertFromString(aux_value, &ctime)) {
+          snapshot_msec = ctime * 1000;
+        }
+        break;
+      }
+      default: {
+        if (!GetTypeName(type)) {
+          return common::make_error(common::MemSPrintf("Unsupported RDB record type: %d", static_cast<int>(type)));
+        }
+
+        std::string key;
+        err = reader.ReadString(&key);
+        if (!err) {
+          err = SkipValue(&reader, type);
+        }
+        if (err) {
+          return err;
+        }
+
+        int64_t ttl = -1;
+        if (expire_msec >= 0) {
+          ttl = expire_msec > snapshot_msec ? std::max<int64_t>((expire_msec - snapshot_msec) / 1000, 1) : 0;
+        }
+        aggregator.AddKey(key, type, reader.GetOffset() - record_offset, ttl);
+        expire_msec = -1;
+        break;
+      }
+    }
+
+    if (err) {
+      return err;
+    }
+  }
+}
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
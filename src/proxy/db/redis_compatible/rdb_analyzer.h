@@ -0,0 +1,85 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <array>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <common/error.h>
+
+#include "proxy/db/redis_compatible/rdb_stream.h"
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+struct RdbKeysStats {
+  RdbKeysStats();
+
+  void Add(uint64_t serialized_bytes);
+
+  size_t keys;
+  uint64_t bytes;  // serialized size of key and value in file
+};
+
+struct RdbLargestKey {
+  RdbLargestKey();
+
+  std::string key;
+  std::string type;
+  uint64_t bytes;
+  int64_t ttl;  // seconds, -1 without expire
+};
+
+enum RdbTTLBucket {
+  RDB_TTL_NONE = 0,
+  RDB_TTL_EXPIRED,
+  RDB_TTL_HOUR,
+  RDB_TTL_DAY,
+  RDB_TTL_WEEK,
+  RDB_TTL_MONTH,
+  RDB_TTL_LONGER,
+  RDB_TTL_BUCKETS_COUNT
+};
+
+const char* GetRdbTTLBucketName(RdbTTLBucket bucket);
+
+struct RdbReport {
+  RdbReport();
+
+  int version;
+  uint64_t file_size;
+  RdbKeysStats total;
+  std::map<std::string, RdbKeysStats> namespaces;  // first key segment before separator
+  std::map<std::string, RdbKeysStats> types;
+  std::array<RdbKeysStats, RDB_TTL_BUCKETS_COUNT> ttls;  // relative to snapshot creation time
+  std::vector<RdbLargestKey> largest_keys;               // descending by size
+};
+
+// Single pass over RDB file, values are skipped without decoding so memory use does not depend on file size.
+common::Error AnalyzeRdbFile(const std::string& path,
+                             const std::string& ns_separator,
+                             size_t largest_keys_count,
+                             rdb_progress_callback_t progress,
+                             RdbReport* report) WARN_UNUSED_RESULT;
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,410 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/db/redis_compatible/rdb_stream.h"
+
+#if defined(OS_WIN)
+#include <winsock2.h>
+#else
+#include <errno.h>
+#include <sys/select.h>
+#endif
+
+#include <algorithm>
+#include <vector>
+
+#include <common/convert2string.h>
+#include <common/file_system/file.h>
+#include <common/file_system/file_system.h>
+#include <common/net/socket_tcp.h>
+
+#include "proxy/db/redis_compatible/resp_connection.h"
+
+#define REDIS_PSYNC_COMMAND "PSYNC"
+#define REDIS_SYNC_COMMAND "SYNC"
+#define REDIS_FULLRESYNC_MARKER "+FULLRESYNC"
+#define REDIS_EOF_MARKER_PREFIX "EOF:"
+
+#define RDB_MAGIC "REDIS"
+#define RDB_MAGIC_SIZE 5
+#define RDB_VERSION_SIZE 4
+#define RDB_CHECKSUM_SIZE 8
+#define RDB_CHECKSUM_MIN_VERSION 5
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+namespace {
+
+const size_t kReadChunkSize = 64 * 1024;
+const size_t kMaxLineSize = 1024;
+// master sends a newline every second while BGSAVE runs, silence longer than this means it is gone
+const int kIdleTimeoutMsec = 60 * 1000;
+
+// CRC-64/Jones in reflected form, the same checksum redis writes into RDB trailer
+class Crc64 {
+ public:
+  Crc64() : crc_(0) {}
+
+  void Update(const char* data, size_t size) {
+    static const std::vector<uint64_t> table = MakeTable();
+    const unsigned char* ptr = reinterpret_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+      crc_ = table[(crc_ ^ ptr[i]) & 0xff] ^ (crc_ >> 8);
+    }
+  }
+
+  uint64_t GetValue() const { return crc_; }
+
+ private:
+  static std::vector<uint64_t> MakeTable() {
+    static const uint64_t poly = 0x95ac9329ac4bc9b5ULL;
+    std::vector<uint64_t> table(256);
+    for (uint64_t i = 0; i < table.size(); ++i) {
+      uint64_t crc = i;
+      for (int bit = 0; bit < 8; ++bit) {
+        crc = crc & 1 ? (crc >> 1) ^ poly : crc >> 1;
+      }
+      table[i] = crc;
+    }
+    return table;
+  }
+
+  uint64_t crc_;
+};
+
+class ReplicaConnection {
+ public:
+  ReplicaConnection(const common::net::HostAndPort& host, const core::SSHInfo& ssh_info)
+      : host_(host), ssh_info_(ssh_info), tunnel_(), client_(host), buffer_() {}
+
+  common::Error Connect() {
+    common::net::HostAndPort endpoint = host_;
+    core::SSHInfo ssh_info = ssh_info_;
+    common::Error tunnel_err = RouteThroughSSHTunnel(&endpoint, &ssh_info, &tunnel_);
+    if (tunnel_err) {
+      return tunnel_err;
+    }
+    client_.SetHost(endpoint);
+
+    common::ErrnoError err = client_.Connect();
+    if (err) {
+      return common::make_error_from_errno(err);
+    }
+    return common::Error();
+  }
+
+  common::Error SendCommand(const std::vector<std::string>& argv) {
+    const std::string request = MakeRespCommand(argv);
+    size_t total = 0;
+    while (total < request.size()) {
+      size_t nwrite = 0;
+      common::ErrnoError err = client_.Write(request.data() + total, request.size() - total, &nwrite);
+      if (err) {
+        return common::make_error_from_errno(err);
+      }
+      total += nwrite;
+    }
+    return common::Error();
+  }
+
+  // master sends bare newlines as keepalive while BGSAVE is in progress, they are skipped
+  common::Error ReadReplyLine(std::string* line) {
+    while (true) {
+      size_t pos = buffer_.find('\n');
+      while (pos == std::string::npos) {
+        if (buffer_.size() > kMaxLineSize) {
+          return common::make_error("Invalid replication reply");
+        }
+        common::Error err = Fill();
+        if (err) {
+          return err;
+        }
+        pos = buffer_.find('\n');
+      }
+
+      std::string result = buffer_.substr(0, pos);
+      buffer_.erase(0, pos + 1);
+      if (!result.empty() && result.back() == '\r') {
+        result.pop_back();
+      }
+      if (!result.empty()) {
+        *line = result;
+        return common::Error();
+      }
+    }
+  }
+
+  common::Error ReadPayload(size_t max_size, std::string* data) {
+    if (buffer_.empty()) {
+      common::Error err = Fill();
+      if (err) {
+        return err;
+      }
+    }
+
+    const size_t size = std::min(max_size, buffer_.size());
+    *data = buffer_.substr(0, size);
+    buffer_.erase(0, size);
+    return common::Error();
+  }
+
+ private:
+  common::Error WaitReadable() {
+    const auto fd = client_.GetFd();
+    while (true) {
+      fd_set read_fds;
+      FD_ZERO(&read_fds);
+      FD_SET(fd, &read_fds);
+      struct timeval tv;
+      tv.tv_sec = kIdleTimeoutMsec / 1000;
+      tv.tv_usec = (kIdleTimeoutMsec % 1000) * 1000;
+      const int res = select(static_cast<int>(fd + 1), &read_fds, nullptr, nullptr, &tv);
+      if (res > 0) {
+        return common::Error();
+      }
+      if (res == 0) {
+        return common::make_error("Replication timed out, master is silent");
+      }
+#if !defined(OS_WIN)
+      if (errno == EINTR) {
+        continue;
+      }
+#endif
+      return common::make_error("Can't poll replication connection");
+    }
+  }
+
+  common::Error Fill() {
+    common::Error wait_err = WaitReadable();
+    if (wait_err) {
+      return wait_err;
+    }
+
+    common::char_buffer_t chunk;
+    common::ErrnoError err = client_.ReadToBuffer(&chunk, kReadChunkSize);
+    if (err) {
+      return common::make_error_from_errno(err);
+    }
+    if (chunk.empty()) {
+      return common::make_error("Connection closed by master");
+    }
+    buffer_.append(chunk.as_string());
+    return common::Error();
+  }
+
+  const common::net::HostAndPort host_;
+  const core::SSHInfo ssh_info_;
+  ssh_tunnel_t tunnel_;  // own tunnel when master is behind ssh
+  common::net::SocketGuard<common::net::ClientSocketTcp> client_;
+  std::string buffer_;
+};
+
+common::Error ReadPayloadSize(ReplicaConnection* connection, size_t* size) {
+  std::string line;
+  common::Error err = connection->ReadReplyLine(&line);
+  if (err) {
+    return err;
+  }
+
+  if (line[0] == '-') {
+    return common::make_error(line.substr(1));
+  }
+  if (line[0] != '$') {
+    return common::make_error("Unexpected replication reply: " + line);
+  }
+
+  const std::string size_str = line.substr(1);
+  if (size_str.compare(0, sizeof(REDIS_EOF_MARKER_PREFIX) - 1, REDIS_EOF_MARKER_PREFIX) == 0) {
+    return common::make_error("Diskless replication payload is not supported");
+  }
+
+  size_t result;
+  if (!common::ConvertFromString(size_str, &result)) {
+    return common::make_error("Invalid RDB payload size: " + size_str);
+  }
+
+  *size = result;
+  return common::Error();
+}
+
+common::Error StartReplication(ReplicaConnection* connection, const std::string& password, size_t* size) {
+  if (!password.empty()) {
+    common::Error err = connection->SendCommand(MakeAuthCommand(password));
+    if (err) {
+      return err;
+    }
+
+    std::string line;
+    err = connection->ReadReplyLine(&line);
+    if (err) {
+      return err;
+    }
+    if (line[0] == '-') {
+      return common::make_error(line.substr(1));
+    }
+  }
+
+  // PSYNC with unknown replication id always triggers full resynchronization
+  common::Error err = connection->SendCommand({REDIS_PSYNC_COMMAND, "?", "-1"});
+  if (err) {
+    return err;
+  }
+
+  std::string line;
+  err = connection->ReadReplyLine(&line);
+  if (err) {
+    return err;
+  }
+
+  if (line[0] == '-') {
+    // servers older than 2.8 know only SYNC
+    err = connection->SendCommand({REDIS_SYNC_COMMAND});
+    if (err) {
+      return err;
+    }
+  } else if (line.compare(0, sizeof(REDIS_FULLRESYNC_MARKER) - 1, REDIS_FULLRESYNC_MARKER) != 0) {
+    return common::make_error("Unexpected replication reply: " + line);
+  }
+
+  return ReadPayloadSize(connection, size);
+}
+
+common::Error ValidateRdbHeader(const std::string& header, int* version) {
+  if (header.compare(0, RDB_MAGIC_SIZE, RDB_MAGIC) != 0) {
+    return common::make_error("Invalid RDB magic");
+  }
+
+  int result;
+  if (!common::ConvertFromString(header.substr(RDB_MAGIC_SIZE, RDB_VERSION_SIZE), &result)) {
+    return common::make_error("Invalid RDB version");
+  }
+
+  *version = result;
+  return common::Error();
+}
+
+common::Error ValidateRdbChecksum(const std::string& trailer, uint64_t crc) {
+  uint64_t expected = 0;
+  for (size_t i = 0; i < RDB_CHECKSUM_SIZE; ++i) {
+    expected |= static_cast<uint64_t>(static_cast<unsigned char>(trailer[i])) << (8 * i);
+  }
+
+  // zero checksum means rdbchecksum is disabled on master
+  if (expected != 0 && expected != crc) {
+    return common::make_error("RDB checksum mismatch");
+  }
+  return common::Error();
+}
+
+common::Error TransferRdbPayload(ReplicaConnection* connection,
+                                 size_t size,
+                                 common::file_system::ANSIFile* file,
+                                 rdb_progress_callback_t progress) {
+  if (size < RDB_MAGIC_SIZE + RDB_VERSION_SIZE) {
+    return common::make_error("RDB payload is too small");
+  }
+
+  const size_t checksum_offset = size > RDB_CHECKSUM_SIZE ? size - RDB_CHECKSUM_SIZE : 0;
+  std::string header;
+  std::string trailer;
+  Crc64 crc;
+  size_t transferred = 0;
+  int last_percent = -1;
+  while (transferred < size) {
+    std::string chunk;
+    common::Error err = connection->ReadPayload(std::min(kReadChunkSize, size - transferred), &chunk);
+    if (err) {
+      return err;
+    }
+
+    if (!file->Write(chunk)) {
+      return common::make_error("Can't write RDB file");
+    }
+
+    if (header.size() < RDB_MAGIC_SIZE + RDB_VERSION_SIZE) {
+      header += chunk.substr(0, RDB_MAGIC_SIZE + RDB_VERSION_SIZE - header.size());
+    }
+
+    const size_t crc_part = transferred < checksum_offset ? std::min(chunk.size(), checksum_offset - transferred) : 0;
+    crc.Update(chunk.data(), crc_part);
+    trailer.append(chunk, crc_part, std::string::npos);
+    transferred += chunk.size();
+
+    const int percent = static_cast<int>(transferred * 100 / size);
+    if (percent != last_percent) {
+      last_percent = percent;
+      if (progress && !progress(percent)) {
+        return common::make_error("Backup interrupted");
+      }
+    }
+  }
+
+  int version;
+  common::Error err = ValidateRdbHeader(header, &version);
+  if (err) {
+    return err;
+  }
+
+  if (version < RDB_CHECKSUM_MIN_VERSION || trailer.size() != RDB_CHECKSUM_SIZE) {
+    return common::Error();
+  }
+
+  return ValidateRdbChecksum(trailer, crc.GetValue());
+}
+
+}  // namespace
+
+common::Error StreamRdbSnapshot(const common::net::HostAndPort& host,
+                                const core::SSHInfo& ssh_info,
+                                const std::string& password,
+                                const std::string& path,
+                                rdb_progress_callback_t progress) {
+  ReplicaConnection connection(host, ssh_info);
+  common::Error err = connection.Connect();
+  if (err) {
+    return err;
+  }
+
+  size_t size = 0;
+  err = StartReplication(&connection, password, &size);
+  if (err) {
+    return err;
+  }
+
+  common::file_system::ANSIFile file;
+  common::ErrnoError errn = file.Open(path, "wb");
+  if (errn) {
+    return common::make_error_from_errno(errn);
+  }
+
+  err = TransferRdbPayload(&connection, size, &file, progress);
+  file.Close();
+  if (err) {
+    common::ErrnoError remove_err = common::file_system::remove_file(path);
+    UNUSED(remove_err);
+    return err;
+  }
+
+  return common::Error();
+}
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
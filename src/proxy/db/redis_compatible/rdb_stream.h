@@ -0,0 +1,47 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <functional>
+#include <string>
+
+#include <common/error.h>
+#include <common/net/types.h>
+
+#include <fastonosql/core/ssh_info.h>
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+// called with transferred percents, return false to abort transfer
+typedef std::function<bool(int)> rdb_progress_callback_t;
+
+// Connects to master as a replica and saves RDB payload of full resynchronization into path.
+// Snapshot is made by master in background (BGSAVE), payload is validated by magic and CRC64 trailer.
+// password may be "user password" for ACL users, a master silent for a minute fails the transfer.
+common::Error StreamRdbSnapshot(const common::net::HostAndPort& host,
+                                const core::SSHInfo& ssh_info,
+                                const std::string& password,
+                                const std::string& path,
+                                rdb_progress_callback_t progress) WARN_UNUSED_RESULT;
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,449 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "proxy/db/redis_compatible/resp_connection.h"
+
+#if defined(OS_WIN)
+#include <winsock2.h>
+#else
+#include <errno.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#endif
+
+#include <algorithm>
+#include <utility>
+
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+
+#include <common/convert2string.h>
+
+#define REDIS_AUTH_COMMAND "AUTH"
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+namespace {
+const size_t kReadChunkSize = 64 * 1024;
+const size_t kTlsReadChunkSize = 16 * 1024;  // one TLS record
+const size_t kMaxLineSize = 64 * 1024;
+const size_t kMaxBulkSize = 512 * 1024 * 1024;
+
+// SSL_get_error returns a category, not an ERR code, real reason (certificate, protocol) is in error queue
+std::string GetTlsError(SSL* ssl, int res) {
+  const int category = SSL_get_error(ssl, res);
+  const unsigned long code = ERR_get_error();
+  ERR_clear_error();
+  if (code != 0) {
+    char reason[256];
+    ERR_error_string_n(code, reason, sizeof(reason));
+    return reason;
+  }
+
+  if (category == SSL_ERROR_ZERO_RETURN) {
+    return "Connection closed by server";
+  }
+  if (category == SSL_ERROR_SYSCALL) {
+    return "I/O error";
+  }
+  return "TLS error " + common::ConvertToString(category);
+}
+}  // namespace
+
+std::string MakeRespCommand(const std::vector<std::string>& argv) {
+  std::string result = "*" + common::ConvertToString(argv.size()) + "\r\n";
+  for (const std::string& arg : argv) {
+    result += "$" + common::ConvertToString(arg.size()) + "\r\n" + arg + "\r\n";
+  }
+  return result;
+}
+
+std::vector<std::string> MakeAuthCommand(const std::string& auth) {
+  const size_t space = auth.find(' ');
+  if (space == std::string::npos) {
+    return {REDIS_AUTH_COMMAND, auth};
+  }
+  return {REDIS_AUTH_COMMAND, auth.substr(0, space), auth.substr(space + 1)};
+}
+
+RespReply::RespReply() : type(NIL), str(), integer(0), elements() {}
+
+RespConnection::RespConnection(const common::net::HostAndPort& host) : RespConnection(host, core::SSHInfo()) {}
+
+RespConnection::RespConnection(const common::net::HostAndPort& host, const core::SSHInfo& ssh_info)
+    : host_(host),
+      ssh_info_(ssh_info),
+      tunnel_(),
+      client_(host),
+      ssl_(nullptr),
+      timeout_msec_(0),
+      write_mutex_(),
+      buffer_(),
+      buffer_pos_(0) {}
+
+RespConnection::~RespConnection() {
+  if (ssl_) {
+    SSL_free(ssl_);
+    ssl_ = nullptr;
+  }
+}
+
+common::Error RespConnection::Connect(const std::string& password) {
+  common::Error err = Open();
+  if (err) {
+    return err;
+  }
+
+  return Auth(password);
+}
+
+void RespConnection::SetTimeout(int timeout_msec) {
+  timeout_msec_ = timeout_msec;
+}
+
+common::Error RespConnection::Open() {
+  // tunnel accepts only this connection and is held while it lives
+  common::net::HostAndPort endpoint = host_;
+  core::SSHInfo ssh_info = ssh_info_;
+  common::Error err = RouteThroughSSHTunnel(&endpoint, &ssh_info, &tunnel_);
+  if (err) {
+    return err;
+  }
+  client_.SetHost(endpoint);
+
+  if (timeout_msec_ <= 0) {
+    common::ErrnoError errn = client_.Connect();
+    if (errn) {
+      return common::make_error_from_errno(errn);
+    }
+    return common::Error();
+  }
+
+  struct timeval tv;
+  tv.tv_sec = timeout_msec_ / 1000;
+  tv.tv_usec = (timeout_msec_ % 1000) * 1000;
+  common::ErrnoError errn = client_.Connect(&tv);
+  if (errn) {
+    return common::make_error_from_errno(errn);
+  }
+
+  // blocked read or write fails instead of hanging on silent peer
+  const auto fd = client_.GetFd();
+#if defined(OS_WIN)
+  const DWORD timeout = timeout_msec_;
+  const char* opt = reinterpret_cast<const char*>(&timeout);
+  const int opt_len = sizeof(timeout);
+#else
+  const void* opt = &tv;
+  const socklen_t opt_len = sizeof(tv);
+#endif
+  if (setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, opt, opt_len) != 0 ||
+      setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, opt, opt_len) != 0) {
+    return common::make_error("Can't set connection timeout");
+  }
+  return common::Error();
+}
+
+common::Error RespConnection::StartTls() {
+  if (ssl_) {
+    return common::Error();
+  }
+
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+  const SSL_METHOD* method = TLSv1_2_client_method();
+#else
+  const SSL_METHOD* method = TLS_client_method();
+#endif
+  SSL_CTX* ctx = method ? SSL_CTX_new(method) : nullptr;
+  if (!ctx) {
+    return common::make_error("Can't create TLS context");
+  }
+
+  SSL* ssl = SSL_new(ctx);
+  SSL_CTX_free(ctx);
+  if (!ssl) {
+    return common::make_error("Can't create TLS session");
+  }
+
+  SSL_set_fd(ssl, client_.GetFd());
+  ERR_clear_error();
+  const int res = SSL_connect(ssl);
+  if (res <= 0) {
+    const std::string reason = GetTlsError(ssl, res);
+    SSL_free(ssl);
+    return common::make_error("TLS handshake failed: " + reason);
+  }
+
+  ssl_ = ssl;
+  return common::Error();
+}
+
+common::Error RespConnection::Auth(const std::string& password) {
+  if (password.empty()) {
+    return common::Error();
+  }
+
+  common::Error err = SendCommand(MakeAuthCommand(password));
+  if (err) {
+    return err;
+  }
+
+  RespReply reply;
+  err = ReadReply(&reply);
+  if (err) {
+    return err;
+  }
+  if (reply.type == RespReply::ERROR) {
+    return common::make_error(reply.str);
+  }
+  return common::Error();
+}
+
+common::Error RespConnection::SendCommand(const std::vector<std::string>& argv) {
+  return SendRaw(MakeRespCommand(argv));
+}
+
+common::Error RespConnection::SendRaw(const std::string& request) {
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  size_t total = 0;
+  while (total < request.size()) {
+    if (ssl_) {
+      ERR_clear_error();
+      const int len = SSL_write(ssl_, request.data() + total, static_cast<int>(request.size() - total));
+      if (len <= 0) {
+        return common::make_error(GetTlsError(ssl_, len));
+      }
+      total += len;
+      continue;
+    }
+
+    size_t nwrite = 0;
+    common::ErrnoError err = client_.Write(request.data() + total, request.size() - total, &nwrite);
+    if (err) {
+      return common::make_error_from_errno(err);
+    }
+    total += nwrite;
+  }
+  return common::Error();
+}
+
+common::Error RespConnection::ReadReply(RespReply* reply) {
+  if (!reply) {
+    DNOTREACHED();
+    return common::make_error_inval();
+  }
+
+  std::string line;
+  common::Error err = ReadLine(&line);
+  if (err) {
+    return err;
+  }
+  if (line.empty()) {
+    return common::make_error("Invalid RESP reply");
+  }
+
+  const char prefix = line[0];
+  const std::string value = line.substr(1);
+  RespReply result;
+  if (prefix == '+') {
+    result.type = RespReply::STATUS;
+    result.str = value;
+  } else if (prefix == '-') {
+    result.type = RespReply::ERROR;
+    result.str = value;
+  } else if (prefix == ':') {
+    result.type = RespReply::INTEGER;
+    if (!common::ConvertFromString(value, &result.integer)) {
+      return common::make_error("Invalid RESP integer: " + value);
+    }
+  } else if (prefix == '$' || prefix == '*') {
+    long long size;
+    if (!common::ConvertFromString(value, &size)) {
+      return common::make_error("Invalid RESP length: " + value);
+    }
+
+    if (size < 0) {
+      result.type = RespReply::NIL;
+    } else if (prefix == '$') {
+      if (static_cast<size_t>(size) > kMaxBulkSize) {
+        return common::make_error("RESP bulk string is too large");
+      }
+      result.type = RespReply::BULK;
+      err = ReadBytes(static_cast<size_t>(size), &result.str);
+      if (err) {
+        return err;
+      }
+      std::string crlf;
+      err = ReadBytes(2, &crlf);
+      if (err) {
+        return err;
+      }
+    } else {
+      result.type = RespReply::ARRAY;
+      result.elements.resize(static_cast<size_t>(size));
+      for (RespReply& element : result.elements) {
+        err = ReadReply(&element);
+        if (err) {
+          return err;
+        }
+      }
+    }
+  } else {
+    return common::make_error("Unexpected RESP reply: " + line);
+  }
+
+  *reply = std::move(result);
+  return common::Error();
+}
+
+common::Error RespConnection::ReadLine(std::string* line) {
+  size_t end = buffer_.find("\r\n", buffer_pos_);
+  while (end == std::string::npos) {
+    if (buffer_.size() - buffer_pos_ > kMaxLineSize) {
+      return common::make_error("RESP line is too long");
+    }
+    common::Error err = Fill();
+    if (err) {
+      return err;
+    }
+    end = buffer_.find("\r\n", buffer_pos_);
+  }
+
+  line->assign(buffer_, buffer_pos_, end - buffer_pos_);
+  buffer_pos_ = end + 2;
+  return common::Error();
+}
+
+common::Error RespConnection::ReadLine(size_t max_size, std::string* line, bool* truncated) {
+  *truncated = false;
+  while (true) {
+    const size_t end = buffer_.find("\r\n", buffer_pos_);
+    if (end != std::string::npos) {
+      if (!*truncated) {
+        *truncated = end - buffer_pos_ > max_size;
+        line->assign(buffer_, buffer_pos_, std::min(end - buffer_pos_, max_size));
+      }
+      buffer_pos_ = end + 2;
+      return common::Error();
+    }
+
+    // prefix is kept once, rest is dropped except last byte which may be CR of split CRLF
+    if (buffer_.size() - buffer_pos_ > max_size + 1) {
+      if (!*truncated) {
+        line->assign(buffer_, buffer_pos_, max_size);
+        *truncated = true;
+      }
+      buffer_pos_ = buffer_.size() - 1;
+    }
+
+    common::Error err = Fill();
+    if (err) {
+      return err;
+    }
+  }
+}
+
+common::Error RespConnection::WaitForData(int timeout_msec, bool* ready) {
+  if (!ready) {
+    DNOTREACHED();
+    return common::make_error_inval();
+  }
+
+  // decrypted or not yet parsed bytes are invisible for select
+  if (buffer_pos_ < buffer_.size() || (ssl_ && SSL_pending(ssl_) > 0)) {
+    *ready = true;
+    return common::Error();
+  }
+
+  const auto fd = client_.GetFd();
+  fd_set read_fds;
+  FD_ZERO(&read_fds);
+  FD_SET(fd, &read_fds);
+  struct timeval tv;
+  tv.tv_sec = timeout_msec / 1000;
+  tv.tv_usec = (timeout_msec % 1000) * 1000;
+  const int res = select(static_cast<int>(fd + 1), &read_fds, nullptr, nullptr, &tv);
+  if (res < 0) {
+#if !defined(OS_WIN)
+    if (errno == EINTR) {
+      *ready = false;
+      return common::Error();
+    }
+#endif
+    return common::make_error("Can't poll connection");
+  }
+
+  *ready = res > 0;
+  return common::Error();
+}
+
+void RespConnection::Shutdown() {
+  const auto fd = client_.GetFd();
+#if defined(OS_WIN)
+  shutdown(fd, SD_BOTH);
+#else
+  shutdown(fd, SHUT_RDWR);
+#endif
+}
+
+common::Error RespConnection::ReadBytes(size_t size, std::string* data) {
+  while (buffer_.size() - buffer_pos_ < size) {
+    common::Error err = Fill();
+    if (err) {
+      return err;
+    }
+  }
+
+  *data = buffer_.substr(buffer_pos_, size);
+  buffer_pos_ += size;
+  return common::Error();
+}
+
+common::Error RespConnection::Fill() {
+  // drop consumed prefix only when it dominates, so busy streams are not copied on every read
+  if (buffer_pos_ > buffer_.size() / 2) {
+    buffer_.erase(0, buffer_pos_);
+    buffer_pos_ = 0;
+  }
+
+  if (ssl_) {
+    char chunk[kTlsReadChunkSize];
+    const int len = SSL_read(ssl_, chunk, sizeof(chunk));
+    if (len <= 0) {
+      return common::make_error("Connection closed by server");
+    }
+    buffer_.append(chunk, len);
+    return common::Error();
+  }
+
+  common::char_buffer_t chunk;
+  common::ErrnoError err = client_.ReadToBuffer(&chunk, kReadChunkSize);
+  if (err) {
+    return common::make_error_from_errno(err);
+  }
+  if (chunk.empty()) {
+    return common::make_error("Connection closed by server");
+  }
+  buffer_.append(chunk.as_string());
+  return common::Error();
+}
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
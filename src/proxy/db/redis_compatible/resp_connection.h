@@ -0,0 +1,98 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <common/error.h>
+#include <common/net/socket_tcp.h>
+
+#include "proxy/db/redis_compatible/ssh_tunnel.h"
+
+typedef struct ssl_st SSL;
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+std::string MakeRespCommand(const std::vector<std::string>& argv);
+std::vector<std::string> MakeAuthCommand(const std::string& auth);  // auth is password or "user password" (ACL)
+
+struct RespReply {
+  enum Type { STATUS, ERROR, INTEGER, BULK, NIL, ARRAY };
+
+  RespReply();
+
+  Type type;
+  std::string str;  // status, error or bulk payload
+  long long integer;
+  std::vector<RespReply> elements;
+};
+
+// Plain RESP2 connection which lives outside of driver thread (pub/sub, monitor).
+// Commands may be sent from any thread while another one blocks in ReadReply.
+class RespConnection {
+ public:
+  explicit RespConnection(const common::net::HostAndPort& host);
+  // with valid ssh info Open connects through own tunnel of shared bastion session
+  RespConnection(const common::net::HostAndPort& host, const core::SSHInfo& ssh_info);
+  ~RespConnection();
+
+  // applied by Open to connect, reads and writes, 0 (default) blocks forever as subscribers expect
+  void SetTimeout(int timeout_msec);
+
+  common::Error Connect(const std::string& password) WARN_UNUSED_RESULT;
+  // steps of Connect, called one by one when each of them has to be timed,
+  // unlike plain connection TLS one must not be read and written from different threads
+  common::Error Open() WARN_UNUSED_RESULT;
+  common::Error StartTls() WARN_UNUSED_RESULT;
+  common::Error Auth(const std::string& password) WARN_UNUSED_RESULT;
+
+  // sends already serialized commands in one write, used for pipelining
+  common::Error SendRaw(const std::string& request) WARN_UNUSED_RESULT;
+  common::Error SendCommand(const std::vector<std::string>& argv) WARN_UNUSED_RESULT;
+  common::Error ReadReply(RespReply* reply) WARN_UNUSED_RESULT;
+  // raw reply line without CRLF for line oriented streams (MONITOR), storage of line is reused
+  common::Error ReadLine(std::string* line) WARN_UNUSED_RESULT;
+  // same for streams with unbounded lines, line over max_size is cut to it and its rest is skipped
+  common::Error ReadLine(size_t max_size, std::string* line, bool* truncated) WARN_UNUSED_RESULT;
+  // waits until ReadReply can make progress without blocking, ready is false on timeout
+  common::Error WaitForData(int timeout_msec, bool* ready) WARN_UNUSED_RESULT;
+  // wakes up reader blocked in another thread, socket is closed by destructor
+  void Shutdown();
+
+ private:
+  common::Error ReadBytes(size_t size, std::string* data) WARN_UNUSED_RESULT;
+  common::Error Fill() WARN_UNUSED_RESULT;
+
+  const common::net::HostAndPort host_;
+  const core::SSHInfo ssh_info_;
+  ssh_tunnel_t tunnel_;
+  common::net::SocketGuard<common::net::ClientSocketTcp> client_;
+  SSL* ssl_;
+  int timeout_msec_;
+  std::mutex write_mutex_;
+  std::string buffer_;
+  size_t buffer_pos_;  // consumed prefix of buffer_, compacted lazily
+};
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
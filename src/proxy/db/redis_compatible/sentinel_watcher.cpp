@@ -0,0 +1,283 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "proxy/db/redis_compatible/sentinel_watcher.h"
+
+#include <chrono>
+#include <thread>
+
+#include <QThread>
+
+#include <common/convert2string.h>
+#include <common/qt/logger.h>
+#include <common/time.h>
+
+#include "proxy/db/redis_compatible/resp_connection.h"
+#include "proxy/sentinel/isentinel.h"
+
+#define REDIS_SUBSCRIBE_COMMAND "SUBSCRIBE"
+#define REDIS_PING_COMMAND "PING"
+#define REDIS_SENTINEL_COMMAND "SENTINEL"
+#define REDIS_SENTINEL_MASTERS "MASTERS"
+#define REDIS_SENTINEL_REPLICAS "REPLICAS"
+#define REDIS_SENTINEL_SLAVES "SLAVES"  // before 5.0
+
+#define SENTINEL_SWITCH_MASTER_CHANNEL "+switch-master"
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+namespace {
+
+// flat field/value array of SENTINEL MASTERS/REPLICAS entry
+std::string GetField(const RespReply& entry, const std::string& field) {
+  for (size_t i = 0; i + 1 < entry.elements.size(); i += 2) {
+    if (entry.elements[i].str == field) {
+      return entry.elements[i + 1].str;
+    }
+  }
+  return std::string();
+}
+
+bool GetAddress(const RespReply& entry, common::net::HostAndPort* host) {
+  uint16_t port;
+  const std::string ip = GetField(entry, "ip");
+  if (ip.empty() || !common::ConvertFromString(GetField(entry, "port"), &port)) {
+    return false;
+  }
+
+  *host = common::net::HostAndPort(ip, port);
+  return true;
+}
+
+common::Error Connect(RespConnection* connection, const SentinelEndpoint& endpoint, int timeout_msec) {
+  connection->SetTimeout(timeout_msec);
+  common::Error err = connection->Open();
+  if (err) {
+    return err;
+  }
+
+  if (endpoint.is_ssl) {
+    err = connection->StartTls();
+    if (err) {
+      return err;
+    }
+  }
+
+  return connection->Auth(endpoint.password);
+}
+
+common::Error Execute(RespConnection* connection, const std::vector<std::string>& argv, RespReply* reply) {
+  common::Error err = connection->SendCommand(argv);
+  if (err) {
+    return err;
+  }
+
+  err = connection->ReadReply(reply);
+  if (err) {
+    return err;
+  }
+
+  if (reply->type == RespReply::ERROR) {
+    return common::make_error(reply->str);
+  }
+  return common::Error();
+}
+
+common::Error LoadReplicas(RespConnection* connection, SentinelMaster* master) {
+  RespReply reply;
+  common::Error err = Execute(connection, {REDIS_SENTINEL_COMMAND, REDIS_SENTINEL_REPLICAS, master->name}, &reply);
+  if (err) {
+    err = Execute(connection, {REDIS_SENTINEL_COMMAND, REDIS_SENTINEL_SLAVES, master->name}, &reply);
+    if (err) {
+      return err;
+    }
+  }
+
+  for (const RespReply& entry : reply.elements) {
+    common::net::HostAndPort replica;
+    if (GetAddress(entry, &replica)) {
+      master->replicas.push_back(replica);
+    }
+  }
+  return common::Error();
+}
+
+common::Error LoadTopology(RespConnection* connection, SentinelTopology* topology) {
+  RespReply reply;
+  common::Error err = Execute(connection, {REDIS_SENTINEL_COMMAND, REDIS_SENTINEL_MASTERS}, &reply);
+  if (err) {
+    return err;
+  }
+
+  for (const RespReply& entry : reply.elements) {
+    SentinelMaster master;
+    master.name = GetField(entry, "name");
+    if (master.name.empty() || !GetAddress(entry, &master.master)) {
+      continue;
+    }
+
+    err = LoadReplicas(connection, &master);
+    if (err) {
+      return err;
+    }
+    topology->SetMaster(master);
+  }
+  return common::Error();
+}
+
+}  // namespace
+
+SentinelEndpoint::SentinelEndpoint() : host(), password(), is_ssl(false), ssh_info() {}
+
+SentinelWatcher::SentinelWatcher(const sentinel_endpoints_t& endpoints, QObject* parent)
+    : QObject(parent), endpoints_(endpoints), stopped_(false) {
+  qRegisterMetaType<common::Error>("common::Error");
+  qRegisterMetaType<SentinelTopology>("fastonosql::proxy::SentinelTopology");
+  qRegisterMetaType<SentinelMasterSwitch>("fastonosql::proxy::SentinelMasterSwitch");
+}
+
+void SentinelWatcher::Stop() {
+  stopped_ = true;
+}
+
+void SentinelWatcher::Routine() {
+  if (endpoints_.empty()) {
+    emit Finished(common::make_error("No sentinels to follow"));
+    return;
+  }
+
+  for (size_t i = 0; !stopped_; i = (i + 1) % endpoints_.size()) {
+    common::Error err = Follow(endpoints_[i]);
+    if (err && !stopped_) {
+      LOG_ERROR(err, common::logging::LOG_LEVEL_WARNING, false);  // repeats while all sentinels are down
+      Sleep(retry_interval_msec);
+    }
+  }
+  emit Finished(common::Error());
+}
+
+common::Error SentinelWatcher::Follow(const SentinelEndpoint& endpoint) {
+  RespConnection subscription(endpoint.host, endpoint.ssh_info);
+  common::Error err = Connect(&subscription, endpoint, io_timeout_msec);
+  if (err) {
+    return err;
+  }
+
+  RespReply reply;
+  err = Execute(&subscription, {REDIS_SUBSCRIBE_COMMAND, SENTINEL_SWITCH_MASTER_CHANNEL}, &reply);
+  if (err) {
+    return err;
+  }
+
+  // topology is read after subscription, so switch between them is not lost
+  SentinelTopology topology;
+  {
+    // closed before listening, only subscription stays open
+    RespConnection connection(endpoint.host, endpoint.ssh_info);
+    err = Connect(&connection, endpoint, io_timeout_msec);
+    if (err) {
+      return err;
+    }
+
+    err = LoadTopology(&connection, &topology);
+    if (err) {
+      return err;
+    }
+  }
+  emit TopologyLoaded(topology);
+
+  return Listen(&subscription);
+}
+
+common::Error SentinelWatcher::Listen(RespConnection* subscription) {
+  common::time64_t last_activity = common::time::current_utc_mstime();
+  bool ping_sent = false;
+  while (!stopped_) {
+    bool ready = false;
+    common::Error err = subscription->WaitForData(poll_interval_msec, &ready);
+    if (err) {
+      return err;
+    }
+
+    if (!ready) {
+      if (common::time::current_utc_mstime() - last_activity < keepalive_interval_msec) {
+        continue;
+      }
+      if (ping_sent) {
+        return common::make_error("Sentinel doesn't respond");
+      }
+
+      err = subscription->SendCommand({REDIS_PING_COMMAND});
+      if (err) {
+        return err;
+      }
+      ping_sent = true;
+      last_activity = common::time::current_utc_mstime();
+      continue;
+    }
+
+    RespReply reply;
+    err = subscription->ReadReply(&reply);
+    if (err) {
+      return err;
+    }
+    last_activity = common::time::current_utc_mstime();
+    ping_sent = false;
+
+    // message, channel, payload; subscribed connection answers ping with pong array
+    if (reply.type != RespReply::ARRAY || reply.elements.size() != 3 || reply.elements[0].str != "message" ||
+        reply.elements[1].str != SENTINEL_SWITCH_MASTER_CHANNEL) {
+      continue;
+    }
+
+    SentinelMasterSwitch master_switch;
+    if (ParseSwitchMaster(reply.elements[2].str, &master_switch)) {
+      emit MasterSwitched(master_switch);
+    }
+  }
+  return common::Error();
+}
+
+void SentinelWatcher::Sleep(int msec) {
+  for (int slept = 0; slept < msec && !stopped_; slept += poll_interval_msec) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(poll_interval_msec));
+  }
+}
+
+void WatchSentinel(ISentinel* sentinel, const sentinel_endpoints_t& endpoints) {
+  CHECK(sentinel);
+
+  SentinelWatcher* watcher = new SentinelWatcher(endpoints);
+  QThread* th = new QThread;
+  watcher->moveToThread(th);
+  VERIFY(QObject::connect(th, &QThread::started, watcher, &SentinelWatcher::Routine));
+  VERIFY(QObject::connect(watcher, &SentinelWatcher::TopologyLoaded, sentinel, &ISentinel::UpdateTopology));
+  VERIFY(QObject::connect(watcher, &SentinelWatcher::MasterSwitched, sentinel, &ISentinel::SwitchMaster));
+  // routine blocks without event loop, so stop flag is raised directly from destroying thread
+  VERIFY(QObject::connect(sentinel, &QObject::destroyed, watcher, [watcher]() { watcher->Stop(); },
+                          Qt::DirectConnection));
+  VERIFY(QObject::connect(watcher, &SentinelWatcher::Finished, th, &QThread::quit));
+  VERIFY(QObject::connect(th, &QThread::finished, watcher, &SentinelWatcher::deleteLater));
+  VERIFY(QObject::connect(th, &QThread::finished, th, &QThread::deleteLater));
+  th->start();
+}
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
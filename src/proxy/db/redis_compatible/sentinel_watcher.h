@@ -0,0 +1,91 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include <QObject>
+
+#include <common/error.h>
+#include <common/net/types.h>
+
+#include <fastonosql/core/ssh_info.h>
+
+#include "proxy/sentinel/sentinel_topology.h"
+
+namespace fastonosql {
+namespace proxy {
+class ISentinel;
+namespace redis_compatible {
+
+class RespConnection;
+
+struct SentinelEndpoint {
+  SentinelEndpoint();
+
+  common::net::HostAndPort host;
+  std::string password;
+  bool is_ssl;
+  core::SSHInfo ssh_info;
+};
+
+typedef std::vector<SentinelEndpoint> sentinel_endpoints_t;
+
+// Follows +switch-master notifications of one sentinel at a time, when it goes away next one is
+// taken and topology is loaded again, so failovers which happened meanwhile are not missed.
+// Routine blocks until Stop.
+class SentinelWatcher : public QObject {
+  Q_OBJECT
+
+ public:
+  enum {
+    poll_interval_msec = 500,
+    keepalive_interval_msec = 5000,
+    retry_interval_msec = 2000,
+    io_timeout_msec = 5000  // dead sentinel must not block failover to next one
+  };
+
+  explicit SentinelWatcher(const sentinel_endpoints_t& endpoints, QObject* parent = Q_NULLPTR);
+
+  void Stop();  // thread safe
+
+ Q_SIGNALS:
+  void TopologyLoaded(const fastonosql::proxy::SentinelTopology& topology);
+  void MasterSwitched(const fastonosql::proxy::SentinelMasterSwitch& master_switch);
+  void Finished(common::Error err);
+
+ public Q_SLOTS:
+  void Routine();
+
+ private:
+  common::Error Follow(const SentinelEndpoint& endpoint) WARN_UNUSED_RESULT;
+  common::Error Listen(RespConnection* subscription) WARN_UNUSED_RESULT;
+  void Sleep(int msec);
+
+  const sentinel_endpoints_t endpoints_;
+  std::atomic<bool> stopped_;
+};
+
+// starts watcher on own thread feeding cached topology of sentinel, watcher is stopped with sentinel
+void WatchSentinel(ISentinel* sentinel, const sentinel_endpoints_t& endpoints);
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,723 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "proxy/db/redis_compatible/ssh_tunnel.h"
+
+#if defined(OS_WIN)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <libssh2.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <list>
+#include <map>
+#include <thread>
+#include <vector>
+
+#include <common/net/socket_tcp.h>
+#include <common/time.h>
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+namespace {
+
+#if defined(OS_WIN)
+typedef SOCKET tunnel_socket_t;
+const tunnel_socket_t kInvalidSocket = INVALID_SOCKET;
+void CloseSocket(tunnel_socket_t fd) {
+  closesocket(fd);
+}
+bool IsWouldBlock() {
+  return WSAGetLastError() == WSAEWOULDBLOCK;
+}
+bool SetNonBlocking(tunnel_socket_t fd) {
+  u_long mode = 1;
+  return ioctlsocket(fd, FIONBIO, &mode) == 0;
+}
+#else
+typedef int tunnel_socket_t;
+const tunnel_socket_t kInvalidSocket = -1;
+void CloseSocket(tunnel_socket_t fd) {
+  close(fd);
+}
+bool IsWouldBlock() {
+  return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+}
+bool SetNonBlocking(tunnel_socket_t fd) {
+  const int flags = fcntl(fd, F_GETFL, 0);
+  return flags != -1 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) != -1;
+}
+#endif
+
+const char kLoopbackHost[] = "127.0.0.1";
+const long kPollMsec = 50;
+const size_t kChunkSize = 16 * 1024;
+const size_t kMaxBufferedSize = 256 * 1024;
+const int kKeepAliveIntervalSec = 30;
+
+std::string MakeSessionKey(const core::SSHInfo& ssh_info) {
+  const common::net::HostAndPort host = ssh_info.GetHost();
+  const core::PublicPrivate key = ssh_info.GetKey();
+  return host.GetHost() + ":" + std::to_string(host.GetPort()) + "|" + ssh_info.GetUsername() + "|" +
+         std::to_string(ssh_info.GetAuthMethod()) + "|" + key.private_key_path;
+}
+
+common::Error MakeListener(tunnel_socket_t* out, uint16_t* port) {
+  tunnel_socket_t fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (fd == kInvalidSocket) {
+    return common::make_error("Can't create tunnel listener");
+  }
+
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = 0;
+  socklen_t addr_len = sizeof(addr);
+  if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0 || listen(fd, 1) != 0 ||
+      getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &addr_len) != 0 || !SetNonBlocking(fd)) {
+    CloseSocket(fd);
+    return common::make_error("Can't bind tunnel listener on loopback interface");
+  }
+
+  *out = fd;
+  *port = ntohs(addr.sin_port);
+  return common::Error();
+}
+
+}  // namespace
+
+// Owns ssh transport of one bastion, all libssh2 calls after Open are made from worker thread only.
+class SSHSession {
+ public:
+  explicit SSHSession(const std::string& key);
+  ~SSHSession();
+
+  // expired is set when session went idle before this call, caller may start over with new one
+  common::Error Open(const core::SSHInfo& ssh_info, bool* expired) WARN_UNUSED_RESULT;
+  bool IsClosed() const;
+
+  common::Error AddForward(const common::net::HostAndPort& remote,
+                           uint64_t* lease_id,
+                           common::net::HostAndPort* local) WARN_UNUSED_RESULT;
+  void ReleaseForward(uint64_t lease_id);
+  // blocks until direct-tcpip channel of accepted lease connection is open
+  common::Error WaitForChannel(uint64_t lease_id, int timeout_msec) WARN_UNUSED_RESULT;
+
+ private:
+  // listener waiting for the only connection of lease
+  struct Forward {
+    uint64_t lease_id;
+    common::net::HostAndPort remote;
+    tunnel_socket_t listener;
+    bool released;
+  };
+
+  struct Pipe {
+    uint64_t lease_id;
+    common::net::HostAndPort remote;
+    tunnel_socket_t local;
+    LIBSSH2_CHANNEL* channel;  // nullptr while direct-tcpip request is in progress
+    std::string to_remote;
+    std::string to_local;
+    bool local_eof;
+    bool remote_eof;
+    bool closing;  // local end is closed, channel close waits for server
+  };
+
+  common::Error Handshake(const core::SSHInfo& ssh_info) WARN_UNUSED_RESULT;
+  common::Error MakeSessionError(const std::string& prefix) const;
+
+  void Run();
+  bool ServicePipe(Pipe* pipe, bool may_open, bool* opening, fd_set* rd);
+  bool ClosePipe(Pipe* pipe);
+  void NotifyChannel(uint64_t lease_id, bool opened);
+  void Teardown();  // under open_lock_
+
+  const std::string key_;
+  std::mutex open_lock_;  // handshake and teardown of session_
+  std::atomic<bool> stop_;
+  std::atomic<bool> closed_;
+
+  common::net::ClientSocketTcp socket_;
+  LIBSSH2_SESSION* session_;
+  std::thread worker_;
+
+  std::mutex lock_;
+  std::list<Forward> forwards_;
+  uint64_t next_lease_id_;
+  size_t refs_;  // leases not yet released
+  common::time64_t idle_since_msec_;
+  std::map<uint64_t, bool> channels_;  // lease -> channel opened, until lease is released
+  std::condition_variable channel_cond_;
+
+  std::list<Pipe> pipes_;  // worker thread only
+};
+
+SSHSession::SSHSession(const std::string& key)
+    : key_(key),
+      open_lock_(),
+      stop_(false),
+      closed_(false),
+      socket_(common::net::HostAndPort()),
+      session_(nullptr),
+      worker_(),
+      lock_(),
+      forwards_(),
+      next_lease_id_(0),
+      refs_(0),
+      idle_since_msec_(common::time::current_utc_mstime()),
+      channels_(),
+      channel_cond_(),
+      pipes_() {}
+
+SSHSession::~SSHSession() {
+  stop_ = true;
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+
+  std::lock_guard<std::mutex> lock(open_lock_);
+  Teardown();
+}
+
+bool SSHSession::IsClosed() const {
+  return closed_;
+}
+
+common::Error SSHSession::Open(const core::SSHInfo& ssh_info, bool* expired) {
+  // connections to same bastion wait here for first handshake instead of doing their own,
+  // worker tears session down under same lock, so session_ is never seen half freed
+  std::lock_guard<std::mutex> lock(open_lock_);
+  *expired = false;
+  if (closed_) {
+    *expired = worker_.joinable();  // handshake succeeded once, so it is idle timeout or lost bastion
+    return common::make_error("SSH session closed");
+  }
+
+  if (session_) {
+    return common::Error();
+  }
+
+  common::Error err = Handshake(ssh_info);
+  if (err) {
+    Teardown();
+    closed_ = true;
+    return err;
+  }
+
+  libssh2_keepalive_config(session_, 1, kKeepAliveIntervalSec);
+  libssh2_session_set_blocking(session_, 0);
+  worker_ = std::thread(&SSHSession::Run, this);
+  return common::Error();
+}
+
+common::Error SSHSession::Handshake(const core::SSHInfo& ssh_info) {
+  common::net::ClientSocketTcp socket(ssh_info.GetHost());
+  common::ErrnoError errn = socket.Connect();
+  if (errn) {
+    return common::make_error_from_errno(errn);
+  }
+  socket_.SetInfo(socket.GetInfo());
+
+  session_ = libssh2_session_init();
+  if (!session_) {
+    return common::make_error("Can't initialize SSH session");
+  }
+
+  libssh2_session_set_blocking(session_, 1);
+  if (libssh2_session_handshake(session_, socket_.GetFd()) != 0) {
+    return MakeSessionError("SSH handshake failed");
+  }
+
+  const std::string user_name = ssh_info.GetUsername();
+  int rc = 0;
+  if (ssh_info.GetAuthMethod() == core::SSHInfo::PUBLICKEY) {
+    const core::PublicPrivate key = ssh_info.GetKey();
+    const std::string passphrase = ssh_info.GetPassPharse();
+    rc = libssh2_userauth_publickey_fromfile(session_, user_name.c_str(),
+                                             key.use_public_key ? key.public_key_path.c_str() : nullptr,
+                                             key.private_key_path.c_str(), passphrase.c_str());
+  } else {
+    const std::string password = ssh_info.GetRuntimePassword();
+    rc = libssh2_userauth_password(session_, user_name.c_str(), password.c_str());
+  }
+
+  if (rc != 0) {
+    return MakeSessionError("SSH authentication failed");
+  }
+
+  return common::Error();
+}
+
+common::Error SSHSession::MakeSessionError(const std::string& prefix) const {
+  char* message = nullptr;
+  libssh2_session_last_error(session_, &message, nullptr, 0);
+  if (!message) {
+    return common::make_error(prefix);
+  }
+
+  return common::make_error(prefix + ": " + message);
+}
+
+common::Error SSHSession::AddForward(const common::net::HostAndPort& remote,
+                                     uint64_t* lease_id,
+                                     common::net::HostAndPort* local) {
+  std::lock_guard<std::mutex> lock(lock_);
+  if (closed_) {
+    return common::make_error("SSH session closed");
+  }
+
+  // every lease gets own port, other local processes can't reuse it once its connection is accepted
+  Forward forward;
+  forward.lease_id = next_lease_id_++;
+  forward.remote = remote;
+  forward.released = false;
+  uint16_t port = 0;
+  common::Error err = MakeListener(&forward.listener, &port);
+  if (err) {
+    return err;
+  }
+
+  forwards_.push_back(forward);
+  refs_++;
+  *lease_id = forward.lease_id;
+  *local = common::net::HostAndPort(kLoopbackHost, port);
+  return common::Error();
+}
+
+void SSHSession::ReleaseForward(uint64_t lease_id) {
+  // listener is closed by worker, it may be waiting on it right now
+  std::lock_guard<std::mutex> lock(lock_);
+  auto it = std::find_if(forwards_.begin(), forwards_.end(),
+                         [lease_id](const Forward& forward) { return forward.lease_id == lease_id; });
+  if (it != forwards_.end()) {  // otherwise connection is already accepted or session closed
+    it->released = true;
+  }
+  channels_.erase(lease_id);
+
+  if (refs_ == 0) {
+    DNOTREACHED();
+    return;
+  }
+
+  refs_--;
+  if (refs_ == 0) {
+    idle_since_msec_ = common::time::current_utc_mstime();
+  }
+}
+
+common::Error SSHSession::WaitForChannel(uint64_t lease_id, int timeout_msec) {
+  std::unique_lock<std::mutex> lock(lock_);
+  const bool done = channel_cond_.wait_for(lock, std::chrono::milliseconds(timeout_msec), [this, lease_id]() {
+    return closed_ || channels_.find(lease_id) != channels_.end();
+  });
+  if (!done) {
+    return common::make_error("SSH channel open timed out");
+  }
+
+  const auto it = channels_.find(lease_id);
+  if (it == channels_.end()) {
+    return common::make_error("SSH session closed");
+  }
+
+  if (!it->second) {
+    return common::make_error("SSH channel open failed");
+  }
+  return common::Error();
+}
+
+void SSHSession::NotifyChannel(uint64_t lease_id, bool opened) {
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    channels_[lease_id] = opened;
+  }
+  channel_cond_.notify_all();
+}
+
+void SSHSession::Run() {
+  const tunnel_socket_t ssh_fd = socket_.GetFd();
+  while (!stop_) {
+    std::vector<Forward> forwards;
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      for (auto it = forwards_.begin(); it != forwards_.end();) {
+        if (it->released) {
+          CloseSocket(it->listener);
+          it = forwards_.erase(it);
+          continue;
+        }
+        forwards.push_back(*it);
+        ++it;
+      }
+
+      if (refs_ == 0 && pipes_.empty() &&
+          common::time::current_utc_mstime() - idle_since_msec_ >= SSHTunnelManager::idle_timeout_msec) {
+        closed_ = true;
+        break;
+      }
+    }
+
+    fd_set rd, wr;
+    FD_ZERO(&rd);
+    FD_ZERO(&wr);
+    tunnel_socket_t max_fd = ssh_fd;
+    FD_SET(ssh_fd, &rd);
+    if (libssh2_session_block_directions(session_) & LIBSSH2_SESSION_BLOCK_OUTBOUND) {
+      FD_SET(ssh_fd, &wr);
+    }
+    for (const Forward& forward : forwards) {
+      FD_SET(forward.listener, &rd);
+      max_fd = std::max(max_fd, forward.listener);
+    }
+    for (const Pipe& pipe : pipes_) {
+      if (pipe.closing) {
+        continue;
+      }
+      if (!pipe.local_eof && pipe.to_remote.size() < kMaxBufferedSize) {
+        FD_SET(pipe.local, &rd);
+      }
+      if (!pipe.to_local.empty()) {
+        FD_SET(pipe.local, &wr);
+      }
+      max_fd = std::max(max_fd, pipe.local);
+    }
+
+    struct timeval tv = {0, kPollMsec * 1000};
+    if (select(static_cast<int>(max_fd + 1), &rd, &wr, nullptr, &tv) < 0 && !IsWouldBlock()) {
+      break;
+    }
+
+    for (const Forward& forward : forwards) {
+      if (!FD_ISSET(forward.listener, &rd)) {
+        continue;
+      }
+
+      tunnel_socket_t local = accept(forward.listener, nullptr, nullptr);
+      if (local == kInvalidSocket) {
+        continue;
+      }
+
+      // lease is served, nobody else gets through this port
+      {
+        std::lock_guard<std::mutex> lock(lock_);
+        const uint64_t lease_id = forward.lease_id;
+        forwards_.remove_if([lease_id](const Forward& item) { return item.lease_id == lease_id; });
+      }
+      CloseSocket(forward.listener);
+
+      if (!SetNonBlocking(local)) {
+        CloseSocket(local);
+        continue;
+      }
+      pipes_.push_back(
+          Pipe{forward.lease_id, forward.remote, local, nullptr, std::string(), std::string(), false, false, false});
+    }
+
+    // libssh2 keeps state of only one pending channel open, so requests are served in accept order
+    bool opening = false;
+    for (auto it = pipes_.begin(); it != pipes_.end();) {
+      if (!it->closing && !ServicePipe(&*it, !opening, &opening, &rd)) {
+        it->closing = true;
+      }
+      if (it->closing && ClosePipe(&*it)) {
+        it = pipes_.erase(it);
+        continue;
+      }
+      ++it;
+    }
+
+    int next_keepalive_sec = 0;
+    if (libssh2_keepalive_send(session_, &next_keepalive_sec) != 0) {
+      break;
+    }
+  }
+
+  {
+    // under lock so that AddForward can't slip a listener in after cleanup
+    std::lock_guard<std::mutex> lock(lock_);
+    closed_ = true;
+    for (const Forward& forward : forwards_) {
+      CloseSocket(forward.listener);
+    }
+    forwards_.clear();
+  }
+  channel_cond_.notify_all();
+
+  // channels which are still open are freed together with session
+  for (const Pipe& pipe : pipes_) {
+    if (pipe.local != kInvalidSocket) {
+      CloseSocket(pipe.local);
+    }
+  }
+  pipes_.clear();
+
+  std::lock_guard<std::mutex> lock(open_lock_);
+  Teardown();
+}
+
+bool SSHSession::ServicePipe(Pipe* pipe, bool may_open, bool* opening, fd_set* rd) {
+  if (!pipe->channel) {
+    if (!may_open) {
+      return true;
+    }
+
+    const common::net::HostAndPort& remote = pipe->remote;
+    pipe->channel = libssh2_channel_direct_tcpip_ex(session_, remote.GetHost().c_str(), remote.GetPort(),
+                                                    kLoopbackHost, 0);
+    if (!pipe->channel) {
+      if (libssh2_session_last_errno(session_) == LIBSSH2_ERROR_EAGAIN) {
+        *opening = true;
+        return true;
+      }
+      NotifyChannel(pipe->lease_id, false);
+      return false;
+    }
+    NotifyChannel(pipe->lease_id, true);
+  }
+
+  char buff[kChunkSize];
+  if (FD_ISSET(pipe->local, rd)) {
+    const auto nread = recv(pipe->local, buff, sizeof(buff), 0);
+    if (nread > 0) {
+      pipe->to_remote.append(buff, nread);
+    } else if (nread == 0) {
+      pipe->local_eof = true;
+    } else if (!IsWouldBlock()) {
+      return false;
+    }
+  }
+
+  while (!pipe->to_remote.empty()) {
+    const ssize_t nwrite = libssh2_channel_write(pipe->channel, pipe->to_remote.data(), pipe->to_remote.size());
+    if (nwrite == LIBSSH2_ERROR_EAGAIN) {
+      break;
+    }
+    if (nwrite < 0) {
+      return false;
+    }
+    pipe->to_remote.erase(0, nwrite);
+  }
+
+  while (!pipe->remote_eof && pipe->to_local.size() < kMaxBufferedSize) {
+    const ssize_t nread = libssh2_channel_read(pipe->channel, buff, sizeof(buff));
+    if (nread == LIBSSH2_ERROR_EAGAIN) {
+      break;
+    }
+    if (nread < 0) {
+      return false;
+    }
+    if (nread == 0) {
+      pipe->remote_eof = libssh2_channel_eof(pipe->channel) != 0;
+      break;
+    }
+    pipe->to_local.append(buff, nread);
+  }
+
+  if (!pipe->to_local.empty()) {
+    const auto nwrite = send(pipe->local, pipe->to_local.data(), static_cast<int>(pipe->to_local.size()), 0);
+    if (nwrite > 0) {
+      pipe->to_local.erase(0, nwrite);
+    } else if (!IsWouldBlock()) {
+      return false;
+    }
+  }
+
+  // database clients never half-close, so end of either side ends the pipe once pending data is flushed
+  if (pipe->local_eof && pipe->to_remote.empty()) {
+    return false;
+  }
+  return !(pipe->remote_eof && pipe->to_local.empty());
+}
+
+bool SSHSession::ClosePipe(Pipe* pipe) {
+  if (pipe->local != kInvalidSocket) {
+    CloseSocket(pipe->local);
+    pipe->local = kInvalidSocket;
+  }
+
+  if (!pipe->channel) {
+    return true;
+  }
+
+  // both wait for server, worker comes back on next round instead of stalling other channels
+  if (libssh2_channel_close(pipe->channel) == LIBSSH2_ERROR_EAGAIN) {
+    return false;
+  }
+  if (libssh2_channel_free(pipe->channel) == LIBSSH2_ERROR_EAGAIN) {
+    return false;
+  }
+
+  pipe->channel = nullptr;
+  return true;
+}
+
+void SSHSession::Teardown() {
+  if (session_) {
+    libssh2_session_set_blocking(session_, 1);
+    libssh2_session_disconnect(session_, "Normal Shutdown");
+    libssh2_session_free(session_);
+    session_ = nullptr;
+  }
+
+  if (socket_.IsValid()) {
+    socket_.Disconnect();
+  }
+}
+
+SSHTunnel::SSHTunnel(std::shared_ptr<SSHSession> session,
+                     uint64_t lease_id,
+                     const common::net::HostAndPort& remote,
+                     const common::net::HostAndPort& local)
+    : session_(session), lease_id_(lease_id), remote_(remote), local_(local) {}
+
+SSHTunnel::~SSHTunnel() {
+  session_->ReleaseForward(lease_id_);
+}
+
+common::net::HostAndPort SSHTunnel::GetLocalHost() const {
+  return local_;
+}
+
+common::net::HostAndPort SSHTunnel::GetRemoteHost() const {
+  return remote_;
+}
+
+common::Error SSHTunnel::WaitForChannel(int timeout_msec) const {
+  return session_->WaitForChannel(lease_id_, timeout_msec);
+}
+
+SSHTunnelManager::SSHTunnelManager() : lock_(), sessions_() {
+  libssh2_init(0);
+}
+
+SSHTunnelManager::~SSHTunnelManager() {
+  sessions_.clear();
+  libssh2_exit();
+}
+
+common::Error SSHTunnelManager::Acquire(const core::SSHInfo& ssh_info,
+                                        const common::net::HostAndPort& remote,
+                                        ssh_tunnel_t* tunnel) {
+  if (!tunnel || !ssh_info.IsValid()) {
+    DNOTREACHED();
+    return common::make_error_inval();
+  }
+
+  const std::string key = MakeSessionKey(ssh_info);
+  // second attempt covers session which went idle between lookup and open or forward
+  common::Error err;
+  for (size_t attempt = 0; attempt < 2; ++attempt) {
+    std::shared_ptr<SSHSession> session;
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      auto it = sessions_.find(key);
+      if (it == sessions_.end() || it->second->IsClosed()) {
+        session = std::make_shared<SSHSession>(key);
+        sessions_[key] = session;
+      } else {
+        session = it->second;
+      }
+    }
+
+    bool expired = false;
+    err = session->Open(ssh_info, &expired);
+    if (err) {
+      {
+        std::lock_guard<std::mutex> lock(lock_);
+        auto it = sessions_.find(key);
+        if (it != sessions_.end() && it->second == session) {
+          sessions_.erase(it);
+        }
+      }
+      if (expired) {
+        continue;
+      }
+      return err;
+    }
+
+    uint64_t lease_id = 0;
+    common::net::HostAndPort local;
+    err = session->AddForward(remote, &lease_id, &local);
+    if (!err) {
+      *tunnel = ssh_tunnel_t(new SSHTunnel(session, lease_id, remote, local));
+      return common::Error();
+    }
+  }
+
+  return err;
+}
+
+bool SSHTunnelManager::HasSession(const core::SSHInfo& ssh_info) {
+  std::lock_guard<std::mutex> lock(lock_);
+  const auto it = sessions_.find(MakeSessionKey(ssh_info));
+  return it != sessions_.end() && !it->second->IsClosed();
+}
+
+size_t SSHTunnelManager::GetSessionsCount() {
+  std::lock_guard<std::mutex> lock(lock_);
+  size_t count = 0;
+  for (const auto& session : sessions_) {
+    if (!session.second->IsClosed()) {
+      count++;
+    }
+  }
+  return count;
+}
+
+common::Error RouteThroughSSHTunnel(common::net::HostAndPort* host, core::SSHInfo* ssh_info, ssh_tunnel_t* tunnel) {
+  if (!host || !ssh_info || !tunnel) {
+    DNOTREACHED();
+    return common::make_error_inval();
+  }
+
+  if (!ssh_info->IsValid()) {
+    tunnel->reset();
+    return common::Error();
+  }
+
+  ssh_tunnel_t acquired;
+  common::Error err = SSHTunnelManager::GetInstance().Acquire(*ssh_info, *host, &acquired);
+  if (err) {
+    return err;
+  }
+
+  *tunnel = acquired;
+  *host = acquired->GetLocalHost();
+  *ssh_info = core::SSHInfo();
+  return common::Error();
+}
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,94 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <common/error.h>
+#include <common/net/types.h>
+#include <common/patterns/singleton_pattern.h>
+
+#include <fastonosql/core/ssh_info.h>
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+class SSHSession;
+
+// Loopback endpoint for exactly one connection through shared ssh session, listener is closed as soon as
+// that connection is accepted, so every connection acquires own tunnel. Lease is released with last reference,
+// accepted connection keeps its channel until it is closed.
+class SSHTunnel {
+ public:
+  ~SSHTunnel();
+
+  common::net::HostAndPort GetLocalHost() const;
+  common::net::HostAndPort GetRemoteHost() const;
+  // called after connecting to local host, returns once bastion has opened channel to remote host
+  common::Error WaitForChannel(int timeout_msec) const WARN_UNUSED_RESULT;
+
+ private:
+  friend class SSHTunnelManager;
+  SSHTunnel(std::shared_ptr<SSHSession> session,
+            uint64_t lease_id,
+            const common::net::HostAndPort& remote,
+            const common::net::HostAndPort& local);
+
+  const std::shared_ptr<SSHSession> session_;
+  const uint64_t lease_id_;
+  const common::net::HostAndPort remote_;
+  const common::net::HostAndPort local_;
+};
+
+typedef std::shared_ptr<SSHTunnel> ssh_tunnel_t;
+
+// Keeps one authenticated session per bastion (host, port, user, key), every database connection
+// gets own direct-tcpip channel inside of it, so only first connection pays for key exchange.
+// Sessions without tunnels are closed after idle timeout.
+class SSHTunnelManager : public common::patterns::LazySingleton<SSHTunnelManager> {
+ public:
+  friend class common::patterns::LazySingleton<SSHTunnelManager>;
+  enum { idle_timeout_msec = 60000 };
+
+  common::Error Acquire(const core::SSHInfo& ssh_info,
+                        const common::net::HostAndPort& remote,
+                        ssh_tunnel_t* tunnel) WARN_UNUSED_RESULT;
+  bool HasSession(const core::SSHInfo& ssh_info);
+  size_t GetSessionsCount();
+
+ private:
+  SSHTunnelManager();
+  ~SSHTunnelManager();
+
+  std::mutex lock_;
+  std::map<std::string, std::shared_ptr<SSHSession>> sessions_;
+};
+
+// if ssh is configured replaces host with local end of shared tunnel and resets ssh info,
+// otherwise leaves arguments untouched and releases tunnel
+common::Error RouteThroughSSHTunnel(common::net::HostAndPort* host,
+                                    core::SSHInfo* ssh_info,
+                                    ssh_tunnel_t* tunnel) WARN_UNUSED_RESULT;
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,215 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "proxy/db/redis_compatible/subscriber.h"
+
+#include <algorithm>
+#include <utility>
+
+#define REDIS_SUBSCRIBE_COMMAND "SUBSCRIBE"
+#define REDIS_PSUBSCRIBE_COMMAND "PSUBSCRIBE"
+#define REDIS_UNSUBSCRIBE_COMMAND "UNSUBSCRIBE"
+#define REDIS_PUNSUBSCRIBE_COMMAND "PUNSUBSCRIBE"
+
+#define REDIS_MESSAGE_KIND "message"
+#define REDIS_PMESSAGE_KIND "pmessage"
+#define REDIS_UNSUBSCRIBE_KIND "unsubscribe"
+#define REDIS_PUNSUBSCRIBE_KIND "punsubscribe"
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+namespace {
+size_t RoundUpToPowerOfTwo(size_t value) {
+  size_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+}  // namespace
+
+PubSubMessage::PubSubMessage() : channel(), pattern(), payload(), payload_size(0), received_msec(0) {}
+
+PubSubRingBuffer::PubSubRingBuffer(size_t capacity)
+    : slots_(RoundUpToPowerOfTwo(capacity)), mask_(slots_.size() - 1), head_(0), tail_(0), dropped_(0) {}
+
+size_t PubSubRingBuffer::GetCapacity() const {
+  return slots_.size();
+}
+
+uint64_t PubSubRingBuffer::GetDroppedCount() const {
+  return dropped_.load(std::memory_order_relaxed);
+}
+
+void PubSubRingBuffer::Push(PubSubMessage* message) {
+  const size_t head = head_.load(std::memory_order_relaxed);
+  if (head - tail_.load(std::memory_order_acquire) == slots_.size()) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  slots_[head & mask_] = std::move(*message);
+  head_.store(head + 1, std::memory_order_release);
+}
+
+size_t PubSubRingBuffer::Pop(size_t max_count, std::vector<PubSubMessage>* messages) {
+  const size_t tail = tail_.load(std::memory_order_relaxed);
+  const size_t available = head_.load(std::memory_order_acquire) - tail;
+  const size_t count = std::min(available, max_count);
+  for (size_t i = 0; i < count; ++i) {
+    messages->push_back(std::move(slots_[(tail + i) & mask_]));
+  }
+  tail_.store(tail + count, std::memory_order_release);
+  return count;
+}
+
+PubSubChannelStats::PubSubChannelStats() : messages(0), bytes(0) {}
+
+Subscriber::Subscriber(const common::net::HostAndPort& host,
+                       const core::SSHInfo& ssh_info,
+                       const std::string& password,
+                       size_t buffer_capacity)
+    : connection_(host, ssh_info),
+      password_(password),
+      messages_(buffer_capacity),
+      stopped_(false),
+      stats_mutex_(),
+      stats_() {}
+
+common::Error Subscriber::Connect() {
+  return connection_.Connect(password_);
+}
+
+common::Error Subscriber::Subscribe(const std::vector<std::string>& channels) {
+  if (channels.empty()) {
+    return common::Error();
+  }
+
+  std::vector<std::string> argv = {REDIS_SUBSCRIBE_COMMAND};
+  argv.insert(argv.end(), channels.begin(), channels.end());
+  return connection_.SendCommand(argv);
+}
+
+common::Error Subscriber::PSubscribe(const std::vector<std::string>& patterns) {
+  if (patterns.empty()) {
+    return common::Error();
+  }
+
+  std::vector<std::string> argv = {REDIS_PSUBSCRIBE_COMMAND};
+  argv.insert(argv.end(), patterns.begin(), patterns.end());
+  return connection_.SendCommand(argv);
+}
+
+common::Error Subscriber::Stop() {
+  stopped_ = true;
+  common::Error err = connection_.SendCommand({REDIS_UNSUBSCRIBE_COMMAND});
+  if (!err) {
+    err = connection_.SendCommand({REDIS_PUNSUBSCRIBE_COMMAND});
+  }
+  if (err) {
+    connection_.Shutdown();  // Run must not wait for confirmation which never comes
+  }
+  return err;
+}
+
+bool Subscriber::IsStopped() const {
+  return stopped_;
+}
+
+common::Error Subscriber::Run() {
+  bool finished = false;
+  while (!finished) {
+    RespReply reply;
+    common::Error err = connection_.ReadReply(&reply);
+    if (err) {
+      return stopped_ ? common::Error() : err;
+    }
+
+    err = HandleReply(reply, &finished);
+    if (err) {
+      return err;
+    }
+  }
+  return common::Error();
+}
+
+size_t Subscriber::PopMessages(size_t max_count, std::vector<PubSubMessage>* messages) {
+  if (!messages) {
+    DNOTREACHED();
+    return 0;
+  }
+
+  return messages_.Pop(max_count, messages);
+}
+
+pub_sub_stats_t Subscriber::GetStats() const {
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  return stats_;
+}
+
+uint64_t Subscriber::GetDroppedCount() const {
+  return messages_.GetDroppedCount();
+}
+
+common::Error Subscriber::HandleReply(const RespReply& reply, bool* finished) {
+  if (reply.type == RespReply::ERROR) {
+    return common::make_error(reply.str);
+  }
+
+  if (reply.type != RespReply::ARRAY || reply.elements.size() < 3) {
+    return common::make_error("Unexpected pub/sub reply");
+  }
+
+  const std::string& kind = reply.elements[0].str;
+  PubSubMessage message;
+  if (kind == REDIS_MESSAGE_KIND) {
+    message.channel = reply.elements[1].str;
+    message.payload = reply.elements[2].str;
+  } else if (kind == REDIS_PMESSAGE_KIND && reply.elements.size() == 4) {
+    message.pattern = reply.elements[1].str;
+    message.channel = reply.elements[2].str;
+    message.payload = reply.elements[3].str;
+  } else {
+    // subscription confirmations carry number of remaining subscriptions
+    if ((kind == REDIS_UNSUBSCRIBE_KIND || kind == REDIS_PUNSUBSCRIBE_KIND) && reply.elements[2].integer == 0) {
+      *finished = stopped_;
+    }
+    return common::Error();
+  }
+
+  message.payload_size = message.payload.size();
+  if (message.payload.size() > payload_preview_size) {
+    message.payload.resize(payload_preview_size);
+  }
+  message.received_msec = common::time::current_utc_mstime();
+  Account(message.channel, message.payload_size);
+  messages_.Push(&message);
+  return common::Error();
+}
+
+void Subscriber::Account(const std::string& channel, size_t bytes) {
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  PubSubChannelStats& stats = stats_[channel];
+  stats.messages++;
+  stats.bytes += bytes;
+}
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
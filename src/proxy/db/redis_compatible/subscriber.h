@@ -0,0 +1,116 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <common/time.h>
+
+#include "proxy/db/redis_compatible/resp_connection.h"
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+struct PubSubMessage {
+  PubSubMessage();
+
+  std::string channel;
+  std::string pattern;  // empty for plain SUBSCRIBE
+  std::string payload;  // truncated to preview size
+  size_t payload_size;
+  common::time64_t received_msec;
+};
+
+// Fixed size single producer/single consumer queue, producer never waits:
+// when consumer falls behind new messages are dropped and counted.
+class PubSubRingBuffer {
+ public:
+  explicit PubSubRingBuffer(size_t capacity);  // rounded up to power of two
+
+  size_t GetCapacity() const;
+  uint64_t GetDroppedCount() const;
+
+  void Push(PubSubMessage* message);  // producer thread, message is moved in
+  size_t Pop(size_t max_count, std::vector<PubSubMessage>* messages);  // consumer thread
+
+ private:
+  std::vector<PubSubMessage> slots_;
+  const size_t mask_;
+  std::atomic<size_t> head_;  // next slot to write, advanced by producer
+  std::atomic<size_t> tail_;  // next slot to read, advanced by consumer
+  std::atomic<uint64_t> dropped_;
+};
+
+struct PubSubChannelStats {
+  PubSubChannelStats();
+
+  uint64_t messages;
+  uint64_t bytes;
+};
+
+typedef std::map<std::string, PubSubChannelStats> pub_sub_stats_t;
+
+// Dedicated subscriber connection: Run blocks on receive thread and fills ring buffer,
+// consumer drains it in batches. Subscriptions may be changed from any thread.
+class Subscriber {
+ public:
+  enum { default_buffer_capacity = 8192, payload_preview_size = 1024 };
+
+  Subscriber(const common::net::HostAndPort& host,
+             const core::SSHInfo& ssh_info,
+             const std::string& password,
+             size_t buffer_capacity = default_buffer_capacity);
+
+  common::Error Connect() WARN_UNUSED_RESULT;
+  common::Error Subscribe(const std::vector<std::string>& channels) WARN_UNUSED_RESULT;
+  common::Error PSubscribe(const std::vector<std::string>& patterns) WARN_UNUSED_RESULT;
+  // drops all subscriptions, Run returns once server confirms it,
+  // connection is shut down when unsubscribe can't be sent (not connected yet or broken)
+  common::Error Stop() WARN_UNUSED_RESULT;
+  bool IsStopped() const;
+
+  common::Error Run() WARN_UNUSED_RESULT;
+
+  size_t PopMessages(size_t max_count, std::vector<PubSubMessage>* messages);
+  pub_sub_stats_t GetStats() const;  // totals since connect, keyed by channel
+  uint64_t GetDroppedCount() const;
+
+ private:
+  common::Error HandleReply(const RespReply& reply, bool* finished) WARN_UNUSED_RESULT;
+  void Account(const std::string& channel, size_t bytes);
+
+  RespConnection connection_;
+  const std::string password_;
+  PubSubRingBuffer messages_;
+  std::atomic<bool> stopped_;
+
+  mutable std::mutex stats_mutex_;
+  pub_sub_stats_t stats_;
+};
+
+typedef std::shared_ptr<Subscriber> SubscriberSPtr;
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
@@ -18,6 +18,20 @@
 
 #include "proxy/db/rocksdb/driver.h"
 
+#include <algorithm>
+#include <functional>
+#include <memory>
+
+#include <QDir>
+
+#include <rocksdb/db.h>
+#include <rocksdb/utilities/backupable_db.h>
+#include <rocksdb/utilities/options_util.h>
+#include <rocksdb/write_batch.h>
+
+#include <common/convert2string.h>
+#include <common/time.h>
+
 #include <fastonosql/core/db/rocksdb/db_connection.h>
 
 #include "proxy/command/command.h"
@@ -25,9 +39,200 @@
 #include "proxy/db/rocksdb/command.h"
 #include "proxy/db/rocksdb/connection_settings.h"
 
+#define ROCKSDB_BACKUP_META_DIR "meta"
+#define ROCKSDB_BROWSE_DIR_PREFIX "fastonosql_rocksdb_restored_"
+#define ROCKSDB_TEMP_SUFFIX ".tmp"
+#define ROCKSDB_BACKUP_BATCH_SIZE 1000
+
 namespace fastonosql {
 namespace proxy {
 namespace rocksdb {
+namespace {
+
+common::Error MakeError(const ::rocksdb::Status& status) {
+  return common::make_error(status.ToString());
+}
+
+bool IsBackupEngineDir(const std::string& path) {
+  return ::rocksdb::Env::Default()->FileExists(path + "/" ROCKSDB_BACKUP_META_DIR).ok();
+}
+
+// Opens the db with the options and column families recorded in its OPTIONS file.
+class NativeDB {
+ public:
+  NativeDB() : db_(nullptr), options_(), cfs_(), handles_() {}
+  ~NativeDB() {
+    if (db_) {
+      for (auto* handle : handles_) {
+        db_->DestroyColumnFamilyHandle(handle);
+      }
+      delete db_;
+    }
+  }
+
+  // read-only instance takes no lock, so it lives next to the connection which holds the db
+  common::Error Open(const std::string& path, bool read_only) {
+    ::rocksdb::Status st = ::rocksdb::LoadLatestOptions(path, ::rocksdb::Env::Default(), &options_, &cfs_, true);
+    if (!st.ok()) {
+      return MakeError(st);
+    }
+
+    if (!read_only) {
+      st = ::rocksdb::DB::Open(options_, path, cfs_, &handles_, &db_);
+    } else {
+      options_.max_open_files = -1;  // sst files removed by compaction of the connection stay readable
+      st = ::rocksdb::DB::OpenForReadOnly(options_, path, cfs_, &handles_, &db_);
+    }
+    if (!st.ok()) {
+      return MakeError(st);
+    }
+    return common::Error();
+  }
+
+  // empty db with the same options and column families as source
+  common::Error CreateLike(const NativeDB& source, const std::string& path) {
+    options_ = source.options_;
+    options_.create_if_missing = true;
+    options_.error_if_exists = true;
+    options_.create_missing_column_families = true;
+    cfs_ = source.cfs_;
+    ::rocksdb::Status st = ::rocksdb::DB::Open(options_, path, cfs_, &handles_, &db_);
+    if (!st.ok()) {
+      return MakeError(st);
+    }
+    return common::Error();
+  }
+
+  ::rocksdb::DB* Get() const { return db_; }
+  const std::vector<::rocksdb::ColumnFamilyHandle*>& GetHandles() const { return handles_; }
+
+ private:
+  ::rocksdb::DB* db_;
+  ::rocksdb::DBOptions options_;
+  std::vector<::rocksdb::ColumnFamilyDescriptor> cfs_;
+  std::vector<::rocksdb::ColumnFamilyHandle*> handles_;
+};
+
+// every column family of source into target, progress returns false to interrupt
+common::Error CopyContent(const NativeDB& source,
+                          const NativeDB& target,
+                          core::keys_limit_t keys_count,
+                          const std::function<bool(int)>& progress) {
+  ::rocksdb::ReadOptions ropts;
+  ropts.fill_cache = false;
+  core::keys_limit_t copied = 0;
+  for (size_t i = 0; i < source.GetHandles().size(); ++i) {
+    std::unique_ptr<::rocksdb::Iterator> it(source.Get()->NewIterator(ropts, source.GetHandles()[i]));
+    ::rocksdb::WriteBatch batch;
+    for (it->SeekToFirst(); it->Valid(); it->Next()) {
+      batch.Put(target.GetHandles()[i], it->key(), it->value());
+      copied++;
+      if (batch.Count() < ROCKSDB_BACKUP_BATCH_SIZE) {
+        continue;
+      }
+
+      ::rocksdb::Status st = target.Get()->Write(::rocksdb::WriteOptions(), &batch);
+      if (!st.ok()) {
+        return MakeError(st);
+      }
+      batch.Clear();
+      const int percent = keys_count ? static_cast<int>(copied * 100 / keys_count) : 0;
+      if (!progress(std::min(percent, 99))) {
+        return common::make_error(common::COMMON_EINTR);
+      }
+    }
+
+    ::rocksdb::Status st = it->status();
+    if (st.ok()) {
+      st = target.Get()->Write(::rocksdb::WriteOptions(), &batch);
+    }
+    if (!st.ok()) {
+      return MakeError(st);
+    }
+  }
+
+  ::rocksdb::FlushOptions fopts;
+  for (auto* handle : target.GetHandles()) {
+    ::rocksdb::Status st = target.Get()->Flush(fopts, handle);
+    if (!st.ok()) {
+      return MakeError(st);
+    }
+  }
+  return common::Error();
+}
+
+// plain copy keeps layout of a checkpoint: a db which can be opened in place
+common::Error CreateCopy(const std::string& db_path,
+                         const std::string& path,
+                         core::keys_limit_t keys_count,
+                         const std::function<bool(int)>& progress) {
+  NativeDB source;
+  common::Error err = source.Open(db_path, true);
+  if (err) {
+    return err;
+  }
+
+  NativeDB target;
+  err = target.CreateLike(source, path);
+  if (err) {
+    return err;
+  }
+
+  return CopyContent(source, target, keys_count, progress);
+}
+
+// backup engine needs a writable db, so it backs up a fresh copy, not the live files
+common::Error CreateIncrementalBackup(const std::string& copy_path, const std::string& path) {
+  NativeDB copy;
+  common::Error err = copy.Open(copy_path, false);
+  if (err) {
+    return err;
+  }
+
+  ::rocksdb::BackupEngine* engine = nullptr;
+  ::rocksdb::BackupableDBOptions backup_options(path);
+  backup_options.share_files_with_checksum = true;  // equal sst files of consecutive copies are stored once
+  ::rocksdb::Status st = ::rocksdb::BackupEngine::Open(::rocksdb::Env::Default(), backup_options, &engine);
+  if (!st.ok()) {
+    return MakeError(st);
+  }
+
+  std::unique_ptr<::rocksdb::BackupEngine> holder(engine);
+  st = engine->CreateNewBackup(copy.Get(), false);
+  if (!st.ok()) {
+    return MakeError(st);
+  }
+  return common::Error();
+}
+
+// backup engine files are not a db, latest backup is restored into temp dir for browsing,
+// backup directory itself is never written
+common::Error RestoreLatestBackup(const std::string& path, std::string* db_path) {
+  ::rocksdb::BackupEngineReadOnly* engine = nullptr;
+  ::rocksdb::Status st = ::rocksdb::BackupEngineReadOnly::Open(::rocksdb::Env::Default(),
+                                                               ::rocksdb::BackupableDBOptions(path), &engine);
+  if (!st.ok()) {
+    return MakeError(st);
+  }
+
+  std::unique_ptr<::rocksdb::BackupEngineReadOnly> holder(engine);
+  const std::string restored = QDir::tempPath().toStdString() + "/" ROCKSDB_BROWSE_DIR_PREFIX +
+                               common::ConvertToString(common::time::current_utc_mstime());
+  const std::string temp = restored + ROCKSDB_TEMP_SUFFIX;
+  st = engine->RestoreDBFromLatestBackup(temp, temp);
+  if (st.ok()) {
+    st = ::rocksdb::Env::Default()->RenameFile(temp, restored);
+  }
+  if (!st.ok()) {
+    ::rocksdb::DestroyDB(temp, ::rocksdb::Options());
+    return MakeError(st);
+  }
+
+  *db_path = restored;
+  return common::Error();
+}
+
+}  // namespace
 
 Driver::Driver(IConnectionSettingsBaseSPtr settings)
     : IDriverLocal(settings), impl_(new core::rocksdb::DBConnection(this)) {
@@ -132,6 +337,68 @@ core::IServerInfoSPtr Driver::MakeServerInfoFromString(const std::string& val) {
   return core::IServerInfoSPtr(impl_->MakeServerInfo(val));
 }
 
+void Driver::HandleBackupEvent(events::BackupRequestEvent* ev) {
+  QObject* sender = ev->sender();
+  NotifyProgress(sender, 0);
+  events::BackupResponseEvent::value_type res(ev->value());
+  const auto config = GetSpecificSettings<ConnectionSettings>()->GetInfo();
+  core::keys_limit_t keys_count = 0;
+  common::Error err = impl_->DBKeysCount(&keys_count);
+  if (!err && !res.incremental && ::rocksdb::Env::Default()->FileExists(res.path).ok()) {
+    err = common::make_error("Backup path already exists: " + res.path);
+  }
+
+  if (!err) {
+    // copy is built aside and renamed when done, so a half written backup never appears under its name
+    const std::string temp_path = res.path + ROCKSDB_TEMP_SUFFIX;
+    const auto progress = [this, sender](int percent) {
+      NotifyProgress(sender, percent);
+      return !IsInterrupted();
+    };
+    err = CreateCopy(config.db_path, temp_path, keys_count, progress);
+    if (!err) {
+      err = res.incremental ? CreateIncrementalBackup(temp_path, res.path)
+                            : MakeError(::rocksdb::Env::Default()->RenameFile(temp_path, res.path));
+    }
+    if (err || res.incremental) {
+      ::rocksdb::DestroyDB(temp_path, ::rocksdb::Options());
+    }
+  }
+
+  if (err) {
+    res.setErrorInfo(err);
+  }
+  Reply(sender, new events::BackupResponseEvent(this, res));
+  NotifyProgress(sender, 100);
+}
+
+void Driver::HandleRestoreEvent(events::RestoreRequestEvent* ev) {
+  QObject* sender = ev->sender();
+  NotifyProgress(sender, 0);
+  events::RestoreResponseEvent::value_type res(ev->value());
+  auto config = GetSpecificSettings<ConnectionSettings>()->GetInfo();
+  config.create_if_missing = false;
+  config.db_path = res.path;
+  common::Error err;
+  if (IsBackupEngineDir(res.path)) {
+    err = RestoreLatestBackup(res.path, &config.db_path);
+  }
+  NotifyProgress(sender, 50);
+  if (!err) {
+    // switches this session to the backup, reconnect returns to the settings path
+    err = impl_->Disconnect();
+    if (!err) {
+      err = impl_->Connect(config);
+    }
+  }
+
+  if (err) {
+    res.setErrorInfo(err);
+  }
+  Reply(sender, new events::RestoreResponseEvent(this, res));
+  NotifyProgress(sender, 100);
+}
+
 }  // namespace rocksdb
 }  // namespace proxy
 }  // namespace fastonosql
@@ -75,6 +75,9 @@ class Driver : public IDriverLocal {
 
   core::IServerInfoSPtr MakeServerInfoFromString(const std::string& val) override;
 
+  void HandleBackupEvent(events::BackupRequestEvent* ev) override;
+  void HandleRestoreEvent(events::RestoreRequestEvent* ev) override;
+
  private:
   core::rocksdb::DBConnection* const impl_;
 };
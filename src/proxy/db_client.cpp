@@ -18,6 +18,10 @@
 
 #include "proxy/db_client.h"
 
+#include <string.h>
+
+#include <limits>
+
 #include <common/convert2string.h>
 
 #define CLIENT_ID "id"
@@ -39,14 +43,103 @@
 #define CLIENT_EVENTS "events"
 #define CLIENT_CMD "cmd"
 
-#define CLIENT_FIELDS_DELEMITER " "
-#define CLIENT_FIELD_VALUE_DELEMITER "="
+#define CLIENT_FIELDS_DELEMITER ' '
+#define CLIENT_FIELD_VALUE_DELEMITER '='
+#define CLIENT_LINES_DELEMITER '\n'
 
 #define INVALID_ID -1
 
 namespace fastonosql {
 namespace proxy {
 
+namespace {
+
+template <size_t N>
+bool IsField(const char* data, size_t size, const char (&field)[N]) {
+  return size == N - 1 && memcmp(data, field, size) == 0;
+}
+
+template <typename T>
+bool ParseNumber(const char* data, size_t size, T* out) {
+  const char* end = data + size;
+  const bool negative = data != end && *data == '-';
+  if (negative) {
+    data++;
+  }
+
+  if (data == end) {
+    return false;
+  }
+
+  T result = 0;
+  for (; data != end; ++data) {
+    if (*data < '0' || *data > '9') {
+      return false;
+    }
+    const T digit = *data - '0';
+    if (result > (std::numeric_limits<T>::max() - digit) / 10) {
+      return false;  // doesn't fit field type
+    }
+    result = result * 10 + digit;
+  }
+
+  *out = negative ? -result : result;
+  return true;
+}
+
+template <typename T>
+void SetNumber(const char* data, size_t size, void (NDbClient::*setter)(T), NDbClient* client) {
+  T number;
+  if (ParseNumber(data, size, &number)) {
+    (client->*setter)(number);
+  }
+}
+
+void ParseField(const char* field, size_t field_size, const char* value, size_t value_size, NDbClient* client) {
+  if (IsField(field, field_size, CLIENT_ID)) {
+    SetNumber(value, value_size, &NDbClient::SetId, client);
+  } else if (IsField(field, field_size, CLIENT_ADDR)) {
+    NDbClient::addr_t hs;
+    if (common::ConvertFromString(std::string(value, value_size), &hs)) {
+      client->SetAddr(hs);
+    }
+  } else if (IsField(field, field_size, CLIENT_FD)) {
+    SetNumber(value, value_size, &NDbClient::SetFd, client);
+  } else if (IsField(field, field_size, CLIENT_NAME)) {
+    client->SetName(NDbClient::name_t(value, value_size));
+  } else if (IsField(field, field_size, CLIENT_AGE)) {
+    SetNumber(value, value_size, &NDbClient::SetAge, client);
+  } else if (IsField(field, field_size, CLIENT_IDLE)) {
+    SetNumber(value, value_size, &NDbClient::SetIdle, client);
+  } else if (IsField(field, field_size, CLIENT_FLAGS)) {
+    client->SetFlags(NDbClient::flags_t(value, value_size));
+  } else if (IsField(field, field_size, CLIENT_DB)) {
+    SetNumber(value, value_size, &NDbClient::SetDb, client);
+  } else if (IsField(field, field_size, CLIENT_SUB)) {
+    SetNumber(value, value_size, &NDbClient::SetSub, client);
+  } else if (IsField(field, field_size, CLIENT_PSUB)) {
+    SetNumber(value, value_size, &NDbClient::SetPSub, client);
+  } else if (IsField(field, field_size, CLIENT_MULTI)) {
+    SetNumber(value, value_size, &NDbClient::SetMulti, client);
+  } else if (IsField(field, field_size, CLIENT_QBUF)) {
+    SetNumber(value, value_size, &NDbClient::SetQbuf, client);
+  } else if (IsField(field, field_size, CLIENT_QBUF_FREE)) {
+    SetNumber(value, value_size, &NDbClient::SetQbufFree, client);
+  } else if (IsField(field, field_size, CLIENT_ODL)) {
+    SetNumber(value, value_size, &NDbClient::SetOdl, client);
+  } else if (IsField(field, field_size, CLIENT_OLL)) {
+    SetNumber(value, value_size, &NDbClient::SetOll, client);
+  } else if (IsField(field, field_size, CLIENT_OMEM)) {
+    SetNumber(value, value_size, &NDbClient::SetOmem, client);
+  } else if (IsField(field, field_size, CLIENT_EVENTS)) {
+    client->SetEvents(NDbClient::events_t(value, value_size));
+  } else if (IsField(field, field_size, CLIENT_CMD)) {
+    client->SetCmd(NDbClient::cmd_t(value, value_size));
+  }
+}
+
+}  // namespace
+
 NDbClient::NDbClient()
     : id_(INVALID_ID),
       addr_(),
@@ -68,100 +161,21 @@ NDbClient::NDbClient()
       cmd_() {}
 
 NDbClient::NDbClient(const std::string& text) : NDbClient() {
-  size_t pos = 0;
-  size_t start = 0;
-  while ((pos = text.find(CLIENT_FIELDS_DELEMITER, start)) != std::string::npos) {
-    std::string line = text.substr(start, pos - start);
-    size_t delem = line.find_first_of(CLIENT_FIELD_VALUE_DELEMITER);
-    std::string field = line.substr(0, delem);
-    std::string value = line.substr(delem + 1);
-    if (field == CLIENT_ID) {
-      id_t iden;
-      if (common::ConvertFromString(value, &iden)) {
-        id_ = iden;
-      }
-    } else if (field == CLIENT_ADDR) {
-      addr_t hs;
-      if (common::ConvertFromString(value, &hs)) {
-        addr_ = hs;
-      }
-    } else if (field == CLIENT_FD) {
-      fd_t fd;
-      if (common::ConvertFromString(value, &fd)) {
-        fd_ = fd;
-      }
-    } else if (field == CLIENT_NAME) {
-      name_ = value;
-    } else if (field == CLIENT_AGE) {
-      age_t age;
-      if (common::ConvertFromString(value, &age)) {
-        age_ = age;
-      }
-    } else if (field == CLIENT_IDLE) {
-      idle_t idle;
-      if (common::ConvertFromString(value, &idle)) {
-        idle_ = idle;
-      }
-    } else if (field == CLIENT_FLAGS) {
-      flags_ = value;
-    } else if (field == CLIENT_DB) {
-      db_t db;
-      if (common::ConvertFromString(value, &db)) {
-        db_ = db;
-      }
-    } else if (field == CLIENT_SUB) {
-      sub_t ps;
-      if (common::ConvertFromString(value, &ps)) {
-        sub_ = ps;
-      }
-    } else if (field == CLIENT_PSUB) {
-      psub_t ps;
-      if (common::ConvertFromString(value, &ps)) {
-        psub_ = ps;
-      }
-    } else if (field == CLIENT_MULTI) {
-      multi_t multi;
-      if (common::ConvertFromString(value, &multi)) {
-        multi_ = multi;
-      }
-    } else if (field == CLIENT_QBUF) {
-      qbuf_t qbuf;
-      if (common::ConvertFromString(value, &qbuf)) {
-        qbuf_ = qbuf;
-      }
-    } else if (field == CLIENT_QBUF_FREE) {
-      qbuf_free_t qbuf_free;
-      if (common::ConvertFromString(value, &qbuf_free)) {
-        qbuf_free_ = qbuf_free;
-      }
-    } else if (field == CLIENT_ODL) {
-      odl_t odl;
-      if (common::ConvertFromString(value, &odl)) {
-        odl_ = odl;
-      }
-    } else if (field == CLIENT_OLL) {
-      oll_t oll;
-      if (common::ConvertFromString(value, &oll)) {
-        oll_ = oll;
-      }
-    } else if (field == CLIENT_OMEM) {
-      omem_t omem;
-      if (common::ConvertFromString(value, &omem)) {
-        omem_ = omem;
-      }
-    } else if (field == CLIENT_EVENTS) {
-      events_ = value;
-    } else if (field == CLIENT_CMD) {
-      cmd_ = value;
-    }
-    start = pos + SIZEOFMASS(CLIENT_FIELDS_DELEMITER) - 1;
-  }
+  ParseClient(text.data(), text.size(), this);
 }
 
 bool NDbClient::IsValid() const {
   return id_ != INVALID_ID;
 }
 
+bool NDbClient::Equals(const NDbClient& other) const {
+  return id_ == other.id_ && addr_ == other.addr_ && fd_ == other.fd_ && name_ == other.name_ &&
+         age_ == other.age_ && idle_ == other.idle_ && flags_ == other.flags_ && db_ == other.db_ &&
+         sub_ == other.sub_ && psub_ == other.psub_ && multi_ == other.multi_ && qbuf_ == other.qbuf_ &&
+         qbuf_free_ == other.qbuf_free_ && odl_ == other.odl_ && oll_ == other.oll_ && omem_ == other.omem_ &&
+         events_ == other.events_ && cmd_ == other.cmd_;
+}
+
 void NDbClient::SetId(id_t iden) {
   id_ = iden;
 }
@@ -263,7 +277,7 @@ void NDbClient::SetQbufFree(qbuf_free_t qbuf_free) {
 }
 
 NDbClient::qbuf_free_t NDbClient::GetQbufFree() const {
-  return qbuf_;
+  return qbuf_free_;
 }
 
 void NDbClient::SetOdl(odl_t odl) {
@@ -306,5 +320,53 @@ NDbClient::cmd_t NDbClient::GetCmd() const {
   return cmd_;
 }
 
+bool ParseClient(const char* data, size_t size, NDbClient* client) {
+  if (!data || !client) {
+    return false;
+  }
+
+  const char* end = data + size;
+  while (data != end) {
+    const char* field_end = static_cast<const char*>(memchr(data, CLIENT_FIELDS_DELEMITER, end - data));
+    if (!field_end) {
+      field_end = end;  // last field has no trailing delimiter
+    }
+
+    const char* delem = static_cast<const char*>(memchr(data, CLIENT_FIELD_VALUE_DELEMITER, field_end - data));
+    if (delem) {
+      ParseField(data, delem - data, delem + 1, field_end - delem - 1, client);
+    }
+    data = field_end == end ? end : field_end + 1;
+  }
+
+  return client->IsValid();
+}
+
+void ParseClientList(const std::string& text, std::vector<NDbClient>* clients) {
+  if (!clients) {
+    return;
+  }
+
+  const char* data = text.data();
+  const char* end = data + text.size();
+  while (data != end) {
+    const char* line_end = static_cast<const char*>(memchr(data, CLIENT_LINES_DELEMITER, end - data));
+    if (!line_end) {
+      line_end = end;
+    }
+
+    size_t line_size = line_end - data;
+    if (line_size && data[line_size - 1] == '\r') {
+      line_size--;
+    }
+
+    NDbClient client;
+    if (ParseClient(data, line_size, &client)) {
+      clients->push_back(client);
+    }
+    data = line_end == end ? end : line_end + 1;
+  }
+}
+
 }  // namespace proxy
 }  // namespace fastonosql
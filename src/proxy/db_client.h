@@ -19,6 +19,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include <common/net/types.h>
 
@@ -53,6 +54,7 @@ class NDbClient {
   explicit NDbClient(const std::string& text);
 
   bool IsValid() const;
+  bool Equals(const NDbClient& other) const;
 
   void SetId(id_t iden);
   id_t GetId() const;
@@ -129,5 +131,18 @@ class NDbClient {
   cmd_t cmd_;
 };
 
+inline bool operator==(const NDbClient& left, const NDbClient& right) {
+  return left.Equals(right);
+}
+
+inline bool operator!=(const NDbClient& left, const NDbClient& right) {
+  return !(left == right);
+}
+
+// parses one CLIENT LIST line in place, only string fields are copied
+bool ParseClient(const char* data, size_t size, NDbClient* client);
+// appends valid clients of CLIENT LIST reply
+void ParseClientList(const std::string& text, std::vector<NDbClient>* clients);
+
 }  // namespace proxy
 }  // namespace fastonosql
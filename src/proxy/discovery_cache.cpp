@@ -0,0 +1,212 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/discovery_cache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include <QSaveFile>
+
+#include <common/file_system/file_system.h>
+#include <common/qt/convert2string.h>
+#include <common/time.h>
+
+#include "proxy/settings_manager.h"
+
+namespace {
+const char kCacheFileName[] = "discovery.cache";
+const char kCacheFormatVersion[] = "#fastonosql-discovery-2";
+const char kKeyDelimiter = '\t';
+}  // namespace
+
+namespace fastonosql {
+namespace proxy {
+
+DiscoveryCache::DiscoveryCache() : lock_(), loaded_(false), dirty_(false), entries_() {}
+
+std::string DiscoveryCache::GetCacheFilePath() {
+  return common::file_system::make_path(SettingsManager::GetSettingsDirPath(), kCacheFileName);
+}
+
+bool DiscoveryCache::Find(const key_t& key, commands_t* commands) {
+  if (key.empty() || !commands) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(lock_);
+  LoadIfNeeded();
+  const auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return false;
+  }
+
+  // stored with use time, so eviction order survives restart
+  it->second.last_used_msec = common::time::current_utc_mstime();
+  dirty_ = true;
+  *commands = it->second.commands;
+  return true;
+}
+
+bool DiscoveryCache::FindResolved(const key_t& key, resolved_commands_t* commands) {
+  if (key.empty() || !commands) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(lock_);
+  const auto it = entries_.find(key);
+  if (it == entries_.end() || !it->second.translator) {
+    return false;
+  }
+
+  it->second.last_used_msec = common::time::current_utc_mstime();
+  dirty_ = true;
+  *commands = it->second.resolved;
+  return true;
+}
+
+void DiscoveryCache::SetResolved(const key_t& key, core::translator_t translator, const resolved_commands_t& commands) {
+  if (key.empty() || !translator) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(lock_);
+  const auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return;
+  }
+
+  it->second.translator = translator;
+  it->second.resolved = commands;
+}
+
+void DiscoveryCache::Insert(const key_t& key, const commands_t& commands) {
+  if (key.empty() || key.find_first_of("\t\n") != key_t::npos || commands.empty()) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(lock_);
+  LoadIfNeeded();
+  const common::time64_t now = common::time::current_utc_mstime();
+  const auto it = entries_.find(key);
+  if (it != entries_.end() && it->second.commands == commands) {
+    it->second.last_used_msec = now;
+    dirty_ = true;
+    return;
+  }
+
+  if (it == entries_.end() && entries_.size() >= max_cached_servers) {
+    const auto lru = std::min_element(entries_.begin(), entries_.end(), [](const auto& left, const auto& right) {
+      return left.second.last_used_msec < right.second.last_used_msec;
+    });
+    entries_.erase(lru);
+  }
+  entries_[key] = Entry{commands, now, core::translator_t(), resolved_commands_t()};
+  Save();
+}
+
+void DiscoveryCache::Remove(const key_t& key) {
+  std::lock_guard<std::mutex> lock(lock_);
+  LoadIfNeeded();
+  if (entries_.erase(key)) {
+    Save();
+  }
+}
+
+void DiscoveryCache::Clear() {
+  std::lock_guard<std::mutex> lock(lock_);
+  loaded_ = true;
+  dirty_ = false;
+  entries_.clear();
+  std::remove(GetCacheFilePath().c_str());
+}
+
+void DiscoveryCache::Flush() {
+  std::lock_guard<std::mutex> lock(lock_);
+  if (dirty_) {
+    Save();
+  }
+}
+
+void DiscoveryCache::LoadIfNeeded() {
+  if (loaded_) {
+    return;
+  }
+
+  loaded_ = true;
+  std::ifstream file(GetCacheFilePath());
+  std::string line;
+  if (!file.is_open() || !std::getline(file, line) || line != kCacheFormatVersion) {
+    return;
+  }
+
+  // one server per line: key, tab, last use msec, tab, space separated command names
+  while (std::getline(file, line)) {
+    const size_t pos = line.find(kKeyDelimiter);
+    const size_t used_pos = pos == std::string::npos ? pos : line.find(kKeyDelimiter, pos + 1);
+    if (pos == 0 || used_pos == std::string::npos) {
+      continue;
+    }
+
+    Entry entry;
+    entry.last_used_msec = strtoll(line.substr(pos + 1, used_pos - pos - 1).c_str(), nullptr, 10);
+    std::istringstream names(line.substr(used_pos + 1));
+    std::string name;
+    while (names >> name) {
+      entry.commands.push_back(name);
+    }
+    if (!entry.commands.empty()) {
+      entries_[line.substr(0, pos)] = entry;
+    }
+  }
+}
+
+void DiscoveryCache::Save() {
+  dirty_ = false;
+  std::ostringstream content;
+  content << kCacheFormatVersion << '\n';
+  for (const auto& entry : entries_) {
+    content << entry.first << kKeyDelimiter << entry.second.last_used_msec << kKeyDelimiter;
+    for (size_t i = 0; i < entry.second.commands.size(); ++i) {
+      content << (i ? " " : "") << entry.second.commands[i];
+    }
+    content << '\n';
+  }
+
+  // written aside and swapped in on commit (replacing existing file on windows too),
+  // so a crash never leaves a truncated cache behind
+  QString qpath;
+  common::ConvertFromString(GetCacheFilePath(), &qpath);
+  QSaveFile file(qpath);
+  if (!file.open(QIODevice::WriteOnly)) {
+    return;
+  }
+
+  const std::string data = content.str();
+  if (file.write(data.data(), data.size()) != static_cast<qint64>(data.size())) {
+    file.cancelWriting();
+    return;
+  }
+  file.commit();
+}
+
+}  // namespace proxy
+}  // namespace fastonosql
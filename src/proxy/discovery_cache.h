@@ -0,0 +1,77 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <common/patterns/singleton_pattern.h>
+#include <common/types.h>
+
+#include <fastonosql/core/icommand_translator.h>
+
+namespace fastonosql {
+namespace proxy {
+
+// on-disk cache of server command tables, keyed by a cheap fingerprint (engine, version, commands count, modules)
+// so connecting to a known build skips the full discovery round trips, least recently used entry is evicted;
+// hits only touch memory, use times reach the file with the next insert or on Flush
+class DiscoveryCache : public common::patterns::LazySingleton<DiscoveryCache> {
+ public:
+  friend class common::patterns::LazySingleton<DiscoveryCache>;
+  typedef std::string key_t;
+  typedef std::vector<std::string> commands_t;
+  typedef std::vector<const core::CommandInfo*> resolved_commands_t;
+  enum { max_cached_servers = 64 };
+
+  static std::string GetCacheFilePath();
+
+  bool Find(const key_t& key, commands_t* commands);
+  void Insert(const key_t& key, const commands_t& commands);
+  void Remove(const key_t& key);
+  void Clear();
+  void Flush();
+
+  // command infos resolved from the cached names, kept in memory only together with the translator owning them
+  bool FindResolved(const key_t& key, resolved_commands_t* commands);
+  void SetResolved(const key_t& key, core::translator_t translator, const resolved_commands_t& commands);
+
+ private:
+  DiscoveryCache();
+
+  struct Entry {
+    commands_t commands;
+    common::time64_t last_used_msec;
+    core::translator_t translator;
+    resolved_commands_t resolved;
+  };
+
+  void LoadIfNeeded();
+  void Save();
+
+  std::mutex lock_;
+  bool loaded_;
+  bool dirty_;
+  std::map<key_t, Entry> entries_;
+};
+
+}  // namespace proxy
+}  // namespace fastonosql
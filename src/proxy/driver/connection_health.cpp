@@ -0,0 +1,111 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/driver/connection_health.h"
+
+#include <algorithm>
+
+namespace fastonosql {
+namespace proxy {
+
+ConnectionHealthInfo::ConnectionHealthInfo()
+    : state(IDLE), last_rtt_msec(0), avg_rtt_msec(0), reconnect_attempts(0), reconnects(0), last_error() {}
+
+ConnectionHealth::ConnectionHealth()
+    : info_(), last_activity_msec_(0), next_attempt_msec_(0), backoff_msec_(min_backoff_msec) {}
+
+ConnectionHealthInfo ConnectionHealth::GetInfo() const {
+  return info_;
+}
+
+bool ConnectionHealth::IsActive() const {
+  return info_.state != ConnectionHealthInfo::IDLE;
+}
+
+bool ConnectionHealth::IsReconnecting() const {
+  return info_.state == ConnectionHealthInfo::RECONNECTING;
+}
+
+void ConnectionHealth::Start(common::time64_t now) {
+  info_ = ConnectionHealthInfo();
+  info_.state = ConnectionHealthInfo::HEALTHY;
+  last_activity_msec_ = now;
+  next_attempt_msec_ = 0;
+  backoff_msec_ = min_backoff_msec;
+}
+
+void ConnectionHealth::Stop() {
+  info_.state = ConnectionHealthInfo::IDLE;
+}
+
+void ConnectionHealth::Touch(common::time64_t now) {
+  last_activity_msec_ = now;
+}
+
+bool ConnectionHealth::IsPingDue(common::time64_t now) const {
+  return info_.state == ConnectionHealthInfo::HEALTHY && now - last_activity_msec_ >= keepalive_interval_msec;
+}
+
+void ConnectionHealth::PingSucceeded(common::time64_t rtt, common::time64_t now) {
+  info_.last_rtt_msec = rtt;
+  info_.avg_rtt_msec = info_.avg_rtt_msec ? (info_.avg_rtt_msec * (rtt_smoothing - 1) + rtt) / rtt_smoothing : rtt;
+  last_activity_msec_ = now;
+}
+
+void ConnectionHealth::Lost(common::Error err, common::time64_t now) {
+  if (info_.state != ConnectionHealthInfo::HEALTHY) {
+    return;
+  }
+
+  info_.state = ConnectionHealthInfo::RECONNECTING;
+  info_.reconnect_attempts = 0;
+  info_.last_error = err;
+  backoff_msec_ = min_backoff_msec;
+  next_attempt_msec_ = now;  // first attempt right away, blips are usually short
+}
+
+bool ConnectionHealth::IsReconnectDue(common::time64_t now) const {
+  return info_.state == ConnectionHealthInfo::RECONNECTING && now >= next_attempt_msec_;
+}
+
+void ConnectionHealth::ReconnectFailed(common::Error err, common::time64_t now) {
+  if (info_.state != ConnectionHealthInfo::RECONNECTING) {
+    return;
+  }
+
+  info_.reconnect_attempts++;
+  info_.last_error = err;
+  next_attempt_msec_ = now + backoff_msec_;
+  backoff_msec_ = std::min<common::time64_t>(backoff_msec_ * 2, max_backoff_msec);
+}
+
+void ConnectionHealth::Reconnected(common::time64_t now) {
+  if (info_.state != ConnectionHealthInfo::RECONNECTING) {
+    return;
+  }
+
+  info_.state = ConnectionHealthInfo::HEALTHY;
+  info_.reconnect_attempts = 0;
+  info_.reconnects++;
+  info_.last_error = common::Error();
+  last_activity_msec_ = now;
+  backoff_msec_ = min_backoff_msec;
+}
+
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,76 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <common/error.h>
+#include <common/types.h>
+
+namespace fastonosql {
+namespace proxy {
+
+struct ConnectionHealthInfo {
+  enum State { IDLE = 0, HEALTHY, RECONNECTING };
+  ConnectionHealthInfo();
+
+  State state;
+  common::time64_t last_rtt_msec;
+  common::time64_t avg_rtt_msec;
+  size_t reconnect_attempts;  // failed attempts since connection was lost
+  size_t reconnects;          // transparent reconnects since connect by user
+  common::Error last_error;
+};
+
+// Keepalive and reconnect policy of one connection, time is passed in by caller (driver thread).
+// Idle connection is pinged every keepalive interval, lost one is reconnected with exponential backoff.
+class ConnectionHealth {
+ public:
+  enum {
+    keepalive_interval_msec = 15000,
+    min_backoff_msec = 500,
+    max_backoff_msec = 30000,
+    rtt_smoothing = 8  // weight of history in average rtt
+  };
+
+  ConnectionHealth();
+
+  ConnectionHealthInfo GetInfo() const;
+  bool IsActive() const;
+  bool IsReconnecting() const;
+
+  void Start(common::time64_t now);  // connection opened by user
+  void Stop();                       // connection closed by user, nothing to keep alive
+
+  void Touch(common::time64_t now);  // any traffic proves connection is alive
+  bool IsPingDue(common::time64_t now) const;
+  void PingSucceeded(common::time64_t rtt, common::time64_t now);
+
+  void Lost(common::Error err, common::time64_t now);
+  bool IsReconnectDue(common::time64_t now) const;
+  void ReconnectFailed(common::Error err, common::time64_t now);
+  void Reconnected(common::time64_t now);
+
+ private:
+  ConnectionHealthInfo info_;
+  common::time64_t last_activity_msec_;
+  common::time64_t next_attempt_msec_;
+  common::time64_t backoff_msec_;
+};
+
+}  // namespace proxy
+}  // namespace fastonosql
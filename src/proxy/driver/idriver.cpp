@@ -108,7 +108,12 @@ void ReplyNotImplementedYet(IDriver* sender, event_request_type* ev, const char*
 }  // namespace
 
 IDriver::IDriver(IConnectionSettingsBaseSPtr settings)
-    : settings_(settings), thread_(nullptr), timer_info_id_(0), log_file_(nullptr), server_info_() {
+    : settings_(settings),
+      thread_(nullptr),
+      timer_info_id_(0),
+      log_file_(nullptr),
+      server_info_(),
+      captured_keys_(nullptr) {
   thread_ = new QThread(this);
   moveToThread(thread_);
 
@@ -248,9 +253,24 @@ void IDriver::customEvent(QEvent* event) {
   } else if (type == static_cast<QEvent::Type>(events::RestoreRequestEvent::EventType)) {
     events::RestoreRequestEvent* ev = static_cast<events::RestoreRequestEvent*>(event);
     HandleRestoreEvent(ev);  // ni
+  } else if (type == static_cast<QEvent::Type>(events::DumpKeysRequestEvent::EventType)) {
+    events::DumpKeysRequestEvent* ev = static_cast<events::DumpKeysRequestEvent*>(event);
+    HandleDumpKeysEvent(ev);  // ni
+  } else if (type == static_cast<QEvent::Type>(events::RestoreKeysRequestEvent::EventType)) {
+    events::RestoreKeysRequestEvent* ev = static_cast<events::RestoreKeysRequestEvent*>(event);
+    HandleRestoreKeysEvent(ev);  // ni
   } else if (type == static_cast<QEvent::Type>(events::LoadDatabaseContentRequestEvent::EventType)) {
     events::LoadDatabaseContentRequestEvent* ev = static_cast<events::LoadDatabaseContentRequestEvent*>(event);
     HandleLoadDatabaseContentEvent(ev);
+  } else if (type == static_cast<QEvent::Type>(events::LoadKeyPageRequestEvent::EventType)) {
+    events::LoadKeyPageRequestEvent* ev = static_cast<events::LoadKeyPageRequestEvent*>(event);
+    HandleLoadKeyPageEvent(ev);  // ni
+  } else if (type == static_cast<QEvent::Type>(events::LoadStreamPageRequestEvent::EventType)) {
+    events::LoadStreamPageRequestEvent* ev = static_cast<events::LoadStreamPageRequestEvent*>(event);
+    HandleLoadStreamPageEvent(ev);  // ni
+  } else if (type == static_cast<QEvent::Type>(events::ChangeKeyValueRequestEvent::EventType)) {
+    events::ChangeKeyValueRequestEvent* ev = static_cast<events::ChangeKeyValueRequestEvent*>(event);
+    HandleChangeKeyValueEvent(ev);  // ni
   } else if (type == static_cast<QEvent::Type>(events::DiscoveryInfoRequestEvent::EventType)) {
     events::DiscoveryInfoRequestEvent* ev = static_cast<events::DiscoveryInfoRequestEvent*>(event);
     HandleDiscoveryInfoEvent(ev);  //
@@ -354,6 +374,7 @@ void IDriver::HandleExecuteEvent(events::ExecuteRequestEvent* ev) {
   RootLocker* lock = history ? new RootLocker(this, sender, input_line, silence)
                              : new FirstChildUpdateRootLocker(this, sender, input_line, silence, commands);
   core::FastoObjectIPtr obj = lock->Root();
+  captured_keys_ = res.notify_keys ? nullptr : &res.loaded_keys;
   const double step = 99.0 / static_cast<double>(commands.size() * (repeat + 1));
   double cur_progress = 0.0;
   for (size_t r = 0; r < repeat + 1; ++r) {
@@ -387,6 +408,7 @@ void IDriver::HandleExecuteEvent(events::ExecuteRequestEvent* ev) {
   }
 
 done:
+  captured_keys_ = nullptr;
   Reply(sender, new events::ExecuteResponseEvent(this, res));
   NotifyProgress(sender, 100);
   delete lock;
@@ -450,6 +472,20 @@ done:
   NotifyProgress(sender, 100);
 }
 
+void IDriver::HandleLoadKeyPageEvent(events::LoadKeyPageRequestEvent* ev) {
+  ReplyNotImplementedYet<events::LoadKeyPageRequestEvent, events::LoadKeyPageResponseEvent>(this, ev, "load key page");
+}
+
+void IDriver::HandleLoadStreamPageEvent(events::LoadStreamPageRequestEvent* ev) {
+  ReplyNotImplementedYet<events::LoadStreamPageRequestEvent, events::LoadStreamPageResponseEvent>(
+      this, ev, "load stream page");
+}
+
+void IDriver::HandleChangeKeyValueEvent(events::ChangeKeyValueRequestEvent* ev) {
+  ReplyNotImplementedYet<events::ChangeKeyValueRequestEvent, events::ChangeKeyValueResponseEvent>(
+      this, ev, "change key value");
+}
+
 void IDriver::HandleLoadServerPropertyEvent(events::ServerPropertyInfoRequestEvent* ev) {
   ReplyNotImplementedYet<events::ServerPropertyInfoRequestEvent, events::ServerPropertyInfoResponseEvent>(
       this, ev, "server property");
@@ -478,6 +514,14 @@ void IDriver::HandleRestoreEvent(events::RestoreRequestEvent* ev) {
   ReplyNotImplementedYet<events::RestoreRequestEvent, events::RestoreResponseEvent>(this, ev, "export server");
 }
 
+void IDriver::HandleDumpKeysEvent(events::DumpKeysRequestEvent* ev) {
+  ReplyNotImplementedYet<events::DumpKeysRequestEvent, events::DumpKeysResponseEvent>(this, ev, "dump keys");
+}
+
+void IDriver::HandleRestoreKeysEvent(events::RestoreKeysRequestEvent* ev) {
+  ReplyNotImplementedYet<events::RestoreKeysRequestEvent, events::RestoreKeysResponseEvent>(this, ev, "restore keys");
+}
+
 void IDriver::HandleLoadDatabaseInfosEvent(events::LoadDatabasesInfoRequestEvent* ev) {
   /*QObject* sender = ev->sender();
   NotifyProgress(sender, 0);
@@ -717,6 +761,10 @@ void IDriver::OnRemovedKeys(const core::NKeys& keys) {
 }
 
 void IDriver::OnAddedKey(const core::NDbKValue& key) {
+  if (captured_keys_) {
+    return;
+  }
+
   emit KeyAdded(key);
 }
 
@@ -726,6 +774,11 @@ void IDriver::OnLoadedKey(const core::NDbKValue& key) {
     return;
   }
 
+  if (captured_keys_) {
+    captured_keys_->push_back(key);
+    return;
+  }
+
   emit KeyLoaded(key);
 }
 
@@ -734,10 +787,18 @@ void IDriver::OnRenamedKey(const core::NKey& key, const core::nkey_t& new_key) {
 }
 
 void IDriver::OnChangedKeyTTL(const core::NKey& key, core::ttl_t ttl) {
+  if (captured_keys_) {
+    return;
+  }
+
   emit KeyTTLChanged(key, ttl);
 }
 
 void IDriver::OnLoadedKeyTTL(const core::NKey& key, core::ttl_t ttl) {
+  if (captured_keys_) {
+    return;
+  }
+
   emit KeyTTLLoaded(key, ttl);
 }
 
@@ -111,6 +111,9 @@ class IDriver : public QObject, public core::CDBConnectionClient {
   virtual void HandleExecuteEvent(events::ExecuteRequestEvent* ev);
 
   virtual void HandleLoadDatabaseContentEvent(events::LoadDatabaseContentRequestEvent* ev);
+  virtual void HandleLoadKeyPageEvent(events::LoadKeyPageRequestEvent* ev);
+  virtual void HandleLoadStreamPageEvent(events::LoadStreamPageRequestEvent* ev);
+  virtual void HandleChangeKeyValueEvent(events::ChangeKeyValueRequestEvent* ev);
 
   virtual void HandleLoadServerPropertyEvent(events::ServerPropertyInfoRequestEvent* ev);
   virtual void HandleServerPropertyChangeEvent(events::ChangeServerPropertyInfoRequestEvent* ev);
@@ -118,6 +121,8 @@ class IDriver : public QObject, public core::CDBConnectionClient {
   virtual void HandleLoadServerClientsRequestEvent(events::LoadServerClientsRequestEvent* ev);
   virtual void HandleBackupEvent(events::BackupRequestEvent* ev);
   virtual void HandleRestoreEvent(events::RestoreRequestEvent* ev);
+  virtual void HandleDumpKeysEvent(events::DumpKeysRequestEvent* ev);
+  virtual void HandleRestoreKeysEvent(events::RestoreKeysRequestEvent* ev);
   virtual void HandleLoadDatabaseInfosEvent(events::LoadDatabasesInfoRequestEvent* ev);
   virtual void HandleDiscoveryInfoEvent(events::DiscoveryInfoRequestEvent* ev);
 
@@ -138,16 +143,45 @@ class IDriver : public QObject, public core::CDBConnectionClient {
 
   common::Error GetServerDiscoveryInfo(core::IDataBaseInfo** dbinfo, std::vector<const core::CommandInfo*>* commands);
 
- private:
   virtual common::Error SyncConnect() WARN_UNUSED_RESULT = 0;
   virtual common::Error SyncDisconnect() WARN_UNUSED_RESULT = 0;
+  // unlike Execute doesn't log command
+  virtual common::Error ExecuteImpl(const core::command_buffer_t& command,
+                                    core::FastoObject* out) WARN_UNUSED_RESULT = 0;
+
+  // executes one inner command built from request and fills response from its reply (paged value loads)
+  template <typename ResponseEvent, typename RequestEvent, typename Request>
+  void HandleInnerCommandEvent(RequestEvent* ev,
+                               common::Error (*make_command)(const Request&, core::command_buffer_t*),
+                               common::Error (*parse_reply)(core::FastoObject*, typename ResponseEvent::value_type*)) {
+    QObject* sender = ev->sender();
+    NotifyProgress(sender, 0);
+    typename ResponseEvent::value_type res(ev->value());
+    core::command_buffer_t command;
+    common::Error err = make_command(res, &command);
+    if (err) {
+      res.setErrorInfo(err);
+    } else {
+      core::FastoObjectCommandIPtr cmd = CreateCommandFast(command, core::C_INNER);
+      NotifyProgress(sender, 50);
+      err = Execute(cmd);
+      if (!err) {
+        err = parse_reply(cmd.get(), &res);
+      }
+      if (err) {
+        res.setErrorInfo(err);
+      }
+    }
+    NotifyProgress(sender, 75);
+    Reply(sender, new ResponseEvent(this, res));
+    NotifyProgress(sender, 100);
+  }
 
+ private:
   void HandleLoadServerInfoEvent(events::ServerInfoRequestEvent* ev);  // call ServerInfo
   void HandleLoadServerInfoHistoryEvent(events::ServerInfoHistoryRequestEvent* ev);
   void HandleClearServerHistoryEvent(events::ClearServerHistoryRequestEvent* ev);
 
-  virtual common::Error ExecuteImpl(const core::command_buffer_t& command,
-                                    core::FastoObject* out) WARN_UNUSED_RESULT = 0;
   virtual common::Error DBkcountImpl(core::keys_limit_t* size) WARN_UNUSED_RESULT = 0;
 
   void OnCreatedDB(core::IDataBaseInfo* info) override;
@@ -180,6 +214,7 @@ class IDriver : public QObject, public core::CDBConnectionClient {
   common::file_system::ANSIFile* log_file_;
 
   core::IServerInfoSPtr server_info_;
+  std::vector<core::NDbKValue>* captured_keys_;  // set while executing request which doesn't notify keys
 };
 
 }  // namespace proxy
@@ -18,19 +18,208 @@
 
 #include "proxy/driver/idriver_remote.h"
 
+#include <QTimerEvent>
+
+#include <common/convert2string.h>
+#include <common/time.h>
+
+#include <fastonosql/core/macros.h>
+
 #include "proxy/connection_settings/iconnection_settings_remote.h"
 
+#define PING_COMMAND "PING"
+
 namespace fastonosql {
 namespace proxy {
 
-IDriverRemote::IDriverRemote(IConnectionSettingsBaseSPtr settings) : IDriver(settings) {
+namespace {
+const int kHealthCheckIntervalMsec = 500;
+
+const struct RegisterTypes {
+  RegisterTypes() {
+    qRegisterMetaType<ConnectionHealthInfo>("fastonosql::proxy::ConnectionHealthInfo");
+  }
+} reg_type;
+}  // namespace
+
+IDriverRemote::IDriverRemote(IConnectionSettingsBaseSPtr settings)
+    : IDriver(settings),
+      health_(),
+      timer_health_id_(0),
+      session_owner_(nullptr),
+      host_mutex_(),
+      repointed_host_(),
+      is_repointed_(false) {
   CHECK(IsRemoteType(GetType()));
+  VERIFY(connect(this, &IDriver::Disconnected, this, &IDriverRemote::ConnectionQuited, Qt::DirectConnection));
 }
 
 common::net::HostAndPort IDriverRemote::GetHost() const {
+  {
+    std::lock_guard<std::mutex> lock(host_mutex_);
+    if (is_repointed_) {
+      return repointed_host_;
+    }
+  }
+
   auto remote_settings = GetSpecificSettings<IConnectionSettingsRemote>();
   return remote_settings->GetHost();
 }
 
+void IDriverRemote::customEvent(QEvent* event) {
+  const QEvent::Type type = event->type();
+  if (type == static_cast<QEvent::Type>(events::RepointRequestEvent::EventType)) {
+    events::RepointRequestEvent* ev = static_cast<events::RepointRequestEvent*>(event);
+    HandleRepointEvent(ev);
+    return;
+  }
+
+  const bool session_event = type == static_cast<QEvent::Type>(events::ConnectRequestEvent::EventType) ||
+                             type == static_cast<QEvent::Type>(events::DisconnectRequestEvent::EventType);
+  if (!session_event && health_.IsReconnecting()) {
+    // requests queued while link was down are served by restored connection instead of failing
+    TryReconnect();
+  }
+
+  IDriver::customEvent(event);
+
+  if (!session_event && health_.IsActive()) {
+    const common::time64_t now = common::time::current_utc_mstime();
+    if (!health_.IsReconnecting() && !IsConnected()) {
+      health_.Lost(common::make_error("Connection lost"), now);
+      NotifyHealth();
+      return;
+    }
+    health_.Touch(now);
+  }
+}
+
+void IDriverRemote::timerEvent(QTimerEvent* event) {
+  if (timer_health_id_ != 0 && timer_health_id_ == event->timerId()) {
+    CheckHealth();
+    return;
+  }
+
+  IDriver::timerEvent(event);
+}
+
+void IDriverRemote::HandleConnectEvent(events::ConnectRequestEvent* ev) {
+  IDriver::HandleConnectEvent(ev);
+  if (!IsConnected()) {
+    return;
+  }
+
+  session_owner_ = ev->sender();
+  health_.Start(common::time::current_utc_mstime());
+  if (timer_health_id_ == 0) {
+    timer_health_id_ = startTimer(kHealthCheckIntervalMsec);
+    DCHECK_NE(timer_health_id_, 0);
+  }
+  NotifyHealth();
+}
+
+void IDriverRemote::HandleDisconnectEvent(events::DisconnectRequestEvent* ev) {
+  health_.Stop();
+  if (timer_health_id_ != 0) {
+    killTimer(timer_health_id_);
+    timer_health_id_ = 0;
+  }
+  NotifyHealth();
+  IDriver::HandleDisconnectEvent(ev);
+}
+
+void IDriverRemote::HandleRepointEvent(events::RepointRequestEvent* ev) {
+  QObject* sender = ev->sender();
+  NotifyProgress(sender, 0);
+  events::RepointResponseEvent::value_type res(ev->value());
+  if (!(GetHost() == res.host)) {
+    {
+      std::lock_guard<std::mutex> lock(host_mutex_);
+      repointed_host_ = res.host;
+      is_repointed_ = true;
+    }
+    if (health_.IsActive()) {
+      // handled as lost link, so requests queued meanwhile wait for new node instead of failing
+      health_.Lost(common::make_error("Node moved to " + common::ConvertToString(res.host)),
+                   common::time::current_utc_mstime());
+      NotifyHealth();
+      NotifyProgress(sender, 50);
+      res.is_reconnected = TryReconnect();
+    }
+  }
+  NotifyProgress(sender, 75);
+  Reply(sender, new events::RepointResponseEvent(this, res));
+  NotifyProgress(sender, 100);
+}
+
+common::Error IDriverRemote::SyncPing() {
+  // health checks run every few seconds, they must not flood command log
+  core::FastoObjectCommandIPtr cmd = CreateCommandFast(GEN_CMD_STRING(PING_COMMAND), core::C_INNER);
+  return ExecuteImpl(cmd->GetInputCommand(), cmd.get());
+}
+
+common::Error IDriverRemote::SyncReconnect() {
+  common::Error err = SyncDisconnect();
+  UNUSED(err);  // connection is broken already
+  return SyncConnect();
+}
+
+void IDriverRemote::ConnectionQuited() {
+  if (!health_.IsActive() || health_.IsReconnecting()) {
+    return;
+  }
+
+  health_.Lost(common::make_error("Connection closed"), common::time::current_utc_mstime());
+  NotifyHealth();
+}
+
+void IDriverRemote::CheckHealth() {
+  const common::time64_t now = common::time::current_utc_mstime();
+  if (health_.IsReconnectDue(now)) {
+    TryReconnect();
+    return;
+  }
+
+  if (!health_.IsPingDue(now)) {
+    return;
+  }
+
+  common::Error err = IsConnected() ? SyncPing() : common::make_error("Connection lost");
+  const common::time64_t after = common::time::current_utc_mstime();
+  if (err) {
+    health_.Lost(err, after);
+    NotifyHealth();
+    TryReconnect();
+    return;
+  }
+
+  health_.PingSucceeded(after - now, after);
+  NotifyHealth();
+}
+
+bool IDriverRemote::TryReconnect() {
+  common::Error err = SyncReconnect();
+  const common::time64_t now = common::time::current_utc_mstime();
+  if (err) {
+    health_.ReconnectFailed(err, now);
+    NotifyHealth();
+    return false;
+  }
+
+  health_.Reconnected(now);
+  NotifyHealth();
+  if (session_owner_) {
+    // owner refreshes server info and discovery the same way as after its own connect
+    const events_info::ConnectInfoRequest req(session_owner_);
+    events::ConnectResponseEvent::value_type res(req);
+    Reply(session_owner_, new events::ConnectResponseEvent(this, res));
+  }
+  return true;
+}
+
+void IDriverRemote::NotifyHealth() {
+  emit HealthChanged(health_.GetInfo());
+}
+
 }  // namespace proxy
 }  // namespace fastonosql
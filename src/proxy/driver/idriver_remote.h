@@ -18,9 +18,12 @@
 
 #pragma once
 
+#include <mutex>
+
 #include <common/net/types.h>
 
 #include "proxy/connection_settings/iconnection_settings.h"
+#include "proxy/driver/connection_health.h"
 #include "proxy/driver/idriver.h"
 
 namespace fastonosql {
@@ -30,6 +33,7 @@ class IDriverRemote : public IDriver {
   Q_OBJECT
 
  public:
+  // address driver connects to, sentinel failover moves it away from saved settings
   common::net::HostAndPort GetHost() const;
 
   core::translator_t GetTranslator() const override = 0;
@@ -40,8 +44,40 @@ class IDriverRemote : public IDriver {
   bool IsConnected() const override = 0;
   bool IsAuthenticated() const override = 0;
 
+ Q_SIGNALS:
+  void HealthChanged(const fastonosql::proxy::ConnectionHealthInfo& info);
+
  protected:
   explicit IDriverRemote(IConnectionSettingsBaseSPtr settings);
+
+  void customEvent(QEvent* event) override;
+  void timerEvent(QTimerEvent* event) override;
+
+  void HandleConnectEvent(events::ConnectRequestEvent* ev) override;
+  void HandleDisconnectEvent(events::DisconnectRequestEvent* ev) override;
+  virtual void HandleRepointEvent(events::RepointRequestEvent* ev);
+
+  // lightweight round trip for keepalive, PING by default
+  virtual common::Error SyncPing() WARN_UNUSED_RESULT;
+  // reopens lost connection, drivers restore session state (selected database) not covered by SyncConnect
+  virtual common::Error SyncReconnect() WARN_UNUSED_RESULT;
+
+ private Q_SLOTS:
+  void ConnectionQuited();
+
+ private:
+  void CheckHealth();
+  bool TryReconnect();
+  void NotifyHealth();
+
+  ConnectionHealth health_;
+  int timer_health_id_;
+  QObject* session_owner_;  // server which opened connection, gets connect reply after reconnect
+
+  // settings are shared with saved connections list, so re-pointed address lives only here
+  mutable std::mutex host_mutex_;
+  common::net::HostAndPort repointed_host_;
+  bool is_repointed_;
 };
 
 }  // namespace proxy
@@ -77,6 +77,22 @@ typedef common::qt::Event<events_info::LoadDatabaseContentResponse, QEvent::User
 typedef common::qt::Event<events_info::DiscoveryInfoRequest, QEvent::User + 33> DiscoveryInfoRequestEvent;
 typedef common::qt::Event<events_info::DiscoveryInfoResponse, QEvent::User + 34> DiscoveryInfoResponseEvent;
 
+typedef common::qt::Event<events_info::LoadKeyPageRequest, QEvent::User + 35> LoadKeyPageRequestEvent;
+typedef common::qt::Event<events_info::LoadKeyPageResponse, QEvent::User + 36> LoadKeyPageResponseEvent;
+
+typedef common::qt::Event<events_info::LoadStreamPageRequest, QEvent::User + 37> LoadStreamPageRequestEvent;
+typedef common::qt::Event<events_info::LoadStreamPageResponse, QEvent::User + 38> LoadStreamPageResponseEvent;
+typedef common::qt::Event<events_info::ChangeKeyValueRequest, QEvent::User + 39> ChangeKeyValueRequestEvent;
+typedef common::qt::Event<events_info::ChangeKeyValueResponse, QEvent::User + 40> ChangeKeyValueResponseEvent;
+
+typedef common::qt::Event<events_info::DumpKeysRequest, QEvent::User + 41> DumpKeysRequestEvent;
+typedef common::qt::Event<events_info::DumpKeysResponse, QEvent::User + 42> DumpKeysResponseEvent;
+typedef common::qt::Event<events_info::RestoreKeysRequest, QEvent::User + 43> RestoreKeysRequestEvent;
+typedef common::qt::Event<events_info::RestoreKeysResponse, QEvent::User + 44> RestoreKeysResponseEvent;
+
+typedef common::qt::Event<events_info::RepointInfoRequest, QEvent::User + 45> RepointRequestEvent;
+typedef common::qt::Event<events_info::RepointInfoResponse, QEvent::User + 46> RepointResponseEvent;
+
 typedef common::qt::Event<events_info::ProgressInfoResponse, QEvent::User + 100> ProgressResponseEvent;
 
 }  // namespace events
@@ -34,12 +34,16 @@ common::time64_t EventInfoBase::GetElapsedTime() const {
   return common::time::current_utc_mstime() - time_start_;
 }
 
-ConnectInfoRequest::ConnectInfoRequest(initiator_type sender, error_type er) : base_class(sender, er) {}
+ConnectInfoRequest::ConnectInfoRequest(initiator_type sender, bool defer_discovery, error_type er)
+    : base_class(sender, er), defer_discovery(defer_discovery) {}
 
 ConnectInfoResponse::ConnectInfoResponse(const base_class& request) : base_class(request) {}
 
-BackupInfoRequest::BackupInfoRequest(initiator_type sender, const std::string& path, error_type er)
-    : base_class(sender, er), path(path) {}
+BackupInfoRequest::BackupInfoRequest(initiator_type sender,
+                                     const std::string& path,
+                                     bool incremental,
+                                     error_type er)
+    : base_class(sender, er), path(path), incremental(incremental) {}
 
 BackupInfoResponse::BackupInfoResponse(const base_class& request) : base_class(request) {}
 
@@ -74,6 +78,11 @@ DisConnectInfoRequest::DisConnectInfoRequest(initiator_type sender, error_type e
 
 DisConnectInfoResponse::DisConnectInfoResponse(const base_class& request) : base_class(request) {}
 
+RepointInfoRequest::RepointInfoRequest(initiator_type sender, const common::net::HostAndPort& host, error_type er)
+    : base_class(sender, er), host(host) {}
+
+RepointInfoResponse::RepointInfoResponse(const base_class& request) : base_class(request), is_reconnected(false) {}
+
 ExecuteInfoRequest::ExecuteInfoRequest(initiator_type sender,
                                        const core::command_buffer_t& text,
                                        size_t repeat,
@@ -81,6 +90,7 @@ ExecuteInfoRequest::ExecuteInfoRequest(initiator_type sender,
                                        bool history,
                                        bool silence,
                                        core::CmdLoggingType logtype,
+                                       bool notify_keys,
                                        error_type er)
     : base_class(sender, er),
       text(text),
@@ -88,9 +98,11 @@ ExecuteInfoRequest::ExecuteInfoRequest(initiator_type sender,
       msec_repeat_interval(msec_repeat_interval),
       history(history),
       silence(silence),
-      logtype(logtype) {}
+      logtype(logtype),
+      notify_keys(notify_keys) {}
 
-ExecuteInfoResponse::ExecuteInfoResponse(const base_class& request) : base_class(request) {}
+ExecuteInfoResponse::ExecuteInfoResponse(const base_class& request)
+    : base_class(request), executed_commands(), loaded_keys() {}
 
 LoadDatabasesInfoRequest::LoadDatabasesInfoRequest(initiator_type sender, error_type er) : base_class(sender, er) {}
 
@@ -107,6 +119,56 @@ LoadDatabaseContentRequest::LoadDatabaseContentRequest(initiator_type sender,
 LoadDatabaseContentResponse::LoadDatabaseContentResponse(const base_class& request)
     : base_class(request), keys(), cursor_out(0), db_keys_count(0) {}
 
+LoadKeyPageRequest::LoadKeyPageRequest(initiator_type sender,
+                                       const core::NKey& key,
+                                       common::Value::Type type,
+                                       core::keys_limit_t count,
+                                       core::cursor_t cursor,
+                                       error_type er)
+    : base_class(sender, er), key(key), type(type), count(count), cursor_in(cursor) {}
+
+LoadKeyPageResponse::LoadKeyPageResponse(const base_class& request) : base_class(request), page(), cursor_out(0) {}
+
+LoadStreamPageRequest::LoadStreamPageRequest(initiator_type sender,
+                                             const core::NKey& key,
+                                             const core::StreamValue::stream_id& start_id,
+                                             core::keys_limit_t count,
+                                             bool reverse,
+                                             error_type er)
+    : base_class(sender, er), key(key), start_id(start_id), count(count), reverse(reverse) {}
+
+LoadStreamPageResponse::LoadStreamPageResponse(const base_class& request)
+    : base_class(request), streams(), next_id() {}
+
+ChangeKeyValueRequest::ChangeKeyValueRequest(initiator_type sender,
+                                             const core::NKey& key,
+                                             common::Value::Type type,
+                                             const KeyChangeSet& changes,
+                                             error_type er)
+    : base_class(sender, er), key(key), type(type), changes(changes) {}
+
+ChangeKeyValueResponse::ChangeKeyValueResponse(const base_class& request) : base_class(request), commands_count(0) {}
+
+DumpKeysRequest::DumpKeysRequest(initiator_type sender,
+                                 const std::string& path,
+                                 const core::pattern_t& pattern,
+                                 size_t workers_count,
+                                 bool resume,
+                                 error_type er)
+    : base_class(sender, er), path(path), pattern(pattern), workers_count(workers_count), resume(resume) {}
+
+DumpKeysResponse::DumpKeysResponse(const base_class& request) : base_class(request), keys_count(0), chunks_count(0) {}
+
+RestoreKeysRequest::RestoreKeysRequest(initiator_type sender,
+                                       const std::string& path,
+                                       size_t workers_count,
+                                       bool resume,
+                                       error_type er)
+    : base_class(sender, er), path(path), workers_count(workers_count), resume(resume) {}
+
+RestoreKeysResponse::RestoreKeysResponse(const base_class& request)
+    : base_class(request), keys_count(0), chunks_count(0) {}
+
 LoadServerChannelsRequest::LoadServerChannelsRequest(initiator_type sender, const std::string& pattern, error_type er)
     : base_class(sender, er), pattern(pattern) {}
 
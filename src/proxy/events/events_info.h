@@ -21,6 +21,7 @@
 #include <string>
 #include <vector>
 
+#include <common/net/types.h>
 #include <common/qt/utils_qt.h>
 
 #include <fastonosql/core/command_info.h>
@@ -28,6 +29,7 @@
 #include <fastonosql/core/db_key.h>
 #include <fastonosql/core/server/iserver_info.h>
 #include <fastonosql/core/server_property_info.h>
+#include <fastonosql/core/value.h>
 
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
 #include <fastonosql/core/module_info.h>
@@ -37,6 +39,7 @@
 
 #include "proxy/db_client.h"
 #include "proxy/db_ps_channel.h"
+#include "proxy/key_change_set.h"
 
 namespace fastonosql {
 namespace proxy {
@@ -55,7 +58,8 @@ class EventInfoBase : public common::qt::EventInfo<common::Error> {
 
 struct ConnectInfoRequest : public EventInfoBase {
   typedef EventInfoBase base_class;
-  explicit ConnectInfoRequest(initiator_type sender, error_type er = error_type());
+  explicit ConnectInfoRequest(initiator_type sender, bool defer_discovery = false, error_type er = error_type());
+  bool defer_discovery;  // server info and discovery wait for IServer::LoadDeferredDiscovery
 };
 
 struct ConnectInfoResponse : ConnectInfoRequest {
@@ -65,8 +69,12 @@ struct ConnectInfoResponse : ConnectInfoRequest {
 
 struct BackupInfoRequest : public EventInfoBase {
   typedef EventInfoBase base_class;
-  BackupInfoRequest(initiator_type sender, const std::string& path, error_type er = error_type());
+  BackupInfoRequest(initiator_type sender,
+                    const std::string& path,
+                    bool incremental = false,
+                    error_type er = error_type());
   std::string path;
+  bool incremental;  // add to backup set at path instead of full copy, where engine supports it
 };
 
 struct BackupInfoResponse : BackupInfoRequest {
@@ -85,6 +93,50 @@ struct RestoreInfoResponse : RestoreInfoRequest {
   explicit RestoreInfoResponse(const base_class& request);
 };
 
+struct DumpKeysRequest : public EventInfoBase {
+  typedef EventInfoBase base_class;
+  DumpKeysRequest(initiator_type sender,
+                  const std::string& path,
+                  const core::pattern_t& pattern,
+                  size_t workers_count,
+                  bool resume = false,
+                  error_type er = error_type());
+
+  const std::string path;
+  const core::pattern_t pattern;
+  const size_t workers_count;  // parallel connections
+  const bool resume;           // continue after last chunk in index
+};
+
+struct DumpKeysResponse : DumpKeysRequest {
+  typedef DumpKeysRequest base_class;
+  explicit DumpKeysResponse(const base_class& request);
+
+  size_t keys_count;
+  size_t chunks_count;
+};
+
+struct RestoreKeysRequest : public EventInfoBase {
+  typedef EventInfoBase base_class;
+  RestoreKeysRequest(initiator_type sender,
+                     const std::string& path,
+                     size_t workers_count,
+                     bool resume = false,
+                     error_type er = error_type());
+
+  const std::string path;
+  const size_t workers_count;  // parallel connections
+  const bool resume;           // skip chunks restored before
+};
+
+struct RestoreKeysResponse : RestoreKeysRequest {
+  typedef RestoreKeysRequest base_class;
+  explicit RestoreKeysResponse(const base_class& request);
+
+  size_t keys_count;
+  size_t chunks_count;
+};
+
 struct DiscoveryInfoRequest : public EventInfoBase {
   typedef EventInfoBase base_class;
   explicit DiscoveryInfoRequest(initiator_type sender, error_type er = error_type());
@@ -142,6 +194,21 @@ struct DisConnectInfoResponse : DisConnectInfoRequest {
   explicit DisConnectInfoResponse(const base_class& request);
 };
 
+// moves live connection to other node of the same role (sentinel failover)
+struct RepointInfoRequest : public EventInfoBase {
+  typedef EventInfoBase base_class;
+  RepointInfoRequest(initiator_type sender, const common::net::HostAndPort& host, error_type er = error_type());
+
+  const common::net::HostAndPort host;
+};
+
+struct RepointInfoResponse : RepointInfoRequest {
+  typedef RepointInfoRequest base_class;
+  explicit RepointInfoResponse(const base_class& request);
+
+  bool is_reconnected;  // false when connection was idle, new host is used on next connect
+};
+
 struct ExecuteInfoRequest : public EventInfoBase {
   typedef EventInfoBase base_class;
   ExecuteInfoRequest(initiator_type sender,
@@ -151,6 +218,7 @@ struct ExecuteInfoRequest : public EventInfoBase {
                      bool history = true,
                      bool silence = false,
                      core::CmdLoggingType logtype = core::C_USER,
+                     bool notify_keys = true,
                      error_type er = error_type());
 
   const core::command_buffer_t text;
@@ -159,6 +227,7 @@ struct ExecuteInfoRequest : public EventInfoBase {
   const bool history;
   const bool silence;
   const core::CmdLoggingType logtype;
+  const bool notify_keys;  // false - keys are not merged into server database, loaded ones come in response only
 };
 
 struct ExecuteInfoResponse : ExecuteInfoRequest {
@@ -166,6 +235,7 @@ struct ExecuteInfoResponse : ExecuteInfoRequest {
   explicit ExecuteInfoResponse(const base_class& request);
 
   std::vector<core::FastoObjectCommandIPtr> executed_commands;
+  std::vector<core::NDbKValue> loaded_keys;  // filled when notify_keys is false
 };
 
 struct LoadDatabasesInfoRequest : public EventInfoBase {
@@ -206,6 +276,73 @@ struct LoadDatabaseContentResponse : LoadDatabaseContentRequest {
   core::keys_limit_t db_keys_count;  // total keys count
 };
 
+struct LoadKeyPageRequest : public EventInfoBase {
+  typedef EventInfoBase base_class;
+  LoadKeyPageRequest(initiator_type sender,
+                     const core::NKey& key,
+                     common::Value::Type type,
+                     core::keys_limit_t count,
+                     core::cursor_t cursor = 0,
+                     error_type er = error_type());
+
+  const core::NKey key;
+  const common::Value::Type type;
+  const core::keys_limit_t count;  // requested
+  const core::cursor_t cursor_in;  // scan cursor or list offset
+};
+
+struct LoadKeyPageResponse : LoadKeyPageRequest {
+  typedef LoadKeyPageRequest base_class;
+  explicit LoadKeyPageResponse(const base_class& request);
+
+  core::NValue page;
+  core::cursor_t cursor_out;  // 0 if no more pages
+};
+
+struct LoadStreamPageRequest : public EventInfoBase {
+  typedef EventInfoBase base_class;
+  LoadStreamPageRequest(initiator_type sender,
+                        const core::NKey& key,
+                        const core::StreamValue::stream_id& start_id,
+                        core::keys_limit_t count,
+                        bool reverse = false,
+                        error_type er = error_type());
+
+  const core::NKey key;
+  const core::StreamValue::stream_id start_id;  // inclusive, "-" or "+" for stream edges
+  const core::keys_limit_t count;               // requested
+  const bool reverse;                           // newest entries first
+};
+
+struct LoadStreamPageResponse : LoadStreamPageRequest {
+  typedef LoadStreamPageRequest base_class;
+  typedef std::vector<core::StreamValue::Stream> streams_container_t;
+  explicit LoadStreamPageResponse(const base_class& request);
+
+  streams_container_t streams;
+  core::StreamValue::stream_id next_id;  // empty if no more entries
+};
+
+struct ChangeKeyValueRequest : public EventInfoBase {
+  typedef EventInfoBase base_class;
+  ChangeKeyValueRequest(initiator_type sender,
+                        const core::NKey& key,
+                        common::Value::Type type,
+                        const KeyChangeSet& changes,
+                        error_type er = error_type());
+
+  const core::NKey key;
+  const common::Value::Type type;
+  const KeyChangeSet changes;
+};
+
+struct ChangeKeyValueResponse : ChangeKeyValueRequest {
+  typedef ChangeKeyValueRequest base_class;
+  explicit ChangeKeyValueResponse(const base_class& request);
+
+  size_t commands_count;  // sent in one pipeline
+};
+
 struct LoadServerChannelsRequest : public EventInfoBase {
   typedef EventInfoBase base_class;
   LoadServerChannelsRequest(initiator_type sender, const std::string& pattern, error_type er = error_type());
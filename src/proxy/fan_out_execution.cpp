@@ -0,0 +1,186 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/fan_out_execution.h"
+
+#include <common/macros.h>
+
+#include "proxy/server/iserver.h"
+
+namespace fastonosql {
+namespace proxy {
+
+namespace {
+const size_t kDefaultConcurrency = 16;
+}  // namespace
+
+FanOutOptions::FanOutOptions() : concurrency(kDefaultConcurrency) {}
+
+FanOutNodeResult::FanOutNodeResult() : name(), latency_msec(0), done(false), err(), commands() {}
+
+FanOutExecution::FanOutExecution(const nodes_t& nodes,
+                                 const events_info::ExecuteInfoRequest& req,
+                                 const FanOutOptions& options,
+                                 QObject* parent)
+    : QObject(parent),
+      text_(req.text),
+      repeat_(req.repeat),
+      msec_repeat_interval_(req.msec_repeat_interval),
+      history_(req.history),
+      logtype_(req.logtype),
+      options_(options),
+      batch_(options.concurrency),
+      results_() {
+  batch_.Reset(nodes);
+}
+
+FanOutExecution::~FanOutExecution() {
+  batch_.Close(this);
+}
+
+FanOutExecution::nodes_t FanOutExecution::GetNodes() const {
+  return batch_.GetServers();
+}
+
+FanOutExecution::results_t FanOutExecution::GetResults() const {
+  return results_;
+}
+
+bool FanOutExecution::IsRunning() const {
+  return batch_.IsRunning();
+}
+
+void FanOutExecution::Start() {
+  if (batch_.IsRunning()) {
+    return;
+  }
+
+  const nodes_t nodes = batch_.GetServers();
+  batch_.Reset(nodes);
+  results_.assign(nodes.size(), FanOutNodeResult());
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    results_[i].name = nodes[i]->GetName();
+  }
+
+  if (nodes.empty()) {
+    emit Finished(results_);
+    return;
+  }
+
+  batch_.Open();
+  for (auto node : nodes) {
+    VERIFY(connect(node.get(), &IServer::ConnectFinished, this, &FanOutExecution::NodeConnected,
+                   Qt::DirectConnection));
+    VERIFY(connect(node.get(), &IServer::ExecuteFinished, this, &FanOutExecution::NodeExecuted,
+                   Qt::DirectConnection));
+  }
+  ExecuteNext();
+}
+
+void FanOutExecution::Stop() {
+  if (!batch_.IsRunning()) {
+    return;
+  }
+
+  for (size_t i = 0; i < batch_.GetCount(); ++i) {
+    if (batch_.IsTaken(i) && !batch_.IsDone(i)) {
+      batch_.GetServer(i)->StopCurrentEvent();
+    }
+  }
+
+  batch_.SkipQueued();  // nothing new is sent, left nodes are interrupted
+  for (size_t i = 0; i < results_.size() && batch_.IsRunning(); ++i) {
+    if (!batch_.IsDone(i)) {
+      FinishNode(i, common::make_error(common::COMMON_EINTR));
+    }
+  }
+}
+
+void FanOutExecution::ExecuteNext() {
+  size_t index = 0;
+  while (batch_.IsRunning() && batch_.TakeNext(&index)) {
+    IServerSPtr node = batch_.GetServer(index);
+    if (node->IsConnected()) {
+      Execute(index);
+      continue;
+    }
+
+    // commands are sent after connect, so latency of node doesn't include it
+    events_info::ConnectInfoRequest req(this);
+    node->Connect(req);
+  }
+}
+
+void FanOutExecution::Execute(size_t index) {
+  batch_.StartClock(index);
+  events_info::ExecuteInfoRequest req(this, text_, repeat_, msec_repeat_interval_, history_, true, logtype_);
+  batch_.GetServer(index)->ExecuteDirect(req);  // every node answers itself, no cluster routing
+}
+
+void FanOutExecution::NodeConnected(const events_info::ConnectInfoResponse& res) {
+  size_t index = 0;
+  if (res.initiator() != this || !batch_.IsRunning() || !batch_.FindServer(sender(), &index) ||
+      batch_.IsDone(index)) {
+    return;
+  }
+
+  common::Error err = res.errorInfo();
+  if (err) {
+    FinishNode(index, err);
+    return;
+  }
+
+  Execute(index);
+}
+
+void FanOutExecution::NodeExecuted(const events_info::ExecuteInfoResponse& res) {
+  size_t index = 0;
+  if (res.initiator() != this || !batch_.IsRunning() || !batch_.FindServer(sender(), &index) ||
+      batch_.IsDone(index)) {
+    return;
+  }
+
+  results_[index].commands = res.executed_commands;
+  FinishNode(index, res.errorInfo());
+}
+
+void FanOutExecution::FinishNode(size_t index, common::Error err) {
+  FanOutNodeResult& result = results_[index];
+  result.done = true;
+  result.err = err;
+  result.latency_msec = batch_.FinishServer(index);
+  emit NodeFinished(index, result);
+
+  if (!batch_.IsAllDone()) {
+    ExecuteNext();
+    return;
+  }
+
+  Finish();
+}
+
+void FanOutExecution::Finish() {
+  if (!batch_.Close(this)) {
+    return;
+  }
+
+  emit Finished(results_);
+}
+
+}  // namespace proxy
+}  // namespace fastonosql
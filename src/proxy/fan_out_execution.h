@@ -0,0 +1,101 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <QObject>
+
+#include <common/error.h>
+
+#include <fastonosql/core/global.h>
+
+#include "proxy/events/events_info.h"
+#include "proxy/proxy_fwd.h"
+#include "proxy/server_batch.h"
+
+namespace fastonosql {
+namespace proxy {
+
+struct FanOutOptions {
+  FanOutOptions();
+
+  size_t concurrency;  // requests in flight at once, 0 - all nodes at once
+};
+
+struct FanOutNodeResult {
+  FanOutNodeResult();
+
+  std::string name;
+  common::time64_t latency_msec;  // execution only, connect of node is not counted
+  bool done;
+  common::Error err;
+  std::vector<core::FastoObjectCommandIPtr> commands;
+};
+
+// Sends same commands to every node, each node executes them in own driver thread.
+// Results are kept per node in order of nodes, not in order of answers.
+class FanOutExecution : public QObject {
+  Q_OBJECT
+
+ public:
+  typedef ServerBatch::servers_t nodes_t;
+  typedef std::vector<FanOutNodeResult> results_t;
+
+  FanOutExecution(const nodes_t& nodes,
+                  const events_info::ExecuteInfoRequest& req,
+                  const FanOutOptions& options,
+                  QObject* parent = Q_NULLPTR);
+  ~FanOutExecution() override;
+
+  nodes_t GetNodes() const;
+  results_t GetResults() const;
+  bool IsRunning() const;
+
+  void Start();
+  void Stop();
+
+ Q_SIGNALS:
+  void NodeFinished(size_t index, const fastonosql::proxy::FanOutNodeResult& result);
+  void Finished(const fastonosql::proxy::FanOutExecution::results_t& results);
+
+ private Q_SLOTS:
+  void NodeConnected(const events_info::ConnectInfoResponse& res);
+  void NodeExecuted(const events_info::ExecuteInfoResponse& res);
+
+ private:
+  void ExecuteNext();
+  void Execute(size_t index);
+  void FinishNode(size_t index, common::Error err);
+  void Finish();
+
+  const core::command_buffer_t text_;
+  const size_t repeat_;
+  const common::time64_t msec_repeat_interval_;
+  const bool history_;
+  const core::CmdLoggingType logtype_;
+  const FanOutOptions options_;
+
+  ServerBatch batch_;
+  results_t results_;
+};
+
+}  // namespace proxy
+}  // namespace fastonosql
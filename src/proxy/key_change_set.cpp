@@ -0,0 +1,59 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/key_change_set.h"
+
+namespace fastonosql {
+namespace proxy {
+
+KeyChangeSet::KeyChangeSet() : set_(), added_(), removed_() {}
+
+bool KeyChangeSet::IsEmpty() const {
+  return set_.empty() && added_.empty() && removed_.empty();
+}
+
+size_t KeyChangeSet::GetSize() const {
+  return set_.size() + added_.size() + removed_.size();
+}
+
+KeyChangeSet::pairs_t KeyChangeSet::GetSetMembers() const {
+  return set_;
+}
+
+void KeyChangeSet::SetMember(const member_t& first, const member_t& second) {
+  set_.push_back(std::make_pair(first, second));
+}
+
+KeyChangeSet::members_t KeyChangeSet::GetAddedMembers() const {
+  return added_;
+}
+
+void KeyChangeSet::AddMember(const member_t& member) {
+  added_.push_back(member);
+}
+
+KeyChangeSet::members_t KeyChangeSet::GetRemovedMembers() const {
+  return removed_;
+}
+
+void KeyChangeSet::RemoveMember(const member_t& member) {
+  removed_.push_back(member);
+}
+
+}  // namespace proxy
+}  // namespace fastonosql
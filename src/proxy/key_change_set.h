@@ -0,0 +1,62 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include <common/value.h>
+
+namespace fastonosql {
+namespace proxy {
+
+// Members changed in a collection editor, lets a save touch only what was edited.
+// hash: set - field/value, removed - fields
+// set: added - members, removed - members
+// zset: set - score/member, removed - members
+// list: set - index/value, added - values pushed to the tail, removed - indexes
+class KeyChangeSet {
+ public:
+  typedef common::Value::string_t member_t;
+  typedef std::pair<member_t, member_t> pair_t;
+  typedef std::vector<member_t> members_t;
+  typedef std::vector<pair_t> pairs_t;
+
+  KeyChangeSet();
+
+  bool IsEmpty() const;
+  size_t GetSize() const;
+
+  pairs_t GetSetMembers() const;
+  void SetMember(const member_t& first, const member_t& second);
+
+  members_t GetAddedMembers() const;
+  void AddMember(const member_t& member);
+
+  members_t GetRemovedMembers() const;
+  void RemoveMember(const member_t& member);
+
+ private:
+  pairs_t set_;
+  members_t added_;
+  members_t removed_;
+};
+
+}  // namespace proxy
+}  // namespace fastonosql
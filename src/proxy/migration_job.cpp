@@ -0,0 +1,400 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "proxy/migration_job.h"
+
+#include <algorithm>
+
+#include <QTimer>
+
+#include <common/macros.h>
+#include <common/time.h>
+
+#include <fastonosql/core/macros.h>
+
+#include "proxy/server/iserver.h"
+
+namespace fastonosql {
+namespace proxy {
+
+namespace {
+const core::keys_limit_t kDefaultBatchSize = 1000;
+const size_t kDefaultQueueCapacity = 10000;
+
+double CalcRate(size_t keys, common::time64_t msec) {
+  if (msec <= 0) {
+    return 0;
+  }
+
+  return static_cast<double>(keys) * 1000 / static_cast<double>(msec);
+}
+}  // namespace
+
+MigrationOptions::MigrationOptions()
+    : pattern(ALL_KEYS_PATTERNS),
+      batch_size(kDefaultBatchSize),
+      queue_capacity(kDefaultQueueCapacity),
+      keys_per_second(0) {}
+
+MigrationStats::MigrationStats()
+    : read_keys(0), read_msec(0), written_keys(0), write_msec(0), queued_keys(0), skipped_keys(0) {}
+
+double MigrationStats::GetReadRate() const {
+  return CalcRate(read_keys, read_msec);
+}
+
+double MigrationStats::GetWriteRate() const {
+  return CalcRate(written_keys, write_msec);
+}
+
+MigrationJob::MigrationJob(IServerSPtr source, IServerSPtr target, const MigrationOptions& options, QObject* parent)
+    : QObject(parent),
+      source_(source),
+      target_(target),
+      options_(options),
+      stats_(),
+      batch_(),
+      source_ready_(false),
+      target_ready_(false),
+      scan_done_(false),
+      read_in_flight_(false),
+      write_in_flight_(false),
+      pump_scheduled_(false),
+      cursor_(0),
+      read_started_msec_(0),
+      write_started_msec_(0),
+      start_msec_(0),
+      write_in_flight_keys_(0),
+      pending_(),
+      queue_() {
+  CHECK(source_ && target_);
+  batch_.Reset({source_, target_});
+}
+
+MigrationJob::~MigrationJob() {
+  batch_.Close(this);
+}
+
+IServerSPtr MigrationJob::GetSource() const {
+  return source_;
+}
+
+IServerSPtr MigrationJob::GetTarget() const {
+  return target_;
+}
+
+MigrationOptions MigrationJob::GetOptions() const {
+  return options_;
+}
+
+MigrationStats MigrationJob::GetStats() const {
+  return stats_;
+}
+
+bool MigrationJob::IsRunning() const {
+  return batch_.IsRunning();
+}
+
+void MigrationJob::Start() {
+  if (batch_.IsRunning()) {
+    return;
+  }
+
+  if (source_ == target_) {
+    emit Finished(common::make_error("Migration source and target should be different servers."), stats_);
+    return;
+  }
+
+  if (options_.batch_size == 0 || options_.queue_capacity == 0) {
+    emit Finished(common::make_error_inval(), stats_);
+    return;
+  }
+
+  stats_ = MigrationStats();
+  batch_.Open();
+  scan_done_ = false;
+  read_in_flight_ = false;
+  write_in_flight_ = false;
+  write_in_flight_keys_ = 0;
+  cursor_ = 0;
+  pending_.clear();
+  queue_.clear();
+  start_msec_ = common::time::current_utc_mstime();
+
+  IServer* source = source_.get();
+  IServer* target = target_.get();
+  VERIFY(connect(source, &IServer::ConnectFinished, this, &MigrationJob::SourceConnected, Qt::DirectConnection));
+  VERIFY(connect(target, &IServer::ConnectFinished, this, &MigrationJob::TargetConnected, Qt::DirectConnection));
+  VERIFY(connect(source, &IServer::LoadDiscoveryInfoFinished, this, &MigrationJob::SourceDiscovered,
+                 Qt::DirectConnection));
+  VERIFY(connect(target, &IServer::LoadDiscoveryInfoFinished, this, &MigrationJob::TargetDiscovered,
+                 Qt::DirectConnection));
+  VERIFY(connect(source, &IServer::LoadDatabaseContentFinished, this, &MigrationJob::PageLoaded,
+                 Qt::DirectConnection));
+  VERIFY(connect(source, &IServer::ExecuteFinished, this, &MigrationJob::SourceExecuted, Qt::DirectConnection));
+  VERIFY(connect(target, &IServer::ExecuteFinished, this, &MigrationJob::TargetExecuted, Qt::DirectConnection));
+
+  source_ready_ = source_->IsConnected() && source_->GetCurrentDatabaseInfo();
+  target_ready_ = target_->IsConnected() && target_->GetCurrentDatabaseInfo();
+  ConnectServer(source_);
+  ConnectServer(target_);
+  Pump();
+}
+
+void MigrationJob::Stop() {
+  if (!batch_.IsRunning()) {
+    return;
+  }
+
+  source_->StopCurrentEvent();
+  target_->StopCurrentEvent();
+  Finish(common::make_error(common::COMMON_EINTR));
+}
+
+void MigrationJob::ConnectServer(IServerSPtr server) {
+  if (server->IsConnected()) {
+    return;
+  }
+
+  events_info::ConnectInfoRequest req(this);
+  server->Connect(req);
+}
+
+void MigrationJob::SourceConnected(const events_info::ConnectInfoResponse& res) {
+  common::Error err = res.errorInfo();
+  if (err) {
+    Finish(err);
+  }
+}
+
+void MigrationJob::TargetConnected(const events_info::ConnectInfoResponse& res) {
+  common::Error err = res.errorInfo();
+  if (err) {
+    Finish(err);
+  }
+}
+
+void MigrationJob::SourceDiscovered(const events_info::DiscoveryInfoResponse& res) {
+  common::Error err = res.errorInfo();
+  if (err) {
+    Finish(err);
+    return;
+  }
+
+  source_ready_ = true;
+  Pump();
+}
+
+void MigrationJob::TargetDiscovered(const events_info::DiscoveryInfoResponse& res) {
+  common::Error err = res.errorInfo();
+  if (err) {
+    Finish(err);
+    return;
+  }
+
+  target_ready_ = true;
+  Pump();
+}
+
+void MigrationJob::Pump() {
+  pump_scheduled_ = false;
+  if (!batch_.IsRunning() || !source_ready_ || !target_ready_) {
+    return;
+  }
+
+  WriteNext();
+  ReadNext();
+  if (scan_done_ && !read_in_flight_ && !write_in_flight_ && queue_.empty()) {
+    Finish(common::Error());
+  }
+}
+
+void MigrationJob::SchedulePump(common::time64_t msec) {
+  if (pump_scheduled_) {
+    return;
+  }
+
+  pump_scheduled_ = true;
+  QTimer::singleShot(static_cast<int>(msec), this, &MigrationJob::Pump);
+}
+
+void MigrationJob::ReadNext() {
+  if (read_in_flight_ || scan_done_ || queue_.size() >= options_.queue_capacity) {
+    return;
+  }
+
+  read_in_flight_ = true;
+  read_started_msec_ = common::time::current_utc_mstime();
+  events_info::LoadDatabaseContentRequest req(this, source_->GetCurrentDatabaseInfo(), options_.pattern,
+                                              options_.batch_size, cursor_);
+  source_->LoadDatabaseContent(req);
+}
+
+void MigrationJob::PageLoaded(const events_info::LoadDatabaseContentResponse& res) {
+  if (res.initiator() != this || !batch_.IsRunning()) {
+    return;
+  }
+
+  common::Error err = res.errorInfo();
+  if (err) {
+    Finish(err);
+    return;
+  }
+
+  cursor_ = res.cursor_out;
+  scan_done_ = cursor_ == 0;
+
+  core::translator_t tran = source_->GetTranslator();
+  core::command_buffer_writer_t wr;
+  for (const core::NDbKValue& key : res.keys) {
+    const core::NKey nkey = key.GetKey();
+    core::command_buffer_t cmd_str;
+    err = tran->LoadKeyCommand(nkey, key.GetType(), &cmd_str);
+    if (err) {
+      Finish(err);
+      return;
+    }
+
+    pending_[nkey.GetKey().GetForCommandLine()] = nkey.GetTTL();
+    wr << cmd_str << "\n";
+  }
+
+  if (pending_.empty()) {
+    read_in_flight_ = false;
+    stats_.read_msec += common::time::current_utc_mstime() - read_started_msec_;
+    Pump();
+    return;
+  }
+
+  events_info::ExecuteInfoRequest req(this, wr.str(), 0, 0, false, true, core::C_INNER, false);
+  source_->Execute(req);
+}
+
+void MigrationJob::SourceExecuted(const events_info::ExecuteInfoResponse& res) {
+  if (res.initiator() != this || !batch_.IsRunning()) {
+    return;
+  }
+
+  read_in_flight_ = false;
+  stats_.read_msec += common::time::current_utc_mstime() - read_started_msec_;
+  common::Error err = res.errorInfo();
+  if (err) {
+    pending_.clear();
+    Finish(err);
+    return;
+  }
+
+  for (const core::NDbKValue& key : res.loaded_keys) {
+    const auto it = pending_.find(key.GetKey().GetKey().GetForCommandLine());
+    if (it == pending_.end()) {
+      continue;
+    }
+
+    queue_.push_back(std::make_pair(key, it->second));
+    pending_.erase(it);
+    stats_.read_keys++;
+  }
+
+  stats_.skipped_keys += pending_.size();  // expired or removed between scan and load
+  pending_.clear();
+
+  stats_.queued_keys = queue_.size();
+  emit Progressed(stats_);
+  Pump();
+}
+
+void MigrationJob::WriteNext() {
+  if (write_in_flight_ || queue_.empty()) {
+    return;
+  }
+
+  size_t count = std::min(queue_.size(), static_cast<size_t>(options_.batch_size));
+  if (options_.keys_per_second) {
+    // token bucket, one batch of burst
+    const size_t rate = options_.keys_per_second;
+    const common::time64_t elapsed = common::time::current_utc_mstime() - start_msec_;
+    const size_t allowed = rate * elapsed / 1000 + std::min(count, rate);
+    if (allowed <= stats_.written_keys) {
+      const size_t need = stats_.written_keys - allowed + 1;
+      SchedulePump(need * 1000 / rate + 1);
+      return;
+    }
+    count = std::min(count, allowed - stats_.written_keys);
+  }
+
+  core::translator_t tran = target_->GetTranslator();
+  const bool support_ttl = target_->IsSupportTTLKeys();
+  core::command_buffer_writer_t wr;
+  for (size_t i = 0; i < count; ++i) {
+    const auto& item = queue_[i];
+    core::command_buffer_t cmd_str;
+    common::Error err = tran->CreateKeyCommand(item.first, &cmd_str);
+    if (err) {
+      Finish(err);
+      return;
+    }
+    wr << cmd_str << "\n";
+
+    if (support_ttl && item.second > 0) {
+      err = tran->ChangeKeyTTLCommand(item.first.GetKey(), item.second, &cmd_str);
+      if (err) {
+        Finish(err);
+        return;
+      }
+      wr << cmd_str << "\n";
+    }
+  }
+
+  queue_.erase(queue_.begin(), queue_.begin() + count);
+  write_in_flight_ = true;
+  write_in_flight_keys_ = count;
+  write_started_msec_ = common::time::current_utc_mstime();
+  events_info::ExecuteInfoRequest req(this, wr.str(), 0, 0, false, true, core::C_INNER, false);
+  target_->Execute(req);
+}
+
+void MigrationJob::TargetExecuted(const events_info::ExecuteInfoResponse& res) {
+  if (res.initiator() != this || !batch_.IsRunning()) {
+    return;
+  }
+
+  write_in_flight_ = false;
+  stats_.write_msec += common::time::current_utc_mstime() - write_started_msec_;
+  common::Error err = res.errorInfo();
+  if (err) {
+    Finish(err);
+    return;
+  }
+
+  stats_.written_keys += write_in_flight_keys_;
+  write_in_flight_keys_ = 0;
+  stats_.queued_keys = queue_.size();
+  emit Progressed(stats_);
+  Pump();
+}
+
+void MigrationJob::Finish(common::Error err) {
+  if (!batch_.Close(this)) {
+    return;
+  }
+
+  stats_.queued_keys = queue_.size();
+  emit Finished(err, stats_);
+}
+
+}  // namespace proxy
+}  // namespace fastonosql
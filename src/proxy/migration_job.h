@@ -0,0 +1,125 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <deque>
+#include <map>
+#include <utility>
+
+#include <QObject>
+
+#include <common/error.h>
+
+#include <fastonosql/core/types.h>
+
+#include "proxy/events/events_info.h"
+#include "proxy/proxy_fwd.h"
+#include "proxy/server_batch.h"
+
+namespace fastonosql {
+namespace proxy {
+
+struct MigrationOptions {
+  MigrationOptions();
+
+  core::pattern_t pattern;
+  core::keys_limit_t batch_size;  // keys per scan page and per write pipeline
+  size_t queue_capacity;          // max loaded keys waiting for the writer
+  size_t keys_per_second;         // write limit, 0 - unlimited
+};
+
+struct MigrationStats {
+  MigrationStats();
+
+  double GetReadRate() const;   // keys/sec
+  double GetWriteRate() const;  // keys/sec
+
+  size_t read_keys;
+  common::time64_t read_msec;
+  size_t written_keys;
+  common::time64_t write_msec;
+  size_t queued_keys;
+  size_t skipped_keys;  // expired, removed or failed to load between scan and load
+};
+
+// Copies keys matching pattern from source into target, engines can differ.
+// Reader: scan page -> load keys commands batch on source.
+// Writer: create key (+ttl) commands batch on target.
+// Stages are linked by bounded queue, reader waits while queue is full.
+// Values live only in the queue, they are not merged into databases of source or target.
+class MigrationJob : public QObject {
+  Q_OBJECT
+
+ public:
+  MigrationJob(IServerSPtr source, IServerSPtr target, const MigrationOptions& options, QObject* parent = Q_NULLPTR);
+  ~MigrationJob() override;
+
+  IServerSPtr GetSource() const;
+  IServerSPtr GetTarget() const;
+  MigrationOptions GetOptions() const;
+  MigrationStats GetStats() const;
+  bool IsRunning() const;
+
+  void Start();
+  void Stop();
+
+ Q_SIGNALS:
+  void Progressed(const fastonosql::proxy::MigrationStats& stats);
+  void Finished(common::Error err, const fastonosql::proxy::MigrationStats& stats);
+
+ private Q_SLOTS:
+  void SourceConnected(const events_info::ConnectInfoResponse& res);
+  void TargetConnected(const events_info::ConnectInfoResponse& res);
+  void SourceDiscovered(const events_info::DiscoveryInfoResponse& res);
+  void TargetDiscovered(const events_info::DiscoveryInfoResponse& res);
+  void PageLoaded(const events_info::LoadDatabaseContentResponse& res);
+  void SourceExecuted(const events_info::ExecuteInfoResponse& res);
+  void TargetExecuted(const events_info::ExecuteInfoResponse& res);
+  void Pump();
+
+ private:
+  void ReadNext();
+  void WriteNext();
+  void Finish(common::Error err);
+  void ConnectServer(IServerSPtr server);
+  void SchedulePump(common::time64_t msec);
+
+  const IServerSPtr source_;
+  const IServerSPtr target_;
+  const MigrationOptions options_;
+  MigrationStats stats_;
+
+  ServerBatch batch_;  // source and target, only running state and signals are shared
+  bool source_ready_;
+  bool target_ready_;
+  bool scan_done_;
+  bool read_in_flight_;
+  bool write_in_flight_;
+  bool pump_scheduled_;
+  core::cursor_t cursor_;
+  common::time64_t read_started_msec_;
+  common::time64_t write_started_msec_;
+  common::time64_t start_msec_;
+  size_t write_in_flight_keys_;
+
+  std::map<core::command_buffer_t, core::ttl_t> pending_;       // key -> ttl, loading on source
+  std::deque<std::pair<core::NDbKValue, core::ttl_t>> queue_;  // loaded, waiting for the writer
+};
+
+}  // namespace proxy
+}  // namespace fastonosql
@@ -29,6 +29,11 @@ typedef std::shared_ptr<IDatabase> IDatabaseSPtr;
 class IServer;
 typedef std::shared_ptr<IServer> IServerSPtr;
 
+class MigrationJob;
+typedef std::shared_ptr<MigrationJob> MigrationJobSPtr;
+class AutoConnectJob;
+typedef std::shared_ptr<AutoConnectJob> AutoConnectJobSPtr;
+
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
 class ICluster;
 typedef std::shared_ptr<ICluster> IClusterSPtr;
@@ -18,12 +18,16 @@
 
 #include "proxy/sentinel/isentinel.h"
 
+#include <algorithm>
 #include <string>
+#include <vector>
+
+#include "proxy/server/iserver_remote.h"
 
 namespace fastonosql {
 namespace proxy {
 
-ISentinel::ISentinel(const std::string& name) : name_(name), sentinels_() {}
+ISentinel::ISentinel(const std::string& name) : name_(name), sentinels_(), topology_() {}
 
 std::string ISentinel::GetName() const {
   return name_;
@@ -37,5 +41,104 @@ ISentinel::sentinels_t ISentinel::GetSentinels() const {
   return sentinels_;
 }
 
+Sentinel::nodes_t ISentinel::GetNodes() const {
+  Sentinel::nodes_t nodes;
+  const auto add_node = [&nodes](IServerSPtr node) {
+    if (node && std::find(nodes.begin(), nodes.end(), node) == nodes.end()) {
+      nodes.push_back(node);
+    }
+  };
+
+  for (const sentinel_t& sentinel : sentinels_) {
+    add_node(sentinel.sentinel);
+    for (auto node : sentinel.sentinels_nodes) {
+      add_node(node);
+    }
+  }
+  return nodes;
+}
+
+SentinelTopology ISentinel::GetTopology() const {
+  return topology_;
+}
+
+void ISentinel::UpdateTopology(const SentinelTopology& topology) {
+  const bool is_first_load = topology_.IsEmpty();
+  const std::vector<SentinelMasterSwitch> switches = topology_.Diff(topology);
+  topology_ = topology;
+  if (is_first_load) {
+    // nothing to diff against, saved addresses may predate failovers happened while nobody followed sentinels
+    ReconcileNodes();
+    return;
+  }
+
+  for (const SentinelMasterSwitch& master_switch : switches) {
+    RepointNodes(master_switch);
+    emit MasterSwitched(master_switch);
+  }
+}
+
+void ISentinel::SwitchMaster(const SentinelMasterSwitch& master_switch) {
+  if (!topology_.SwitchMaster(master_switch)) {  // every sentinel of quorum announces the same failover
+    return;
+  }
+
+  RepointNodes(master_switch);
+  emit MasterSwitched(master_switch);
+}
+
+Sentinel::nodes_t ISentinel::GetRemoteNodes() const {
+  Sentinel::nodes_t nodes;
+  for (const sentinel_t& sentinel : sentinels_) {
+    for (auto node : sentinel.sentinels_nodes) {
+      if (node && node->IsCanRemote() && std::find(nodes.begin(), nodes.end(), node) == nodes.end()) {
+        nodes.push_back(node);
+      }
+    }
+  }
+  return nodes;
+}
+
+void ISentinel::RepointNodes(const SentinelMasterSwitch& master_switch) {
+  const Sentinel::nodes_t nodes = GetRemoteNodes();
+  // nodes are matched by address reported by sentinel, connection of promoted replica and of old master
+  // swap places, so master connection keeps following master and replica one stays on replica
+  for (auto node : nodes) {
+    IServerRemote* remote = static_cast<IServerRemote*>(node.get());
+    const common::net::HostAndPort host = remote->GetHost();
+    if (host == master_switch.old_master) {
+      remote->Repoint(events_info::RepointInfoRequest(this, master_switch.new_master));
+    } else if (host == master_switch.new_master) {
+      remote->Repoint(events_info::RepointInfoRequest(this, master_switch.old_master));
+    }
+  }
+}
+
+void ISentinel::ReconcileNodes() {
+  const Sentinel::nodes_t nodes = GetRemoteNodes();
+  for (const SentinelMaster& master : topology_.GetMasters()) {
+    // addresses of group, master first so stale master connection lands on master
+    std::vector<common::net::HostAndPort> unclaimed = master.replicas;
+    unclaimed.insert(unclaimed.begin(), master.master);
+    for (auto node : nodes) {
+      IServerRemote* remote = static_cast<IServerRemote*>(node.get());
+      unclaimed.erase(std::remove(unclaimed.begin(), unclaimed.end(), remote->GetHost()), unclaimed.end());
+    }
+
+    // discovered nodes are named after master they were found for
+    std::vector<IServerRemote*> stale;
+    for (auto node : nodes) {
+      IServerRemote* remote = static_cast<IServerRemote*>(node.get());
+      if (node->GetName() == master.name && !topology_.FindHost(remote->GetHost())) {
+        stale.push_back(remote);
+      }
+    }
+
+    for (size_t i = 0; i < stale.size() && i < unclaimed.size(); ++i) {
+      stale[i]->Repoint(events_info::RepointInfoRequest(this, unclaimed[i]));
+    }
+  }
+}
+
 }  // namespace proxy
 }  // namespace fastonosql
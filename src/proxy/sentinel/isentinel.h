@@ -22,6 +22,7 @@
 #include <vector>
 
 #include "proxy/proxy_fwd.h"
+#include "proxy/sentinel/sentinel_topology.h"
 #include "proxy/server/iserver_base.h"
 
 namespace fastonosql {
@@ -35,6 +36,8 @@ struct Sentinel {
 };
 
 class ISentinel : public IServerBase {
+  Q_OBJECT
+
  public:
   typedef Sentinel sentinel_t;
   typedef std::vector<sentinel_t> sentinels_t;
@@ -43,13 +46,33 @@ class ISentinel : public IServerBase {
 
   void AddSentinel(sentinel_t root);
   sentinels_t GetSentinels() const;
+  // sentinels and their monitored servers, every server once
+  Sentinel::nodes_t GetNodes() const;
+
+  // last known masters and replicas, empty until first sentinel answers
+  SentinelTopology GetTopology() const;
+
+ Q_SIGNALS:
+  void MasterSwitched(const fastonosql::proxy::SentinelMasterSwitch& master_switch);
+
+ public Q_SLOTS:
+  // full reload after (re)subscription, catches up failovers which happened while no sentinel was followed
+  void UpdateTopology(const fastonosql::proxy::SentinelTopology& topology);
+  void SwitchMaster(const fastonosql::proxy::SentinelMasterSwitch& master_switch);
 
  protected:
   explicit ISentinel(const std::string& name);
 
  private:
+  // monitored servers which can be moved, every server once
+  Sentinel::nodes_t GetRemoteNodes() const;
+  void RepointNodes(const SentinelMasterSwitch& master_switch);
+  // moves nodes with addresses unknown to topology onto its unclaimed addresses
+  void ReconcileNodes();
+
   const std::string name_;
   sentinels_t sentinels_;
+  SentinelTopology topology_;
 };
 
 }  // namespace proxy
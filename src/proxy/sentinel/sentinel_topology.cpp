@@ -0,0 +1,137 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "proxy/sentinel/sentinel_topology.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace fastonosql {
+namespace proxy {
+
+SentinelMaster::SentinelMaster() : name(), master(), replicas() {}
+
+SentinelMasterSwitch::SentinelMasterSwitch() : name(), old_master(), new_master() {}
+
+bool ParseSwitchMaster(const std::string& payload, SentinelMasterSwitch* out) {
+  if (!out) {
+    return false;
+  }
+
+  std::istringstream stream(payload);
+  std::string name, old_ip, new_ip;
+  uint16_t old_port = 0;
+  uint16_t new_port = 0;
+  if (!(stream >> name >> old_ip >> old_port >> new_ip >> new_port)) {
+    return false;
+  }
+
+  out->name = name;
+  out->old_master = common::net::HostAndPort(old_ip, old_port);
+  out->new_master = common::net::HostAndPort(new_ip, new_port);
+  return true;
+}
+
+SentinelTopology::SentinelTopology() : masters_() {}
+
+bool SentinelTopology::IsEmpty() const {
+  return masters_.empty();
+}
+
+SentinelTopology::masters_t SentinelTopology::GetMasters() const {
+  return masters_;
+}
+
+bool SentinelTopology::FindMaster(const std::string& name, SentinelMaster* master) const {
+  const auto it = std::find_if(masters_.begin(), masters_.end(),
+                               [&name](const SentinelMaster& item) { return item.name == name; });
+  if (it == masters_.end()) {
+    return false;
+  }
+
+  if (master) {
+    *master = *it;
+  }
+  return true;
+}
+
+void SentinelTopology::SetMaster(const SentinelMaster& master) {
+  auto it = std::find_if(masters_.begin(), masters_.end(),
+                         [&master](const SentinelMaster& item) { return item.name == master.name; });
+  if (it == masters_.end()) {
+    masters_.push_back(master);
+    return;
+  }
+  *it = master;
+}
+
+bool SentinelTopology::SwitchMaster(const SentinelMasterSwitch& master_switch) {
+  auto it = std::find_if(masters_.begin(), masters_.end(),
+                         [&master_switch](const SentinelMaster& item) { return item.name == master_switch.name; });
+  if (it == masters_.end()) {
+    SentinelMaster master;
+    master.name = master_switch.name;
+    master.master = master_switch.new_master;
+    master.replicas.push_back(master_switch.old_master);
+    masters_.push_back(master);
+    return true;
+  }
+
+  if (it->master == master_switch.new_master) {
+    return false;
+  }
+
+  auto& replicas = it->replicas;
+  replicas.erase(std::remove(replicas.begin(), replicas.end(), master_switch.new_master), replicas.end());
+  if (std::find(replicas.begin(), replicas.end(), it->master) == replicas.end()) {
+    replicas.push_back(it->master);
+  }
+  it->master = master_switch.new_master;
+  return true;
+}
+
+bool SentinelTopology::FindHost(const common::net::HostAndPort& host) const {
+  for (const SentinelMaster& master : masters_) {
+    if (master.master == host) {
+      return true;
+    }
+    if (std::find(master.replicas.begin(), master.replicas.end(), host) != master.replicas.end()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<SentinelMasterSwitch> SentinelTopology::Diff(const SentinelTopology& other) const {
+  std::vector<SentinelMasterSwitch> switches;
+  for (const SentinelMaster& master : other.masters_) {
+    SentinelMaster current;
+    if (!FindMaster(master.name, &current) || current.master == master.master) {
+      continue;
+    }
+
+    SentinelMasterSwitch master_switch;
+    master_switch.name = master.name;
+    master_switch.old_master = current.master;
+    master_switch.new_master = master.master;
+    switches.push_back(master_switch);
+  }
+  return switches;
+}
+
+}  // namespace proxy
+}  // namespace fastonosql
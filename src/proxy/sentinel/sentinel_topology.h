@@ -0,0 +1,74 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <common/net/types.h>
+
+namespace fastonosql {
+namespace proxy {
+
+struct SentinelMaster {
+  SentinelMaster();
+
+  std::string name;
+  common::net::HostAndPort master;
+  std::vector<common::net::HostAndPort> replicas;
+};
+
+struct SentinelMasterSwitch {
+  SentinelMasterSwitch();
+
+  std::string name;
+  common::net::HostAndPort old_master;
+  common::net::HostAndPort new_master;
+};
+
+// "<name> <old ip> <old port> <new ip> <new port>" payload of +switch-master
+bool ParseSwitchMaster(const std::string& payload, SentinelMasterSwitch* out);
+
+// Masters watched by sentinels with their replicas, loaded with SENTINEL MASTERS/REPLICAS
+// and moved by +switch-master notifications between reloads.
+class SentinelTopology {
+ public:
+  typedef std::vector<SentinelMaster> masters_t;
+
+  SentinelTopology();
+
+  bool IsEmpty() const;
+  masters_t GetMasters() const;
+  bool FindMaster(const std::string& name, SentinelMaster* master) const;
+  void SetMaster(const SentinelMaster& master);
+  // address is master or replica of any watched master
+  bool FindHost(const common::net::HostAndPort& host) const;
+
+  // promoted node leaves replicas and demoted one joins them,
+  // false when switch is known already (every sentinel reports the same failover)
+  bool SwitchMaster(const SentinelMasterSwitch& master_switch);
+
+  // switches needed to go from this topology to other one
+  std::vector<SentinelMasterSwitch> Diff(const SentinelTopology& other) const;
+
+ private:
+  masters_t masters_;
+};
+
+}  // namespace proxy
+}  // namespace fastonosql
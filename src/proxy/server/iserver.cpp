@@ -29,10 +29,15 @@
 
 #include "proxy/driver/idriver.h"
 
+#if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
+#include "proxy/cluster/icluster.h"
+#endif
+
 namespace fastonosql {
 namespace proxy {
 
-IServer::IServer(IDriver* drv) : drv_(drv), current_database_info_(), timer_check_key_exists_id_(0) {
+IServer::IServer(IDriver* drv)
+    : drv_(drv), current_database_info_(), timer_check_key_exists_id_(0), discovery_deferred_(false) {
   if (!drv_) {
     DNOTREACHED();
     return;
@@ -84,6 +89,10 @@ bool IServer::IsConnected() const {
   return drv_->IsConnected() && drv_->IsAuthenticated();
 }
 
+bool IServer::IsDiscoveryDeferred() const {
+  return discovery_deferred_;
+}
+
 bool IServer::IsCanRemote() const {
   return IsRemoteType(GetType());
 }
@@ -121,6 +130,11 @@ std::string IServer::GetName() const {
   return path.GetName();
 }
 
+std::string IServer::GetPath() const {
+  const connection_path_t path = drv_->GetConnectionPath();
+  return path.ToString();
+}
+
 core::IServerInfoSPtr IServer::GetCurrentServerInfo() const {
   return drv_->GetCurrentServerInfoIfConnected();
 }
@@ -191,12 +205,75 @@ void IServer::LoadDatabaseContent(const events_info::LoadDatabaseContentRequest&
   NotifyStartEvent(ev);
 }
 
+void IServer::LoadKeyPage(const events_info::LoadKeyPageRequest& req) {
+  emit LoadKeyPageStarted(req);
+  QEvent* ev = new events::LoadKeyPageRequestEvent(this, req);
+  NotifyStartEvent(ev);
+}
+
+void IServer::LoadStreamPage(const events_info::LoadStreamPageRequest& req) {
+  emit LoadStreamPageStarted(req);
+  QEvent* ev = new events::LoadStreamPageRequestEvent(this, req);
+  NotifyStartEvent(ev);
+}
+
+void IServer::ChangeKeyValue(const events_info::ChangeKeyValueRequest& req) {
+  emit ChangeKeyValueStarted(req);
+  QEvent* ev = new events::ChangeKeyValueRequestEvent(this, req);
+  NotifyStartEvent(ev);
+}
+
 void IServer::Execute(const events_info::ExecuteInfoRequest& req) {
+#if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
+  if (cluster_) {
+    cluster_->Execute(this, req);
+    return;
+  }
+#endif
+  ExecuteDirect(req);
+}
+
+void IServer::ExecuteDirect(const events_info::ExecuteInfoRequest& req, IServer* node) {
   emit ExecuteStarted(req);
+  PostExecute(req, node);
+}
+
+void IServer::PostExecute(const events_info::ExecuteInfoRequest& req, IServer* node) {
   QEvent* ev = new events::ExecuteRequestEvent(this, req);
-  NotifyStartEvent(ev);
+  if (!node || node == this) {
+    NotifyStartEvent(ev);
+    return;
+  }
+
+  // driver replies to sender of event, so results of other node land in this server as own ones
+  events_info::ProgressInfoResponse resp(0);
+  emit ProgressChanged(resp);
+  qApp->postEvent(node->drv_, ev);
+}
+
+#if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
+void IServer::SetCluster(ICluster* cluster) {
+  cluster_ = cluster;
 }
 
+void IServer::ExecutePart(const events_info::ExecuteInfoRequest& part, IServer* node) {
+  PostExecute(part, node);
+}
+
+void IServer::NotifyExecuteStarted(const events_info::ExecuteInfoRequest& req) {
+  emit ExecuteStarted(req);
+}
+
+void IServer::NotifyExecuteFinished(const events_info::ExecuteInfoResponse& res) {
+  common::Error err = res.errorInfo();
+  if (err) {
+    const bool is_eintr = err->GetErrorCode() == common::COMMON_EINTR;
+    LOG_ERROR(err, is_eintr ? common::logging::LOG_LEVEL_WARNING : common::logging::LOG_LEVEL_ERR, true);
+  }
+  emit ExecuteFinished(res);
+}
+#endif
+
 void IServer::BackupToPath(const events_info::BackupInfoRequest& req) {
   emit BackupStarted(req);
   QEvent* ev = new events::BackupRequestEvent(this, req);
@@ -209,6 +286,18 @@ void IServer::RestoreFromPath(const events_info::RestoreInfoRequest& req) {
   NotifyStartEvent(ev);
 }
 
+void IServer::DumpKeys(const events_info::DumpKeysRequest& req) {
+  emit DumpKeysStarted(req);
+  QEvent* ev = new events::DumpKeysRequestEvent(this, req);
+  NotifyStartEvent(ev);
+}
+
+void IServer::RestoreKeys(const events_info::RestoreKeysRequest& req) {
+  emit RestoreKeysStarted(req);
+  QEvent* ev = new events::RestoreKeysRequestEvent(this, req);
+  NotifyStartEvent(ev);
+}
+
 void IServer::LoadServerInfo(const events_info::ServerInfoRequest& req) {
   emit LoadServerInfoStarted(req);
   QEvent* ev = new events::ServerInfoRequestEvent(this, req);
@@ -260,11 +349,10 @@ void IServer::customEvent(QEvent* event) {
     events::ConnectResponseEvent::value_type v = ev->value();
     common::Error err = v.errorInfo();
     if (!err) {
-      events_info::ServerInfoRequest sreq(this);
-      LoadServerInfo(sreq);
-
-      events_info::DiscoveryInfoRequest dreq(this);
-      ProcessDiscoveryInfo(dreq);
+      discovery_deferred_ = true;
+      if (!v.defer_discovery) {
+        LoadDeferredDiscovery();
+      }
     }
   } else if (type == static_cast<QEvent::Type>(events::EnterModeEvent::EventType)) {
     events::EnterModeEvent* ev = static_cast<events::EnterModeEvent*>(event);
@@ -282,6 +370,7 @@ void IServer::customEvent(QEvent* event) {
     emit RootCompleated(v);
   } else if (type == static_cast<QEvent::Type>(events::DisconnectResponseEvent::EventType)) {
     events::DisconnectResponseEvent* ev = static_cast<events::DisconnectResponseEvent*>(event);
+    discovery_deferred_ = false;
     HandleDisconnectEvent(ev);
   } else if (type == static_cast<QEvent::Type>(events::LoadDatabasesInfoResponseEvent::EventType)) {
     events::LoadDatabasesInfoResponseEvent* ev = static_cast<events::LoadDatabasesInfoResponseEvent*>(event);
@@ -314,9 +403,24 @@ void IServer::customEvent(QEvent* event) {
   } else if (type == static_cast<QEvent::Type>(events::RestoreResponseEvent::EventType)) {
     events::RestoreResponseEvent* ev = static_cast<events::RestoreResponseEvent*>(event);
     HandleRestoreEvent(ev);
+  } else if (type == static_cast<QEvent::Type>(events::DumpKeysResponseEvent::EventType)) {
+    events::DumpKeysResponseEvent* ev = static_cast<events::DumpKeysResponseEvent*>(event);
+    HandleDumpKeysEvent(ev);
+  } else if (type == static_cast<QEvent::Type>(events::RestoreKeysResponseEvent::EventType)) {
+    events::RestoreKeysResponseEvent* ev = static_cast<events::RestoreKeysResponseEvent*>(event);
+    HandleRestoreKeysEvent(ev);
   } else if (type == static_cast<QEvent::Type>(events::LoadDatabaseContentResponseEvent::EventType)) {
     events::LoadDatabaseContentResponseEvent* ev = static_cast<events::LoadDatabaseContentResponseEvent*>(event);
     HandleLoadDatabaseContentEvent(ev);
+  } else if (type == static_cast<QEvent::Type>(events::LoadKeyPageResponseEvent::EventType)) {
+    events::LoadKeyPageResponseEvent* ev = static_cast<events::LoadKeyPageResponseEvent*>(event);
+    HandleLoadKeyPageEvent(ev);
+  } else if (type == static_cast<QEvent::Type>(events::LoadStreamPageResponseEvent::EventType)) {
+    events::LoadStreamPageResponseEvent* ev = static_cast<events::LoadStreamPageResponseEvent*>(event);
+    HandleLoadStreamPageEvent(ev);
+  } else if (type == static_cast<QEvent::Type>(events::ChangeKeyValueResponseEvent::EventType)) {
+    events::ChangeKeyValueResponseEvent* ev = static_cast<events::ChangeKeyValueResponseEvent*>(event);
+    HandleChangeKeyValueEvent(ev);
   } else if (type == static_cast<QEvent::Type>(events::ExecuteResponseEvent::EventType)) {
     events::ExecuteResponseEvent* ev = static_cast<events::ExecuteResponseEvent*>(event);
     HandleExecuteEvent(ev);
@@ -427,8 +531,31 @@ void IServer::HandleRestoreEvent(events::RestoreResponseEvent* ev) {
   emit ExportFinished(v);
 }
 
+void IServer::HandleDumpKeysEvent(events::DumpKeysResponseEvent* ev) {
+  auto v = ev->value();
+  common::Error err = v.errorInfo();
+  if (err) {
+    LOG_ERROR(err, common::logging::LOG_LEVEL_ERR, true);
+  }
+  emit DumpKeysFinished(v);
+}
+
+void IServer::HandleRestoreKeysEvent(events::RestoreKeysResponseEvent* ev) {
+  auto v = ev->value();
+  common::Error err = v.errorInfo();
+  if (err) {
+    LOG_ERROR(err, common::logging::LOG_LEVEL_ERR, true);
+  }
+  emit RestoreKeysFinished(v);
+}
+
 void IServer::HandleExecuteEvent(events::ExecuteResponseEvent* ev) {
   auto v = ev->value();
+#if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
+  if (cluster_ && cluster_->HandlePartExecuted(v)) {
+    return;
+  }
+#endif
   common::Error err = v.errorInfo();
   if (!err) {
     emit ExecuteFinished(v);
@@ -494,6 +621,36 @@ void IServer::HandleLoadDatabaseContentEvent(events::LoadDatabaseContentResponse
   emit LoadDatabaseContentFinished(v);
 }
 
+void IServer::HandleLoadKeyPageEvent(events::LoadKeyPageResponseEvent* ev) {
+  auto v = ev->value();
+  common::Error err = v.errorInfo();
+  if (err) {
+    LOG_ERROR(err, common::logging::LOG_LEVEL_ERR, true);
+  }
+
+  emit LoadKeyPageFinished(v);
+}
+
+void IServer::HandleLoadStreamPageEvent(events::LoadStreamPageResponseEvent* ev) {
+  auto v = ev->value();
+  common::Error err = v.errorInfo();
+  if (err) {
+    LOG_ERROR(err, common::logging::LOG_LEVEL_ERR, true);
+  }
+
+  emit LoadStreamPageFinished(v);
+}
+
+void IServer::HandleChangeKeyValueEvent(events::ChangeKeyValueResponseEvent* ev) {
+  auto v = ev->value();
+  common::Error err = v.errorInfo();
+  if (err) {
+    LOG_ERROR(err, common::logging::LOG_LEVEL_ERR, true);
+  }
+
+  emit ChangeKeyValueFinished(v);
+}
+
 void IServer::CreateDB(core::IDataBaseInfoSPtr db) {
   database_t dbs = FindDatabase(db);
   if (!dbs) {
@@ -715,6 +872,19 @@ void IServer::HandleClearServerHistoryResponseEvent(events::ClearServerHistoryRe
   emit ClearServerHistoryFinished(v);
 }
 
+void IServer::LoadDeferredDiscovery() {
+  if (!discovery_deferred_ || !IsConnected()) {
+    return;
+  }
+
+  discovery_deferred_ = false;
+  events_info::ServerInfoRequest sreq(this);
+  LoadServerInfo(sreq);
+
+  events_info::DiscoveryInfoRequest dreq(this);
+  ProcessDiscoveryInfo(dreq);
+}
+
 void IServer::ProcessDiscoveryInfo(const events_info::DiscoveryInfoRequest& req) {
   emit LoadDiscoveryInfoStarted(req);
   QEvent* ev = new events::DiscoveryInfoRequestEvent(this, req);
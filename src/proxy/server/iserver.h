@@ -21,6 +21,8 @@
 #include <string>
 #include <vector>
 
+#include <QPointer>
+
 #include <fastonosql/core/db_traits.h>
 #include <fastonosql/core/icommand_translator.h>
 
@@ -33,6 +35,9 @@ namespace fastonosql {
 namespace proxy {
 
 class IDriver;
+#if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
+class ICluster;
+#endif
 class IServer : public IServerBase, public std::enable_shared_from_this<IServer> {
   Q_OBJECT
 
@@ -48,6 +53,7 @@ class IServer : public IServerBase, public std::enable_shared_from_this<IServer>
   bool IsSupportTTLKeys() const;
   bool IsCanCreateDatabase() const;
   bool IsCanRemoveDatabase() const;
+  bool IsDiscoveryDeferred() const;
 
   core::translator_t GetTranslator() const;
 
@@ -55,6 +61,7 @@ class IServer : public IServerBase, public std::enable_shared_from_this<IServer>
   core::ConnectionType GetType() const;
   std::vector<core::info_field_t> GetInfoFields() const;
   std::string GetName() const override;
+  std::string GetPath() const;  // full connection path, unique unlike the name
 
   database_t GetCurrentDatabaseInfo() const;
   core::IServerInfoSPtr GetCurrentServerInfo() const;
@@ -65,6 +72,9 @@ class IServer : public IServerBase, public std::enable_shared_from_this<IServer>
   IDatabaseSPtr CreateDatabaseByInfo(core::IDataBaseInfoSPtr inf);
   database_t FindDatabase(core::IDataBaseInfoSPtr inf) const;
 
+  // starts server info and discovery skipped by a connect with defer_discovery, no-op otherwise
+  void LoadDeferredDiscovery();
+
  Q_SIGNALS:  // only direct connections
   void ConnectStarted(const events_info::ConnectInfoRequest& req);
   void ConnectFinished(const events_info::ConnectInfoResponse& res);
@@ -116,6 +126,21 @@ class IServer : public IServerBase, public std::enable_shared_from_this<IServer>
   void LoadDataBaseContentStarted(const events_info::LoadDatabaseContentRequest& req);
   void LoadDatabaseContentFinished(const events_info::LoadDatabaseContentResponse& res);
 
+  void LoadKeyPageStarted(const events_info::LoadKeyPageRequest& req);
+  void LoadKeyPageFinished(const events_info::LoadKeyPageResponse& res);
+
+  void LoadStreamPageStarted(const events_info::LoadStreamPageRequest& req);
+  void LoadStreamPageFinished(const events_info::LoadStreamPageResponse& res);
+
+  void ChangeKeyValueStarted(const events_info::ChangeKeyValueRequest& req);
+  void ChangeKeyValueFinished(const events_info::ChangeKeyValueResponse& res);
+
+  void DumpKeysStarted(const events_info::DumpKeysRequest& req);
+  void DumpKeysFinished(const events_info::DumpKeysResponse& res);
+
+  void RestoreKeysStarted(const events_info::RestoreKeysRequest& req);
+  void RestoreKeysFinished(const events_info::RestoreKeysResponse& res);
+
   void LoadDiscoveryInfoStarted(const events_info::DiscoveryInfoRequest& res);
   void LoadDiscoveryInfoFinished(const events_info::DiscoveryInfoResponse& res);
 
@@ -146,10 +171,28 @@ class IServer : public IServerBase, public std::enable_shared_from_this<IServer>
                                                                          // LoadDatabasesFinished
   void LoadDatabaseContent(const events_info::LoadDatabaseContentRequest& req);  // signals: LoadDataBaseContentStarted,
                                                                                  // LoadDatabaseContentFinished
+  void LoadKeyPage(const events_info::LoadKeyPageRequest& req);  // signals: LoadKeyPageStarted, LoadKeyPageFinished
+  void LoadStreamPage(const events_info::LoadStreamPageRequest& req);  // signals: LoadStreamPageStarted,
+                                                                       // LoadStreamPageFinished
+  void ChangeKeyValue(const events_info::ChangeKeyValueRequest& req);  // signals: ChangeKeyValueStarted,
+                                                                       // ChangeKeyValueFinished
   void Execute(const events_info::ExecuteInfoRequest& req);                      // signals: ExecuteStarted
+  // skips cluster routing, runs on driver of node (this server when null), replies still come to this server
+  void ExecuteDirect(const events_info::ExecuteInfoRequest& req, IServer* node = nullptr);
+#if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
+  // set by cluster which owns node, Execute goes through its slot routing then
+  void SetCluster(ICluster* cluster);
+  // cluster reports a routed request as a whole: its parts run on node drivers without signals,
+  // answers of them go to cluster, which emits one ExecuteStarted/ExecuteFinished pair through origin server
+  void ExecutePart(const events_info::ExecuteInfoRequest& part, IServer* node);
+  void NotifyExecuteStarted(const events_info::ExecuteInfoRequest& req);
+  void NotifyExecuteFinished(const events_info::ExecuteInfoResponse& res);
+#endif
 
   void BackupToPath(const events_info::BackupInfoRequest& req);      // signals: BackupStarted, BackupFinished
   void RestoreFromPath(const events_info::RestoreInfoRequest& req);  // signals: ExportStarted, ExportFinished
+  void DumpKeys(const events_info::DumpKeysRequest& req);            // signals: DumpKeysStarted, DumpKeysFinished
+  void RestoreKeys(const events_info::RestoreKeysRequest& req);      // signals: RestoreKeysStarted, RestoreKeysFinished
 
   void LoadServerInfo(const events_info::ServerInfoRequest& req);  // signals:
   // LoadServerInfoStarted,
@@ -191,11 +234,16 @@ class IServer : public IServerBase, public std::enable_shared_from_this<IServer>
   virtual void HandleLoadServerClientsEvent(events::LoadServerClientsResponseEvent* ev);
   virtual void HandleBackupEvent(events::BackupResponseEvent* ev);
   virtual void HandleRestoreEvent(events::RestoreResponseEvent* ev);
+  virtual void HandleDumpKeysEvent(events::DumpKeysResponseEvent* ev);
+  virtual void HandleRestoreKeysEvent(events::RestoreKeysResponseEvent* ev);
   virtual void HandleExecuteEvent(events::ExecuteResponseEvent* ev);
 
   // handle database events
   virtual void HandleLoadDatabaseInfosEvent(events::LoadDatabasesInfoResponseEvent* ev);
   virtual void HandleLoadDatabaseContentEvent(events::LoadDatabaseContentResponseEvent* ev);
+  virtual void HandleLoadKeyPageEvent(events::LoadKeyPageResponseEvent* ev);
+  virtual void HandleLoadStreamPageEvent(events::LoadStreamPageResponseEvent* ev);
+  virtual void HandleChangeKeyValueEvent(events::ChangeKeyValueResponseEvent* ev);
 
   // handle command events
   virtual void HandleDiscoveryInfoResponseEvent(events::DiscoveryInfoResponseEvent* ev);
@@ -209,15 +257,20 @@ class IServer : public IServerBase, public std::enable_shared_from_this<IServer>
   void FlushCurrentDB();
   void ChangeCurrentDB(core::IDataBaseInfoSPtr db);
 
-  void RemoveKey(core::NKey key);
-  void AddKey(core::NDbKValue key);
   void LoadKey(core::NDbKValue key);
   void RenameKey(core::NKey key, core::nkey_t new_name);
-  void ChangeKeyTTL(core::NKey key, core::ttl_t ttl);
   void LoadKeyTTL(core::NKey key, core::ttl_t ttl);
 
+ protected Q_SLOTS:
+  // apply changes made outside of our commands to current database
+  void RemoveKey(core::NKey key);
+  void AddKey(core::NDbKValue key);
+  void ChangeKeyTTL(core::NKey key, core::ttl_t ttl);
+
  private:
   void HandleCheckDBKeys(core::IDataBaseInfoSPtr db, core::ttl_t expired_time);
+  // posts execute to driver of node (this server when null) without signals
+  void PostExecute(const events_info::ExecuteInfoRequest& req, IServer* node);
 
   void HandleEnterModeEvent(events::EnterModeEvent* ev);
   void HandleLeaveModeEvent(events::LeaveModeEvent* ev);
@@ -230,6 +283,10 @@ class IServer : public IServerBase, public std::enable_shared_from_this<IServer>
 
   database_t current_database_info_;
   int timer_check_key_exists_id_;
+  bool discovery_deferred_;
+#if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
+  QPointer<ICluster> cluster_;
+#endif
 };
 
 }  // namespace proxy
@@ -18,11 +18,52 @@
 
 #include "proxy/server/iserver_remote.h"
 
+#include <common/qt/logger.h>
+
+#include "proxy/driver/idriver_remote.h"
+
 namespace fastonosql {
 namespace proxy {
 
-IServerRemote::IServerRemote(IDriver* drv) : IServer(drv) {
+IServerRemote::IServerRemote(IDriver* drv) : IServer(drv), health_() {
   CHECK(IsCanRemote());
+  IDriverRemote* rdrv = static_cast<IDriverRemote*>(drv);
+  VERIFY(QObject::connect(rdrv, &IDriverRemote::HealthChanged, this, &IServerRemote::UpdateHealth));
+}
+
+ConnectionHealthInfo IServerRemote::GetHealthInfo() const {
+  return health_;
+}
+
+void IServerRemote::Repoint(const events_info::RepointInfoRequest& req) {
+  emit RepointStarted(req);
+  QEvent* ev = new events::RepointRequestEvent(this, req);
+  NotifyStartEvent(ev);
+}
+
+void IServerRemote::customEvent(QEvent* event) {
+  const QEvent::Type type = event->type();
+  if (type == static_cast<QEvent::Type>(events::RepointResponseEvent::EventType)) {
+    events::RepointResponseEvent* ev = static_cast<events::RepointResponseEvent*>(event);
+    HandleRepointEvent(ev);
+    return;
+  }
+
+  IServer::customEvent(event);
+}
+
+void IServerRemote::HandleRepointEvent(events::RepointResponseEvent* ev) {
+  auto v = ev->value();
+  common::Error err = v.errorInfo();
+  if (err) {
+    LOG_ERROR(err, common::logging::LOG_LEVEL_ERR, true);
+  }
+  emit RepointFinished(v);
+}
+
+void IServerRemote::UpdateHealth(const ConnectionHealthInfo& info) {
+  health_ = info;
+  emit HealthChanged(info);
 }
 
 }  // namespace proxy
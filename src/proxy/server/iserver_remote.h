@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include "proxy/driver/connection_health.h"
 #include "proxy/server/iserver.h"
 
 namespace fastonosql {
@@ -33,8 +34,29 @@ class IServerRemote : public IServer {
   virtual core::ServerState GetState() const = 0;
   IDatabaseSPtr CreateDatabase(core::IDataBaseInfoSPtr info) override = 0;
 
+  // keepalive rtt and reconnect state, driver reconnects lost connection by itself
+  ConnectionHealthInfo GetHealthInfo() const;
+
+  // async API
+  void Repoint(const events_info::RepointInfoRequest& req);  // signals: RepointStarted, RepointFinished
+
+ Q_SIGNALS:
+  void HealthChanged(const fastonosql::proxy::ConnectionHealthInfo& info);
+  void RepointStarted(const events_info::RepointInfoRequest& req);
+  void RepointFinished(const events_info::RepointInfoResponse& res);
+
  protected:
   explicit IServerRemote(IDriver* drv);
+
+  void customEvent(QEvent* event) override;
+
+  virtual void HandleRepointEvent(events::RepointResponseEvent* ev);
+
+ private Q_SLOTS:
+  void UpdateHealth(const fastonosql::proxy::ConnectionHealthInfo& info);
+
+ private:
+  ConnectionHealthInfo health_;
 };
 
 }  // namespace proxy
@@ -0,0 +1,156 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/server_batch.h"
+
+#include <QObject>
+
+#include <common/macros.h>
+#include <common/time.h>
+
+#include "proxy/server/iserver.h"
+
+namespace fastonosql {
+namespace proxy {
+
+ServerBatch::State::State() : taken(false), done(false), start_msec(0) {}
+
+ServerBatch::ServerBatch(size_t concurrency)
+    : concurrency_(concurrency), servers_(), states_(), running_(false), next_(0), in_flight_(0) {}
+
+void ServerBatch::Reset(const servers_t& servers) {
+  servers_ = servers;
+  states_.assign(servers_.size(), State());
+  next_ = 0;
+  in_flight_ = 0;
+}
+
+ServerBatch::servers_t ServerBatch::GetServers() const {
+  return servers_;
+}
+
+size_t ServerBatch::GetCount() const {
+  return servers_.size();
+}
+
+IServerSPtr ServerBatch::GetServer(size_t index) const {
+  return servers_[index];
+}
+
+bool ServerBatch::FindServer(const QObject* sender, size_t* index) const {
+  if (!index) {
+    return false;
+  }
+
+  for (size_t i = 0; i < servers_.size(); ++i) {
+    if (servers_[i].get() == sender) {
+      *index = i;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool ServerBatch::IsRunning() const {
+  return running_;
+}
+
+void ServerBatch::Open() {
+  running_ = true;
+}
+
+bool ServerBatch::Close(QObject* receiver) {
+  if (!running_) {
+    return false;
+  }
+
+  running_ = false;
+  for (size_t i = 0; i < servers_.size(); ++i) {
+    size_t first = i;
+    if (FindServer(servers_[i].get(), &first) && first != i) {
+      continue;  // same server twice, its signals are already dropped
+    }
+    VERIFY(QObject::disconnect(servers_[i].get(), Q_NULLPTR, receiver, Q_NULLPTR));
+  }
+  return true;
+}
+
+bool ServerBatch::TakeNext(size_t* index) {
+  if (!index || next_ >= servers_.size() || (concurrency_ && in_flight_ >= concurrency_)) {
+    return false;
+  }
+
+  *index = next_++;
+  states_[*index].taken = true;
+  in_flight_++;
+  return true;
+}
+
+void ServerBatch::SkipQueued() {
+  next_ = servers_.size();
+}
+
+bool ServerBatch::IsTaken(size_t index) const {
+  return states_[index].taken;
+}
+
+bool ServerBatch::IsDone(size_t index) const {
+  return states_[index].done;
+}
+
+bool ServerBatch::IsAllDone() const {
+  for (const State& state : states_) {
+    if (!state.done) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ServerBatch::StartClock(size_t index) {
+  State& state = states_[index];
+  if (state.start_msec == 0) {
+    state.start_msec = common::time::current_utc_mstime();
+  }
+}
+
+common::time64_t ServerBatch::GetElapsed(size_t index) const {
+  const State& state = states_[index];
+  if (state.start_msec == 0) {
+    return 0;
+  }
+  return common::time::current_utc_mstime() - state.start_msec;
+}
+
+common::time64_t ServerBatch::FinishServer(size_t index) {
+  State& state = states_[index];
+  if (state.done) {
+    return 0;
+  }
+
+  const common::time64_t elapsed = GetElapsed(index);
+  state.done = true;
+  if (state.taken) {
+    in_flight_--;
+  }
+  return elapsed;
+}
+
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,78 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include <common/types.h>
+
+#include "proxy/proxy_fwd.h"
+
+class QObject;
+
+namespace fastonosql {
+namespace proxy {
+
+// Bookkeeping of jobs which drive many servers from the GUI thread: which servers are queued, in flight or done,
+// bounded parallelism and clocks per server. Jobs connect signals of servers themselves, Close drops them all.
+class ServerBatch {
+ public:
+  typedef std::vector<IServerSPtr> servers_t;
+
+  explicit ServerBatch(size_t concurrency = 0);  // servers in flight at once, 0 - all servers at once
+
+  void Reset(const servers_t& servers);  // every server is queued again
+  servers_t GetServers() const;
+  size_t GetCount() const;
+  IServerSPtr GetServer(size_t index) const;
+  bool FindServer(const QObject* sender, size_t* index) const;
+
+  bool IsRunning() const;
+  void Open();
+  bool Close(QObject* receiver);  // disconnects receiver from servers, false if batch was not running
+
+  bool TakeNext(size_t* index);  // next queued server while in flight limit allows
+  void SkipQueued();             // queued servers are never taken after this
+  bool IsTaken(size_t index) const;
+  bool IsDone(size_t index) const;
+  bool IsAllDone() const;
+
+  void StartClock(size_t index);                    // first call wins, time before it is not counted
+  common::time64_t GetElapsed(size_t index) const;  // 0 if clock is not started
+  common::time64_t FinishServer(size_t index);      // frees slot of taken server, returns its elapsed time
+
+ private:
+  struct State {
+    State();
+
+    bool taken;
+    bool done;
+    common::time64_t start_msec;
+  };
+
+  const size_t concurrency_;
+  servers_t servers_;
+  std::vector<State> states_;
+  bool running_;
+  size_t next_;
+  size_t in_flight_;
+};
+
+}  // namespace proxy
+}  // namespace fastonosql
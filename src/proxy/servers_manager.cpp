@@ -100,15 +100,37 @@
 #endif
 #endif
 
+#if defined(BUILD_WITH_REDIS) || defined(BUILD_WITH_PIKA) || defined(BUILD_WITH_DYNOMITE) || defined(BUILD_WITH_KEYDB)
+#include "proxy/db/redis_compatible/connection_probe.h"
+#include "proxy/db/redis_compatible/ssh_tunnel.h"
+#endif
+
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
 #include "proxy/cluster/icluster.h"
 #include "proxy/sentinel/isentinel.h"
+#if defined(BUILD_WITH_REDIS) || defined(BUILD_WITH_KEYDB)
+#include "proxy/db/redis_compatible/sentinel_watcher.h"
+#endif
 #endif
 
 namespace fastonosql {
 namespace proxy {
 
 namespace {
+#if (defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)) && (defined(BUILD_WITH_REDIS) || defined(BUILD_WITH_KEYDB))
+template <typename Settings>
+redis_compatible::SentinelEndpoint MakeSentinelEndpoint(IConnectionSettingsBaseSPtr settings) {
+  Settings* sentinel_settings = static_cast<Settings*>(settings.get());
+  const auto info = sentinel_settings->GetInfo();
+  redis_compatible::SentinelEndpoint endpoint;
+  endpoint.host = info.host;
+  endpoint.password = info.auth;
+  endpoint.is_ssl = info.is_ssl;
+  endpoint.ssh_info = sentinel_settings->GetSSHInfo();
+  return endpoint;
+}
+#endif
+
 IServerSPtr CreateServerImpl(IConnectionSettingsBaseSPtr settings) {
   const core::ConnectionType connection_type = settings->GetType();
 #if defined(BUILD_WITH_REDIS)
@@ -172,7 +194,7 @@ IServerSPtr CreateServerImpl(IConnectionSettingsBaseSPtr settings) {
 }
 }  // namespace
 
-ServersManager::ServersManager() : servers_() {}
+ServersManager::ServersManager() : servers_(), migrations_(), auto_connect_() {}
 
 ServersManager::server_t ServersManager::CreateServer(IConnectionSettingsBaseSPtr settings) {
   if (!settings) {
@@ -193,8 +215,16 @@ common::Error ServersManager::TestConnection(IConnectionSettingsBaseSPtr connect
   const core::ConnectionType connection_type = connection->GetType();
 #if defined(BUILD_WITH_REDIS)
   if (connection_type == core::REDIS) {
+    // goes through shared ssh session, so connecting right after the test skips the handshake
     redis::ConnectionSettings* settings = static_cast<redis::ConnectionSettings*>(connection.get());
-    core::redis::RConfig rconfig(settings->GetInfo(), settings->GetSSHInfo());
+    core::redis::Config info = settings->GetInfo();
+    core::SSHInfo ssh_info = settings->GetSSHInfo();
+    redis_compatible::ssh_tunnel_t tunnel;
+    common::Error err = redis_compatible::RouteThroughSSHTunnel(&info.host, &ssh_info, &tunnel);
+    if (err) {
+      return err;
+    }
+    core::redis::RConfig rconfig(info, ssh_info);
     return core::redis::TestConnection(rconfig);
   }
 #endif
@@ -243,21 +273,42 @@ common::Error ServersManager::TestConnection(IConnectionSettingsBaseSPtr connect
 #if defined(BUILD_WITH_PIKA)
   if (connection_type == core::PIKA) {
     pika::ConnectionSettings* settings = static_cast<pika::ConnectionSettings*>(connection.get());
-    core::pika::RConfig rconfig(settings->GetInfo(), settings->GetSSHInfo());
+    core::pika::Config info = settings->GetInfo();
+    core::SSHInfo ssh_info = settings->GetSSHInfo();
+    redis_compatible::ssh_tunnel_t tunnel;
+    common::Error err = redis_compatible::RouteThroughSSHTunnel(&info.host, &ssh_info, &tunnel);
+    if (err) {
+      return err;
+    }
+    core::pika::RConfig rconfig(info, ssh_info);
     return core::pika::TestConnection(rconfig);
   }
 #endif
 #if defined(BUILD_WITH_DYNOMITE)
   if (connection_type == core::DYNOMITE) {
     dynomite::ConnectionSettings* settings = static_cast<dynomite::ConnectionSettings*>(connection.get());
-    core::dynomite::RConfig rconfig(settings->GetInfo(), settings->GetSSHInfo());
+    core::dynomite::Config info = settings->GetInfo();
+    core::SSHInfo ssh_info = settings->GetSSHInfo();
+    redis_compatible::ssh_tunnel_t tunnel;
+    common::Error err = redis_compatible::RouteThroughSSHTunnel(&info.host, &ssh_info, &tunnel);
+    if (err) {
+      return err;
+    }
+    core::dynomite::RConfig rconfig(info, ssh_info);
     return core::dynomite::TestConnection(rconfig);
   }
 #endif
 #if defined(BUILD_WITH_KEYDB)
   if (connection_type == core::KEYDB) {
     keydb::ConnectionSettings* settings = static_cast<keydb::ConnectionSettings*>(connection.get());
-    core::keydb::RConfig rconfig(settings->GetInfo(), settings->GetSSHInfo());
+    core::keydb::Config info = settings->GetInfo();
+    core::SSHInfo ssh_info = settings->GetSSHInfo();
+    redis_compatible::ssh_tunnel_t tunnel;
+    common::Error err = redis_compatible::RouteThroughSSHTunnel(&info.host, &ssh_info, &tunnel);
+    if (err) {
+      return err;
+    }
+    core::keydb::RConfig rconfig(info, ssh_info);
     return core::keydb::TestConnection(rconfig);
   }
 #endif
@@ -266,10 +317,99 @@ common::Error ServersManager::TestConnection(IConnectionSettingsBaseSPtr connect
   return common::make_error("Invalid setting type");
 }
 
+common::Error ServersManager::DiagnoseConnection(IConnectionSettingsBaseSPtr connection,
+                                                 const DiagnosticsOptions& options,
+                                                 ConnectionDiagnostics* out) {
+  if (!connection || !out) {
+    DNOTREACHED();
+    return common::make_error_inval();
+  }
+
+  const core::ConnectionType connection_type = connection->GetType();
+#if defined(BUILD_WITH_REDIS)
+  if (connection_type == core::REDIS) {
+    redis::ConnectionSettings* settings = static_cast<redis::ConnectionSettings*>(connection.get());
+    const core::redis::Config info = settings->GetInfo();
+    if (!info.hostsocket.empty()) {
+      return common::make_error("Diagnostics require TCP connection");
+    }
+    return redis_compatible::ProbeConnection(info.host, info.auth, info.is_ssl, settings->GetSSHInfo(), options, out);
+  }
+#endif
+#if defined(BUILD_WITH_PIKA)
+  if (connection_type == core::PIKA) {
+    pika::ConnectionSettings* settings = static_cast<pika::ConnectionSettings*>(connection.get());
+    const core::pika::Config info = settings->GetInfo();
+    return redis_compatible::ProbeConnection(info.host, info.auth, info.is_ssl, settings->GetSSHInfo(), options, out);
+  }
+#endif
+#if defined(BUILD_WITH_DYNOMITE)
+  if (connection_type == core::DYNOMITE) {
+    dynomite::ConnectionSettings* settings = static_cast<dynomite::ConnectionSettings*>(connection.get());
+    const core::dynomite::Config info = settings->GetInfo();
+    return redis_compatible::ProbeConnection(info.host, info.auth, info.is_ssl, settings->GetSSHInfo(), options, out);
+  }
+#endif
+#if defined(BUILD_WITH_KEYDB)
+  if (connection_type == core::KEYDB) {
+    keydb::ConnectionSettings* settings = static_cast<keydb::ConnectionSettings*>(connection.get());
+    const core::keydb::Config info = settings->GetInfo();
+    if (!info.hostsocket.empty()) {
+      return common::make_error("Diagnostics require TCP connection");
+    }
+    return redis_compatible::ProbeConnection(info.host, info.auth, info.is_ssl, settings->GetSSHInfo(), options, out);
+  }
+#endif
+
+  UNUSED(options);
+  return common::make_error("Diagnostics are not supported for this connection type");
+}
+
 void ServersManager::Clear() {
+  if (auto_connect_) {
+    auto_connect_->Stop();
+    auto_connect_.reset();
+  }
+  for (const migration_t& migration : migrations_) {
+    migration->Stop();
+  }
+  migrations_.clear();
   servers_.clear();
 }
 
+ServersManager::auto_connect_t ServersManager::CreateAutoConnect(const servers_t& servers,
+                                                                 const AutoConnectOptions& options) {
+  if (auto_connect_) {
+    auto_connect_->Stop();
+  }
+
+  auto_connect_ = std::make_shared<AutoConnectJob>(servers, options);
+  return auto_connect_;
+}
+
+ServersManager::migration_t ServersManager::CreateMigration(IConnectionSettingsBaseSPtr source,
+                                                            IConnectionSettingsBaseSPtr target,
+                                                            const MigrationOptions& options) {
+  if (!source || !target) {
+    return nullptr;
+  }
+
+  const migration_t migration =
+      std::make_shared<MigrationJob>(CreateServerImpl(source), CreateServerImpl(target), options);
+  migrations_.push_back(migration);
+  return migration;
+}
+
+void ServersManager::CloseMigration(migration_t migration) {
+  if (!migration) {
+    DNOTREACHED() << "To close migration need to have migration.";
+    return;
+  }
+
+  migration->Stop();
+  migrations_.erase(std::remove(migrations_.begin(), migrations_.end(), migration), migrations_.end());
+}
+
 void ServersManager::CloseServer(server_t server) {
   if (!server) {
     DNOTREACHED() << "To close server need to have server.";
@@ -291,7 +431,14 @@ common::Error ServersManager::DiscoveryClusterConnection(IConnectionSettingsBase
 #if defined(BUILD_WITH_REDIS)
   if (connection_type == core::REDIS) {
     redis::ConnectionSettings* settings = static_cast<redis::ConnectionSettings*>(connection.get());
-    core::redis::RConfig rconfig(settings->GetInfo(), settings->GetSSHInfo());
+    core::redis::Config info = settings->GetInfo();
+    core::SSHInfo ssh_info = settings->GetSSHInfo();
+    redis_compatible::ssh_tunnel_t tunnel;
+    common::Error err = redis_compatible::RouteThroughSSHTunnel(&info.host, &ssh_info, &tunnel);
+    if (err) {
+      return err;
+    }
+    core::redis::RConfig rconfig(info, ssh_info);
     return core::redis::DiscoveryClusterConnection(rconfig, out);
   }
 #endif
@@ -311,14 +458,28 @@ common::Error ServersManager::DiscoverySentinelConnection(IConnectionSettingsBas
 #if defined(BUILD_WITH_REDIS)
   if (connection_type == core::REDIS) {
     redis::ConnectionSettings* settings = static_cast<redis::ConnectionSettings*>(connection.get());
-    core::redis::RConfig rconfig(settings->GetInfo(), settings->GetSSHInfo());
+    core::redis::Config info = settings->GetInfo();
+    core::SSHInfo ssh_info = settings->GetSSHInfo();
+    redis_compatible::ssh_tunnel_t tunnel;
+    common::Error err = redis_compatible::RouteThroughSSHTunnel(&info.host, &ssh_info, &tunnel);
+    if (err) {
+      return err;
+    }
+    core::redis::RConfig rconfig(info, ssh_info);
     return core::redis::DiscoverySentinelConnection(rconfig, out);
   }
 #endif
 #if defined(BUILD_WITH_KEYDB)
   if (connection_type == core::KEYDB) {
     keydb::ConnectionSettings* settings = static_cast<keydb::ConnectionSettings*>(connection.get());
-    core::keydb::RConfig rconfig(settings->GetInfo(), settings->GetSSHInfo());
+    core::keydb::Config info = settings->GetInfo();
+    core::SSHInfo ssh_info = settings->GetSSHInfo();
+    redis_compatible::ssh_tunnel_t tunnel;
+    common::Error err = redis_compatible::RouteThroughSSHTunnel(&info.host, &ssh_info, &tunnel);
+    if (err) {
+      return err;
+    }
+    core::keydb::RConfig rconfig(info, ssh_info);
     return core::keydb::DiscoverySentinelConnection(rconfig, out);
   }
 #endif
@@ -335,6 +496,7 @@ ServersManager::sentinel_t ServersManager::CreateSentinel(ISentinelSettingsBaseS
   if (connection_type == core::REDIS) {
     sentinel_t sent = std::make_shared<redis::Sentinel>(settings->GetPath().ToString());
     auto nodes = settings->GetSentinels();
+    redis_compatible::sentinel_endpoints_t endpoints;
     for (size_t i = 0; i < nodes.size(); ++i) {
       SentinelSettings nd = nodes[i];
       Sentinel sentt;
@@ -346,7 +508,9 @@ ServersManager::sentinel_t ServersManager::CreateSentinel(ISentinelSettingsBaseS
       }
 
       sent->AddSentinel(sentt);
+      endpoints.push_back(MakeSentinelEndpoint<redis::ConnectionSettings>(nd.sentinel));
     }
+    redis_compatible::WatchSentinel(sent.get(), endpoints);
     return sent;
   }
 #endif
@@ -354,6 +518,7 @@ ServersManager::sentinel_t ServersManager::CreateSentinel(ISentinelSettingsBaseS
   if (connection_type == core::KEYDB) {
     sentinel_t sent = std::make_shared<keydb::Sentinel>(settings->GetPath().ToString());
     auto nodes = settings->GetSentinels();
+    redis_compatible::sentinel_endpoints_t endpoints;
     for (size_t i = 0; i < nodes.size(); ++i) {
       SentinelSettings nd = nodes[i];
       Sentinel sentt;
@@ -365,7 +530,9 @@ ServersManager::sentinel_t ServersManager::CreateSentinel(ISentinelSettingsBaseS
       }
 
       sent->AddSentinel(sentt);
+      endpoints.push_back(MakeSentinelEndpoint<keydb::ConnectionSettings>(nd.sentinel));
     }
+    redis_compatible::WatchSentinel(sent.get(), endpoints);
     return sent;
   }
 #endif
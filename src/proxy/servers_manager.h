@@ -34,6 +34,9 @@
 #include "proxy/connection_settings/isentinel_connection_settings.h"
 #endif
 
+#include "proxy/auto_connect_job.h"
+#include "proxy/connection_diagnostics.h"
+#include "proxy/migration_job.h"
 #include "proxy/proxy_fwd.h"
 
 namespace fastonosql {
@@ -47,8 +50,24 @@ class ServersManager : public common::patterns::LazySingleton<ServersManager> {
   typedef std::vector<server_t> servers_t;
   server_t CreateServer(IConnectionSettingsBaseSPtr settings);
   common::Error TestConnection(IConnectionSettingsBaseSPtr connection) WARN_UNUSED_RESULT;
+  // step by step timings, ping latency distribution and throughput, redis compatible connections only
+  common::Error DiagnoseConnection(IConnectionSettingsBaseSPtr connection,
+                                   const DiagnosticsOptions& options,
+                                   ConnectionDiagnostics* out) WARN_UNUSED_RESULT;
   void CloseServer(server_t server);
 
+  // connects servers with bounded parallelism once started, previous auto connect job is stopped
+  typedef AutoConnectJobSPtr auto_connect_t;
+  auto_connect_t CreateAutoConnect(const servers_t& servers, const AutoConnectOptions& options);
+
+  // source and target are opened by job privately, not shared with explorer
+  typedef MigrationJobSPtr migration_t;
+  typedef std::vector<migration_t> migrations_t;
+  migration_t CreateMigration(IConnectionSettingsBaseSPtr source,
+                              IConnectionSettingsBaseSPtr target,
+                              const MigrationOptions& options);
+  void CloseMigration(migration_t migration);
+
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
   typedef IClusterSPtr cluster_t;
   typedef ISentinelSPtr sentinel_t;
@@ -68,6 +87,8 @@ class ServersManager : public common::patterns::LazySingleton<ServersManager> {
   ServersManager();
 
   servers_t servers_;
+  migrations_t migrations_;
+  auto_connect_t auto_connect_;
 };
 
 }  // namespace proxy
@@ -60,6 +60,7 @@
 #define RCONNECTIONS PREFIX "rconnections"
 #define AUTOOPENCONSOLE PREFIX "auto_open_console"
 #define AUTOCONNECTDB PREFIX "auto_connect_db"
+#define AUTOCONNECTSAVED PREFIX "auto_connect_saved"
 #define WINDOW_SETTINGS PREFIX "window_settings"
 #define SEND_STATISTIC PREFIX "send_statistic"
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
@@ -124,6 +125,7 @@ SettingsManager::SettingsManager()
       auto_completion_(),
       auto_open_console_(),
       auto_connect_db_(),
+      auto_connect_saved_(),
       window_settings_(),
       python_path_() {
 }
@@ -354,6 +356,14 @@ void SettingsManager::SetAutoConnectDB(bool open_db) {
   auto_connect_db_ = open_db;
 }
 
+bool SettingsManager::GetAutoConnectSavedConnections() const {
+  return auto_connect_saved_;
+}
+
+void SettingsManager::SetAutoConnectSavedConnections(bool connect) {
+  auto_connect_saved_ = connect;
+}
+
 QByteArray SettingsManager::GetMainWindowSettings() const {
   return window_settings_;
 }
@@ -456,6 +466,7 @@ void SettingsManager::ReloadFromPath(const std::string& path, bool merge) {
   auto_completion_ = settings.value(AUTOCOMPLETION, true).toBool();
   auto_open_console_ = settings.value(AUTOOPENCONSOLE, true).toBool();
   auto_connect_db_ = settings.value(AUTOCONNECTDB, true).toBool();
+  auto_connect_saved_ = settings.value(AUTOCONNECTSAVED, false).toBool();
   window_settings_ = settings.value(WINDOW_SETTINGS, QByteArray()).toByteArray();
 
   QString qpython_path;
@@ -543,6 +554,7 @@ void SettingsManager::Save() {
   settings.setValue(AUTOCOMPLETION, auto_completion_);
   settings.setValue(AUTOOPENCONSOLE, auto_open_console_);
   settings.setValue(AUTOCONNECTDB, auto_connect_db_);
+  settings.setValue(AUTOCONNECTSAVED, auto_connect_saved_);
   settings.setValue(WINDOW_SETTINGS, window_settings_);
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
   settings.setValue(LAST_LOGIN, last_login_);
@@ -115,6 +115,10 @@ class SettingsManager : public common::patterns::Singleton<SettingsManager> {
   bool GetAutoConnectDB() const;
   void SetAutoConnectDB(bool open_db);
 
+  // opt-in, connecting every saved server at startup may hit production hosts nobody asked for
+  bool GetAutoConnectSavedConnections() const;
+  void SetAutoConnectSavedConnections(bool connect);
+
   QByteArray GetMainWindowSettings() const;
   void SetMainWindowSettings(const QByteArray& settings);
 
@@ -167,6 +171,7 @@ class SettingsManager : public common::patterns::Singleton<SettingsManager> {
   bool auto_completion_;
   bool auto_open_console_;
   bool auto_connect_db_;
+  bool auto_connect_saved_;
   QByteArray window_settings_;
   QString python_path_;
 };
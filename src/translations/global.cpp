@@ -65,6 +65,7 @@ const QString trKill = QObject::tr("Kill");
 const QString trInvalidInput = QObject::tr("Invalid input");
 const QString trViews = QObject::tr("Views");
 const QString trEncodeDecode = QObject::tr("Encode/Decode");
+const QString trMigrateKeys = QObject::tr("Migrate keys");
 const QString trInfo = QObject::tr("Info");
 const QString trError = QObject::tr("Error");
 const QString trCheckVersion = QObject::tr("Check version");
@@ -64,6 +64,7 @@ extern const QString trKill;
 extern const QString trInvalidInput;
 extern const QString trViews;
 extern const QString trEncodeDecode;
+extern const QString trMigrateKeys;
 extern const QString trInfo;
 extern const QString trError;
 extern const QString trCheckVersion;